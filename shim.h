@@ -0,0 +1,4162 @@
+#ifndef LIBSHIM_H
+#define LIBSHIM_H
+
+/*
+ * common headers
+ */
+
+#include <pthread.h>
+
+
+/**
+ * Mutex structure.
+ *   @lock: The pthread lock.
+ */
+
+struct thread_mutex_t {
+	pthread_mutex_t lock;
+};
+
+/**
+ * Read-write lock structure.
+ *   @rwlock: The pthread rwlock.
+ */
+
+struct thread_rwlock_t {
+	pthread_rwlock_t rwlock;
+};
+
+/**
+ * Condition variable structure.
+ *   @var: The pthread condition variable.
+ *   @clock: The clock used by timed waits.
+ */
+
+struct thread_cond_t {
+	pthread_cond_t var;
+	clockid_t clock;
+};
+
+/**
+ * Single run structure.
+ *   @once: The once.
+ */
+
+struct thread_once_t {
+	pthread_once_t once;
+};
+
+
+/*
+ * static initailizer definitions
+ */
+
+#define THREAD_MUTEX_INIT	{ PTHREAD_MUTEX_INITIALIZER }
+#define THREAD_RWLOCK_INIT	{ PTHREAD_RWLOCK_INITIALIZER }
+#define THREAD_ONCE_INIT	{ PTHREAD_ONCE_INIT }
+
+
+/*
+ * debug definitions
+ */
+
+#if !defined(_debug) && defined(DEBUG)
+#	define _debug 1
+#endif
+
+#if !defined(_debug)
+#	define NDEBUG 1
+#endif
+
+/*
+ * common headers
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/**
+ * Variable argument list wrapper structure.
+ *   @args: The internal argument list.
+ */
+
+struct arglist_t {
+	va_list args;
+};
+
+/**
+ * String slice structure. The referenced characters are borrowed and need not
+ * be null terminated.
+ *   @ptr: The first character.
+ *   @len: The length in bytes.
+ */
+
+struct str_slice_t {
+	const char *ptr;
+	size_t len;
+};
+
+
+/**
+ * Control a device.
+ *   @ref: The refernce.
+ *   @id: The control identifier.
+ *   @data: The control data.
+ *   &returns: True if the signal is handle, false otherwise.
+ */
+
+typedef bool (*io_ctrl_f)(void *ref, unsigned int id, void *data);
+
+/**
+ * Close a device.
+ *   @ref: The reference.
+ */
+
+typedef void (*io_close_f)(void *ref);
+
+
+/**
+ * Device interface structure.
+ *   @ctrl: Control.
+ *   @close: Close.
+ */
+
+struct io_device_i {
+	io_ctrl_f ctrl;
+	io_close_f close;
+};
+
+/**
+ * Device structure.
+ *   @ref: The reference.
+ *   @iface: The interface.
+ */
+
+struct io_device_t {
+	void *ref;
+	const struct io_device_t *iface;
+};
+
+
+/**
+ * Write function.
+ *   @ref: The reference.
+ *   @buf: The buffer.
+ *   @nbytes: The number of bytes.
+ *   &returns: The number of bytes written.
+ */
+
+typedef size_t (*io_write_f)(void *ref, const void *restrict buf, size_t nbytes);
+
+/**
+ * Output interface.
+ *   @device: The base device interface.
+ *   @write: Write.
+ */
+
+struct io_output_i {
+	struct io_device_i device;
+
+	io_write_f write;
+};
+
+/**
+ * Output structure.
+ *   @ref: The reference.
+ *   @iface: The interface.
+ */
+
+struct io_output_t {
+	void *ref;
+	const struct io_output_i *iface;
+};
+
+
+/**
+ * Read function.
+ *   @ref: The reference.
+ *   @buf: The buffer.
+ *   @nbytes: The number of bytes.
+ *   &returns: The number of bytes read.
+ */
+
+typedef size_t (*io_read_f)(void *ref, void *restrict buf, size_t nbytes);
+
+/**
+ * Input interface.
+ *   @device: The base device interface.
+ *   @write: Write.
+ */
+
+struct io_input_i {
+	struct io_device_i device;
+
+	io_read_f read;
+};
+
+/**
+ * Input structure.
+ *   @ref: The reference.
+ *   @iface: The interface.
+ */
+
+struct io_input_t {
+	void *ref;
+	const struct io_input_i *iface;
+};
+
+
+/**
+ * Seek whence enumerator.
+ *   @io_seek_set_e: Beginning of the file.
+ *   @io_seek_cur_e: Current position.
+ *   @io_seek_end_e: End of the file.
+ */
+
+enum io_whence_e {
+	io_seek_set_e,
+	io_seek_cur_e,
+	io_seek_end_e
+};
+
+
+/**
+ * Retrieve the file offset.
+ *   @ref: The reference.
+ *   &returns: The offset from the beginning of the file.
+ */
+
+typedef uint64_t (*io_tell_f)(void *ref);
+
+/**
+ * Seek to a given file offset.
+ *   @ref: The reference.
+ *   @offset: The offset.
+ *   @whence: The position from which to seek.
+ *   &returns: The new offset from the beginning of the file.
+ */
+
+typedef uint64_t (*io_seek_f)(void *ref, int64_t offset, enum io_whence_e whence);
+
+/**
+ * File interface.
+ *   @device: The base device interface.
+ *   @read: Read.
+ *   @write: Write.
+ *   @tell: Tell.
+ *   @seek: Seek.
+ */
+
+struct io_file_i {
+	struct io_device_i device;
+
+	io_read_f read;
+	io_write_f write;
+
+	io_tell_f tell;
+	io_seek_f seek;
+};
+
+/**
+ * File structure.
+ *   @ref: The reference.
+ *   @iface: The interface.
+ */
+
+struct io_file_t {
+	void *ref;
+	const struct io_file_i *iface;
+};
+
+/**
+ * File open options enumerator.
+ *   @io_read_e: Read.
+ *   @io_write_e: Write.
+ *   @io_rw_e: Read and write.
+ *   @io_append_e: Append.
+ *   @io_trunc_e: Truncate.
+ *   @io_unbuf_e: Unbuffered.
+ *   @io_create_e: Create.
+ */
+
+enum io_file_e {
+	io_read_e = 0x01,
+	io_write_e = 0x02,
+	io_rw_e = 0x03,
+	io_append_e = 0x04,
+	io_trunc_e = 0x08,
+	io_unbuf_e = 0x10,
+	io_create_e = 0x20
+};
+
+/**
+ * Output buffering mode enumerator.
+ *   @io_buf_none_e: Unbuffered, writes pass straight through.
+ *   @io_buf_line_e: Line buffered, flushed after every newline.
+ *   @io_buf_full_e: Fully buffered, flushed only when full.
+ */
+
+enum io_buf_e {
+	io_buf_none_e,
+	io_buf_line_e,
+	io_buf_full_e
+};
+
+/**
+ * Serialization encoding enumerator.
+ *   @io_serial_native_e: Fixed-width values in native byte order.
+ *   @io_serial_compact_e: Versioned, endian-stable encoding using LEB128
+ *     varints for tags, lengths, and integers.
+ */
+
+enum io_serial_e {
+	io_serial_native_e,
+	io_serial_compact_e
+};
+
+
+/*
+ * special value definitions
+ */
+
+#define IO_EOS		(-1)
+
+/*
+ * compact serialization header definitions
+ */
+
+#define IO_SERIAL_MAGIC		"shim"
+#define IO_SERIAL_VERSION	1
+
+/*
+ * control definitions
+ */
+
+enum io_ctrl_e {
+	io_ctrl_eos_e,
+	io_ctrl_flush_e,
+	io_ctrl_fd_e
+};
+#define IO_CTRL_EOS	(1)
+#define IO_CTRL_FLUSH	(2)
+#define IO_CTRL_FD	(3)
+
+
+/**
+ * Chunked output callback.
+ *   @output: The output device.
+ *   @arg: The argument.
+ */
+
+typedef void (*io_chunk_f)(struct io_output_t output, void *arg);
+
+/**
+ * Chunked output structure.
+ *   @func: The callback function.
+ *   @arg: The callback argument.
+ */
+
+struct io_chunk_t {
+	io_chunk_f func;
+	void *arg;
+};
+
+
+
+
+/**
+ * Initializer function.
+ *   @ref: The reference.
+ */
+
+typedef void (*init_f)(void *ref);
+
+/**
+ * Delete a reference.
+ *   @ref: The reference.
+ */
+
+typedef void (*delete_f)(void *ref);
+
+/**
+ * Copy a reference.
+ *   @ref: The source reference.
+ *   &returns: The copied reference.
+ */
+
+typedef void *(*copy_f)(void *ref);
+
+
+/**
+ * Value comparison.
+ *   @p1: The first pointer value.
+ *   @p2: The second pointer value.
+ *   &returns: Their order.
+ */
+
+typedef int (*compare_f)(const void *p1, const void *p2);
+
+
+/**
+ * Obtain the next iterator reference.
+ *   @ref: The iterator reference.
+ *   &returns: The reference. 'NULL' if at the end of the iterator.
+ */
+
+typedef void *(*iter_f)(void *ref);
+
+/**
+ * Iterator interface structure.
+ *   @next: The next function.
+ *   @delete: The internal deletion function.
+ */
+
+struct iter_i {
+	iter_f next;
+	delete_f delete;
+};
+
+/**
+ * Iterator storage structure.
+ *   @ref: The internal reference.
+ *   @iface: The iterator interface.
+ */
+
+struct iter_t {
+	void *ref;
+	const struct iter_i *iface;
+};
+
+
+/**
+ * Create an iterator.
+ *   @ref: The enumerator reference.
+ *   &returns: The iterator.
+ */
+
+typedef struct iter_t (*enum_f)(void *ref);
+
+/**
+ * Enumerator interface structure.
+ *   @iter: The iterator function.
+ *   @delete: The internal deletion function.
+ */
+
+struct enum_i {
+	enum_f iter;
+	delete_f delete;
+};
+
+/**
+ * Enumerator storage structure.
+ *   @ref: The internal reference.
+ *   @iface: The enumerator interface.
+ */
+
+struct enum_t {
+	void *ref;
+	const struct enum_i *iface;
+};
+
+
+/**
+ * Filter an input element.
+ *   @ref: The filter reference.
+ *   @in: The input.
+ *   &returns: The output reference or null.
+ */
+
+typedef void *(*filter_f)(void *ref, void *in);
+
+/**
+ * Filter an input element.
+ *   @in: The input.
+ *   @arg: The argument.
+ *   &returns: The output reference or null.
+ */
+
+typedef void *(*filter_apply_f)(void *in, void *arg);
+
+/**
+ * Filter interface structure.
+ *   @apply: The filter application function.
+ *   @delete: The internal deletion function.
+ */
+
+struct filter_i {
+	filter_f apply;
+	delete_f delete;
+};
+
+/**
+ * Enumerator storage structure.
+ *   @ref: The internal reference.
+ *   @iface: The filter interface.
+ */
+
+struct filter_t {
+	void *ref;
+	const struct filter_i *iface;
+};
+
+
+/*
+ * blank function declarations
+ */
+
+void delete_noop(void *ref);
+
+
+/**
+ * AVL tree definitions.
+ *   @AVLTREE_MAX_HEIGHT: The maximum height of an AVL tree.
+ *   @AVLTREE_NODE_INIT: An inline structure to initialize a node.
+ */
+
+#define AVLTREE_MAX_HEIGHT	48
+#define AVLTREE_NODE_INIT	(struct avltree_node_t){ 0, NULL, { NULL, NULL } }
+
+
+/*
+ * structure prototypes
+ */
+
+struct avltree_t;
+struct avltree_node_t;
+struct avltree_inst_t;
+struct avltree_iter_t;
+
+
+/**
+ * AVL tree root structure.
+ *   @node: The root node.
+ */
+
+struct avltree_root_t {
+	struct avltree_node_t *node;
+};
+
+/**
+ * AVL tree storage.
+ *   @root: The root.
+ *   @count: The number of nodes.
+ *   @compare: The comparison function.
+ *   @delete: The value deletion function.
+ */
+
+struct avltree_t {
+	struct avltree_root_t root;
+
+	unsigned int count;
+
+	compare_f compare;
+	delete_f delete;
+};
+
+/**
+ * AVL tree node storage.
+ *   @balance: The current balance of the node, between '-2' to '2'.
+ *   @parent, child: The parent and child nodes.
+ */
+
+struct avltree_node_t {
+	int8_t balance;
+	struct avltree_node_t *parent, *child[2];
+};
+
+/**
+ * AVL tree reference storage.
+ *   @key: The key reference.
+ *   @ref: The value reference.
+ *   @node: The node.
+ */
+
+struct avltree_inst_t {
+	const void *key;
+	void *ref;
+
+	struct avltree_node_t node;
+};
+
+/**
+ * AVL tree iterator storage.
+ *   @i: The current level.
+ *   @stack: The stack of nodes.
+ *   @state: The stack of states per level.
+ */
+
+struct avltree_iter_t {
+	short i;
+	struct avltree_node_t *stack[AVLTREE_MAX_HEIGHT];
+	uint8_t state[AVLTREE_MAX_HEIGHT];
+};
+
+
+/**
+ * AVL index tree definitions.
+ *   @AVLITREE_MAX_HEIGHT: The maximum height of an AVL tree.
+ *   @AVLITREE_NODE_INIT: An inline structure to initialize a node.
+ */
+
+#define AVLITREE_MAX_HEIGHT	48
+#define AVLITREE_NODE_INIT	(struct avlitree_node_t){ 0, { NULL, NULL }, NULL, 1 }
+
+
+/*
+ * structure prototypes
+ */
+
+struct avlitree_t;
+struct avlitree_node_t;
+struct avlitree_ref_t;
+struct avlitree_iter_t;
+
+
+/**
+ * Deletion callback for a node.
+ *   @node: The current node.
+ *   @arg: The callback argument.
+ */
+
+typedef void (*avlitree_delete_node_f)(struct avlitree_node_t *node, void *arg);
+
+
+/**
+ * Storage feor the AVL index tree.
+ *   @root: A reference to the root node.
+ *   @count: The number of nodes in the tree.
+ *   @delete: The deletion function for nodes.
+ */
+
+struct avlitree_t {
+	struct avlitree_node_t *root;
+
+	unsigned int count;
+
+	delete_f delete;
+};
+
+/**
+ * AVL index tree node storage.
+ *   @balance: The current balance of the node, between '-2' to '2'.
+ *   @child, parent: The child and parent nodes.
+ *   @count: The count of nodes below this node.
+ */
+
+struct avlitree_node_t {
+	int8_t balance;
+	struct avlitree_node_t *child[2], *parent;
+	unsigned int count;
+};
+
+/**
+ * AVL index tree root structure.
+ *   @node: The root node.
+ */
+
+struct avlitree_root_t {
+	struct avlitree_node_t *node;
+};
+
+/**
+ * AVL index tree reference storage.
+ *   @ref: The value reference.
+ *   @node: The node.
+ */
+
+struct avlitree_ref_t {
+	void *ref;
+
+	struct avlitree_node_t node;
+};
+
+/**
+ * AVL index tree iterator storage.
+ *   @i: The current level.
+ *   @stack: The stack of nodes.
+ *   @state: The stack of states per level.
+ */
+
+struct avlitree_iter_t {
+	short i;
+	struct avlitree_node_t *stack[AVLITREE_MAX_HEIGHT];
+	uint8_t state[AVLITREE_MAX_HEIGHT];
+};
+
+
+/*
+ * type prototypes
+ */
+
+enum os_path_e;
+
+/*
+ * application path function declarations
+ */
+
+struct io_chunk_t app_path_chunk(const char *app, enum os_path_e id);
+
+
+/*
+ * setjmp header
+ */
+
+#include <setjmp.h>
+
+/*
+ * fatal function declarations
+ */
+
+void _nothrow();
+_noreturn void _abort();
+_noreturn void _shim_fatal(const char *file, unsigned int line, const char *restrict format, ...);
+
+void _backtrace();
+
+
+/**
+ * Try state structure.
+ *   @fatal: Fatal flag.
+ *   @jmpbuf: The jump buffer.
+ *   @prev: The previous try on the stack.
+ */
+
+struct _shim_try_t {
+	bool fatal;
+	jmp_buf jmpbuf;
+
+	struct _shim_try_t *prev;
+};
+
+
+/*
+ * exception function declarations
+ */
+
+struct _shim_try_t *_shim_try_start();
+void _shim_try_end(struct _shim_try_t *inst);
+
+const char *_shim_catch_start();
+void _shim_catch_end();
+
+_noreturn void _shim_throw(const char *file, unsigned int line, const char *restrict format, ...);
+_noreturn void _shim_vthrow(const char *file, unsigned int line, const char *restrict format, va_list args);
+_noreturn void _shim_sthrow(const char *file, unsigned int line, char *restrict error);
+
+#define try		for(struct _shim_try_t *_shim_try = _shim_try_start(); _shim_try != NULL; _shim_try_end(_shim_try), _shim_try = NULL) if(!setjmp(_shim_try->jmpbuf)) switch(0) case 0:
+#define catch(e)	else for(const char *e = (_shim_try = NULL, _shim_catch_start()); e != NULL ; _shim_catch_end(), e = NULL) switch(0) case 0:
+
+#define _fatal(...)	_shim_fatal(__FILE__, __LINE__, __VA_ARGS__)
+#define throw(...)	_shim_throw(__FILE__, __LINE__, __VA_ARGS__)
+#define vthrow(...)	_shim_vthrow(__FILE__, __LINE__, __VA_ARGS__)
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+struct io_chunk_t;
+
+/*
+ * resource debuggin function declarations
+ */
+
+void _dbg_res_alloc(void *res, const char *file, unsigned int line, struct io_chunk_t info);
+void _dbg_res_free(void *res);
+void _dbg_res_atexit();
+
+unsigned int dbg_res_count();
+void dbg_res_dump(struct io_output_t output);
+
+#define dbg_res_alloc(res) _dbg_res_alloc(res, __FILE__, __LINE__)
+#define dbg_res_free(res) _dbg_res_free(res)
+
+
+/*
+ * base filesystem function declarations
+ */
+
+bool fs_exists(const char *path);
+bool fs_isfile(const char *path);
+bool fs_islink(const char *path);
+bool fs_isdir(const char *path);
+
+void fs_write(const char *path, const void *buf, size_t nbytes);
+void fs_writestr(const char *path, const char *str);
+void fs_read(const char *path, void *buf, size_t nbytes);
+char *fs_readstr(const char *path);
+
+void fs_move(const char *dest, const char *src);
+bool fs_trymove(const char *dest, const char *src);
+size_t fs_copy(const char *dest, const char *src);
+bool fs_trycopy(const char *dest, const char *src);
+
+void fs_link(const char *dest, const char *target);
+bool fs_trylink(const char *dest, const char *target);
+void fs_symlink(const char *dest, const char *target);
+bool fs_trysymlink(const char *dest, const char *target);
+void fs_mkfile(const char *path);
+bool fs_trymkfile(const char *path);
+void fs_mkdir(const char *path);
+bool fs_trymkdir(const char *path);
+void fs_mkdir_parents(const char *path);
+
+void fs_rmdir(const char *path);
+void fs_rmfile(const char *path);
+void fs_clear(const char *path);
+
+struct iter_t fs_lsdir(const char *path);
+
+const char *fs_tmpdir();
+void fs_tmpfill(char *buf, unsigned int len);
+char *fs_tmpname(const char *prefix);
+char *fs_mktmpdir(const char *prefix);
+char *fs_mktmpfile(const char *prefix);
+
+
+/*
+ * path filesystem function declarations
+ */
+
+const char *fs_basename(const char *path);
+
+
+/*
+ * algorithm function declarations
+ */
+
+unsigned int m_gcd(unsigned int a, unsigned int b);
+unsigned int m_lcm(unsigned int a, unsigned int b);
+
+
+/**
+ * Double-precision floating-point absolute value.
+ *   @val: The value.
+ *   &returns: The absolute value.
+ */
+
+static inline double m_dblabs(double val)
+{
+	return fabs(val);
+}
+
+
+static inline double m_rnd(double val, double mul)
+{
+	return mul * round(val / mul);
+}
+
+static inline double m_log10rnd(double val, unsigned int n)
+{
+	double t;
+
+	t = pow(10, ceil(log10(val / (5.5 / n))));
+	return m_rnd(val, t / n) ?: t / 10.0;
+}
+
+static inline double m_log10rnd_prev(double val, unsigned int n)
+{
+	double inc, t;
+
+	val = m_log10rnd(val, n);
+	t = pow(10, ceil(log10(val)));
+	inc = t / n;
+	return m_rnd(val - inc, inc) ?: t / 10.0;
+}
+
+static inline double m_log10rnd_next(double val, unsigned int n)
+{
+	double inc, t;
+
+	val = m_log10rnd(val, n);
+	t = pow(10, floor(log10(val)) + 1.0);
+	inc = t / n;
+	return m_rnd(val + inc - inc / 4, inc) ?: t / 10.0;
+}
+
+
+/**
+ * Unsigned 16-bit integer maximum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The maximum.
+ */
+
+static inline uint16_t m_uint16max(uint16_t a, uint16_t b)
+{
+	return (a > b) ? a : b;
+}
+
+/**
+ * Unsigned 32-bit integer maximum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The maximum.
+ */
+
+static inline uint32_t m_uint32max(uint32_t a, uint32_t b)
+{
+	return (a > b) ? a : b;
+}
+
+/**
+ * Unsigned integer minimum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The minimum.
+ */
+
+static inline unsigned int m_uintmin(unsigned int a, unsigned int b)
+{
+	return (a < b) ? a : b;
+}
+
+/**
+ * Unsigned integer maximum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The maximum.
+ */
+
+static inline unsigned int m_uintmax(unsigned int a, unsigned int b)
+{
+	return (a > b) ? a : b;
+}
+
+/**
+ * Unsigned 32-bit integer maximum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The maximum.
+ */
+
+static inline size_t m_sizemax(size_t a, size_t b)
+{
+	return (a > b) ? a : b;
+}
+
+
+/**
+ * Unsigned 32-bit integer minimum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The minimum.
+ */
+
+static inline size_t m_sizemin(size_t a, size_t b)
+{
+	return (a < b) ? a : b;
+}
+
+/**
+ * Unsigned 64-bit integer minimum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The minimum.
+ */
+
+static inline uint64_t m_uint64min(uint64_t a, uint64_t b)
+{
+	return (a < b) ? a : b;
+}
+
+
+/**
+ * Unsinged integer count the number of leading zeros.
+ *   @n: The number.
+ *   &returns: The number of leading zeros
+ */
+
+static inline int8_t m_uintclz(unsigned int n)
+{
+	return __builtin_clz(n);
+}
+
+/**
+ * Unsinged integer count the number of leading zeros.
+ *   @n: The number.
+ *   &returns: The number of leading zeros
+ */
+
+static inline int8_t m_uintctz(unsigned int n)
+{
+	return __builtin_ctz(n);
+}
+
+
+/**
+ * Double maximum.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   &returns: The maximum.
+ */
+
+static inline double m_dblmax(double a, double b)
+{
+	return (a > b) ? a : b;
+}
+
+/**
+ * Double minimum.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   &returns: The minimum.
+ */
+
+static inline double m_dblmin(double a, double b)
+{
+	return (a < b) ? a : b;
+}
+
+/**
+ * Unsigned 64-bit integer full multiplication.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   @hi: Out. The high 64 bits of the product.
+ *   &returns: The low 64 bits of the product.
+ */
+
+static inline uint64_t m_uint64mul(uint64_t a, uint64_t b, uint64_t *hi)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 p = (unsigned __int128)a * b;
+
+	*hi = p >> 64;
+
+	return p;
+#else
+	uint64_t ll, lh, hl, mid;
+
+	ll = (a & 0xffffffff) * (b & 0xffffffff);
+	lh = (a & 0xffffffff) * (b >> 32);
+	hl = (a >> 32) * (b & 0xffffffff);
+	mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+
+	*hi = (a >> 32) * (b >> 32) + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+	return (mid << 32) | (ll & 0xffffffff);
+#endif
+}
+
+/**
+ * Unsigned 128-bit by 64-bit integer division. The high half of the dividend
+ * must be less than the divisor so that the quotient fits in 64 bits.
+ *   @hi: The high 64 bits of the dividend.
+ *   @lo: The low 64 bits of the dividend.
+ *   @d: The divisor.
+ *   @rem: Optional. Out. The remainder.
+ *   &returns: The quotient.
+ */
+
+static inline uint64_t m_uint64div(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *rem)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 n = ((unsigned __int128)hi << 64) | lo;
+
+	if(rem != NULL)
+		*rem = n % d;
+
+	return n / d;
+#else
+	uint64_t dh, dl, nh, nl, qh, ql, r, un;
+	int s;
+
+	s = __builtin_clzll(d);
+	if(s > 0) {
+		d <<= s;
+		hi = (hi << s) | (lo >> (64 - s));
+		lo <<= s;
+	}
+
+	dh = d >> 32;
+	dl = d & 0xffffffff;
+	nh = lo >> 32;
+	nl = lo & 0xffffffff;
+
+	qh = hi / dh;
+	r = hi % dh;
+	while(((qh >> 32) != 0) || ((qh * dl) > ((r << 32) | nh))) {
+		qh--;
+		r += dh;
+		if((r >> 32) != 0)
+			break;
+	}
+
+	un = ((hi << 32) | nh) - qh * d;
+	ql = un / dh;
+	r = un % dh;
+	while(((ql >> 32) != 0) || ((ql * dl) > ((r << 32) | nl))) {
+		ql--;
+		r += dh;
+		if((r >> 32) != 0)
+			break;
+	}
+
+	if(rem != NULL)
+		*rem = (((un << 32) | nl) - ql * d) >> s;
+
+	return (qh << 32) | ql;
+#endif
+}
+
+/**
+ * Double modulus operator.
+ *   @a: The input value.
+ *   @b: The modulus.
+ *   &returns: The modulated value.
+ */
+
+static inline double m_dblmod(double a, double b)
+{
+	return fmod(a, b);
+}
+
+
+/**
+ * Random storage structure.
+ *   @x, y, z, w: Storage data.
+ */
+
+struct m_rand_t {
+	uint32_t x, y, z, w;
+};
+
+
+/**
+ * Create a new random generator.
+ *   @seed: The seed.
+ *   &returns; The random generator.
+ */
+
+static inline struct m_rand_t m_rand_new(uint32_t seed)
+{
+	return (struct m_rand_t){ 123456789, 362436069, 521288629, seed };
+}
+
+
+/*
+ * random function declarations
+ */
+
+uint32_t m_rand_next(struct m_rand_t *rand);
+double m_rand_nextd(struct m_rand_t *rand);
+
+/*
+ * random function declarations
+ */
+
+
+/*
+ * basic memory function declarations
+ */
+
+void mem_zero(void *dest, size_t nbytes);
+void mem_set(void *dest, uint8_t byte, size_t nbytes);
+void mem_copy(void *restrict dest, const void *restrict src, size_t nbytes);
+void mem_move(void *dest, const void *src, size_t nbytes);
+
+int mem_cmp(const void *p1, const void *p2, size_t nbytes);
+bool mem_isequal(const void *p1, const void *p2, size_t nbytes);
+
+void *mem_dup(void *ptr, size_t nbytes);
+
+#define mem_getref(type, val) (&(union { type v; }){ .v = (val) })
+#define mem_dupval(type, val) mem_dup(&(union { type v; }){ .v = (val) }, sizeof(type))
+
+#define getcontainer(ptr, type, member) ((type *)((void *)(ptr) - offsetof(type, member)))
+
+
+/*
+ * memory function declarations
+ */
+
+void *_mem_alloc(size_t nbytes);
+void *_mem_realloc(void *ptr, size_t nbytes);
+void _mem_free(void *ptr);
+void _mem_delete(void *ptr);
+
+void *_mem_alloc_dbg(size_t nbytes, const char *file, unsigned int line);
+void *_mem_realloc_dbg(void *ptr, size_t nbytes, const char *file, unsigned int line);
+void _mem_free_dbg(void *ptr);
+void _mem_delete_dbg(void *ptr);
+
+#ifdef _debug
+#	define mem_alloc(nbytes) _mem_alloc_dbg(nbytes, __FILE__, __LINE__)
+#	define mem_realloc(ptr, nbytes) _mem_realloc_dbg(ptr, nbytes, __FILE__, __LINE__)
+#	define mem_free _mem_free_dbg
+#	define mem_delete _mem_delete_dbg
+#else
+#	define mem_alloc(nbytes) _mem_alloc(nbytes)
+#	define mem_realloc(ptr, nbytes) _mem_realloc(ptr, nbytes)
+#	define mem_free _mem_free
+#	define mem_delete _mem_delete
+#endif
+
+
+/*
+ * chunk variables
+ */
+
+extern struct io_chunk_t io_chunk_null;
+
+/*
+ * chunk function declarations
+ */
+
+void io_chunk_proc(struct io_chunk_t chunk, struct io_output_t output);
+void io_chunk_proc_nbytes(struct io_chunk_t chunk, struct io_output_t output, size_t nbytes);
+char *io_chunk_proc_str(struct io_chunk_t chunk);
+void io_chunk_proc_buf(struct io_chunk_t chunk, char *buf);
+size_t io_chunk_proc_len(struct io_chunk_t chunk);
+
+struct io_chunk_t io_chunk_str(const char *str);
+struct io_chunk_t io_chunk_strptr(char **str);
+struct io_chunk_t io_chunk_uint(unsigned int *val);
+struct io_chunk_t io_chunk_cond(const struct io_chunk_t *pair);
+struct io_chunk_t io_chunk_indent(const unsigned int *indent);
+struct io_chunk_t io_chunk_pair(struct io_chunk_t *pair);
+
+/*
+ * chunk definitions
+ */
+
+#define io_chunk_nullstr(chunk, str) io_chunk_cond((struct io_chunk_t []){ chunk, io_chunk_str(str) })
+#define io_chunk_indentval(val) io_chunk_indent(&(union { unsigned int i; }){ .i = val }.i)
+#define io_chunk_pairval(left, right) io_chunk_pair((struct io_chunk_t []){ left, right })
+#define io_chunk_pairstr(left, right) io_chunk_pairval(io_chunk_str(left), io_chunk_str(right))
+
+
+/**
+ * Determine if a chunk is null.
+ *   @chunk: The chunk.
+ *   &returns: True if null, false otherwise.
+ */
+
+static inline bool io_chunk_isnull(struct io_chunk_t chunk)
+{
+	return (chunk.func == NULL) && (chunk.arg == NULL);
+}
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_conf_t;
+struct io_conf_link_t;
+
+
+/**
+ * Configuration pair structure.
+ *   @id: The interned identifier.
+ *   @nvalues: The number of values.
+ *   @value: The value array.
+ */
+
+struct io_conf_pair_t {
+	const char *id;
+
+	unsigned int nvalues;
+	char **value;
+};
+
+
+/**
+ * Configure pair iterator.
+ *   @link: The next link.
+ */
+
+struct io_conf_iter_t {
+	struct io_conf_link_t *link;
+};
+
+/**
+ * Sub-configuration pair iterator.
+ *   @link: The next link.
+ */
+
+struct io_conf_subiter_t {
+	struct io_conf_link_t *link;
+};
+
+
+/**
+ * Configuration change enumerator.
+ *   @io_conf_add_e: Added.
+ *   @io_conf_remove_e: Removed.
+ *   @io_conf_modify_e: Values modified.
+ */
+
+enum io_conf_change_e {
+	io_conf_add_e,
+	io_conf_remove_e,
+	io_conf_modify_e
+};
+
+/**
+ * Configuration change structure. Key changes refer to the containing
+ * sections, section changes refer to the sections themselves.
+ *   @type: The change type.
+ *   @section: Section flag.
+ *   @id: The key or section identifier.
+ *   @prev, next: The previous and next sections, null if absent.
+ *   @before, after: The previous and next pairs, null if absent.
+ */
+
+struct io_conf_change_t {
+	enum io_conf_change_e type;
+	bool section;
+	const char *id;
+
+	struct io_conf_t *prev, *next;
+	const struct io_conf_pair_t *before, *after;
+};
+
+/**
+ * Configuration change callback.
+ *   @change: The change.
+ *   @arg: The argument.
+ */
+
+typedef void (*io_conf_change_f)(const struct io_conf_change_t *change, void *arg);
+
+
+/*
+ * configuration function declarations
+ */
+
+struct io_conf_t *io_conf_new();
+void io_conf_delete(struct io_conf_t *conf);
+
+struct io_conf_t *io_conf_read(struct io_input_t input);
+struct io_conf_t *io_conf_load(const char *path);
+struct io_conf_t *io_conf_reload(struct io_conf_t *conf, const char *path, io_conf_change_f func, void *arg);
+void io_conf_diff(struct io_conf_t *prev, struct io_conf_t *next, io_conf_change_f func, void *arg);
+
+const char *io_conf_id(struct io_conf_t *conf);
+struct io_conf_t *io_conf_parent(struct io_conf_t *conf);
+unsigned int io_conf_accum(struct io_conf_t *conf);
+
+const char *const *io_conf_lookup_values(struct io_conf_t *conf, const char *id);
+struct io_conf_pair_t *io_conf_lookup(struct io_conf_t *conf, const char *id);
+const char *io_conf_lookup_single(struct io_conf_t *conf, const char *id);
+
+struct io_conf_pair_t *io_conf_remove(struct io_conf_t *conf, const char *id);
+char *io_conf_remove_single(struct io_conf_t *conf, const char *id);
+
+struct io_conf_iter_t io_conf_iter_begin(struct io_conf_t *conf);
+const struct io_conf_pair_t *io_conf_iter_next(struct io_conf_iter_t *iter);
+
+struct io_conf_subiter_t io_conf_subiter_begin(struct io_conf_t *conf);
+struct io_conf_t *io_conf_subiter_next(struct io_conf_subiter_t *iter);
+
+/*
+ * configuration pair function declarations
+ */
+
+struct io_conf_pair_t *io_conf_pair_new(const char *id);
+void io_conf_pair_delete(struct io_conf_pair_t *pair);
+
+void io_conf_pair_add(struct io_conf_pair_t *pair, const char *value);
+
+
+/*
+ * blank function declarations
+ */
+
+bool io_blank_ctrl(void *ref, unsigned int id, void *data);
+void io_blank_close(void *ref);
+
+
+/*
+ * file function declarations
+ */
+
+struct io_file_t _io_file_open(const char *path, enum io_file_e opt);
+void io_file_close(struct io_file_t file);
+
+bool io_file_ctrl(struct io_file_t file, unsigned int id, void *data);
+
+size_t io_file_read(struct io_file_t file, void *restrict buf, size_t nbytes);
+size_t io_file_write(struct io_file_t file, const void *restrict buf, size_t nbytes);
+
+uint64_t io_file_tell(struct io_file_t file);
+uint64_t io_file_seek(struct io_file_t file, int64_t offset, enum io_whence_e whence);
+
+/*
+ * i/o file function declarations
+ */
+
+struct io_input_t io_file_input(struct io_file_t file);
+struct io_output_t io_file_output(struct io_file_t file);
+
+/*
+ * convenience definitions
+ */
+
+#ifdef _debug
+//#	define io_file_open(path, opt) _io_file_open_dbg(path, opt, __FILE__, __LINE__)
+#	define io_file_open(path, opt) _io_file_open(path, opt)
+#else
+#	define io_file_open(path, opt) _io_file_open(path, opt)
+#endif
+
+
+/**
+ * Filter an input element to a chunk.
+ *   @ref: The filter reference.
+ *   @in: The input.
+ *   &returns: The output chunk.
+ */
+
+typedef struct io_chunk_t (*io_filter_f)(void *ref, void *in);
+
+/**
+ * Filter an input element.
+ *   @in: The input.
+ *   @arg: The argument.
+ *   &returns: The output chunk.
+ */
+
+typedef struct io_chunk_t (*io_filter_apply_f)(void *in, void *arg);
+
+/**
+ * Filter interface structure.
+ *   @apply: The filter application function.
+ *   @delete: The internal deletion function.
+ */
+
+struct io_filter_i {
+	io_filter_f apply;
+	delete_f delete;
+};
+
+/**
+ * Enumerator storage structure.
+ *   @ref: The internal reference.
+ *   @iface: The filter interface.
+ */
+
+struct io_filter_t {
+	void *ref;
+	const struct io_filter_i *iface;
+};
+
+
+/*
+ * filter variables
+ */
+
+extern struct io_filter_t io_filter_blank;
+extern struct io_filter_t io_filter_str;
+
+/*
+ * filter function declarations
+ */
+
+struct io_filter_t io_filter_new(io_filter_apply_f func, void *arg);
+
+
+/**
+ * Create the iterator from a filter.
+ *   @filter: The filter.
+ *   @in: The input.
+ *   &returns: The chunk.
+ */
+
+static inline struct io_chunk_t io_filter_apply(struct io_filter_t filter, void *in)
+{
+	return filter.iface->apply(filter.ref, in);
+}
+
+/**
+ * Delete the filter.
+ *   @filter: The filter.
+ */
+
+static inline void io_filter_delete(struct io_filter_t filter)
+{
+	filter.iface->delete(filter.ref);
+}
+
+
+/*
+ * input function declarations
+ */
+
+struct io_input_t io_input_stdin();
+
+struct io_input_t _io_input_open(const char *path);
+struct io_input_t _io_input_open_dbg(const char *path, const char *file, unsigned int line);
+
+bool io_input_ctrl(struct io_input_t input, unsigned int cmd, void *arg);
+size_t io_input_read(struct io_input_t input, void *restrict buf, size_t nbytes);
+void io_input_readfull(struct io_input_t input, void *restrict buf, size_t nbytes);
+int16_t io_input_byte(struct io_input_t input);
+void io_input_close(struct io_input_t input);
+
+bool io_input_eos(struct io_input_t input);
+
+bool io_input_bool(struct io_input_t input);
+uint8_t io_input_uint8(struct io_input_t input);
+uint16_t io_input_uint16(struct io_input_t input);
+uint32_t io_input_uint32(struct io_input_t input);
+uint64_t io_input_uint64(struct io_input_t input);
+char io_input_ch(struct io_input_t input);
+char *io_input_str(struct io_input_t input);
+char *io_input_strptr(struct io_input_t input);
+char *io_input_line(struct io_input_t input);
+float io_input_float(struct io_input_t input);
+double io_input_double(struct io_input_t input);
+uint64_t io_input_varint(struct io_input_t input);
+int64_t io_input_zigzag(struct io_input_t input);
+
+/*
+ * convenience definitions
+ */
+
+#define io_stdin io_input_stdin()
+
+#ifdef _debug
+#	define io_input_open(path) _io_input_open_dbg(path, __FILE__, __LINE__)
+#else
+#	define io_input_open(path) _io_input_open(path)
+#endif
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_chunk_t;
+struct io_filter_t;
+
+
+/**
+ * I/O iterator function.
+ *   @ref: The reference.
+ *   &returns: The chunk.
+ */
+
+typedef struct io_chunk_t (*io_iter_f)(void *ref);
+
+/**
+ * Iterator interface structure.
+ *   @next: The next function.
+ *   @delete: The internal deletion function.
+ */
+
+struct io_iter_i {
+	io_iter_f next;
+	delete_f delete;
+};
+
+/**
+ * Iteator instance storage structure.
+ *   @ref: The internal reference.
+ *   @iface: The iterator interface.
+ */
+
+struct io_iter_t {
+	void *ref;
+	const struct io_iter_i *iface;
+};
+
+
+/*
+ * i/o iterator function declarations
+ */
+
+struct io_iter_t io_iter_filter(struct iter_t inner, struct io_filter_t apply);
+
+
+/**
+ * Obtain the next chunk from the iterator.
+ *   @iter: The iterator.
+ *   &returns: The reference. 'NULL' if at the end of the iterator.
+ */
+
+static inline struct io_chunk_t io_iter_next(struct io_iter_t iter)
+{
+	return iter.iface->next(iter.ref);
+}
+
+/**
+ * Delete the iterator.
+ *   @iter: The iterator.
+ */
+
+static inline void io_iter_delete(struct io_iter_t iter)
+{
+	iter.iface->delete(iter.ref);
+}
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+
+
+/**
+ * I/O object processing callback.
+ *   @ref: The reference.
+ *   @output: The output.
+ */
+
+typedef void (*io_object_f)(void *ref, struct io_output_t output);
+
+/**
+ * I/O object interface.
+ *   @proc: Processing function.
+ *   @delete: Deletion.
+ */
+
+struct io_object_i {
+	io_object_f proc;
+	delete_f delete;
+};
+
+/**
+ * Object structure.
+ *   @ref: The reference.
+ *   @iface: The interface.
+ */
+
+struct io_object_t {
+	void *ref;
+	const struct io_object_i *iface;
+};
+
+
+/*
+ * i/o object variables
+ */
+
+extern struct io_object_t io_object_null;
+
+/*
+ * i/o object function declarations
+ */
+
+struct io_object_t io_object_new(void *ref, io_object_f proc, delete_f delete);
+void io_object_proc(struct io_object_t object, struct io_output_t output);
+void io_object_delete(struct io_object_t object);
+
+struct io_object_t io_object_copy(const char *path);
+
+
+/**
+ * Test if an I/O object is null.
+ *   @object: The object.
+ *   &returns: True if null, false otherwise.
+ */
+
+static inline bool io_object_isnull(struct io_object_t object)
+{
+	return (object.ref == NULL) && (object.iface == NULL);
+}
+
+
+/*
+ * output function declarations
+ */
+
+struct io_output_t io_output_stdout();
+struct io_output_t io_output_stderr();
+
+struct io_output_t _io_output_open(const char *path);
+struct io_output_t _io_output_open_dbg(const char *path, const char *file, unsigned int line);
+struct io_output_t _io_output_append(const char *path);
+struct io_output_t _io_output_append_dbg(const char *path, const char *file, unsigned int line);
+
+size_t io_output_write(struct io_output_t output, const void *restrict buf, size_t nbytes);
+void io_output_writefull(struct io_output_t output, const void *restrict buf, size_t nbytes);
+bool io_output_ctrl(struct io_output_t output, unsigned int cmd, void *arg);
+void io_output_flush(struct io_output_t output);
+void io_output_close(struct io_output_t output);
+
+void io_output_bool(struct io_output_t output, bool value);
+void io_output_uint8(struct io_output_t output, uint8_t value);
+void io_output_uint16(struct io_output_t output, uint16_t value);
+void io_output_uint32(struct io_output_t output, uint32_t value);
+void io_output_uint64(struct io_output_t output, uint64_t value);
+void io_output_ch(struct io_output_t output, char ch);
+void io_output_str(struct io_output_t output, const char *str);
+void io_output_slice(struct io_output_t output, struct str_slice_t slice);
+void io_output_strptr(struct io_output_t output, const char *str);
+void io_output_float(struct io_output_t output, float value);
+void io_output_double(struct io_output_t output, double value);
+void io_output_varint(struct io_output_t output, uint64_t value);
+void io_output_zigzag(struct io_output_t output, int64_t value);
+void io_output_segment(struct io_output_t output, struct io_file_t file, uint64_t offset, uint64_t nbytes);
+
+/*
+ * output wrapper function declarations
+ */
+
+struct io_output_t io_output_counter(struct io_output_t output, uint64_t *nbytes);
+struct io_output_t io_output_buffer(struct io_output_t output, size_t size, enum io_buf_e mode);
+
+/*
+ * buffer definitions
+ */
+
+#define IO_OUTPUT_BUFSIZE	4096
+
+/*
+ * convenience definitions
+ */
+
+#define io_stdout io_output_stdout()
+#define io_stderr io_output_stderr()
+
+#ifdef _debug
+#	define io_output_open(path) _io_output_open_dbg(path, __FILE__, __LINE__)
+#	define io_output_append(path) _io_output_append_dbg(path, __FILE__, __LINE__)
+#else
+#	define io_output_open(path) _io_output_open(path)
+#	define io_output_append(path) _io_output_append(path)
+#endif
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_chunk_t;
+struct io_fmt_t;
+
+
+/**
+ * Print callback modifiers structure.
+ *   @zero, neg: Zero padding, and negative flag.
+ *   @width: The field width.
+ */
+
+struct io_print_mod_t {
+	bool zero, neg;
+	uint16_t width;
+};
+
+/**
+ * Printing callback funtion.
+ *   @output: The output device.
+ *   @mod: Modifiers.
+ *   @args: The variable argument list. Read only the parameter expected.
+ */
+
+typedef void (*io_print_f)(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+
+/**
+ * Printing callback structure.
+ *   @ch: The short character. Set to '\0' if unused.
+ *   @name: The long name. Set to 'NULL' if unused.
+ *   @callback: The callback function.
+ */
+
+struct io_print_t {
+	char ch;
+	const char *name;
+	uint16_t flags;
+	io_print_f callback;
+};
+
+
+/*
+ * printing function declarations
+ */
+
+void io_print_str(struct io_output_t output, const char *str);
+void io_print_slice(struct io_output_t output, struct str_slice_t slice);
+void io_print_int(struct io_output_t output, int value);
+void io_print_uint(struct io_output_t output, unsigned int value);
+void io_print_int64(struct io_output_t output, int64_t value);
+void io_print_uint64(struct io_output_t output, uint64_t value);
+void io_print_double(struct io_output_t output, double value);
+
+void io_printf(struct io_output_t output, const char *restrict format, ...);
+void io_vprintf(struct io_output_t output, const char *restrict format, va_list args);
+void io_vprintf_custom(struct io_output_t output, struct io_print_t *print, const char *format, struct arglist_t *args);
+
+struct io_fmt_t *io_fmt_new(const char *format);
+struct io_fmt_t *io_fmt_custom(struct io_print_t *print, const char *format);
+void io_fmt_delete(struct io_fmt_t *fmt);
+
+void io_fmt_printf(struct io_output_t output, const struct io_fmt_t *fmt, ...);
+void io_fmt_vprintf(struct io_output_t output, const struct io_fmt_t *fmt, struct arglist_t *args);
+
+void io_printf_chunk(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_str(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_slice(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_int(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_uint(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_hex(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_int64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_uint64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_hex64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_binary(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_char(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_float(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+
+void io_format_chunk(struct io_output_t output, struct io_chunk_t chunk, uint16_t width, bool neg, char pad);
+void io_format_str(struct io_output_t output, const char *str, uint16_t width, bool neg, char pad);
+void io_format_slice(struct io_output_t output, struct str_slice_t slice, uint16_t width, bool neg, char pad);
+void io_format_int(struct io_output_t output, int value, uint8_t base, int16_t width, bool pad);
+void io_format_uint(struct io_output_t output, unsigned int value, uint8_t base, int16_t width, bool neg, bool pad);
+void io_format_int64(struct io_output_t output, int64_t value, uint16_t width, bool neg, bool pad);
+void io_format_uint64(struct io_output_t output, uint64_t value, uint8_t base, uint16_t width, bool neg, bool pad);
+
+/*
+ * conversion function declarations
+ */
+
+size_t io_conv_uint32(char *buf, uint32_t value);
+size_t io_conv_uint64(char *buf, uint64_t value);
+size_t io_conv_int32(char *buf, int32_t value);
+size_t io_conv_int64(char *buf, int64_t value);
+size_t io_conv_hex64(char *buf, uint64_t value);
+size_t io_conv_double(char *buf, double value);
+
+/*
+ * conversion definitions
+ */
+
+#define IO_CONV_MAX	32
+
+/*
+ * convenience defintions
+ */
+
+#define printf(...) io_printf(io_stdout, __VA_ARGS__)
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_input_t;
+struct io_reader_t;
+
+
+/**
+ * Load callback function.
+ *   @reader: The reader.
+ *   &returns: The reference.
+ */
+
+typedef void *(*io_load_f)(struct io_reader_t *reader, void *arg);
+
+
+/*
+ * reader function declarations
+ */
+
+struct io_reader_t *io_reader_new(struct io_input_t input, enum io_serial_e serial);
+void io_reader_delete(struct io_reader_t *reader);
+
+struct io_input_t io_reader_input(struct io_reader_t *reader);
+
+void *io_reader_load(struct io_reader_t *reader, io_load_f load, void *arg);
+
+void io_reader_scope_begin(struct io_reader_t *reader);
+void io_reader_scope_end(struct io_reader_t *reader);
+
+bool io_reader_bool(struct io_reader_t *reader);
+uint64_t io_reader_uint64(struct io_reader_t *reader);
+int64_t io_reader_int64(struct io_reader_t *reader);
+double io_reader_double(struct io_reader_t *reader);
+char *io_reader_str(struct io_reader_t *reader);
+
+
+/*
+ * scan function declarations
+ */
+
+char *io_scan_str(struct io_input_t input);
+
+unsigned long io_scan_ulong(struct io_input_t input, char *ch);
+double io_scan_double(struct io_input_t input, char *ch);
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+struct io_writer_t;
+
+
+/**
+ * Save callback function.
+ *   @ref: The reference.
+ *   @writer: The writer.
+ */
+
+typedef void (*io_save_f)(void *ref, struct io_writer_t *writer, void *arg);
+
+
+/*
+ * writer function declarations
+ */
+
+struct io_writer_t *io_writer_new(struct io_output_t output, enum io_serial_e serial);
+void io_writer_delete(struct io_writer_t *writer);
+
+struct io_output_t io_writer_output(struct io_writer_t *writer);
+
+void io_writer_save(struct io_writer_t *writer, void *ref, io_save_f save, void *arg);
+
+void io_writer_scope_begin(struct io_writer_t *writer);
+void io_writer_scope_end(struct io_writer_t *writer);
+
+void io_writer_bool(struct io_writer_t *writer, bool value);
+void io_writer_uint64(struct io_writer_t *writer, uint64_t value);
+void io_writer_int64(struct io_writer_t *writer, int64_t value);
+void io_writer_double(struct io_writer_t *writer, double value);
+void io_writer_str(struct io_writer_t *writer, const char *str);
+
+
+/*
+ * environment function declarations
+ */
+
+const char *os_env_get(const char *id);
+
+
+/**
+ * Path enumerator.
+ *   @os_path_lib_e: The library directory.
+ *   @os_path_share_e: The shared resource directory.
+ *   @os_path_user_config_e: The user configuration directory.
+ */
+
+enum os_path_e {
+	os_path_lib_e,
+	os_path_share_e,
+	os_path_user_config_e
+};
+
+
+/*
+ * operating system path function declarations
+ */
+
+struct io_chunk_t os_path_chunk(enum os_path_e id);
+
+
+/*
+ * base string function declarations
+ */
+
+size_t str_len(const char *str);
+
+void str_copy(char *restrict dest, const char *restrict src);
+size_t str_ncopy(char *restrict dest, const char *restrict src, size_t nbytes);
+
+bool str_isequal(const char *s1, const char *s2);
+bool str_isequali(const char *s1, const char *s2);
+bool str_isprefix(const char *str, const char *prefix);
+int str_cmp(const char *s1, const char *s2);
+
+char *str_chr(const char *str, char ch);
+char *str_rchr(const char *str, char ch);
+char *str_str(const char *str, char *sub);
+char *str_pbrk(const char *str, const char *set);
+
+void str_cat(char **restrict base, const char *restrict str);
+char *str_dup(const char *str);
+char *str_ndup(const char *str, size_t n);
+char *str_clone(const char *str);
+void str_set(char **dest, char *src);
+void str_replace(char **dest, const char *src);
+
+void str_rtrim(char **str);
+char *str_ltrimptr(const char *str);
+
+void str_longest(char *str, const char *sub);
+
+
+/*
+ * structure prototypes
+ */
+
+struct str_intern_t;
+
+/*
+ * string intern function declarations
+ */
+
+struct str_intern_t *str_intern_new();
+void str_intern_delete(struct str_intern_t *pool);
+
+const char *str_intern_add(struct str_intern_t *pool, struct str_slice_t slice);
+const char *str_intern_find(struct str_intern_t *pool, struct str_slice_t slice);
+size_t str_intern_count(struct str_intern_t *pool);
+
+const char *str_intern(const char *str);
+const char *str_intern_slice(struct str_slice_t slice);
+const char *str_intern_lookup(struct str_slice_t slice);
+
+
+/*
+ * string output function declarations
+ */
+
+struct io_output_t str_output_buf(char *buf, size_t nbytes, size_t *nread);
+struct io_output_t str_output_len(size_t *len);
+struct io_output_t str_output_accum(char **buf, size_t *nread);
+
+struct io_input_t str_input_buf(const char *buf);
+struct io_input_t str_input_ref(const char **ref);
+
+/*
+ * string formatted printing funtcion declarations
+ */
+
+void str_printf(char *buf, const char *restrict format, ...);
+void str_vprintf(char *buf, const char *restrict format, va_list args);
+
+size_t str_nprintf(char *buf, size_t nbytes, const char *restrict format, ...);
+size_t str_vnprintf(char *buf, size_t nbytes, const char *restrict format, va_list args);
+
+size_t str_lprintf(const char *restrict format, ...);
+size_t str_vlprintf(const char *restrict format, va_list args);
+
+char *str_aprintf(const char *restrict format, ...);
+char *str_vaprintf(const char *restrict format, va_list args);
+
+
+/*
+ * locale function declarations
+ */
+
+bool str_isdigit(char ch);
+bool str_isspace(char ch);
+bool str_isalpha(char ch);
+bool str_isalnum(char ch);
+
+
+/*
+ * string scanning function declarations
+ */
+
+int8_t str_getdigit(char ch);
+
+unsigned int str_parse_uint(const char *str);
+double str_parse_double(const char *str);
+
+unsigned long str_toulong(const char *str, char **endptr);
+double str_todouble(const char *str, char **endptr);
+bool str_endchk(const char *str);
+
+size_t str_scan_uint64(const char *buf, size_t len, uint64_t *val, bool *ovf);
+size_t str_scan_double(const char *buf, size_t len, double *val, bool *ovf);
+
+
+/*
+ * string slice function declarations
+ */
+
+struct str_slice_t str_slice_from(const char *str);
+struct str_slice_t str_slice_sub(struct str_slice_t slice, size_t off, size_t len);
+char *str_slice_dup(struct str_slice_t slice);
+
+bool str_slice_isequal(struct str_slice_t s1, struct str_slice_t s2);
+bool str_slice_isequali(struct str_slice_t s1, struct str_slice_t s2);
+bool str_slice_isprefix(struct str_slice_t slice, struct str_slice_t prefix);
+bool str_slice_issuffix(struct str_slice_t slice, struct str_slice_t suffix);
+int str_slice_cmp(struct str_slice_t s1, struct str_slice_t s2);
+
+const char *str_slice_chr(struct str_slice_t slice, char ch);
+const char *str_slice_rchr(struct str_slice_t slice, char ch);
+const char *str_slice_find(struct str_slice_t slice, struct str_slice_t sub);
+const char *str_slice_pbrk(struct str_slice_t slice, const char *set);
+
+bool str_slice_split(struct str_slice_t slice, char delim, struct str_slice_t *head, struct str_slice_t *tail);
+
+struct str_slice_t str_slice_ltrim(struct str_slice_t slice);
+struct str_slice_t str_slice_rtrim(struct str_slice_t slice);
+struct str_slice_t str_slice_trim(struct str_slice_t slice);
+
+
+/**
+ * Create a slice from a pointer and length.
+ *   @ptr: The pointer.
+ *   @len: The length.
+ *   &returns: The slice.
+ */
+
+static inline struct str_slice_t str_slice(const char *ptr, size_t len)
+{
+	return (struct str_slice_t){ ptr, len };
+}
+
+/**
+ * Retrieve the end of a slice.
+ *   @slice: The slice.
+ *   &returns: Pointer just past the last character.
+ */
+
+static inline const char *str_slice_end(struct str_slice_t slice)
+{
+	return slice.ptr + slice.len;
+}
+
+
+/*
+ * structure prototypes
+ */
+
+struct sys_dynlib_t;
+
+/*
+ * dynamic library variables
+ */
+
+extern const char sys_dynlib_ext[];
+
+/*
+ * dynamic library function declarations
+ */
+
+struct sys_dynlib_t *sys_dynlib_open(const char *path);
+void sys_dynlib_close(struct sys_dynlib_t *dynlib);
+void *sys_dynlib_symbol(struct sys_dynlib_t *dynlib, const char *restrict name);
+
+
+/*
+ * process function declarations
+ */
+
+_noreturn void sys_exit(int status);
+
+void sys_atexit(void (*func)());
+
+
+
+
+/*
+ * time function declarations
+ */
+
+int64_t sys_time();
+int64_t sys_utime();
+uint64_t sys_monotonic_ns();
+uint64_t sys_coarsetime();
+
+void sys_tsc_calibrate();
+uint64_t sys_tsc_ns(uint64_t ticks);
+uint64_t sys_tsc_hz();
+
+void sys_sleep(uint64_t sec);
+void sys_usleep(uint64_t usec);
+
+
+/**
+ * Read the processor time stamp counter. On processors without a usable
+ * counter, the monotonic clock in nanoseconds is returned instead. Use
+ * 'sys_tsc_ns' to convert tick differences to nanoseconds. The first
+ * conversion busy-waits ten milliseconds to calibrate the counter unless
+ * 'sys_tsc_calibrate' was called beforehand, typically at startup.
+ *   &returns: The number of ticks from an arbitrary point.
+ */
+
+static inline uint64_t sys_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return sys_monotonic_ns();
+#endif
+}
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_t;
+struct thread_attr_t;
+struct thread_once_t;
+
+
+/**
+ * Thread function.
+ *   @arg: The argument.
+ *   &returns: The return value.
+ */
+
+typedef void *(*thread_f)(void *arg);
+
+/**
+ * Single run function.
+ */
+
+typedef void (*thread_once_f)();
+
+/**
+ * Pool task function.
+ *   @arg: The argument.
+ */
+
+typedef void (*thread_task_f)(void *arg);
+
+/**
+ * Thread scheduling policy enumerator.
+ *   @thread_sched_inherit_e: Inherit the policy of the creating thread.
+ *   @thread_sched_other_e: Normal time sharing.
+ *   @thread_sched_batch_e: Time sharing for throughput-bound threads.
+ *   @thread_sched_idle_e: Run only when the system is otherwise idle.
+ *   @thread_sched_fifo_e: Real-time first-in, first-out.
+ *   @thread_sched_rr_e: Real-time round robin.
+ */
+
+enum thread_sched_e {
+	thread_sched_inherit_e,
+	thread_sched_other_e,
+	thread_sched_batch_e,
+	thread_sched_idle_e,
+	thread_sched_fifo_e,
+	thread_sched_rr_e
+};
+
+/**
+ * Thread attribute structure. The name, processor set, and nice values are
+ * only applied on Linux, where the batch and idle policies also fall back to
+ * the default time sharing policy elsewhere.
+ *   @stack: The stack size in bytes, zero for the default.
+ *   @name: The thread name shown by debuggers and profilers, or null.
+ *   @cpu, ncpu: The processors the thread may run on, or null for any.
+ *   @node: The NUMA node whose processors the thread may run on, or -1.
+ *   @sched: The scheduling policy.
+ *   @priority: The real-time priority, or the nice value for the time
+ *     sharing policies.
+ */
+
+struct thread_attr_t {
+	size_t stack;
+	const char *name;
+
+	const unsigned int *cpu;
+	unsigned int ncpu;
+	int node;
+
+	enum thread_sched_e sched;
+	int priority;
+};
+
+#define THREAD_ATTR_INIT	{ 0, NULL, NULL, 0, -1, thread_sched_inherit_e, 0 }
+
+
+/*
+ * thread function declarations
+ */
+
+struct thread_t *thread_new(thread_f func, void *arg, const struct thread_attr_t *attr);
+void thread_detach(struct thread_t *thread);
+void *thread_join(struct thread_t *thread);
+
+void thread_once(struct thread_once_t *once, thread_once_f func);
+
+
+/**
+ * Hint to the processor that the caller is spinning.
+ */
+
+static inline void thread_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#else
+	__asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_cond_t;
+struct thread_mutex_t;
+
+/**
+ * Condition variable attribute structure.
+ *   @realtime: Flag indicating timed waits use the realtime clock instead of
+ *     the monotonic clock.
+ */
+
+struct thread_cond_attr_t {
+	bool realtime;
+};
+
+#define THREAD_COND_ATTR_INIT	{ false }
+
+
+/*
+ * condition variable function declarations
+ */
+
+struct thread_cond_t thread_cond_new(struct thread_cond_attr_t *attr);
+void thread_cond_delete(struct thread_cond_t *cond);
+
+void thread_cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex);
+bool thread_cond_timedwait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t utime);
+bool thread_cond_waitfor(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t usec);
+bool thread_cond_waituntil(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec);
+
+void thread_cond_signal(struct thread_cond_t *cond);
+void thread_cond_broadcast(struct thread_cond_t *cond);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_drwslot_t;
+
+/**
+ * Distributed read-write lock structure. Readers count themselves in a
+ * per-thread slot on its own cache line, so read locking without writers
+ * only reads shared state.
+ *   @writer: Zero when free, one when held by a writer, and two when held
+ *     with possible sleepers.
+ *   @nslot: The number of slots, a power of two.
+ *   @slot: The reader slots.
+ *   @mem: The allocation backing the slots.
+ */
+
+struct thread_drwlock_t {
+	unsigned int writer;
+	unsigned int nslot;
+	struct thread_drwslot_t *slot;
+	void *mem;
+};
+
+
+/*
+ * distributed read-write lock function declarations
+ */
+
+struct thread_drwlock_t thread_drwlock_new();
+void thread_drwlock_delete(struct thread_drwlock_t *lock);
+
+void thread_drwlock_rdlock(struct thread_drwlock_t *lock);
+bool thread_drwlock_tryrdlock(struct thread_drwlock_t *lock);
+void thread_drwlock_rdunlock(struct thread_drwlock_t *lock);
+
+void thread_drwlock_wrlock(struct thread_drwlock_t *lock);
+bool thread_drwlock_trywrlock(struct thread_drwlock_t *lock);
+void thread_drwlock_wrunlock(struct thread_drwlock_t *lock);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_epoch_t;
+
+
+/*
+ * epoch reclamation function declarations
+ */
+
+struct thread_epoch_t *thread_epoch_new();
+void thread_epoch_delete(struct thread_epoch_t *epoch);
+
+void thread_epoch_enter(struct thread_epoch_t *epoch);
+void thread_epoch_exit(struct thread_epoch_t *epoch);
+
+void thread_epoch_defer(struct thread_epoch_t *epoch, void *ref, void (*delete)(void *));
+void thread_epoch_synchronize(struct thread_epoch_t *epoch);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_future_t;
+struct thread_pool_t;
+
+
+/**
+ * Future continuation function.
+ *   @future: The completed future.
+ *   @arg: The argument.
+ */
+
+typedef void (*thread_future_f)(struct thread_future_t *future, void *arg);
+
+
+/*
+ * future function declarations
+ */
+
+struct thread_future_t *thread_future_new();
+struct thread_future_t *thread_future_async(struct thread_pool_t *pool, thread_f func, void *arg);
+struct thread_future_t *thread_future_ref(struct thread_future_t *future);
+void thread_future_delete(struct thread_future_t *future);
+
+void thread_future_set(struct thread_future_t *future, void *value);
+void thread_future_fail(struct thread_future_t *future, const char *error);
+
+bool thread_future_isready(struct thread_future_t *future);
+void *thread_future_get(struct thread_future_t *future);
+void thread_future_wait(struct thread_future_t *future);
+bool thread_future_timedwait(struct thread_future_t *future, uint64_t utime);
+
+void thread_future_then(struct thread_future_t *future, thread_future_f func, void *arg);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_graph_t;
+struct thread_graph_node_t;
+struct thread_pool_t;
+
+
+/*
+ * task graph function declarations
+ */
+
+struct thread_graph_t *thread_graph_new(struct thread_pool_t *pool);
+void thread_graph_delete(struct thread_graph_t *graph);
+
+struct thread_graph_node_t *thread_graph_add(struct thread_graph_t *graph, thread_task_f func, void *arg);
+void thread_graph_depend(struct thread_graph_t *graph, struct thread_graph_node_t *node, struct thread_graph_node_t *dep);
+
+void thread_graph_run(struct thread_graph_t *graph);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_local_t;
+
+/*
+ * thread-local function declarations
+ */
+
+struct thread_local_t *thread_local_new(void (*destroy)(void *));
+void thread_local_delete(struct thread_local_t *local);
+
+void *thread_local_get(struct thread_local_t *local);
+void thread_local_set(struct thread_local_t *local, void *value);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_mutex_t;
+struct thread_mutex_attr_t;
+struct thread_rwlock_t;
+struct thread_rwlock_attr_t;
+
+/*
+ * mutex function declarations
+ */
+
+struct thread_mutex_t thread_mutex_new(struct thread_mutex_attr_t *attr);
+void thread_mutex_delete(struct thread_mutex_t *mutex);
+
+void thread_mutex_lock(struct thread_mutex_t *mutex);
+bool thread_mutex_trylock(struct thread_mutex_t *mutex);
+void thread_mutex_unlock(struct thread_mutex_t *mutex);
+
+struct thread_rwlock_t thread_rwlock_new(struct thread_rwlock_attr_t *attr);
+void thread_rwlock_delete(struct thread_rwlock_t *lock);
+
+void thread_rwlock_rdlock(struct thread_rwlock_t *lock);
+bool thread_rwlock_tryrdlock(struct thread_rwlock_t *lock);
+void thread_rwlock_rdunlock(struct thread_rwlock_t *lock);
+
+void thread_rwlock_wrlock(struct thread_rwlock_t *lock);
+bool thread_rwlock_trywrlock(struct thread_rwlock_t *lock);
+void thread_rwlock_wrunlock(struct thread_rwlock_t *lock);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/**
+ * Task group structure. A group counts its unfinished tasks and may be
+ * waited on as a unit.
+ *   @pending: The number of unfinished tasks.
+ */
+
+struct thread_group_t {
+	unsigned int pending;
+};
+
+#define THREAD_GROUP_INIT	{ 0 }
+
+
+/*
+ * thread pool function declarations
+ */
+
+struct thread_pool_t *thread_pool_new(unsigned int nworkers);
+void thread_pool_delete(struct thread_pool_t *pool);
+
+unsigned int thread_pool_nworkers(struct thread_pool_t *pool);
+
+void thread_pool_submit(struct thread_pool_t *pool, struct thread_group_t *group, thread_task_f func, void *arg);
+void thread_pool_wait(struct thread_pool_t *pool, struct thread_group_t *group);
+
+
+/**
+ * Sequence lock structure. The sequence is odd while a write is in
+ * progress.
+ *   @seq: The sequence.
+ */
+
+struct thread_seq_t {
+	unsigned int seq;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SEQ_INIT	{ 0 }
+
+
+/*
+ * sequence lock function declarations
+ */
+
+unsigned int _thread_seq_wait(struct thread_seq_t *lock);
+
+
+/**
+ * Begin a sequence lock read, waiting out any write in progress.
+ *   @lock: The sequence lock.
+ *   &returns: The sequence to pass to 'thread_seq_rdretry'.
+ */
+
+static inline unsigned int thread_seq_rdbegin(struct thread_seq_t *lock)
+{
+	unsigned int seq;
+
+	seq = __atomic_load_n(&lock->seq, __ATOMIC_ACQUIRE);
+
+	return (seq & 1) ? _thread_seq_wait(lock) : seq;
+}
+
+/**
+ * Finish a sequence lock read.
+ *   @lock: The sequence lock.
+ *   @seq: The sequence from 'thread_seq_rdbegin'.
+ *   &returns: True if a write intervened and the read must be retried.
+ */
+
+static inline bool thread_seq_rdretry(struct thread_seq_t *lock, unsigned int seq)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&lock->seq, __ATOMIC_RELAXED) != seq;
+}
+
+/**
+ * Lock a sequence lock for writing. Writers exclude each other.
+ *   @lock: The sequence lock.
+ */
+
+static inline void thread_seq_wrlock(struct thread_seq_t *lock)
+{
+	unsigned int seq;
+
+	do
+		seq = thread_seq_rdbegin(lock);
+	while(!__atomic_compare_exchange_n(&lock->seq, &seq, seq + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * Unlock a sequence lock after writing.
+ *   @lock: The sequence lock.
+ */
+
+static inline void thread_seq_wrunlock(struct thread_seq_t *lock)
+{
+	__atomic_store_n(&lock->seq, __atomic_load_n(&lock->seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Read plain data protected by a sequence lock, retrying until a
+ * consistent copy is obtained. The data is copied a word at a time.
+ *   @lock: The sequence lock.
+ *   @dest: The destination.
+ *   @src: The protected data, aligned to the size of a pointer.
+ *   @nbytes: The number of bytes, a multiple of the size of a pointer.
+ */
+
+static inline void thread_seq_read(struct thread_seq_t *lock, void *dest, const void *src, size_t nbytes)
+{
+	size_t i;
+	unsigned int seq;
+
+	do {
+		seq = thread_seq_rdbegin(lock);
+		for(i = 0; i < nbytes / sizeof(uintptr_t); i++)
+			((uintptr_t *)dest)[i] = __atomic_load_n((const uintptr_t *)src + i, __ATOMIC_RELAXED);
+	} while(thread_seq_rdretry(lock, seq));
+}
+
+/**
+ * Write plain data protected by a sequence lock.
+ *   @lock: The sequence lock.
+ *   @dest: The protected data, aligned to the size of a pointer.
+ *   @src: The source.
+ *   @nbytes: The number of bytes, a multiple of the size of a pointer.
+ */
+
+static inline void thread_seq_write(struct thread_seq_t *lock, void *dest, const void *src, size_t nbytes)
+{
+	size_t i;
+
+	thread_seq_wrlock(lock);
+
+	for(i = 0; i < nbytes / sizeof(uintptr_t); i++)
+		__atomic_store_n((uintptr_t *)dest + i, ((const uintptr_t *)src)[i], __ATOMIC_RELAXED);
+
+	thread_seq_wrunlock(lock);
+}
+
+
+/**
+ * Spinlock structure.
+ *   @lock: Nonzero when held.
+ */
+
+struct thread_spin_t {
+	unsigned int lock;
+};
+
+/**
+ * Adaptive mutex structure. The state is zero when unlocked, one when locked
+ * and two when locked with possible sleepers.
+ *   @state: The state.
+ *   @spin: The running estimate of useful spins.
+ */
+
+struct thread_fmutex_t {
+	unsigned int state;
+	unsigned int spin;
+};
+
+/**
+ * Ticket lock structure.
+ *   @next: The next ticket to hand out.
+ *   @serve: The ticket being served.
+ */
+
+struct thread_ticket_t {
+	unsigned int next;
+	unsigned int serve;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SPIN_INIT	{ 0 }
+#define THREAD_FMUTEX_INIT	{ 0, 0 }
+#define THREAD_TICKET_INIT	{ 0, 0 }
+
+
+/*
+ * spin function declarations
+ */
+
+void _thread_spin_slow(struct thread_spin_t *spin);
+void _thread_fmutex_slow(struct thread_fmutex_t *mutex);
+void _thread_fmutex_wake(struct thread_fmutex_t *mutex);
+void _thread_ticket_slow(struct thread_ticket_t *ticket, unsigned int mine);
+
+
+/**
+ * Lock a spinlock. Waiters spin on a plain load with exponential backoff,
+ * and yield the processor once the backoff is exhausted.
+ *   @spin: The spinlock.
+ */
+
+static inline void thread_spin_lock(struct thread_spin_t *spin)
+{
+	if(__atomic_exchange_n(&spin->lock, 1, __ATOMIC_ACQUIRE) != 0)
+		_thread_spin_slow(spin);
+}
+
+/**
+ * Try to lock a spinlock.
+ *   @spin: The spinlock.
+ *   &returns: True if locked, false if already held.
+ */
+
+static inline bool thread_spin_trylock(struct thread_spin_t *spin)
+{
+	return (__atomic_load_n(&spin->lock, __ATOMIC_RELAXED) == 0) && (__atomic_exchange_n(&spin->lock, 1, __ATOMIC_ACQUIRE) == 0);
+}
+
+/**
+ * Unlock a spinlock.
+ *   @spin: The spinlock.
+ */
+
+static inline void thread_spin_unlock(struct thread_spin_t *spin)
+{
+	__atomic_store_n(&spin->lock, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Lock an adaptive mutex. Contended lockers spin for a bounded, adaptively
+ * tuned time before sleeping on a futex.
+ *   @mutex: The mutex.
+ */
+
+static inline void thread_fmutex_lock(struct thread_fmutex_t *mutex)
+{
+	unsigned int expect = 0;
+
+	if(!__atomic_compare_exchange_n(&mutex->state, &expect, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		_thread_fmutex_slow(mutex);
+}
+
+/**
+ * Try to lock an adaptive mutex.
+ *   @mutex: The mutex.
+ *   &returns: True if locked, false if already held.
+ */
+
+static inline bool thread_fmutex_trylock(struct thread_fmutex_t *mutex)
+{
+	unsigned int expect = 0;
+
+	return __atomic_compare_exchange_n(&mutex->state, &expect, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Unlock an adaptive mutex, waking a sleeper if there may be one.
+ *   @mutex: The mutex.
+ */
+
+static inline void thread_fmutex_unlock(struct thread_fmutex_t *mutex)
+{
+	if(__atomic_exchange_n(&mutex->state, 0, __ATOMIC_RELEASE) == 2)
+		_thread_fmutex_wake(mutex);
+}
+
+
+/**
+ * Lock a ticket lock. Lockers are served in arrival order.
+ *   @ticket: The ticket lock.
+ */
+
+static inline void thread_ticket_lock(struct thread_ticket_t *ticket)
+{
+	unsigned int mine;
+
+	mine = __atomic_fetch_add(&ticket->next, 1, __ATOMIC_RELAXED);
+	if(__atomic_load_n(&ticket->serve, __ATOMIC_ACQUIRE) != mine)
+		_thread_ticket_slow(ticket, mine);
+}
+
+/**
+ * Try to lock a ticket lock.
+ *   @ticket: The ticket lock.
+ *   &returns: True if locked, false if held or contended.
+ */
+
+static inline bool thread_ticket_trylock(struct thread_ticket_t *ticket)
+{
+	unsigned int serve;
+
+	serve = __atomic_load_n(&ticket->serve, __ATOMIC_ACQUIRE);
+
+	return __atomic_compare_exchange_n(&ticket->next, &serve, serve + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Unlock a ticket lock, serving the next ticket.
+ *   @ticket: The ticket lock.
+ */
+
+static inline void thread_ticket_unlock(struct thread_ticket_t *ticket)
+{
+	__atomic_store_n(&ticket->serve, __atomic_load_n(&ticket->serve, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Counting semaphore structure.
+ *   @count: The count.
+ *   @waiters: The number of sleeping waiters.
+ */
+
+struct thread_sem_t {
+	unsigned int count;
+	unsigned int waiters;
+};
+
+/**
+ * Reusable barrier structure.
+ *   @count: The number of threads arrived in the current phase.
+ *   @total: The number of threads per phase.
+ *   @phase: The phase, incremented when every thread has arrived.
+ */
+
+struct thread_barrier_t {
+	unsigned int count;
+	unsigned int total;
+	unsigned int phase;
+};
+
+/**
+ * Countdown latch structure.
+ *   @count: The remaining count.
+ */
+
+struct thread_latch_t {
+	unsigned int count;
+};
+
+/**
+ * Event structure.
+ *   @state: One when set, zero otherwise.
+ *   @waiters: The number of sleeping waiters.
+ *   @manual: Flag indicating the event stays set until reset.
+ */
+
+struct thread_event_t {
+	unsigned int state;
+	unsigned int waiters;
+	bool manual;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SEM_INIT(n)	{ (n), 0 }
+#define THREAD_BARRIER_INIT(n)	{ 0, (n), 0 }
+#define THREAD_LATCH_INIT(n)	{ (n) }
+#define THREAD_EVENT_INIT(m)	{ 0, 0, (m) }
+
+
+/*
+ * semaphore function declarations
+ */
+
+struct thread_sem_t thread_sem_new(unsigned int count);
+
+void thread_sem_wait(struct thread_sem_t *sem);
+bool thread_sem_trywait(struct thread_sem_t *sem);
+bool thread_sem_waitfor(struct thread_sem_t *sem, uint64_t usec);
+bool thread_sem_waituntil(struct thread_sem_t *sem, uint64_t nsec);
+void thread_sem_post(struct thread_sem_t *sem);
+
+/*
+ * barrier function declarations
+ */
+
+struct thread_barrier_t thread_barrier_new(unsigned int total);
+
+bool thread_barrier_wait(struct thread_barrier_t *barrier);
+
+/*
+ * latch function declarations
+ */
+
+struct thread_latch_t thread_latch_new(unsigned int count);
+
+void thread_latch_arrive(struct thread_latch_t *latch);
+bool thread_latch_isready(struct thread_latch_t *latch);
+void thread_latch_wait(struct thread_latch_t *latch);
+bool thread_latch_waitfor(struct thread_latch_t *latch, uint64_t usec);
+bool thread_latch_waituntil(struct thread_latch_t *latch, uint64_t nsec);
+
+/*
+ * event function declarations
+ */
+
+struct thread_event_t thread_event_new(bool manual);
+
+void thread_event_set(struct thread_event_t *event);
+void thread_event_reset(struct thread_event_t *event);
+void thread_event_wait(struct thread_event_t *event);
+bool thread_event_trywait(struct thread_event_t *event);
+bool thread_event_waitfor(struct thread_event_t *event, uint64_t usec);
+bool thread_event_waituntil(struct thread_event_t *event, uint64_t nsec);
+
+
+/**
+ * Comparison callback between a node and a key.
+ *   @key: The input key.
+ *   @node: The compared-to node.
+ *   @arg: The callback argument.
+ *   &returns: An integer representing their order.
+ */
+
+typedef int (*avltree_compare_nodekey_f)(const void *key, const struct avltree_node_t *node, void *arg);
+
+/**
+ * Comparison callback between two nodes.
+ *   @n1: The first node.
+ *   @n2: The seconde node.
+ *   @arg: The callback argument.
+ *   &returns: An integer representing their order.
+ */
+
+typedef int (*avltree_compare_nodenode_f)(const struct avltree_node_t *n1, const struct avltree_node_t *n2, void *arg);
+
+/**
+ * Deletion callback for a node.
+ *   @node: The current node.
+ *   @arg: The callback argument.
+ */
+
+typedef void (*avltree_delete_node_f)(struct avltree_node_t *node, void *arg);
+
+
+/**
+ * Iteration callback function on references.
+ *   @ref: The reference.
+ *   @arg: A user-specified argument.
+ *   &returns: Non-zero to halt iteration, zero to continue.
+ */
+
+typedef short (*avltree_iterate_f)(void *ref, void *arg);
+
+/**
+ * Iteration callbcak function on keys.
+ *   @ref: The reference.
+ *   @arg: A user-specified argument.
+ *   &returns: Non-zero to halt iteration, zero to continue.
+ */
+
+typedef short (*avltree_iterate_key_f)(const void *key, void *arg);
+
+/**
+ * Iteration callbcak function on reference structures.
+ *   @ref: The reference.
+ *   @arg: A user-specified argument.
+ *   &returns: Non-zero to halt iteration, zero to continue.
+ */
+
+typedef short (*avltree_iterate_ref_f)(struct avltree_inst_t *ref, void *arg);
+
+
+/*
+ * avl tree node function declarations
+ */
+
+struct avltree_root_t avltree_root_empty();
+
+struct avltree_node_t *avltree_root_first(struct avltree_root_t *root);
+struct avltree_node_t *avltree_root_last(struct avltree_root_t *root);
+
+struct avltree_node_t *avltree_node_first(struct avltree_node_t *node);
+struct avltree_node_t *avltree_node_last(struct avltree_node_t *node);
+struct avltree_node_t *avltree_node_prev(struct avltree_node_t *node);
+struct avltree_node_t *avltree_node_next(struct avltree_node_t *node);
+
+struct avltree_node_t *avltree_node_lookup(struct avltree_node_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+struct avltree_node_t *avltree_node_nearby(struct avltree_node_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+struct avltree_node_t *avltree_node_atleast(struct avltree_node_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+struct avltree_node_t *avltree_node_atmost(struct avltree_node_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+
+void avltree_node_insert(struct avltree_node_t **root, struct avltree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+struct avltree_node_t *avltree_node_remove(struct avltree_node_t **root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+void avltree_node_clear(struct avltree_node_t *root, avltree_delete_node_f delete, void *arg);
+
+struct avltree_iter_t avltree_node_iter_blank();
+struct avltree_iter_t avltree_node_iter_begin(struct avltree_node_t *root);
+struct avltree_node_t *avltree_node_iter_prev(struct avltree_iter_t *iter);
+struct avltree_node_t *avltree_node_iter_next(struct avltree_iter_t *iter);
+struct avltree_node_t *avltree_node_iter_next_depth(struct avltree_iter_t *iter);
+
+/*
+ * avl tree function declarations
+ */
+
+void avltree_init(struct avltree_t *tree, compare_f compare, delete_f delete);
+struct avltree_t avltree_empty(compare_f compare, delete_f delete);
+struct avltree_t *avltree_new(compare_f compare, delete_f delete);
+void avltree_destroy(struct avltree_t *tree);
+void avltree_delete(struct avltree_t *tree);
+
+void *avltree_first(struct avltree_t *tree);
+void *avltree_last(struct avltree_t *tree);
+
+void *avltree_lookup(const struct avltree_t *tree, const void *key);
+void *avltree_nearby(const struct avltree_t *tree, const void *key);
+void *avltree_atleast(const struct avltree_t *tree, const void *key);
+void *avltree_atmost(const struct avltree_t *tree, const void *key);
+
+void avltree_insert(struct avltree_t *tree, const void *key, void *ref);
+void avltree_insert_ref(struct avltree_t *tree, void *ref);
+void *avltree_remove(struct avltree_t *tree, const void *key);
+void avltree_purge(struct avltree_t *tree, const void *key);
+
+void avltree_merge(struct avltree_t *dest, struct avltree_t *src);
+void avltree_clear(struct avltree_t *tree);
+
+struct avltree_iter_t avltree_iter(const struct avltree_t *tree);
+struct avltree_iter_t avltree_iter_blank();
+struct avltree_iter_t avltree_iter_begin(const struct avltree_t *tree);
+void avltree_iter_init(struct avltree_iter_t *iter, const struct avltree_t *tree);
+void *avltree_iter_prev(struct avltree_iter_t *iter);
+void *avltree_iter_next(struct avltree_iter_t *iter);
+void *avltree_iter_next_key(struct avltree_iter_t *iter);
+struct avltree_inst_t *avltree_iter_next_ref(struct avltree_iter_t *iter);
+
+struct iter_t avltree_iter_new(const struct avltree_t *tree);
+struct iter_t avltree_iter_keys_new(const struct avltree_t *tree);
+struct iter_t avltree_iter_refs_new(const struct avltree_t *tree);
+
+struct iter_t avltree_asiter(struct avltree_t *tree);
+
+void avltree_iterate(const struct avltree_t *tree, avltree_iterate_f func, void *arg);
+void avltree_iterate_keys(const struct avltree_t *tree, avltree_iterate_key_f func, void *arg);
+void avltree_iterate_refs(const struct avltree_t *tree, avltree_iterate_ref_f func, void *arg);
+
+/*
+ * avl tree instance function declarations
+ */
+
+struct avltree_inst_t *avltree_inst_first(struct avltree_t *tree);
+struct avltree_inst_t *avltree_inst_last(struct avltree_t *tree);
+struct avltree_inst_t *avltree_inst_prev(struct avltree_inst_t *inst);
+struct avltree_inst_t *avltree_inst_next(struct avltree_inst_t *inst);
+
+struct avltree_inst_t *avltree_inst_atleast(const struct avltree_t *tree, const void *key);
+struct avltree_inst_t *avltree_inst_atmost(const struct avltree_t *tree, const void *key);
+
+
+/*
+ * avl index tree node function declarations
+ */
+
+struct avlitree_root_t avlitree_root_empty();
+
+struct avlitree_node_t *avlitree_root_first(struct avlitree_root_t *root);
+struct avlitree_node_t *avlitree_root_last(struct avlitree_root_t *root);
+struct avlitree_node_t *avlitree_root_get(struct avlitree_root_t *root, unsigned int index);
+
+void avlitree_root_insert(struct avlitree_root_t *root, unsigned int index, struct avlitree_node_t *node);
+struct avlitree_node_t *avlitree_root_slice(struct avlitree_root_t *root, unsigned int index);
+struct avlitree_node_t *avlitree_root_set(struct avlitree_root_t *root, unsigned int index, struct avlitree_node_t *node);
+
+struct avlitree_node_t *avlitree_node_prev(struct avlitree_node_t *node);
+struct avlitree_node_t *avlitree_node_next(struct avlitree_node_t *node);
+
+struct avlitree_node_t *avlitree_node_first(struct avlitree_node_t *root);
+struct avlitree_node_t *avlitree_node_last(struct avlitree_node_t *root);
+struct avlitree_node_t *avlitree_node_get(struct avlitree_node_t *root, unsigned int index);
+struct avlitree_node_t *avlitree_node_set(struct avlitree_node_t **root, unsigned int index, struct avlitree_node_t *node);
+unsigned int avlitree_node_index(struct avlitree_node_t *node);
+
+void avlitree_node_insert(struct avlitree_node_t **root, unsigned int index, struct avlitree_node_t *node);
+struct avlitree_node_t *avlitree_node_slice(struct avlitree_node_t **root, unsigned int index);
+void avlitree_node_clear(struct avlitree_node_t *root, avlitree_delete_node_f delete, void *arg);
+
+struct avlitree_iter_t avlitree_node_iter_new(struct avlitree_node_t *root);
+struct avlitree_node_t *avlitree_node_iter_next(struct avlitree_iter_t *iter);
+
+/**
+ * avl index tree function declarations
+ */
+
+void avlitree_init(struct avlitree_t *tree, delete_f delete);
+struct avlitree_t avlitree_empty(delete_f delete);
+struct avlitree_t *avlitree_new(delete_f delete);
+void avlitree_destroy(struct avlitree_t *tree);
+void avlitree_delete(struct avlitree_t *tree);
+
+void *avlitree_get(const struct avlitree_t *tree, unsigned int index);
+void *avlitree_set(struct avlitree_t *tree, unsigned int index, void *ref);
+void *avlitree_set(struct avlitree_t *tree, unsigned int index, void *ref);
+
+void avlitree_insert(struct avlitree_t *tree, unsigned int index, void *ref);
+void *avlitree_slice(struct avlitree_t *tree, unsigned int index);
+void avlitree_erase(struct avlitree_t *tree, unsigned int index);
+void avlitree_clear(struct avlitree_t *tree);
+
+void avlitree_append(struct avlitree_t *tree, void *ref);
+void avlitree_prepend(struct avlitree_t *tree, void *ref);
+
+struct avlitree_iter_t avlitree_iter_begin(const struct avlitree_t *tree);
+void *avlitree_iter_next(struct avlitree_iter_t *iter);
+struct avlitree_ref_t *avlitree_iter_next_ref(struct avlitree_iter_t *iter);
+
+struct iter_t avlitree_valiter_new(const struct avlitree_t *tree);
+struct iter_t avlitree_refiter_new(const struct avlitree_t *tree);
+
+
+/**
+ * AVL joint tree definitions.
+ *   @AVLJTREE_MAX_HEIGHT: The maximum height of an AVL tree.
+ *   @AVLJTREE_NODE_INIT: An inline structure to initialize a node.
+ */
+
+#define AVLJTREE_MAX_HEIGHT	AVLTREE_MAX_HEIGHT
+#define AVLJTREE_NODE_INIT	(struct avljtree_node_t){ AVLTREE_NODE_INIT, AVLITREE_NODE_INIT }
+
+
+/*
+ * structure prototypes
+ */
+
+struct avljtree_t;
+struct avljtree_node_t;
+struct avljtree_ref_t;
+struct avljtree_iter_t;
+
+
+/**
+ * Deletion callback for a node.
+ *   @node: The current node.
+ *   @arg: The callback argument.
+ */
+
+typedef void (*avljtree_delete_node_f)(struct avljtree_node_t *node, void *arg);
+
+
+/**
+ * AVL joint tree structure.
+ *   @keyroot: The keyed root node.
+ *   @idxroot: The indexeded root node.
+ *   @count: The number of nodes.
+ *   @compare: The comparison function.
+ *   @delete: The value deletion function.
+ */
+
+struct avljtree_t {
+	struct avljtree_node_t *keyroot;
+	struct avljtree_node_t *idxroot;
+
+	unsigned int count;
+
+	compare_f compare;
+	delete_f delete;
+};
+
+/**
+ * AVL joint tree node storage.
+ *   @key: The key-based node.
+ *   @index: The index-based node.
+ */
+
+struct avljtree_node_t {
+	struct avltree_node_t key;
+	struct avlitree_node_t index;
+};
+
+/**
+ * AVL joint tree root structure.
+ *   @bykey, byidx: By key and index.
+ */
+
+struct avljtree_root_t {
+	struct avljtree_node_t *bykey, *byidx;
+};
+
+/**
+ * AVL joint tree reference storage.
+ *   @key: The key reference.
+ *   @ref: The value reference.
+ *   @node: The node.
+ */
+
+struct avljtree_ref_t {
+	const void *key;
+	void *ref;
+
+	struct avljtree_node_t node;
+};
+
+/**
+ * AVL joint tree key iterator.
+ *   @keyiter: The base AVL tree iterator.
+ */
+
+struct avljtree_keyiter_t {
+	struct avltree_iter_t keyiter;
+};
+
+/**
+ * AVL joint tree index iterator.
+ *   @keyiter: The base AVL index tree iterator.
+ */
+
+struct avljtree_idxiter_t {
+	struct avlitree_iter_t idxiter;
+};
+
+
+/*
+ * avl joint tree root function declarations
+ */
+
+struct avljtree_root_t avljtree_root_empty();
+
+struct avljtree_node_t *avljtree_root_idxfirst(struct avljtree_root_t *root);
+struct avljtree_node_t *avljtree_root_idxlast(struct avljtree_root_t *root);
+
+struct avljtree_node_t *avljtree_root_get(struct avljtree_root_t *root, unsigned int index);
+
+void avljtree_root_prepend(struct avljtree_root_t *root, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+void avljtree_root_append(struct avljtree_root_t *root, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+void avljtree_root_insert(struct avljtree_root_t *root, unsigned int index, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+
+struct avljtree_node_t *avljtree_root_remove(struct avljtree_root_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+
+void avljtree_root_keyiter_init(struct avljtree_keyiter_t *iter, struct avljtree_root_t *root);
+struct avljtree_node_t *avljtree_root_keyiter_next(struct avljtree_keyiter_t *iter);
+struct avljtree_node_t *avljtree_root_keyiter_next_depth(struct avljtree_keyiter_t *iter);
+
+void avljtree_root_idxiter_init(struct avljtree_idxiter_t *iter, struct avljtree_root_t *root);
+struct avljtree_node_t *avljtree_root_idxiter_next(struct avljtree_idxiter_t *iter);
+
+/*
+ * avl joint tree node function declarations
+ */
+
+struct avljtree_node_t *avljtree_node_keyfirst(struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_keylast(struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_idxfirst(struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_idxlast(struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_lookup(struct avljtree_node_t *root, const void *key, avltree_compare_nodekey_f compare, void *arg);
+struct avljtree_node_t *avljtree_node_get(struct avljtree_node_t *root, unsigned int index);
+unsigned int avljtree_node_index(struct avljtree_node_t *node);
+
+void avljtree_node_prepend(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+void avljtree_node_append(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+void avljtree_node_insert(struct avljtree_node_t **keyroot, struct avljtree_node_t **iroot, unsigned int index, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+struct avljtree_node_t *avljtree_node_set(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, unsigned int index, struct avljtree_node_t *node, avltree_compare_nodenode_f compare, void *arg);
+struct avljtree_node_t *avljtree_node_replace(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, struct avljtree_node_t *node, const void *key, avltree_compare_nodekey_f compare_k, void *arg_k, avltree_compare_nodenode_f compare_n, void *arg_n);
+struct avljtree_node_t *avljtree_node_slice(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, unsigned int index, avltree_compare_nodenode_f compare, void *arg);
+struct avljtree_node_t *avljtree_node_remove(struct avljtree_node_t **keyroot, struct avljtree_node_t **idxroot, const void *key, avltree_compare_nodekey_f compare, void *arg);
+void avljtree_node_clear(struct avljtree_node_t *root, avljtree_delete_node_f delete, void *arg);
+
+struct avljtree_keyiter_t avljtree_node_keyiter_new(struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_keyiter_next(struct avljtree_keyiter_t *iter);
+
+void avljtree_node_idxiter_init(struct avljtree_idxiter_t *iter, struct avljtree_node_t *root);
+struct avljtree_node_t *avljtree_node_idxiter_next(struct avljtree_idxiter_t *iter);
+
+/*
+ * avl joint tree function declarations
+ */
+
+struct avljtree_t avljtree_empty(compare_f compare, delete_f delete);
+void avljtree_init(struct avljtree_t *tree, compare_f compare, delete_f delete);
+void avljtree_destroy(struct avljtree_t *tree);
+void avljtree_delete(struct avljtree_t *tree);
+
+void *avljtree_first(const struct avljtree_t *tree);
+void *avljtree_last(const struct avljtree_t *tree);
+void *avljtree_lookup(const struct avljtree_t *tree, const void *key);
+void *avljtree_get(const struct avljtree_t *tree, unsigned int index);
+unsigned int avljtree_index(const struct avljtree_t *tree, const void *key);
+
+void avljtree_insert(struct avljtree_t *tree, unsigned int index, const void *key, void *ref);
+void *avljtree_set(struct avljtree_t *tree, unsigned int index, const void *key, void *ref);
+void *avljtree_replace(struct avljtree_t *tree, const void *orig, const void *key, void *ref);
+void avljtree_displace(struct avljtree_t *tree, const void *orig, const void *key, void *ref);
+void *avljtree_slice(struct avljtree_t *tree, unsigned int index);
+void avljtree_erase(struct avljtree_t *tree, unsigned int index);
+void *avljtree_remove(struct avljtree_t *tree, const void *key);
+void avljtree_purge(struct avljtree_t *tree, const void *key);
+void avljtree_clear(struct avljtree_t *tree);
+
+void avljtree_append(struct avljtree_t *tree, const void *key, void *ref);
+void avljtree_prepend(struct avljtree_t *tree, const void *key, void *ref);
+
+struct avljtree_keyiter_t avljtree_keyiter_begin(const struct avljtree_t *tree);
+void *avljtree_keyiter_next(struct avljtree_keyiter_t *iter);
+void *avljtree_keyiter_next_key(struct avljtree_keyiter_t *iter);
+struct avljtree_ref_t *avljtree_keyiter_next_ref(struct avljtree_keyiter_t *iter);
+
+struct iter_t avljtree_keyiter_vals_new(struct avljtree_t *tree);
+struct iter_t avljtree_keyiter_keys_new(struct avljtree_t *tree);
+struct iter_t avljtree_keyiter_refs_new(struct avljtree_t *tree);
+
+void avljtree_idxiter_init(struct avljtree_idxiter_t *iter, const struct avljtree_t *tree);
+void *avljtree_idxiter_next(struct avljtree_idxiter_t *iter);
+void *avljtree_idxiter_next_key(struct avljtree_idxiter_t *iter);
+struct avljtree_ref_t *avljtree_idxiter_next_ref(struct avljtree_idxiter_t *iter);
+
+struct iter_t avljtree_idxiter_vals_new(struct avljtree_t *tree);
+struct iter_t avljtree_idxiter_keys_new(struct avljtree_t *tree);
+struct iter_t avljtree_idxiter_refs_new(struct avljtree_t *tree);
+
+
+/**
+ * Cast an AVL tree node to an AVL joint tree node.
+ *   @node: The AVL tree node.
+ *   &returns: The AVL joint tree node.
+ */
+
+static inline struct avljtree_node_t *avljtree_cast_bykey(struct avltree_node_t *node)
+{
+	return (void *)node - offsetof(struct avljtree_node_t, key);
+}
+
+/**
+ * Constant cast an AVL tree node to an AVL joint tree node.
+ *   @node: The AVL tree node.
+ *   &returns: The AVL joint tree node.
+ */
+
+static inline const struct avljtree_node_t *avljtree_cast_bykey_const(const struct avltree_node_t *node)
+{
+	return (const void *)node - offsetof(struct avljtree_node_t, key);
+}
+
+/**
+ * Cast an AVL index tree node to an AVL joint tree node.
+ *   @node: The AVL index tree node.
+ *   &returns: The AVL joint tree node.
+ */
+
+static inline struct avljtree_node_t *avljtree_cast_byidx(struct avlitree_node_t *node)
+{
+	return (void *)node - offsetof(struct avljtree_node_t, index);
+}
+
+/**
+ * Constant cast an AVL index tree node to an AVL joint tree node.
+ *   @node: The AVL index tree node.
+ *   &returns: The AVL joint tree node.
+ */
+
+static inline const struct avljtree_node_t *avljtree_cast_byidx_const(const struct avlitree_node_t *node)
+{
+	return (const void *)node - offsetof(struct avljtree_node_t, index);
+}
+
+
+
+/*
+ * stock comparison function declarations
+ */
+
+int compare_str(const void *s1, const void *s2);
+int compare_ptr(const void *p1, const void *p2);
+int compare_int(const void *p1, const void *p2);
+int compare_uint(const void *p1, const void *p2);
+int compare_uint16(const void *p1, const void *p2);
+int compare_uint32(const void *p1, const void *p2);
+int compare_double(const void *p1, const void *p2);
+
+
+/*
+ * enumerator variables
+ */
+
+extern struct enum_t enum_null;
+extern struct enum_t enum_blank;
+
+/*
+ * enumerator function declarations
+ */
+
+void enum_replace(struct enum_t *dest, struct enum_t src);
+struct enum_t enum_new(void *ref, enum_f iter, delete_f delete);
+struct enum_t enum_const(struct enum_t iter);
+struct enum_t enum_arr(void **arr);
+struct enum_t enum_arrstr(const char *const *arr);
+struct enum_t enum_filter(struct enum_t inner, struct filter_t filter);
+struct enum_t enum_sort(struct enum_t inner, compare_f compare);
+struct enum_t enum_compose(struct enum_t outer, enum_f inner);
+
+
+/**
+ * Create the iterator from an enumerator.
+ *   @enumer: The enumerator.
+ *   &returns: The interator.
+ */
+
+static inline struct iter_t enum_iter(struct enum_t enumer)
+{
+	return enumer.iface->iter(enumer.ref);
+}
+
+/**
+ * Delete the enumerator.
+ *   @enumer: The enumerator.
+ */
+
+static inline void enum_delete(struct enum_t enumer)
+{
+	enumer.iface->delete(enumer.ref);
+}
+
+
+/*
+ * filter variables
+ */
+
+extern struct filter_t filter_blank;
+
+/*
+ * filter function declarations
+ */
+
+struct filter_t filter_new(filter_apply_f func, void *arg);
+
+
+/**
+ * Create the iterator from a filter.
+ *   @filter: The filter.
+ *   @in: The input.
+ *   &returns: The output reference or null.
+ */
+
+static inline void *filter_apply(struct filter_t filter, void *in)
+{
+	return filter.iface->apply(filter.ref, in);
+}
+
+/**
+ * Delete the filter.
+ *   @filter: The filter.
+ */
+
+static inline void filter_delete(struct filter_t filter)
+{
+	filter.iface->delete(filter.ref);
+}
+
+
+/**
+ * Integer structure.
+ *   @neg: Negative flag.
+ *   @len: The number of limbs.
+ *   @arr: The 64-bit limbs, least significant first.
+ */
+
+struct integer_t {
+	bool neg;
+	unsigned int len;
+
+	uint64_t arr[];
+};
+
+
+/*
+ * integer function declarations
+ */
+
+struct integer_t *integer_zero();
+struct integer_t *integer_new(int val);
+struct integer_t *integer_copy(const struct integer_t *integer);
+struct integer_t *integer_parse(const char *str, char **endptr);
+struct integer_t *integer_scan(struct io_input_t input, int16_t *cur);
+void integer_delete(struct integer_t *integer);
+
+uint8_t integer_uint8(struct integer_t *integer);
+int8_t integer_uint8chk(struct integer_t *integer);
+uint16_t integer_uint16(struct integer_t *integer);
+int8_t integer_uint16chk(struct integer_t *integer);
+uint32_t integer_uint32(struct integer_t *integer);
+int8_t integer_uint32chk(struct integer_t *integer);
+uint64_t integer_uint64(struct integer_t *integer);
+int8_t integer_uint64chk(struct integer_t *integer);
+
+void integer_add(struct integer_t **integer, const struct integer_t *val);
+void integer_add_uint(struct integer_t **integer, unsigned int val);
+void integer_add_ushort(struct integer_t **integer, unsigned short val);
+
+void integer_sub(struct integer_t **integer, const struct integer_t *val);
+
+void integer_mul(struct integer_t **integer, const struct integer_t *val);
+void integer_mul_ushort(struct integer_t **integer, unsigned short val);
+
+void integer_divmod(struct integer_t **integer, const struct integer_t *val, struct integer_t **rem);
+void integer_div(struct integer_t **integer, const struct integer_t *val);
+void integer_mod(struct integer_t **integer, const struct integer_t *val);
+unsigned short integer_div_ushort(struct integer_t **integer, unsigned short val);
+
+void integer_shl(struct integer_t **integer, unsigned int bits);
+void integer_shr(struct integer_t **integer, unsigned int bits);
+void integer_and(struct integer_t **integer, const struct integer_t *val);
+void integer_or(struct integer_t **integer, const struct integer_t *val);
+void integer_xor(struct integer_t **integer, const struct integer_t *val);
+
+int integer_cmp(const struct integer_t *left, const struct integer_t *right);
+
+void integer_print(const struct integer_t *integer, struct io_output_t output);
+struct io_chunk_t integer_chunk(const struct integer_t *integer);
+
+
+/**
+ * Test if an integer is zero.
+ *   @integer: The itneger.
+ *   &returns: True if zero, false otherwise.
+ */
+
+static inline bool integer_iszero(const struct integer_t *integer)
+{
+	return integer->len == 0;
+}
+
+
+/**
+ * Wrapper callback function.
+ *   @ref: The input reference.
+ *   @arg: The argument.
+ *   &returns: The translated reference.
+ */
+
+typedef void *(*iter_wrapper_f)(void *ref, void *arg);
+
+
+/*
+ * iterator variables
+ */
+
+extern struct iter_t iter_blank;
+
+/*
+ * iterator function declarations
+ */
+
+struct iter_t iter_new(void *ref, iter_f next, delete_f delete);
+struct iter_t iter_arr(void **arr);
+struct iter_t iter_arrstr(const char *const *arr);
+struct iter_t iter_wrapper(struct iter_t inner, iter_wrapper_f func, void *arg);
+struct iter_t iter_filter(struct iter_t iter, struct filter_t filter);
+struct iter_t iter_compose(struct iter_t outer, enum_f iter);
+
+
+/**
+ * Obtain the next iterator reference.
+ *   @iter: The iterator.
+ *   &returns: The reference. 'NULL' if at the end of the iterator.
+ */
+
+static inline void *iter_next(struct iter_t iter)
+{
+	return iter.iface->next(iter.ref);
+}
+
+/**
+ * Delete the iterator.
+ *   @iter: The iterator.
+ */
+
+static inline void iter_delete(struct iter_t iter)
+{
+	iter.iface->delete(iter.ref);
+}
+
+
+/**
+ * Linked list root structure.
+ *   @head, tail: The head and tail nodes.
+ */
+
+struct llist_root_t {
+	struct llist_node_t *head, *tail;
+};
+
+/**
+ * Linked list node structure.
+ *   @prev, next: The previous and next nodes.
+ */
+
+struct llist_node_t {
+	struct llist_node_t *prev, *next;
+};
+
+
+/**
+ * Clear callback.
+ *   @node: The node.
+ *   @arg: The argument.
+ */
+
+typedef void (*llist_clear_f)(struct llist_node_t *node, void *arg);
+
+
+/**
+ * Linked list structure.
+ *   @root: The list root.
+ *   @len: The length.
+ *   @delete: The deletion callback.
+ */
+
+struct llist_t {
+	struct llist_root_t root;
+	unsigned int len;
+
+	delete_f delete;
+};
+
+/**
+ * Linked list instance.
+ *   @ref: The reference.
+ *   @node: The node.
+ */
+
+struct llist_inst_t {
+	void *ref;
+
+	struct llist_node_t node;
+};
+
+
+/**
+ * Linked list iterator.
+ *   @inst: The current instance.
+ */
+
+struct llist_iter_t {
+	struct llist_inst_t *inst;
+};
+
+
+/*
+ * linked list root function declarations
+ */
+
+void llist_root_init(struct llist_root_t *root);
+struct llist_root_t llist_root_empty();
+void llist_root_clear(struct llist_root_t *root, llist_clear_f clear, void *arg);
+
+void llist_root_prepend(struct llist_root_t *root, struct llist_node_t *node);
+void llist_root_append(struct llist_root_t *root, struct llist_node_t *node);
+
+void llist_root_insert_before(struct llist_root_t *root, struct llist_node_t *cur, struct llist_node_t *node);
+void llist_root_insert_after(struct llist_root_t *root, struct llist_node_t *cur, struct llist_node_t *node);
+
+void llist_root_remove(struct llist_root_t *root, struct llist_node_t *node);
+
+/*
+ * linked list function declarations
+ */
+
+struct llist_t llist_empty(delete_f delete);
+struct llist_t *llist_new(delete_f delete);
+void llist_destroy(struct llist_t *list);
+void llist_delete(struct llist_t *list);
+
+void llist_clear(struct llist_t *list);
+
+struct llist_inst_t *llist_scan(struct llist_t *list, void *ref);
+
+struct llist_inst_t *llist_prepend(struct llist_t *list, void *ref);
+struct llist_inst_t *llist_append(struct llist_t *list, void *ref);
+void llist_pull(struct llist_t *list, struct iter_t iter);;
+
+void *llist_front(struct llist_t *list);
+void *llist_front_remove(struct llist_t *list);
+void *llist_back(struct llist_t *list);
+void *llist_back_remove(struct llist_t *list);
+
+void llist_push(struct llist_t *list, void *ref);
+void *llist_pop(struct llist_t *list);
+
+struct llist_inst_t *llist_insert_before(struct llist_t *list, struct llist_inst_t *cur, void *ref);
+struct llist_inst_t *llist_insert_after(struct llist_t *list, struct llist_inst_t *cur, void *ref);
+
+struct llist_iter_t llist_iter_begin(struct llist_t *list);
+void *llist_iter_next(struct llist_iter_t *iter);
+
+struct iter_t llist_iter(struct llist_t *list);
+struct iter_t llist_asiter(struct llist_t *list);
+
+/*
+ * linked list instance function declarations
+ */
+
+struct llist_inst_t *llist_inst_front(struct llist_t *list);
+struct llist_inst_t *llist_inst_back(struct llist_t *list);
+
+struct llist_inst_t *llist_inst_prev(struct llist_inst_t *inst);
+struct llist_inst_t *llist_inst_next(struct llist_inst_t *inst);
+
+void *llist_inst_remove(struct llist_t *list, struct llist_inst_t *inst);
+void llist_inst_purge(struct llist_t *list, struct llist_inst_t *inst);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/**
+ * Parallel reduction function. It must be associative, since partial
+ * results of adjacent chunks are combined in order.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   @arg: The argument.
+ *   &returns: The combined value.
+ */
+
+typedef void *(*par_reduce_f)(void *left, void *right, void *arg);
+
+
+/*
+ * parallel pipeline function declarations
+ */
+
+struct iter_t par_map(struct thread_pool_t *pool, struct iter_t iter, iter_wrapper_f func, void *arg);
+struct iter_t par_filter(struct thread_pool_t *pool, struct iter_t iter, struct filter_t filter);
+void *par_reduce(struct thread_pool_t *pool, struct iter_t iter, par_reduce_f func, void *arg);
+
+struct enum_t par_enum_map(struct thread_pool_t *pool, struct enum_t inner, iter_wrapper_f func, void *arg);
+struct enum_t par_enum_filter(struct thread_pool_t *pool, struct enum_t inner, struct filter_t filter);
+
+
+/**
+ * Queue root structure.
+ *   @head, tail: The and tail pointers.
+ */
+
+struct queue_root_t {
+	struct queue_node_t *head, *tail;
+};
+
+/**
+ * Queue node.
+ *   @next: The next node.
+ */
+
+struct queue_node_t {
+	struct queue_node_t *next;
+};
+
+
+/**
+ * Queue structure.
+ *   @len: The length.
+ *   @root: The root.
+ *   @delete: Delete callback.
+ */
+
+struct queue_t {
+	unsigned int len;
+	struct queue_root_t root;
+
+	delete_f delete;
+};
+
+/**
+ * Queue instance.
+ *   @node: The node.
+ *   @ref: The reference.
+ */
+
+struct queue_inst_t {
+	struct queue_node_t node;
+
+	void *ref;
+};
+
+
+/**
+ * Initialize a queue root.
+ *   &returns: The root.
+ */
+
+static inline struct queue_root_t queue_root()
+{
+	return (struct queue_root_t){ NULL, NULL };
+}
+
+
+/*
+ * queue root definitions
+ */
+
+#define QUEUE_ROOT_INIT { NULL, NULL }
+
+/*
+ * queue root function declarations
+ */
+
+void queue_root_add(struct queue_root_t *root, struct queue_node_t *node);
+struct queue_node_t *queue_root_remove(struct queue_root_t *root);
+
+/*
+ * queue function declarations
+ */
+
+struct queue_t queue_empty(delete_f delete);
+void queue_destroy(struct queue_t *queue);
+
+void queue_add(struct queue_t *queue, void *ref);
+void *queue_remove(struct queue_t *queue);
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+struct snapshot_t;
+
+
+/*
+ * snapshot definitions
+ */
+
+#define SNAPSHOT_MAGIC	"shimsnap"
+#define SNAPSHOT_VERSION	1
+
+/**
+ * Snapshot encoding callback. The returned bytes must remain valid until the
+ * snapshot has been written.
+ *   @ptr: The key or reference.
+ *   @arg: The argument.
+ *   &returns: The encoded bytes.
+ */
+
+typedef struct str_slice_t (*snapshot_encode_f)(const void *ptr, void *arg);
+
+/**
+ * Snapshot comparison callback. The ordering must match the ordering of the
+ * tree the snapshot was created from.
+ *   @key: The search key.
+ *   @stored: The stored key bytes.
+ *   @arg: The argument.
+ *   &returns: The comparison of the search key against the stored key.
+ */
+
+typedef int (*snapshot_compare_f)(const void *key, struct str_slice_t stored, void *arg);
+
+/**
+ * Snapshot iterator structure.
+ *   @snap: The snapshot.
+ *   @idx: The next index.
+ */
+
+struct snapshot_iter_t {
+	const struct snapshot_t *snap;
+	size_t idx;
+};
+
+
+/*
+ * snapshot function declarations
+ */
+
+void snapshot_save_avltree(struct io_output_t output, const struct avltree_t *tree, snapshot_encode_f key, snapshot_encode_f ref, void *arg);
+void snapshot_save_avlitree(struct io_output_t output, const struct avlitree_t *tree, snapshot_encode_f ref, void *arg);
+
+struct snapshot_t *snapshot_open(const char *path);
+struct snapshot_t *snapshot_load(const void *buf, size_t nbytes);
+void snapshot_close(struct snapshot_t *snap);
+
+size_t snapshot_count(const struct snapshot_t *snap);
+struct str_slice_t snapshot_key(const struct snapshot_t *snap, size_t idx);
+struct str_slice_t snapshot_get(const struct snapshot_t *snap, size_t idx);
+
+struct str_slice_t snapshot_lookup(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+struct str_slice_t snapshot_atleast(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+struct str_slice_t snapshot_atmost(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+size_t snapshot_search(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+
+struct snapshot_iter_t snapshot_iter_begin(const struct snapshot_t *snap);
+bool snapshot_iter_next(struct snapshot_iter_t *iter, struct str_slice_t *key, struct str_slice_t *ref);
+
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/*
+ * sort function declarations
+ */
+
+void sort_stable(void **arr, size_t n, compare_f compare);
+void sort_merge(void **dest, void **left, size_t nleft, void **right, size_t nright, compare_f compare);
+void sort_par(struct thread_pool_t *pool, void **arr, size_t n, compare_f compare);
+
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+
+
+/*
+ * string buffer definitions
+ */
+
+#define STRBUF_SMALL	40
+
+/**
+ * String buffer storage.
+ *   @store: The heap storage, or null while using the inline storage.
+ *   @i, n: The current index and buffer length.
+ *   @small: The inline storage.
+ */
+
+struct strbuf_t {
+	char *store;
+	size_t i, n;
+	char small[STRBUF_SMALL];
+};
+
+
+/*
+ * string buffer function declarations
+ */
+
+void strbuf_init(struct strbuf_t *buf, size_t initlen);
+struct strbuf_t strbuf_empty(size_t initlen);
+struct strbuf_t *strbuf_new(size_t initlen);
+void strbuf_destroy(struct strbuf_t *buf);
+void strbuf_delete(struct strbuf_t *buf);
+
+void strbuf_reset(struct strbuf_t *buf);
+void strbuf_reserve(struct strbuf_t *buf, size_t nbytes);
+void strbuf_shrink(struct strbuf_t *buf);
+void strbuf_store(struct strbuf_t *buf, char ch);
+void strbuf_append(struct strbuf_t *buf, const char *restrict str);
+void strbuf_append_slice(struct strbuf_t *buf, struct str_slice_t slice);
+void strbuf_write(struct strbuf_t *buf, const void *restrict data, size_t nbytes);
+void strbuf_printf(struct strbuf_t *buf, const char *restrict format, ...);
+void strbuf_vprintf(struct strbuf_t *buf, const char *restrict format, va_list args);
+
+char *strbuf_done(struct strbuf_t *buf);
+char *strbuf_detach(struct strbuf_t *buf);
+const char *strbuf_finish(struct strbuf_t *buf);
+struct str_slice_t strbuf_slice(const struct strbuf_t *buf);
+
+struct io_output_t strbuf_output(struct strbuf_t *buf);
+
+
+/**
+ * Type enumerator.
+ *   @type_void_e: Void.
+ *   @type_int_e: Integer.
+ *   @type_uint_e: Unsigned integer.
+ *   @type_int32_e: 32-bit integer.
+ *   @type_uint32_e: 32-bit unsigned integer.
+ *   @type_ptr_e: Pointer.
+ *   @type_func_e: Function.
+ */
+
+enum type_e {
+	type_void_e,
+	type_int_e,
+	type_uint_e,
+	type_int32_e,
+	type_uint32_e,
+	type_ptr_e,
+	type_func_e,
+};
+
+/**
+ * Type union.
+ *   @id: The identifier.
+ *   @ptr: The pointer.
+ *   @func: The function.
+ */
+
+union type_u {
+	enum type_e *id;
+	struct type_ptr_t *ptr;
+	struct type_func_t *func;
+};
+
+
+/**
+ * Pointer type structure.
+ *   @id: The type identifier.
+ *   @subtype: The sub-type.
+ */
+
+struct type_ptr_t {
+	enum type_e id;
+
+	enum type_e *subtype;
+};
+
+/**
+ * Function type structure.
+ *   @id: The type identifier.
+ *   @ret, param: The return and array of parameters.
+ *   @nparam: The number of parameters.
+ */
+
+struct type_func_t {
+	enum type_e id;
+
+	enum type_e *ret, **param;
+	unsigned int nparam;
+};
+
+
+/*
+ * type function declarations
+ */
+
+enum type_e *type_copy(const enum type_e *type);
+void type_delete(enum type_e *type);
+
+bool type_isequal(enum type_e *left, enum type_e *right);
+
+void type_print(const enum type_e *type, struct io_output_t output);
+struct io_chunk_t type_chunk(const enum type_e *type);
+
+/*
+ * void type function declarations
+ */
+
+enum type_e *type_void_new();
+void type_void_delete(enum type_e *type);
+
+bool type_void_isequal(enum type_e *left, enum type_e *right);
+
+void type_void_print(const enum type_e *type, struct io_output_t output);
+struct io_chunk_t type_void_chunk(const enum type_e *type);
+
+/*
+ * native type function declarations
+ */
+
+enum type_e *type_native_new(enum type_e id);
+void type_native_delete(enum type_e *type);
+
+bool type_native_isequal(enum type_e *left, enum type_e *right);
+
+void type_native_print(const enum type_e *type, struct io_output_t output);
+struct io_chunk_t type_native_chunk(const enum type_e *type);
+
+/*
+ * pointer type function declarations
+ */
+
+struct type_ptr_t *type_ptr_new(enum type_e *subtype);
+struct type_ptr_t *type_ptr_copy(const struct type_ptr_t *type);
+void type_ptr_delete(struct type_ptr_t *type);
+
+/*
+ * function type function declarations
+ */
+
+struct type_func_t *type_func_new(enum type_e *ret, enum type_e **param, unsigned int nparam);
+struct type_func_t *type_func_copy(const struct type_func_t *type);
+void type_func_delete(struct type_func_t *type);
+
+bool type_func_isequal(struct type_func_t *left, struct type_func_t *right);
+
+void type_func_print(const struct type_func_t *type, struct io_output_t output);
+struct io_chunk_t type_func_chunk(const struct type_func_t *type);
+
+/*
+ * type helper functions
+ */
+
+bool type_isnative(enum type_e id);
+bool type_isint(enum type_e id);
+bool type_issigned(enum type_e id);
+const char *type_name(enum type_e id);
+
+
+/**
+ * Replace a destination type with the source type.
+ *   @dest: The destination type pointer.
+ *   @src; The source type.
+ */
+
+static inline void type_replace(enum type_e **dest, enum type_e *src)
+{
+	if(*dest != NULL)
+		type_delete(*dest);
+
+	*dest = src;
+}
+
+
+
+/**
+ * Value union.
+ *   @integer: Integer.
+ */
+
+union value_u {
+	struct value_t *base;
+	struct value_integer_t *integer;
+};
+
+/**
+ * Value structure.
+ *   @type: The type.
+ *   @data: The data union.
+ */
+
+struct value_t {
+	enum type_e *type;
+};
+
+
+/**
+ * Integer value.
+ *   @base: The base value.
+ *   @integer: The integer.
+ */
+
+struct value_integer_t {
+	struct value_t base;
+
+	struct integer_t *integer;
+};
+
+
+/*
+ * value function declarations
+ */
+
+struct value_t *value_copy(struct value_t *value);
+void value_delete(struct value_t *value);
+
+void value_print(const struct value_t *value, struct io_output_t output);
+void value_print_raw(const struct value_t *value, struct io_output_t output);
+struct io_chunk_t value_chunk(const struct value_t *value);
+struct io_chunk_t value_chunk_raw(const struct value_t *value);
+
+struct value_integer_t *value_integer_new(enum type_e type, struct integer_t *integer);
+struct value_integer_t *value_integer_copy(struct value_integer_t *value);
+void value_integer_delete(struct value_integer_t *value);
+
+void value_integer_print(const struct value_integer_t *value, struct io_output_t output);
+void value_integer_print_raw(const struct value_integer_t *value, struct io_output_t output);
+
+#endif
@@ -0,0 +1,362 @@
+src/app/path.o: src/app/path.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/mem/base.o: src/mem/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/mem/manage.o: src/mem/manage.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/mem/posix/manage.o: src/mem/posix/manage.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/debug/exception.o: src/debug/exception.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/debug/res.o: src/debug/res.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/debug/posix/exception.o: src/debug/posix/exception.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/fs/base.o: src/fs/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/fs/path.o: src/fs/path.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/fs/posix/base.o: src/fs/posix/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/chunk.o: src/io/chunk.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/conf.o: src/io/conf.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/device.o: src/io/device.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/file.o: src/io/file.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/filter.o: src/io/filter.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/input.o: src/io/input.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/iter.o: src/io/iter.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/object.o: src/io/object.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/output.o: src/io/output.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/print.o: src/io/print.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/reader.o: src/io/reader.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/scan.o: src/io/scan.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/writer.o: src/io/writer.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/posix/file.o: src/io/posix/file.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/posix/input.o: src/io/posix/input.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/io/posix/output.o: src/io/posix/output.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/math/algo.o: src/math/algo.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/math/rand.o: src/math/rand.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/os/env.o: src/os/env.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/os/path.o: src/os/path.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/os/posix/env.o: src/os/posix/env.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/os/posix/path.o: src/os/posix/path.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/argv.o: src/string/argv.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/base.o: src/string/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/intern.o: src/string/intern.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/io.o: src/string/io.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/locale.o: src/string/locale.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/scan.o: src/string/scan.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/string/slice.o: src/string/slice.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/lib.o: src/sys/lib.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/proc.o: src/sys/proc.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/sync.o: src/sys/sync.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/time.o: src/sys/time.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/posix/lib.o: src/sys/posix/lib.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/posix/proc.o: src/sys/posix/proc.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/posix/sync.o: src/sys/posix/sync.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/sys/posix/time.o: src/sys/posix/time.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/base.o: src/thread/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/cond.o: src/thread/cond.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/drwlock.o: src/thread/drwlock.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/epoch.o: src/thread/epoch.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/future.o: src/thread/future.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/graph.o: src/thread/graph.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/local.o: src/thread/local.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/lock.o: src/thread/lock.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/pool.o: src/thread/pool.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/seq.o: src/thread/seq.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/spin.o: src/thread/spin.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/sync.o: src/thread/sync.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/posix/base.o: src/thread/posix/base.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/posix/cond.o: src/thread/posix/cond.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/posix/local.o: src/thread/posix/local.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/posix/lock.o: src/thread/posix/lock.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/thread/posix/spin.o: src/thread/posix/spin.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/avltree.o: src/types/avltree.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/avljtree.o: src/types/avljtree.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/avlitree.o: src/types/avlitree.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/compare.o: src/types/compare.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/defs.o: src/types/defs.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/enum.o: src/types/enum.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/filter.o: src/types/filter.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/float.o: src/types/float.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/integer.o: src/types/integer.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/iter.o: src/types/iter.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/llist.o: src/types/llist.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/par.o: src/types/par.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/queue.o: src/types/queue.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/snapshot.o: src/types/snapshot.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/sort.o: src/types/sort.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/strbuf.o: src/types/strbuf.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/type.o: src/types/type.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/value.o: src/types/value.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+src/types/posix/snapshot.o: src/types/posix/snapshot.c
+	$(bmake_PRECC)
+	$(CC) -fpic -fvisibility=internal -D_FILE_OFFSET_BITS=64 $(CFLAGS) -c $< -o $@
+
+libshim.a: src/app/path.o src/mem/base.o src/mem/manage.o src/mem/posix/manage.o src/debug/exception.o src/debug/res.o src/debug/posix/exception.o src/fs/base.o src/fs/path.o src/fs/posix/base.o src/io/chunk.o src/io/conf.o src/io/device.o src/io/file.o src/io/filter.o src/io/input.o src/io/iter.o src/io/object.o src/io/output.o src/io/print.o src/io/reader.o src/io/scan.o src/io/writer.o src/io/posix/file.o src/io/posix/input.o src/io/posix/output.o src/math/algo.o src/math/rand.o src/os/env.o src/os/path.o src/os/posix/env.o src/os/posix/path.o src/string/argv.o src/string/base.o src/string/intern.o src/string/io.o src/string/locale.o src/string/scan.o src/string/slice.o src/sys/lib.o src/sys/proc.o src/sys/sync.o src/sys/time.o src/sys/posix/lib.o src/sys/posix/proc.o src/sys/posix/sync.o src/sys/posix/time.o src/thread/base.o src/thread/cond.o src/thread/drwlock.o src/thread/epoch.o src/thread/future.o src/thread/graph.o src/thread/local.o src/thread/lock.o src/thread/pool.o src/thread/seq.o src/thread/spin.o src/thread/sync.o src/thread/posix/base.o src/thread/posix/cond.o src/thread/posix/local.o src/thread/posix/lock.o src/thread/posix/spin.o src/types/avltree.o src/types/avljtree.o src/types/avlitree.o src/types/compare.o src/types/defs.o src/types/enum.o src/types/filter.o src/types/float.o src/types/integer.o src/types/iter.o src/types/llist.o src/types/par.o src/types/queue.o src/types/snapshot.o src/types/sort.o src/types/strbuf.o src/types/type.o src/types/value.o src/types/posix/snapshot.o
+	$(AR) $@ $^
+
+libshim.so.0.1.0: src/app/path.o src/mem/base.o src/mem/manage.o src/mem/posix/manage.o src/debug/exception.o src/debug/res.o src/debug/posix/exception.o src/fs/base.o src/fs/path.o src/fs/posix/base.o src/io/chunk.o src/io/conf.o src/io/device.o src/io/file.o src/io/filter.o src/io/input.o src/io/iter.o src/io/object.o src/io/output.o src/io/print.o src/io/reader.o src/io/scan.o src/io/writer.o src/io/posix/file.o src/io/posix/input.o src/io/posix/output.o src/math/algo.o src/math/rand.o src/os/env.o src/os/path.o src/os/posix/env.o src/os/posix/path.o src/string/argv.o src/string/base.o src/string/intern.o src/string/io.o src/string/locale.o src/string/scan.o src/string/slice.o src/sys/lib.o src/sys/proc.o src/sys/sync.o src/sys/time.o src/sys/posix/lib.o src/sys/posix/proc.o src/sys/posix/sync.o src/sys/posix/time.o src/thread/base.o src/thread/cond.o src/thread/drwlock.o src/thread/epoch.o src/thread/future.o src/thread/graph.o src/thread/local.o src/thread/lock.o src/thread/pool.o src/thread/seq.o src/thread/spin.o src/thread/sync.o src/thread/posix/base.o src/thread/posix/cond.o src/thread/posix/local.o src/thread/posix/lock.o src/thread/posix/spin.o src/types/avltree.o src/types/avljtree.o src/types/avlitree.o src/types/compare.o src/types/defs.o src/types/enum.o src/types/filter.o src/types/float.o src/types/integer.o src/types/iter.o src/types/llist.o src/types/par.o src/types/queue.o src/types/snapshot.o src/types/sort.o src/types/strbuf.o src/types/type.o src/types/value.o src/types/posix/snapshot.o
+	$(LD) $^ -lpthread -lrt -lm -ldl $(LDFLAGS) -shared -Wl,-soname,libshim.so.0 -o $@
+	ln -fs libshim.so.0.1.0 libshim.so.0
+	ln -fs libshim.so.0.1.0 libshim.so
+
+bmake_all: libshim.a libshim.so.0.1.0
+
+bmake_test:
+
+bmake_install: libshim.a libshim.so.0.1.0
+	install --mode 0644 -D libshim.a "/usr/local/lib/libshim.a"
+	install --mode 0755 -D libshim.so.0.1.0 "/usr/local/lib/libshim.so.0.1.0"
+	ln -fs libshim.so.0.1.0 "/usr/local/lib/libshim.so"
+	ln -fs libshim.so.0.1.0 "/usr/local/lib/libshim.so.0"
+
+bmake_clean:
+	rm -rf config.status config.log src/app/path.o src/mem/base.o src/mem/manage.o src/mem/posix/manage.o src/debug/exception.o src/debug/res.o src/debug/posix/exception.o src/fs/base.o src/fs/path.o src/fs/posix/base.o src/io/chunk.o src/io/conf.o src/io/device.o src/io/file.o src/io/filter.o src/io/input.o src/io/iter.o src/io/object.o src/io/output.o src/io/print.o src/io/reader.o src/io/scan.o src/io/writer.o src/io/posix/file.o src/io/posix/input.o src/io/posix/output.o src/math/algo.o src/math/rand.o src/os/env.o src/os/path.o src/os/posix/env.o src/os/posix/path.o src/string/argv.o src/string/base.o src/string/intern.o src/string/io.o src/string/locale.o src/string/scan.o src/string/slice.o src/sys/lib.o src/sys/proc.o src/sys/sync.o src/sys/time.o src/sys/posix/lib.o src/sys/posix/proc.o src/sys/posix/sync.o src/sys/posix/time.o src/thread/base.o src/thread/cond.o src/thread/drwlock.o src/thread/epoch.o src/thread/future.o src/thread/graph.o src/thread/local.o src/thread/lock.o src/thread/pool.o src/thread/seq.o src/thread/spin.o src/thread/sync.o src/thread/posix/base.o src/thread/posix/cond.o src/thread/posix/local.o src/thread/posix/lock.o src/thread/posix/spin.o src/types/avltree.o src/types/avljtree.o src/types/avlitree.o src/types/compare.o src/types/defs.o src/types/enum.o src/types/filter.o src/types/float.o src/types/integer.o src/types/iter.o src/types/llist.o src/types/par.o src/types/queue.o src/types/snapshot.o src/types/sort.o src/types/strbuf.o src/types/type.o src/types/value.o src/types/posix/snapshot.o libshim.a libshim.so.0.1.0 libshim.so.0 libshim.so src/app/.deps/* src/mem/.deps/* src/mem/.deps/* src/mem/posix/.deps/* src/debug/.deps/* src/debug/.deps/* src/debug/posix/.deps/* src/fs/.deps/* src/fs/.deps/* src/fs/posix/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/posix/.deps/* src/io/posix/.deps/* src/io/posix/.deps/* src/math/.deps/* src/math/.deps/* src/os/.deps/* src/os/.deps/* src/os/posix/.deps/* src/os/posix/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/posix/.deps/*
+
+bmake_dist:
+	if [ -e libshim-0.1.0 ] ; then rm -rf libshim-0.1.0 ; fi ; mkdir libshim-0.1.0
+	cp --parents configure Makefile.in $(wildcard mktests/* sources user.mk) src/common.h src/app/path.h src/app/path.c src/mem/base.h src/mem/base.c src/mem/manage.h src/mem/manage.c src/mem/posix/manage.c src/debug/exception.h src/debug/exception.c src/debug/res.h src/debug/res.c src/debug/posix/exception.c src/fs/base.h src/fs/base.c src/fs/path.h src/fs/path.c src/fs/posix/base.c src/io/defs.h src/io/chunk.h src/io/chunk.c src/io/conf.h src/io/conf.c src/io/device.h src/io/device.c src/io/file.h src/io/file.c src/io/filter.h src/io/filter.c src/io/input.h src/io/input.c src/io/iter.h src/io/iter.c src/io/object.h src/io/object.c src/io/output.h src/io/output.c src/io/print.h src/io/print.c src/io/reader.h src/io/reader.c src/io/scan.h src/io/scan.c src/io/writer.h src/io/writer.c src/io/posix/file.c src/io/posix/input.c src/io/posix/output.c src/math/float.h src/math/func.h src/math/algo.h src/math/algo.c src/math/rand.h src/math/rand.c src/os/env.h src/os/env.c src/os/path.h src/os/path.c src/os/posix/env.c src/os/posix/path.c src/string/argv.h src/string/argv.c src/string/base.h src/string/base.c src/string/intern.h src/string/intern.c src/string/io.h src/string/io.c src/string/locale.h src/string/locale.c src/string/scan.h src/string/scan.c src/string/slice.h src/string/slice.c src/sys/lib.h src/sys/lib.c src/sys/proc.h src/sys/proc.c src/sys/sync.h src/sys/sync.c src/sys/time.h src/sys/time.c src/sys/posix/lib.c src/sys/posix/proc.c src/sys/posix/sync.c src/sys/posix/time.c src/thread/base.h src/thread/base.c src/thread/cond.h src/thread/cond.c src/thread/drwlock.h src/thread/drwlock.c src/thread/epoch.h src/thread/epoch.c src/thread/future.h src/thread/future.c src/thread/graph.h src/thread/graph.c src/thread/local.h src/thread/local.c src/thread/lock.h src/thread/lock.c src/thread/pool.h src/thread/pool.c src/thread/seq.h src/thread/seq.c src/thread/spin.h src/thread/spin.c src/thread/sync.h src/thread/sync.c src/thread/posix/defs.h src/thread/posix/base.c src/thread/posix/cond.c src/thread/posix/local.c src/thread/posix/lock.h src/thread/posix/lock.c src/thread/posix/spin.c src/types/avltree.h src/types/avltree.c src/types/avljtree.h src/types/avljtree.c src/types/avlitree.h src/types/avlitree.c src/types/compare.h src/types/compare.c src/types/defs.h src/types/defs.c src/types/enum.h src/types/enum.c src/types/filter.h src/types/filter.c src/types/float.h src/types/float.c src/types/integer.h src/types/integer.c src/types/iter.h src/types/iter.c src/types/llist.h src/types/llist.c src/types/par.h src/types/par.c src/types/queue.h src/types/queue.c src/types/snapshot.h src/types/snapshot.c src/types/sort.h src/types/sort.c src/types/strbuf.h src/types/strbuf.c src/types/type.h src/types/type.c src/types/value.h src/types/value.c src/types/posix/snapshot.c libshim-0.1.0
+	tar -zcf libshim-0.1.0.tar.gz libshim-0.1.0/
+	rm -rf libshim-0.1.0
+
+sinclude src/app/.deps/* src/mem/.deps/* src/mem/.deps/* src/mem/posix/.deps/* src/debug/.deps/* src/debug/.deps/* src/debug/posix/.deps/* src/fs/.deps/* src/fs/.deps/* src/fs/posix/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/.deps/* src/io/posix/.deps/* src/io/posix/.deps/* src/io/posix/.deps/* src/math/.deps/* src/math/.deps/* src/os/.deps/* src/os/.deps/* src/os/posix/.deps/* src/os/posix/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/string/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/sys/posix/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/thread/posix/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/.deps/* src/types/posix/.deps/*
+
+.PNOHY: bmake_install bmake_clean
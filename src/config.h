@@ -0,0 +1,14 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#define BMAKE__PATH_PREFIX	"/usr/local"
+#define BMAKE__PATH_BIN		"/usr/local/bin"
+#define BMAKE__PATH_LIB		"/usr/local/lib"
+#define BMAKE__PATH_INCLUDE	"/usr/local/include"
+#define BMAKE__PATH_SHARE	"/usr/local/share"
+#define BMAKE__PATH_CONF	"/usr/local/etc"
+
+#define BMAKE__HOST		""
+
+#define _noreturn __attribute__((noreturn))
+#endif
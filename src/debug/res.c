@@ -5,6 +5,8 @@
 #include "../io/output.h"
 #include "../mem/base.h"
 #include "../string/base.h"
+#include "../string/intern.h"
+#include "../thread/lock.h"
 #include "../types/avltree.h"
 #include "../types/compare.h"
 #include "../types/compare.h"
@@ -15,7 +17,7 @@
  * Resource reference structure.
  *   @node: The tree node.
  *   @res: The resource.
- *   @file: The file.
+ *   @file: The interned file name.
  *   @line: The line.
  *   @info: Resource information.
  *   @backtrace: Backtrace information.
@@ -26,7 +28,7 @@ struct ref_t {
 
 	void *res;
 
-	char *file;
+	const char *file;
 	unsigned int line;
 
 	char *info;
@@ -44,6 +46,8 @@ void _impl_mem_free(void *ptr);
 
 void _impl_sys_atexit_init();
 
+struct io_output_t _impl_io_output_stderr(enum io_buf_e *mode);
+
 /*
  * local function declarations
  */
@@ -59,6 +63,7 @@ static int compare_node(const struct avltree_node_t *n1, const struct avltree_no
 
 static struct avltree_node_t *res_tree = NULL;
 static unsigned int res_count = 0;
+static struct thread_mutex_t res_lock = THREAD_MUTEX_INIT;
 
 static struct io_output_i info_iface = { { NULL, NULL }, (io_write_f)info_write };
 
@@ -81,8 +86,7 @@ void _dbg_res_alloc(void *res, const char *file, unsigned int line, struct io_ch
 	ref = _impl_mem_alloc(sizeof(struct ref_t));
 	ref->res = res;
 	ref->line = line;
-	ref->file = _impl_mem_alloc(str_len(file) + 1);
-	str_copy(ref->file, file);
+	ref->file = str_intern(file);
 
 	if(!io_chunk_isnull(info)) {
 		ref->info = _impl_mem_alloc(1);
@@ -92,8 +96,16 @@ void _dbg_res_alloc(void *res, const char *file, unsigned int line, struct io_ch
 	else
 		ref->info = NULL;
 
+	thread_mutex_lock(&res_lock);
+
+	if(avltree_node_lookup(res_tree, res, compare_key, NULL) != NULL) {
+		thread_mutex_unlock(&res_lock);
+		_fatal("Resource already allocated.");
+	}
+
 	res_count++;
 	avltree_node_insert(&res_tree, &ref->node, compare_node, NULL);
+	thread_mutex_unlock(&res_lock);
 }
 
 /**
@@ -108,16 +120,19 @@ void _dbg_res_free(void *res)
 
 	_impl_sys_atexit_init();
 
+	thread_mutex_lock(&res_lock);
 	ref = (struct ref_t *)avltree_node_remove(&res_tree, res, compare_key, NULL);
-	if(ref == NULL)
+	if(ref == NULL) {
+		thread_mutex_unlock(&res_lock);
 		_fatal("Invalid free.");
+	}
 
 	res_count--;
+	thread_mutex_unlock(&res_lock);
 
 	if(ref->info != NULL)
 		_impl_mem_free(ref->info);
 
-	_impl_mem_free(ref->file);
 	_impl_mem_free(ref);
 }
 
@@ -156,19 +171,25 @@ void dbg_res_dump(struct io_output_t output)
 }
 
 /**
- * Exit handler for printing unfreed resources.
+ * Exit handler for printing unfreed resources. The dump is written to the
+ * raw standard error device, since the buffered stream would lazily create
+ * tracked state while the resources are being listed.
  */
 
 void _dbg_res_atexit()
 {
+	enum io_buf_e mode;
+	struct io_output_t output;
 	unsigned int count = dbg_res_count();
 
 	if(count == 0)
 		return;
-	
-	io_printf(io_stderr, "Warning: Unfreed resources (%u).\n", count);
-	io_printf(io_stderr, "--begin dump--\n");
-	dbg_res_dump(io_stderr);
+
+	output = _impl_io_output_stderr(&mode);
+
+	io_printf(output, "Warning: Unfreed resources (%u).\n", count);
+	io_printf(output, "--begin dump--\n");
+	dbg_res_dump(output);
 }
 
 
@@ -43,6 +43,18 @@ struct arglist_t {
 	va_list args;
 };
 
+/**
+ * String slice structure. The referenced characters are borrowed and need not
+ * be null terminated.
+ *   @ptr: The first character.
+ *   @len: The length in bytes.
+ */
+
+struct str_slice_t {
+	const char *ptr;
+	size_t len;
+};
+
 /* %~shim.h% */
 
 /*
@@ -6,7 +6,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
+
+#ifdef __linux__
+#	include <linux/fs.h>
+#endif
+
 #include "../../debug/exception.h"
 #include "../../mem/manage.h"
 #include "../../io/chunk.h"
@@ -23,10 +29,18 @@
 
 #define NAMELEN 8
 
+/*
+ * implementation function declarations
+ */
+
+bool _impl_io_fdcopy(int dfd, int sfd, uint64_t *offset, uint64_t nbytes, uint64_t *total);
+
 /*
  * local function declarations
  */
 
+static bool fdcopy(int dfd, int sfd, uint64_t *total);
+
 static void tmpfill(struct io_output_t output, void *arg);
 
 static const char *lsdir_next(DIR *dir);
@@ -255,35 +269,14 @@ _export
 size_t _impl_fs_copy(const char *dest, const char *src)
 {
 	int dfd, sfd;
-	size_t total = 0;
-	ssize_t nbytes = 0, written = 0;
-	uint8_t buf[16*1024], *ptr;
+	uint64_t total = 0;
+	bool suc = false;
 
-	dfd = open(dest, O_WRONLY | O_CREAT, 0666);
+	dfd = open(dest, O_WRONLY | O_CREAT | O_TRUNC, 0666);
 	sfd = open(src, O_RDONLY);
 
-	if((dfd != -1) && (sfd != -1)) {
-		while(true) {
-			nbytes = read(sfd, buf, sizeof(buf));
-			if(nbytes <= 0)
-				break;
-
-			ptr = buf;
-			total += nbytes;
-
-			do {
-				written = write(dfd, ptr, nbytes);
-				if(written < 0)
-					break;
-
-				ptr += written;
-				nbytes -= written;
-			} while(nbytes > 0);
-
-			if(written < 0)
-				break;
-		}
-	}
+	if((dfd != -1) && (sfd != -1))
+		suc = fdcopy(dfd, sfd, &total);
 
 	if(dfd != -1)
 		close(dfd);
@@ -291,7 +284,7 @@ size_t _impl_fs_copy(const char *dest, const char *src)
 	if(sfd != -1)
 		close(sfd);
 
-	if((dfd < 0) || (sfd < 0) || (nbytes < 0) || (written < 0))
+	if(!suc)
 		throw("Failed to copy files. %s.", strerror(errno));
 
 	return total;
@@ -307,9 +300,9 @@ size_t _impl_fs_copy(const char *dest, const char *src)
 _export
 bool _impl_fs_trycopy(const char *dest, const char *src)
 {
+	bool suc;
 	int rdfd, wrfd;
-	uint8_t buf[16*1024];
-	ssize_t nbytes, written = 0;
+	uint64_t total;
 
 	rdfd = open(src, O_RDONLY);
 	wrfd = open(dest, O_WRONLY | O_CREAT | O_TRUNC, 0666);
@@ -318,33 +311,43 @@ bool _impl_fs_trycopy(const char *dest, const char *src)
 		if(rdfd >= 0)
 			close(rdfd);
 
-		if(rdfd >= 0)
-			close(rdfd);
+		if(wrfd >= 0)
+			close(wrfd);
 
 		return false;
 	}
 
-	while(true) {
-		nbytes = read(rdfd, buf, sizeof(buf));
-		if(nbytes <= 0)
-			break;
+	suc = fdcopy(wrfd, rdfd, &total);
 
-		do {
-			written = write(wrfd, buf, nbytes);
-			if(written <= 0)
-				break;
+	close(rdfd);
+	close(wrfd);
 
-			nbytes -= written;
-		} while(nbytes > 0);
+	return suc;
+}
 
-		if(written <= 0)
-			break;
-	}
+/**
+ * Copy the contents of one file descriptor into another. The destination is
+ * first cloned as a reflink where the filesystem supports it, otherwise the
+ * data is copied inside the kernel when possible.
+ *   @dfd: The destination descriptor.
+ *   @sfd: The source descriptor.
+ *   @total: Out. The number of bytes copied.
+ *   &returns: True on success, false on error with 'errno' set.
+ */
 
-	close(rdfd);
-	close(wrfd);
+static bool fdcopy(int dfd, int sfd, uint64_t *total)
+{
+#ifdef FICLONE
+	struct stat st;
+
+	if((ioctl(dfd, FICLONE, sfd) == 0) && (fstat(sfd, &st) == 0)) {
+		*total = st.st_size;
+
+		return true;
+	}
+#endif
 
-	return (nbytes >= 0) && (written >= 0);
+	return _impl_io_fdcopy(dfd, sfd, NULL, UINT64_MAX, total);
 }
 
 
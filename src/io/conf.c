@@ -2,26 +2,117 @@
 #include "conf.h"
 #include "../debug/exception.h"
 #include "../mem/manage.h"
+#include "../mem/base.h"
 #include "../string/base.h"
+#include "../string/intern.h"
 #include "../string/locale.h"
-#include "../types/avlitree.h"
-#include "../types/avltree.h"
-#include "../types/compare.h"
+#include "../string/slice.h"
 #include "input.h"
 
 
+/*
+ * local definitions
+ */
+
+#define ARENA_SIZE	16384
+#define TABLE_INIT	16
+#define ALIGN(n)	(((n) + 7) & ~(size_t)7)
+
+/**
+ * Arena block structure.
+ *   @next: The previous block.
+ *   @data: The storage.
+ */
+
+struct block_t {
+	struct block_t *next;
+	uint64_t data[];
+};
+
+/**
+ * Arena structure. Everything reachable from a configuration is allocated
+ * from the arena of its root, and released at once when the root is deleted.
+ *   @block: The current block.
+ *   @idx, size: The used and total bytes of the current block.
+ */
+
+struct arena_t {
+	struct block_t *block;
+	size_t idx, size;
+};
+
+/**
+ * Index entry structure.
+ *   @hash: The identifier hash.
+ *   @pair: The accumulated pair, or null if unused.
+ *   @merged: Merged flag, set once the pair is no longer shared with a line.
+ */
+
+struct entry_t {
+	uint64_t hash;
+	struct io_conf_pair_t *pair;
+	bool merged;
+};
+
+/**
+ * Link structure.
+ *   @ref: The reference.
+ *   @next: The next link.
+ */
+
+struct io_conf_link_t {
+	void *ref;
+	struct io_conf_link_t *next;
+};
+
 /**
- * Configuration structure.
+ * Configuration structure. Accumulated pairs are found through an open
+ * addressed hash index on the identifier.
  *   @id: The identifier.
- *   @sub: The sub-configuration.
- *   @pair: The pairs in order.
- *   @accum: The accumulated values by id.
+ *   @parent: The parent configuration.
+ *   @arena: The arena of the root.
+ *   @pair, pairtail: The pairs in order.
+ *   @sub, subtail: The sub-configurations in order.
+ *   @key, keytail: The accumulated identifiers in order of first use.
+ *   @table: The accumulated pair index.
+ *   @mask, count: The table mask and number of accumulated pairs.
  */
 
 struct io_conf_t {
-	char *id;
-	struct avlitree_t sub, pair;
-	struct avltree_t accum;
+	const char *id;
+	struct io_conf_t *parent;
+	struct arena_t *arena;
+
+	struct io_conf_link_t *pair, **pairtail;
+	struct io_conf_link_t *sub, **subtail;
+	struct io_conf_link_t *key, **keytail;
+
+	struct entry_t *table;
+	size_t mask, count;
+};
+
+/**
+ * Root configuration structure.
+ *   @conf: The configuration, placed first so both share an address.
+ *   @arena: The arena.
+ */
+
+struct root_t {
+	struct io_conf_t conf;
+	struct arena_t arena;
+};
+
+/**
+ * Parser state structure.
+ *   @input: The input.
+ *   @n: The line number.
+ *   @line: The current line, or null.
+ */
+
+struct parse_t {
+	struct io_input_t input;
+	unsigned int n;
+	char *line;
 };
 
 
@@ -29,7 +120,28 @@ struct io_conf_t {
  * local function declarations
  */
 
-static char *readstr(const char **str);
+static void conf_init(struct io_conf_t *conf, struct io_conf_t *parent, struct arena_t *arena);
+static void conf_read(struct io_conf_t *conf, struct io_input_t input);
+static void conf_parse(struct io_conf_t *conf, struct parse_t *parse);
+static void conf_pair(struct io_conf_t *conf, struct str_slice_t key, const char **ptr);
+
+static bool pair_isequal(const struct io_conf_pair_t *left, const struct io_conf_pair_t *right);
+static void pair_add(struct io_conf_pair_t *pair, struct str_slice_t value);
+static void pair_merge(struct arena_t *arena, struct entry_t *entry, struct io_conf_pair_t *pair);
+static void diff_sections(struct io_conf_t *prev, struct io_conf_t **list, size_t n, io_conf_change_f func, void *arg);
+
+static uint64_t hash(struct str_slice_t slice);
+static struct entry_t *probe(struct io_conf_t *conf, const char *id, uint64_t hash);
+static struct entry_t *find(struct io_conf_t *conf, const char *id);
+static void grow(struct io_conf_t *conf);
+static void erase(struct io_conf_t *conf, struct entry_t *entry);
+static unsigned int capacity(unsigned int n);
+
+static void *arena_alloc(struct arena_t *arena, size_t nbytes);
+static char *arena_strdup(struct arena_t *arena, struct str_slice_t slice);
+static void link_append(struct arena_t *arena, struct io_conf_link_t ***tail, void *ref);
+
+static bool readstr(const char **str, struct str_slice_t *slice);
 static bool chkend(const char **ptr);
 
 
@@ -41,29 +153,35 @@ static bool chkend(const char **ptr);
 _export
 struct io_conf_t *io_conf_new()
 {
-	struct io_conf_t *conf;
+	struct root_t *root;
 
-	conf = mem_alloc(sizeof(struct io_conf_t));
-	conf->id = NULL;
-	conf->sub = avlitree_empty((delete_f)io_conf_delete);
-	conf->pair = avlitree_empty((delete_f)io_conf_pair_delete);
-	conf->accum = avltree_empty(compare_str, (delete_f)io_conf_pair_delete);
+	root = mem_alloc(sizeof(struct root_t));
+	root->arena = (struct arena_t){ NULL, 0, 0 };
+	conf_init(&root->conf, NULL, &root->arena);
 
-	return conf;
+	return &root->conf;
 }
 
 /**
- * Delete a configuration.
+ * Delete a configuration, releasing all of its pairs, values and
+ * sub-configurations at once. Only root configurations may be deleted.
  *   @conf: The configuration.
  */
 
 _export
 void io_conf_delete(struct io_conf_t *conf)
 {
-	avlitree_destroy(&conf->sub);
-	avlitree_destroy(&conf->pair);
-	avltree_destroy(&conf->accum);
-	mem_delete(conf->id);
+	struct block_t *block;
+
+	if(conf->parent != NULL)
+		_fatal("Cannot delete a sub-configuration.");
+
+	while(conf->arena->block != NULL) {
+		block = conf->arena->block;
+		conf->arena->block = block->next;
+		mem_free(block);
+	}
+
 	mem_free(conf);
 }
 
@@ -77,53 +195,15 @@ void io_conf_delete(struct io_conf_t *conf)
 _export
 struct io_conf_t *io_conf_read(struct io_input_t input)
 {
-	unsigned int n;
-	bool term = false;
-	char *line, *key, *value;
-	const char *ptr;
-	struct io_conf_t *conf, *sub;
-	struct io_conf_pair_t *pair, *accum;
+	struct io_conf_t *conf;
 
 	conf = io_conf_new();
-	for(n = 1; ((line = io_input_line(input)) != NULL); n++) {
-		ptr = line;
-
-		key = readstr(&ptr);
-		if(key != NULL) {
-			if(str_isequal(key, "Begin")) {
-				sub = io_conf_read(input);
-				sub->id = readstr(&ptr);
-				avlitree_append(&conf->sub, sub);
-			}
-			else if(str_isequal(key, "End"))
-				term = true;
-			else {
-				pair = io_conf_pair_new(key);
-				avlitree_append(&conf->pair, pair);
-
-				accum = avltree_lookup(&conf->accum, key);
-				if(accum == NULL) {
-					accum = io_conf_pair_new(key);
-					avltree_insert(&conf->accum, accum->id, accum);
-				}
-
-				while((value = readstr(&ptr)) != NULL) {
-					io_conf_pair_add(pair, value);
-					io_conf_pair_add(accum, value);
-					mem_free(value);
-				}
-			}
-
-			if(!chkend(&ptr))
-				throw("Unexpected data at end of line %u.", n);
-
-			mem_free(key);
-		}
 
-		mem_free(line);
-
-		if(term)
-			break;
+	try
+		conf_read(conf, input);
+	catch(e) {
+		io_conf_delete(conf);
+		throw("%s", e);
 	}
 
 	return conf;
@@ -142,12 +222,111 @@ struct io_conf_t *io_conf_load(const char *path)
 	struct io_input_t input;
 
 	input = io_input_open(path);
-	conf = io_conf_read(input);
+	conf = io_conf_new();
+
+	try
+		conf_read(conf, input);
+	catch(e) {
+		io_conf_delete(conf);
+		io_input_close(input);
+		throw("%s", e);
+	}
+
 	io_input_close(input);
 
 	return conf;
 }
 
+/**
+ * Reload a configuration from a path, reporting every change against the
+ * current configuration. On success, the current configuration is deleted
+ * once all changes are reported; on failure, it is left untouched.
+ *   @conf: The current configuration.
+ *   @path: The path.
+ *   @func: The change callback.
+ *   @arg: The callback argument.
+ *   &returns: The new configuration.
+ */
+
+_export
+struct io_conf_t *io_conf_reload(struct io_conf_t *conf, const char *path, io_conf_change_f func, void *arg)
+{
+	struct io_conf_t *next;
+
+	next = io_conf_load(path);
+
+	try {
+		io_conf_diff(conf, next, func, arg);
+	}
+	catch(e) {
+		io_conf_delete(next);
+		throw("%s", e);
+	}
+
+	io_conf_delete(conf);
+
+	return next;
+}
+
+/**
+ * Report the differences between two configurations. Accumulated pairs are
+ * compared by identifier, in order of first use. Sections are matched by
+ * identifier in order; matched sections are compared recursively, while
+ * unmatched sections are reported whole.
+ *   @prev: The previous configuration.
+ *   @next: The next configuration.
+ *   @func: The change callback.
+ *   @arg: The callback argument.
+ */
+
+_export
+void io_conf_diff(struct io_conf_t *prev, struct io_conf_t *next, io_conf_change_f func, void *arg)
+{
+	size_t i, n;
+	struct io_conf_t **list;
+	struct io_conf_link_t *link;
+	struct entry_t *before, *after;
+
+	for(link = prev->key; link != NULL; link = link->next) {
+		before = find(prev, link->ref);
+		if(before == NULL)
+			continue;
+
+		after = find(next, link->ref);
+		if(after == NULL)
+			func(&(struct io_conf_change_t){ io_conf_remove_e, false, link->ref, prev, next, before->pair, NULL }, arg);
+		else if(!pair_isequal(before->pair, after->pair))
+			func(&(struct io_conf_change_t){ io_conf_modify_e, false, link->ref, prev, next, before->pair, after->pair }, arg);
+	}
+
+	for(link = next->key; link != NULL; link = link->next) {
+		after = find(next, link->ref);
+		if((after != NULL) && (find(prev, link->ref) == NULL))
+			func(&(struct io_conf_change_t){ io_conf_add_e, false, link->ref, prev, next, NULL, after->pair }, arg);
+	}
+
+	for(n = 0, link = next->sub; link != NULL; link = link->next)
+		n++;
+
+	if(n == 0) {
+		diff_sections(prev, NULL, 0, func, arg);
+		return;
+	}
+
+	list = mem_alloc(n * sizeof(struct io_conf_t *));
+	for(i = 0, link = next->sub; link != NULL; link = link->next)
+		list[i++] = link->ref;
+
+	try
+		diff_sections(prev, list, n, func, arg);
+	catch(e) {
+		mem_free(list);
+		throw("%s", e);
+	}
+
+	mem_free(list);
+}
+
 
 /**
  * Retrieve the configuration identifier.
@@ -161,6 +340,18 @@ const char *io_conf_id(struct io_conf_t *conf)
 	return conf->id;
 }
 
+/**
+ * Retrieve the parent of a sub-configuration.
+ *   @conf: The configuration.
+ *   &returns: The parent or null for the root.
+ */
+
+_export
+struct io_conf_t *io_conf_parent(struct io_conf_t *conf)
+{
+	return conf->parent;
+}
+
 /**
  * Retrieve the number of pairs accumulated by key.
  *   @conf: The configuration.
@@ -170,12 +361,13 @@ const char *io_conf_id(struct io_conf_t *conf)
 _export
 unsigned int io_conf_accum(struct io_conf_t *conf)
 {
-	return conf->accum.count;
+	return conf->count;
 }
 
 
 /**
- * Lookup a pair from a configuration.
+ * Lookup a pair from a configuration. Pairs are owned by the configuration
+ * and must not be modified.
  *   @conf: The configuration.
  *   @id: The identifier.
  *   &returns: The configuration pair.
@@ -184,7 +376,11 @@ unsigned int io_conf_accum(struct io_conf_t *conf)
 _export
 struct io_conf_pair_t *io_conf_lookup(struct io_conf_t *conf, const char *id)
 {
-	return avltree_lookup(&conf->accum, id);
+	struct entry_t *entry;
+
+	entry = find(conf, id);
+
+	return entry ? entry->pair : NULL;
 }
 
 /**
@@ -226,17 +422,31 @@ const char *const *io_conf_lookup_values(struct io_conf_t *conf, const char *id)
 }
 
 /**
- * Remove a pair from the configuration. The pair is still available through
- * iteration.
+ * Remove a pair from the configuration. The returned pair is a copy owned by
+ * the caller and must be deleted with 'io_conf_pair_delete'.
  *   @conf: The configuration.
  *   @id: The identifier.
- *   &returns: The configuration pair.
+ *   &returns: The configuration pair or null if no such key exists.
  */
 
 _export
 struct io_conf_pair_t *io_conf_remove(struct io_conf_t *conf, const char *id)
 {
-	return avltree_remove(&conf->accum, id);
+	unsigned int i;
+	struct entry_t *entry;
+	struct io_conf_pair_t *pair;
+
+	entry = find(conf, id);
+	if(entry == NULL)
+		return NULL;
+
+	pair = io_conf_pair_new(entry->pair->id);
+	for(i = 0; i < entry->pair->nvalues; i++)
+		io_conf_pair_add(pair, entry->pair->value[i]);
+
+	erase(conf, entry);
+
+	return pair;
 }
 
 /**
@@ -259,6 +469,7 @@ char *io_conf_remove_single(struct io_conf_t *conf, const char *id)
 	else if(pair->nvalues != 1)
 		throw("Too many values with key '%s'.", pair->id);
 
+	pair = io_conf_remove(conf, id);
 	value = pair->value[0];
 	pair->value[0] = NULL;
 
@@ -277,7 +488,7 @@ char *io_conf_remove_single(struct io_conf_t *conf, const char *id)
 _export
 struct io_conf_iter_t io_conf_iter_begin(struct io_conf_t *conf)
 {
-	return (struct io_conf_iter_t){ avlitree_iter_begin(&conf->pair) };
+	return (struct io_conf_iter_t){ conf->pair };
 }
 
 /**
@@ -289,7 +500,14 @@ struct io_conf_iter_t io_conf_iter_begin(struct io_conf_t *conf)
 _export
 const struct io_conf_pair_t *io_conf_iter_next(struct io_conf_iter_t *iter)
 {
-	return avlitree_iter_next(&iter->inner);
+	struct io_conf_link_t *link = iter->link;
+
+	if(link == NULL)
+		return NULL;
+
+	iter->link = link->next;
+
+	return link->ref;
 }
 
 
@@ -301,7 +519,7 @@ const struct io_conf_pair_t *io_conf_iter_next(struct io_conf_iter_t *iter)
 _export
 struct io_conf_subiter_t io_conf_subiter_begin(struct io_conf_t *conf)
 {
-	return (struct io_conf_subiter_t){ avlitree_iter_begin(&conf->sub) };
+	return (struct io_conf_subiter_t){ conf->sub };
 }
 
 /**
@@ -313,13 +531,20 @@ struct io_conf_subiter_t io_conf_subiter_begin(struct io_conf_t *conf)
 _export
 struct io_conf_t *io_conf_subiter_next(struct io_conf_subiter_t *iter)
 {
-	return avlitree_iter_next(&iter->inner);
+	struct io_conf_link_t *link = iter->link;
+
+	if(link == NULL)
+		return NULL;
+
+	iter->link = link->next;
+
+	return link->ref;
 }
 
 
 /**
  * Create an empty configuration pair.
- *   @id: The identifier.
+ *   @id: The identifier, interned in the global pool.
  *   &returns: The pair.
  */
 
@@ -329,7 +554,7 @@ struct io_conf_pair_t *io_conf_pair_new(const char *id)
 	struct io_conf_pair_t *pair;
 
 	pair = mem_alloc(sizeof(struct io_conf_pair_t));
-	pair->id = str_dup(id);
+	pair->id = str_intern(id);
 	pair->nvalues = 0;
 	pair->value = mem_alloc(sizeof(char *));
 	pair->value[0] = NULL;
@@ -351,7 +576,6 @@ void io_conf_pair_delete(struct io_conf_pair_t *pair)
 		mem_free(*value);
 
 	mem_free(pair->value);
-	mem_free(pair->id);
 	mem_free(pair);
 }
 
@@ -363,51 +587,491 @@ void io_conf_pair_delete(struct io_conf_pair_t *pair)
 
 _export
 void io_conf_pair_add(struct io_conf_pair_t *pair, const char *value)
+{
+	pair_add(pair, str_slice_from(value));
+}
+
+
+/**
+ * Initialize a configuration.
+ *   @conf: The configuration.
+ *   @parent: The parent or null.
+ *   @arena: The arena.
+ */
+
+static void conf_init(struct io_conf_t *conf, struct io_conf_t *parent, struct arena_t *arena)
+{
+	conf->id = NULL;
+	conf->parent = parent;
+	conf->arena = arena;
+	conf->pair = conf->sub = conf->key = NULL;
+	conf->pairtail = &conf->pair;
+	conf->subtail = &conf->sub;
+	conf->keytail = &conf->key;
+	conf->table = NULL;
+	conf->mask = conf->count = 0;
+}
+
+/**
+ * Read a configuration from an input, freeing the pending line on failure.
+ *   @conf: The configuration.
+ *   @input: The input.
+ */
+
+static void conf_read(struct io_conf_t *conf, struct io_input_t input)
+{
+	struct parse_t parse = { input, 0, NULL };
+
+	try
+		conf_parse(conf, &parse);
+	catch(e) {
+		if(parse.line != NULL)
+			mem_free(parse.line);
+
+		throw("%s", e);
+	}
+}
+
+/**
+ * Parse lines into a configuration until the end of the input or its
+ * section.
+ *   @conf: The configuration.
+ *   @parse: The parser state.
+ */
+
+static void conf_parse(struct io_conf_t *conf, struct parse_t *parse)
+{
+	bool term;
+	const char *ptr;
+	struct str_slice_t key, value;
+	struct io_conf_t *sub;
+
+	while((parse->line = io_input_line(parse->input)) != NULL) {
+		parse->n++;
+		ptr = parse->line;
+		term = false;
+		sub = NULL;
+
+		if(readstr(&ptr, &key)) {
+			if(str_slice_isequal(key, str_slice("Begin", 5))) {
+				sub = arena_alloc(conf->arena, sizeof(struct io_conf_t));
+				conf_init(sub, conf, conf->arena);
+				if(readstr(&ptr, &value))
+					sub->id = str_intern_slice(value);
+
+				link_append(conf->arena, &conf->subtail, sub);
+			}
+			else if(str_slice_isequal(key, str_slice("End", 3)))
+				term = true;
+			else
+				conf_pair(conf, key, &ptr);
+
+			if(!chkend(&ptr))
+				throw("Unexpected data at end of line %u.", parse->n);
+		}
+
+		mem_free(parse->line);
+		parse->line = NULL;
+
+		if(sub != NULL)
+			conf_parse(sub, parse);
+		else if(term)
+			break;
+	}
+}
+
+/**
+ * Parse the values of a line into a new pair, accumulating them by key.
+ *   @conf: The configuration.
+ *   @key: The key.
+ *   @ptr: The line pointer, advanced past the values.
+ */
+
+static void conf_pair(struct io_conf_t *conf, struct str_slice_t key, const char **ptr)
+{
+	uint64_t h;
+	unsigned int i, n;
+	const char *tmp;
+	struct str_slice_t value;
+	struct io_conf_pair_t *pair;
+	struct entry_t *entry;
+
+	tmp = *ptr;
+	for(n = 0; readstr(&tmp, &value); n++);
+
+	pair = arena_alloc(conf->arena, sizeof(struct io_conf_pair_t));
+	pair->id = str_intern_slice(key);
+	pair->nvalues = n;
+	pair->value = arena_alloc(conf->arena, (n + 1) * sizeof(char *));
+
+	for(i = 0; readstr(ptr, &value); i++)
+		pair->value[i] = arena_strdup(conf->arena, value);
+
+	pair->value[n] = NULL;
+	link_append(conf->arena, &conf->pairtail, pair);
+
+	if((2 * (conf->count + 1)) > (conf->mask + 1))
+		grow(conf);
+
+	h = hash(key);
+	entry = probe(conf, pair->id, h);
+	if(entry->pair == NULL) {
+		*entry = (struct entry_t){ h, pair, false };
+		conf->count++;
+		link_append(conf->arena, &conf->keytail, (void *)pair->id);
+	}
+	else
+		pair_merge(conf->arena, entry, pair);
+}
+
+
+/**
+ * Check if two pairs hold the same values.
+ *   @left: The left pair.
+ *   @right: The right pair.
+ *   &returns: True if equal.
+ */
+
+static bool pair_isequal(const struct io_conf_pair_t *left, const struct io_conf_pair_t *right)
+{
+	unsigned int i;
+
+	if(left->nvalues != right->nvalues)
+		return false;
+
+	for(i = 0; i < left->nvalues; i++) {
+		if(!str_isequal(left->value[i], right->value[i]))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Add a value slice to the pair.
+ *   @pair: The pair.
+ *   @value: The value.
+ */
+
+static void pair_add(struct io_conf_pair_t *pair, struct str_slice_t value)
 {
 	pair->value = mem_realloc(pair->value, (pair->nvalues + 2) * sizeof(char *));
-	pair->value[pair->nvalues++] = str_dup(value);
+	pair->value[pair->nvalues++] = str_slice_dup(value);
 	pair->value[pair->nvalues] = NULL;
 }
 
+/**
+ * Merge the values of a line pair into an accumulated pair. The first line
+ * of a key is used directly as its accumulated pair; later lines switch to
+ * a separate value array that grows by doubling. Values are shared.
+ *   @arena: The arena.
+ *   @entry: The index entry.
+ *   @pair: The line pair.
+ */
+
+static void pair_merge(struct arena_t *arena, struct entry_t *entry, struct io_conf_pair_t *pair)
+{
+	unsigned int n;
+	char **value;
+	struct io_conf_pair_t *accum = entry->pair;
+
+	n = accum->nvalues + pair->nvalues;
+	if(!entry->merged || (capacity(n) != capacity(accum->nvalues))) {
+		value = arena_alloc(arena, capacity(n) * sizeof(char *));
+		mem_copy(value, accum->value, accum->nvalues * sizeof(char *));
+
+		if(!entry->merged) {
+			accum = arena_alloc(arena, sizeof(struct io_conf_pair_t));
+			accum->id = pair->id;
+			accum->nvalues = entry->pair->nvalues;
+			entry->pair = accum;
+			entry->merged = true;
+		}
+
+		accum->value = value;
+	}
+
+	mem_copy(accum->value + accum->nvalues, pair->value, (pair->nvalues + 1) * sizeof(char *));
+	accum->nvalues = n;
+}
+
 
 /**
- * Read a single string from the line.
- *   @str: The origin string.
- *   &returns: The extracted string.
+ * Report the section differences between two configurations.
+ *   @prev: The previous configuration.
+ *   @list: The sections of the next configuration, cleared once matched.
+ *   @n: The number of next sections.
+ *   @func: The change callback.
+ *   @arg: The callback argument.
  */
 
-static char *readstr(const char **str)
+static void diff_sections(struct io_conf_t *prev, struct io_conf_t **list, size_t n, io_conf_change_f func, void *arg)
 {
-	char *val;
-	const char *ptr;
+	size_t i, j, k;
+	struct io_conf_t *sub;
+	struct io_conf_link_t *link;
 
-	if(chkend(str))
+	for(j = 0, link = prev->sub; link != NULL; link = link->next) {
+		sub = link->ref;
+
+		for(k = 0, i = 0; k < n; k++) {
+			i = (j + k) % n;
+			if((list[i] != NULL) && (list[i]->id == sub->id))
+				break;
+		}
+
+		if(k == n)
+			func(&(struct io_conf_change_t){ io_conf_remove_e, true, sub->id, sub, NULL, NULL, NULL }, arg);
+		else {
+			io_conf_diff(sub, list[i], func, arg);
+			list[i] = NULL;
+			j = i + 1;
+		}
+	}
+
+	for(i = 0; i < n; i++) {
+		if(list[i] != NULL)
+			func(&(struct io_conf_change_t){ io_conf_add_e, true, list[i]->id, NULL, list[i], NULL, NULL }, arg);
+	}
+}
+
+
+/**
+ * Hash a string slice using 64-bit FNV-1a.
+ *   @slice: The slice.
+ *   &returns: The hash.
+ */
+
+static uint64_t hash(struct str_slice_t slice)
+{
+	size_t i;
+	uint64_t h = UINT64_C(0xcbf29ce484222325);
+
+	for(i = 0; i < slice.len; i++)
+		h = (h ^ (uint8_t)slice.ptr[i]) * UINT64_C(0x100000001b3);
+
+	return h;
+}
+
+/**
+ * Probe the index for an identifier.
+ *   @conf: The configuration.
+ *   @id: The identifier.
+ *   @hash: The identifier hash.
+ *   &returns: The matching entry, or the empty entry where it belongs.
+ */
+
+static struct entry_t *probe(struct io_conf_t *conf, const char *id, uint64_t hash)
+{
+	size_t i = hash & conf->mask;
+	struct entry_t *entry;
+
+	while(true) {
+		entry = &conf->table[i];
+		if(entry->pair == NULL)
+			return entry;
+		else if((entry->hash == hash) && ((entry->pair->id == id) || str_isequal(entry->pair->id, id)))
+			return entry;
+
+		i = (i + 1) & conf->mask;
+	}
+}
+
+/**
+ * Find the index entry of an identifier.
+ *   @conf: The configuration.
+ *   @id: The identifier.
+ *   &returns: The entry or null.
+ */
+
+static struct entry_t *find(struct io_conf_t *conf, const char *id)
+{
+	struct entry_t *entry;
+
+	if(conf->table == NULL)
 		return NULL;
 
-	switch(**str) {
-	case '"':
-		ptr = ++(*str);
-		while(*ptr != '"') {
-			if(*ptr == '\0')
-				throw("Unterminated quote.");
+	entry = probe(conf, id, hash(str_slice_from(id)));
 
-			ptr++;
+	return entry->pair ? entry : NULL;
+}
+
+/**
+ * Double the size of the index, rehashing all entries. The previous table is
+ * left in the arena.
+ *   @conf: The configuration.
+ */
+
+static void grow(struct io_conf_t *conf)
+{
+	size_t i, j, n = conf->table ? 2 * (conf->mask + 1) : TABLE_INIT;
+	struct entry_t *table;
+
+	table = arena_alloc(conf->arena, n * sizeof(struct entry_t));
+	mem_zero(table, n * sizeof(struct entry_t));
+
+	if(conf->table != NULL) {
+		for(i = 0; i <= conf->mask; i++) {
+			if(conf->table[i].pair == NULL)
+				continue;
+
+			for(j = conf->table[i].hash & (n - 1); table[j].pair != NULL; j = (j + 1) & (n - 1));
+
+			table[j] = conf->table[i];
 		}
+	}
 
-		val = str_ndup(*str, ptr++ - *str);
+	conf->table = table;
+	conf->mask = n - 1;
+}
 
-		break;
+/**
+ * Erase an entry from the index, shifting back any entries displaced past
+ * it.
+ *   @conf: The configuration.
+ *   @entry: The entry.
+ */
 
-	case '\'':
-		ptr = ++(*str);
-		while(*ptr != '\'') {
-			if(*ptr == '\0')
-				throw("Unterminated quote.");
+static void erase(struct io_conf_t *conf, struct entry_t *entry)
+{
+	size_t i, j, k;
 
-			ptr++;
+	i = j = entry - conf->table;
+
+	while(true) {
+		j = (j + 1) & conf->mask;
+		if(conf->table[j].pair == NULL)
+			break;
+
+		k = conf->table[j].hash & conf->mask;
+		if((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+			continue;
+
+		conf->table[i] = conf->table[j];
+		i = j;
+	}
+
+	conf->table[i].pair = NULL;
+	conf->count--;
+}
+
+/**
+ * Compute the value array capacity of a merged pair.
+ *   @n: The number of values.
+ *   &returns: The capacity, including the terminator.
+ */
+
+static unsigned int capacity(unsigned int n)
+{
+	unsigned int cap = 4;
+
+	while(cap < (n + 1))
+		cap *= 2;
+
+	return cap;
+}
+
+
+/**
+ * Allocate memory from an arena.
+ *   @arena: The arena.
+ *   @nbytes: The number of bytes.
+ *   &returns: The memory, aligned to eight bytes.
+ */
+
+static void *arena_alloc(struct arena_t *arena, size_t nbytes)
+{
+	size_t size;
+	void *ptr;
+	struct block_t *block;
+
+	nbytes = ALIGN(nbytes);
+
+	if((arena->idx + nbytes) > arena->size) {
+		size = (nbytes > ARENA_SIZE) ? nbytes : ARENA_SIZE;
+		block = mem_alloc(sizeof(struct block_t) + size);
+
+		if((size == ARENA_SIZE) || (arena->block == NULL)) {
+			block->next = arena->block;
+			arena->block = block;
+			arena->idx = 0;
+			arena->size = size;
 		}
+		else {
+			block->next = arena->block->next;
+			arena->block->next = block;
+
+			return block->data;
+		}
+	}
+
+	ptr = (uint8_t *)arena->block->data + arena->idx;
+	arena->idx += nbytes;
+
+	return ptr;
+}
+
+/**
+ * Copy a string slice into an arena.
+ *   @arena: The arena.
+ *   @slice: The slice.
+ *   &returns: The null-terminated copy.
+ */
+
+static char *arena_strdup(struct arena_t *arena, struct str_slice_t slice)
+{
+	char *str;
+
+	str = arena_alloc(arena, slice.len + 1);
+	mem_copy(str, slice.ptr, slice.len);
+	str[slice.len] = '\0';
+
+	return str;
+}
+
+/**
+ * Append a reference to a linked list.
+ *   @arena: The arena.
+ *   @tail: The list tail reference.
+ *   @ref: The reference.
+ */
+
+static void link_append(struct arena_t *arena, struct io_conf_link_t ***tail, void *ref)
+{
+	struct io_conf_link_t *link;
+
+	link = arena_alloc(arena, sizeof(struct io_conf_link_t));
+	link->ref = ref;
+	link->next = NULL;
+
+	**tail = link;
+	*tail = &link->next;
+}
+
+
+/**
+ * Read a single string from the line without copying it.
+ *   @str: The origin string.
+ *   @slice: Out. The extracted string, borrowed from the line.
+ *   &returns: True if a string was read, false at the end of the line.
+ */
+
+static bool readstr(const char **str, struct str_slice_t *slice)
+{
+	const char *ptr;
+
+	if(chkend(str))
+		return false;
+
+	switch(**str) {
+	case '"':
+	case '\'':
+		ptr = str_chr(*str + 1, **str);
+		if(ptr == NULL)
+			throw("Unterminated quote.");
 
-		val = str_ndup(*str, ptr++ - *str);
+		*slice = str_slice(*str + 1, ptr - *str - 1);
+		ptr++;
 
 		break;
 
@@ -416,12 +1080,12 @@ static char *readstr(const char **str)
 		while(!str_isspace(*ptr) && (*ptr != '\0'))
 			ptr++;
 
-		val = str_ndup(*str, ptr - *str);
+		*slice = str_slice(*str, ptr - *str);
 	}
 
 	*str = ptr;
 
-	return val;
+	return true;
 }
 
 /**
@@ -12,17 +12,18 @@
  */
 
 struct io_conf_t;
+struct io_conf_link_t;
 
 
 /**
  * Configuration pair structure.
- *   @id: The identifier.
+ *   @id: The interned identifier.
  *   @nvalues: The number of values.
  *   @value: The value array.
  */
 
 struct io_conf_pair_t {
-	char *id;
+	const char *id;
 
 	unsigned int nvalues;
 	char **value;
@@ -31,23 +32,64 @@ struct io_conf_pair_t {
 
 /**
  * Configure pair iterator.
- *   @inner: The internal iterator.
+ *   @link: The next link.
  */
 
 struct io_conf_iter_t {
-	struct avlitree_iter_t inner;
+	struct io_conf_link_t *link;
 };
 
 /**
  * Sub-configuration pair iterator.
- *   @inner: The internal iterator.
+ *   @link: The next link.
  */
 
 struct io_conf_subiter_t {
-	struct avlitree_iter_t inner;
+	struct io_conf_link_t *link;
 };
 
 
+/**
+ * Configuration change enumerator.
+ *   @io_conf_add_e: Added.
+ *   @io_conf_remove_e: Removed.
+ *   @io_conf_modify_e: Values modified.
+ */
+
+enum io_conf_change_e {
+	io_conf_add_e,
+	io_conf_remove_e,
+	io_conf_modify_e
+};
+
+/**
+ * Configuration change structure. Key changes refer to the containing
+ * sections, section changes refer to the sections themselves.
+ *   @type: The change type.
+ *   @section: Section flag.
+ *   @id: The key or section identifier.
+ *   @prev, next: The previous and next sections, null if absent.
+ *   @before, after: The previous and next pairs, null if absent.
+ */
+
+struct io_conf_change_t {
+	enum io_conf_change_e type;
+	bool section;
+	const char *id;
+
+	struct io_conf_t *prev, *next;
+	const struct io_conf_pair_t *before, *after;
+};
+
+/**
+ * Configuration change callback.
+ *   @change: The change.
+ *   @arg: The argument.
+ */
+
+typedef void (*io_conf_change_f)(const struct io_conf_change_t *change, void *arg);
+
+
 /*
  * configuration function declarations
  */
@@ -57,8 +99,11 @@ void io_conf_delete(struct io_conf_t *conf);
 
 struct io_conf_t *io_conf_read(struct io_input_t input);
 struct io_conf_t *io_conf_load(const char *path);
+struct io_conf_t *io_conf_reload(struct io_conf_t *conf, const char *path, io_conf_change_f func, void *arg);
+void io_conf_diff(struct io_conf_t *prev, struct io_conf_t *next, io_conf_change_f func, void *arg);
 
 const char *io_conf_id(struct io_conf_t *conf);
+struct io_conf_t *io_conf_parent(struct io_conf_t *conf);
 unsigned int io_conf_accum(struct io_conf_t *conf);
 
 const char *const *io_conf_lookup_values(struct io_conf_t *conf, const char *id);
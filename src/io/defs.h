@@ -199,6 +199,31 @@ enum io_file_e {
 	io_create_e = 0x20
 };
 
+/**
+ * Output buffering mode enumerator.
+ *   @io_buf_none_e: Unbuffered, writes pass straight through.
+ *   @io_buf_line_e: Line buffered, flushed after every newline.
+ *   @io_buf_full_e: Fully buffered, flushed only when full.
+ */
+
+enum io_buf_e {
+	io_buf_none_e,
+	io_buf_line_e,
+	io_buf_full_e
+};
+
+/**
+ * Serialization encoding enumerator.
+ *   @io_serial_native_e: Fixed-width values in native byte order.
+ *   @io_serial_compact_e: Versioned, endian-stable encoding using LEB128
+ *     varints for tags, lengths, and integers.
+ */
+
+enum io_serial_e {
+	io_serial_native_e,
+	io_serial_compact_e
+};
+
 
 /*
  * special value definitions
@@ -206,14 +231,25 @@ enum io_file_e {
 
 #define IO_EOS		(-1)
 
+/*
+ * compact serialization header definitions
+ */
+
+#define IO_SERIAL_MAGIC		"shim"
+#define IO_SERIAL_VERSION	1
+
 /*
  * control definitions
  */
 
 enum io_ctrl_e {
-	io_ctrl_eos_e
+	io_ctrl_eos_e,
+	io_ctrl_flush_e,
+	io_ctrl_fd_e
 };
 #define IO_CTRL_EOS	(1)
+#define IO_CTRL_FLUSH	(2)
+#define IO_CTRL_FD	(3)
 
 
 /**
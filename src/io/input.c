@@ -354,3 +354,46 @@ double io_input_double(struct io_input_t input)
 
 	return value;
 }
+
+/**
+ * Read an unsigned LEB128 varint from the input.
+ *   @input: The input device.
+ *   &returns: The value.
+ */
+
+_export
+uint64_t io_input_varint(struct io_input_t input)
+{
+	int16_t byte;
+	uint64_t value = 0;
+	unsigned int shift = 0;
+
+	do {
+		byte = io_input_byte(input);
+		if(byte == IO_EOS)
+			throw("Unable to read data from input.");
+		else if((shift == 63) && (byte > 1))
+			throw("Invalid varint.");
+
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while(byte & 0x80);
+
+	return value;
+}
+
+/**
+ * Read a zigzag encoded signed varint from the input.
+ *   @input: The input device.
+ *   &returns: The value.
+ */
+
+_export
+int64_t io_input_zigzag(struct io_input_t input)
+{
+	uint64_t value;
+
+	value = io_input_varint(input);
+
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
@@ -42,6 +42,8 @@ char *io_input_strptr(struct io_input_t input);
 char *io_input_line(struct io_input_t input);
 float io_input_float(struct io_input_t input);
 double io_input_double(struct io_input_t input);
+uint64_t io_input_varint(struct io_input_t input);
+int64_t io_input_zigzag(struct io_input_t input);
 
 /*
  * convenience definitions
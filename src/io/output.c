@@ -3,11 +3,16 @@
 #include "../debug/exception.h"
 #include "../debug/res.h"
 #include "../math/func.h"
+#include "../mem/base.h"
 #include "../mem/manage.h"
 #include "../io/chunk.h"
+#include "../io/print.h"
 #include "../string/base.h"
+#include "../thread/base.h"
+#include "../thread/lock.h"
 #include "device.h"
 #include "file.h"
+#include <string.h>
 
 
 /**
@@ -22,31 +27,82 @@ struct counter_t {
 	struct io_output_t output;
 };
 
+/**
+ * Buffer structure.
+ *   @output: The wrapped output.
+ *   @mode: The buffering mode.
+ *   @own: Ownership flag, closing the buffer closes the output.
+ *   @lock: The buffer lock.
+ *   @buf: The buffer data.
+ *   @idx, size: The number of buffered bytes and the buffer size.
+ */
+
+struct buffer_t {
+	struct io_output_t output;
+	enum io_buf_e mode;
+	bool own;
+
+	struct thread_mutex_t lock;
+
+	uint8_t *buf;
+	size_t idx, size;
+};
+
 
 /*
  * implementation function declarations
  */
 
-struct io_output_t _impl_io_output_stdout();
-struct io_output_t _impl_io_output_stderr();
+struct io_output_t _impl_io_output_stdout(enum io_buf_e *mode);
+struct io_output_t _impl_io_output_stderr(enum io_buf_e *mode);
 
 struct io_output_t _impl_io_output_open(const char *path);
-struct io_output_t _impl_io_output_open_dbg(const char *path, const char *file, unsigned int line);
-
 struct io_output_t _impl_io_output_append(const char *path);
-struct io_output_t _impl_io_output_append_dbg(const char *path, const char *file, unsigned int line);
+
+bool _impl_io_output_segment(struct io_output_t output, struct io_file_t file, uint64_t offset, uint64_t nbytes);
+
+/*
+ * local definitions
+ */
+
+#define IO_SEGMENT_BUFSIZE	(128 * 1024)
 
 /*
  * local function declarations
  */
 
 static size_t counter_proc(struct counter_t *counter, const void *restrict buf, size_t nbytes);
+static void segment_copy(struct io_output_t output, struct io_file_t file, uint8_t *buf, uint64_t nbytes);
+
+static struct buffer_t *buffer_new(struct io_output_t output, size_t size, enum io_buf_e mode, bool own);
+static size_t buffer_write(struct buffer_t *buffer, const void *restrict buf, size_t nbytes);
+static void buffer_slow(struct buffer_t *buffer, const void *restrict buf, size_t nbytes);
+static void buffer_drain(struct buffer_t *buffer);
+static bool buffer_ctrl(struct buffer_t *buffer, unsigned int id, void *data);
+static void buffer_close(struct buffer_t *buffer);
+static void buffer_free(struct buffer_t *buffer);
+static struct io_output_t buffer_dbg(struct io_output_t output, const char *path, const char *file, unsigned int line);
+static void buffer_dbgclose(struct buffer_t *buffer);
+static void buffer_chunk(struct io_output_t output, void *arg);
+
+static void std_init();
+static void std_close(struct buffer_t *buffer);
+static void std_exit() __attribute__((destructor));
+static void std_drain(struct buffer_t *buffer);
 
 /*
  * local variables
  */
 
 static struct io_output_i counter_iface = { { io_blank_ctrl, mem_free }, (io_write_f)counter_proc };
+static struct io_output_i buffer_iface = { { (io_ctrl_f)buffer_ctrl, (io_close_f)buffer_close }, (io_write_f)buffer_write };
+static struct io_output_i dbg_iface = { { (io_ctrl_f)buffer_ctrl, (io_close_f)buffer_dbgclose }, (io_write_f)buffer_write };
+static struct io_output_i std_iface = { { (io_ctrl_f)buffer_ctrl, (io_close_f)std_close }, (io_write_f)buffer_write };
+
+static struct thread_once_t std_once = THREAD_ONCE_INIT;
+static uint8_t stdout_data[IO_OUTPUT_BUFSIZE], stderr_data[IO_OUTPUT_BUFSIZE];
+static struct buffer_t stdout_buf = { .lock = THREAD_MUTEX_INIT, .buf = stdout_data, .size = sizeof(stdout_data) };
+static struct buffer_t stderr_buf = { .lock = THREAD_MUTEX_INIT, .buf = stderr_data, .size = sizeof(stderr_data) };
 
 
 /**
@@ -57,7 +113,9 @@ static struct io_output_i counter_iface = { { io_blank_ctrl, mem_free }, (io_wri
 _export
 struct io_output_t io_output_stdout()
 {
-	return _impl_io_output_stdout();
+	thread_once(&std_once, std_init);
+
+	return (struct io_output_t){ &stdout_buf, &std_iface };
 }
 
 /**
@@ -68,7 +126,63 @@ struct io_output_t io_output_stdout()
 _export
 struct io_output_t io_output_stderr()
 {
-	return _impl_io_output_stderr();
+	thread_once(&std_once, std_init);
+
+	return (struct io_output_t){ &stderr_buf, &std_iface };
+}
+
+/**
+ * Initialize the standard output buffers.
+ */
+
+static void std_init()
+{
+	stdout_buf.output = _impl_io_output_stdout(&stdout_buf.mode);
+	stderr_buf.output = _impl_io_output_stderr(&stderr_buf.mode);
+}
+
+/**
+ * Close a standard output buffer. The underlying stream remains open, only
+ * the pending data is flushed.
+ *   @buffer: The buffer.
+ */
+
+static void std_close(struct buffer_t *buffer)
+{
+	buffer_ctrl(buffer, IO_CTRL_FLUSH, NULL);
+}
+
+/**
+ * Flush the standard output buffers on process exit. As a destructor, this
+ * runs after every 'atexit' handler has had a chance to print.
+ */
+
+static void std_exit()
+{
+	if(stdout_buf.output.iface == NULL)
+		return;
+
+	std_drain(&stdout_buf);
+	std_drain(&stderr_buf);
+}
+
+/**
+ * Drain a standard output buffer without throwing, discarding the data on a
+ * failed write.
+ *   @buffer: The buffer.
+ */
+
+static void std_drain(struct buffer_t *buffer)
+{
+	size_t i, nbytes;
+
+	for(i = 0; i < buffer->idx; i += nbytes) {
+		nbytes = io_output_write(buffer->output, buffer->buf + i, buffer->idx - i);
+		if(nbytes == 0)
+			break;
+	}
+
+	buffer->idx = 0;
 }
 
 
@@ -81,7 +195,7 @@ struct io_output_t io_output_stderr()
 _export
 struct io_output_t _io_output_open(const char *path)
 {
-	return _impl_io_output_open(path);
+	return (struct io_output_t){ buffer_new(_impl_io_output_open(path), IO_OUTPUT_BUFSIZE, io_buf_full_e, true), &buffer_iface };
 }
 
 /**
@@ -95,7 +209,7 @@ struct io_output_t _io_output_open(const char *path)
 _export
 struct io_output_t _io_output_open_dbg(const char *path, const char *file, unsigned int line)
 {
-	return _impl_io_output_open_dbg(path, file, line);
+	return buffer_dbg(_impl_io_output_open(path), path, file, line);
 }
 
 /**
@@ -107,7 +221,7 @@ struct io_output_t _io_output_open_dbg(const char *path, const char *file, unsig
 _export
 struct io_output_t _io_output_append(const char *path)
 {
-	return _impl_io_output_append(path);
+	return (struct io_output_t){ buffer_new(_impl_io_output_append(path), IO_OUTPUT_BUFSIZE, io_buf_full_e, true), &buffer_iface };
 }
 
 /**
@@ -121,7 +235,7 @@ struct io_output_t _io_output_append(const char *path)
 _export
 struct io_output_t _io_output_append_dbg(const char *path, const char *file, unsigned int line)
 {
-	return _impl_io_output_append_dbg(path, file, line);
+	return buffer_dbg(_impl_io_output_append(path), path, file, line);
 }
 
 
@@ -175,6 +289,17 @@ bool io_output_ctrl(struct io_output_t output, unsigned int cmd, void *arg)
 	return output.iface->device.ctrl(output.ref, cmd, arg);
 }
 
+/**
+ * Flush any data buffered by the output device.
+ *   @output: The output device.
+ */
+
+_export
+void io_output_flush(struct io_output_t output)
+{
+	io_output_ctrl(output, IO_CTRL_FLUSH, NULL);
+}
+
 /**
  * Close the output device.
  *   @output: The output device.
@@ -279,6 +404,23 @@ void io_output_str(struct io_output_t output, const char *str)
 	io_output_writefull(output, str, len);
 }
 
+/**
+ * Write a string slice to the output device. The encoding matches
+ * 'io_output_str', so it may be read back with 'io_input_str'.
+ *   @output: The output device.
+ *   @slice: The slice.
+ */
+
+_export
+void io_output_slice(struct io_output_t output, struct str_slice_t slice)
+{
+	if(slice.len > UINT32_MAX)
+		throw("String too long to be written.");
+
+	io_output_uint32(output, slice.len);
+	io_output_writefull(output, slice.ptr, slice.len);
+}
+
 /**
  * Write a string to the output device.
  *   @output: The output device.
@@ -327,21 +469,85 @@ void io_output_double(struct io_output_t output, double value)
 }
 
 /**
- * Write a double to the output device.
+ * Write an unsigned LEB128 varint to the output device. Each byte carries
+ * seven bits, least significant first, with the high bit set on every byte
+ * but the last.
  *   @output: The output device.
- *   @ch: The double.
+ *   @value: The value.
+ */
+
+_export
+void io_output_varint(struct io_output_t output, uint64_t value)
+{
+	uint8_t buf[10];
+	unsigned int n = 0;
+
+	while(value >= 0x80) {
+		buf[n++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+
+	buf[n++] = value;
+	io_output_writefull(output, buf, n);
+}
+
+/**
+ * Write a signed integer as a zigzag encoded varint, so that values of small
+ * magnitude take few bytes regardless of sign.
+ *   @output: The output device.
+ *   @value: The value.
+ */
+
+_export
+void io_output_zigzag(struct io_output_t output, int64_t value)
+{
+	io_output_varint(output, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+/**
+ * Write a segment of a file to the output device. When both ends are backed
+ * by file descriptors, the data is transferred inside the kernel.
+ *   @output: The output device.
+ *   @file: The file.
+ *   @offset: The segment offset.
+ *   @nbytes: The segment size.
  */
 
 _export
 void io_output_segment(struct io_output_t output, struct io_file_t file, uint64_t offset, uint64_t nbytes)
 {
-	size_t read;
-	uint8_t buf[4096];
+	uint8_t *buf;
+
+	if(_impl_io_output_segment(output, file, offset, nbytes))
+		return;
 
 	io_file_seek(file, offset, io_seek_set_e);
+	buf = mem_alloc(m_uint64min(nbytes, IO_SEGMENT_BUFSIZE));
+
+	try
+		segment_copy(output, file, buf, nbytes);
+	catch(e) {
+		mem_free(buf);
+		throw("%s", e);
+	}
+
+	mem_free(buf);
+}
+
+/**
+ * Copy a file segment through a buffer, starting at the current position.
+ *   @output: The output device.
+ *   @file: The file.
+ *   @buf: The buffer, holding up to 'IO_SEGMENT_BUFSIZE' bytes.
+ *   @nbytes: The segment size.
+ */
+
+static void segment_copy(struct io_output_t output, struct io_file_t file, uint8_t *buf, uint64_t nbytes)
+{
+	size_t read;
 
 	while(nbytes > 0) {
-		read = io_file_read(file, buf, m_sizemin(sizeof(buf), nbytes));
+		read = io_file_read(file, buf, m_uint64min(nbytes, IO_SEGMENT_BUFSIZE));
 		if(read == 0)
 			throw("Failed to read from file.");
 
@@ -385,3 +591,235 @@ static size_t counter_proc(struct counter_t *counter, const void *restrict buf,
 
 	return nbytes;
 }
+
+
+/**
+ * Create a buffered output. Small writes are accumulated and passed to the
+ * wrapped output in a single write once the buffer fills, on a newline when
+ * line buffered, or on an explicit flush. Closing the buffer flushes it but
+ * does not close the wrapped output.
+ *   @output: The output.
+ *   @size: The buffer size, also used as the flush threshold.
+ *   @mode: The buffering mode.
+ *   &returns: The buffered output.
+ */
+
+_export
+struct io_output_t io_output_buffer(struct io_output_t output, size_t size, enum io_buf_e mode)
+{
+	return (struct io_output_t){ buffer_new(output, size, mode, false), &buffer_iface };
+}
+
+/**
+ * Create a new buffer instance.
+ *   @output: The output.
+ *   @size: The buffer size.
+ *   @mode: The buffering mode.
+ *   @own: Ownership flag.
+ *   &returns: The buffer.
+ */
+
+static struct buffer_t *buffer_new(struct io_output_t output, size_t size, enum io_buf_e mode, bool own)
+{
+	struct buffer_t *buffer;
+
+	if(size == 0)
+		throw("Invalid buffer size.");
+
+	buffer = mem_alloc(sizeof(struct buffer_t) + size);
+	buffer->output = output;
+	buffer->mode = mode;
+	buffer->own = own;
+	buffer->lock = thread_mutex_new(NULL);
+	buffer->buf = (uint8_t *)(buffer + 1);
+	buffer->idx = 0;
+	buffer->size = size;
+
+	return buffer;
+}
+
+/**
+ * Write to a buffer.
+ *   @buffer: The buffer.
+ *   @buf: The data.
+ *   @nbytes: The number of bytes.
+ *   &returns: The number of bytes written.
+ */
+
+static size_t buffer_write(struct buffer_t *buffer, const void *restrict buf, size_t nbytes)
+{
+	thread_mutex_lock(&buffer->lock);
+
+	if((buffer->mode == io_buf_full_e) && ((buffer->idx + nbytes) <= buffer->size)) {
+		mem_copy(buffer->buf + buffer->idx, buf, nbytes);
+		buffer->idx += nbytes;
+	}
+	else if((buffer->mode == io_buf_line_e) && ((buffer->idx + nbytes) <= buffer->size) && (memchr(buf, '\n', nbytes) == NULL)) {
+		mem_copy(buffer->buf + buffer->idx, buf, nbytes);
+		buffer->idx += nbytes;
+	}
+	else
+		buffer_slow(buffer, buf, nbytes);
+
+	thread_mutex_unlock(&buffer->lock);
+
+	return nbytes;
+}
+
+/**
+ * Write to a buffer when the data must reach the wrapped output. Must be
+ * called with the lock held; the lock is released if the output throws.
+ *   @buffer: The buffer.
+ *   @buf: The data.
+ *   @nbytes: The number of bytes.
+ */
+
+static void buffer_slow(struct buffer_t *buffer, const void *restrict buf, size_t nbytes)
+{
+	try {
+		if((buffer->idx + nbytes) > buffer->size)
+			buffer_drain(buffer);
+
+		if((buffer->mode == io_buf_none_e) || (nbytes >= buffer->size))
+			io_output_writefull(buffer->output, buf, nbytes);
+		else {
+			mem_copy(buffer->buf + buffer->idx, buf, nbytes);
+			buffer->idx += nbytes;
+
+			if(buffer->mode == io_buf_line_e)
+				buffer_drain(buffer);
+		}
+	}
+	catch(e) {
+		thread_mutex_unlock(&buffer->lock);
+		throw("%s", e);
+	}
+}
+
+/**
+ * Drain all buffered data to the wrapped output. The buffer is emptied even
+ * if the write fails.
+ *   @buffer: The buffer.
+ */
+
+static void buffer_drain(struct buffer_t *buffer)
+{
+	size_t idx = buffer->idx;
+
+	if(idx == 0)
+		return;
+
+	buffer->idx = 0;
+	io_output_writefull(buffer->output, buffer->buf, idx);
+}
+
+/**
+ * Handle a control signal to a buffer. Flush requests are propagated to the
+ * wrapped output. Descriptor requests flush first, since the caller will
+ * write around the buffer. All others are passed through.
+ *   @buffer: The buffer.
+ *   @id: The control identifier.
+ *   @data: The control data.
+ *   &returns: True if handled, false otherwise.
+ */
+
+static bool buffer_ctrl(struct buffer_t *buffer, unsigned int id, void *data)
+{
+	if((id != IO_CTRL_FLUSH) && (id != IO_CTRL_FD))
+		return io_output_ctrl(buffer->output, id, data);
+
+	thread_mutex_lock(&buffer->lock);
+
+	try
+		buffer_drain(buffer);
+	catch(e) {
+		thread_mutex_unlock(&buffer->lock);
+		throw("%s", e);
+	}
+
+	thread_mutex_unlock(&buffer->lock);
+
+	if(id == IO_CTRL_FD)
+		return io_output_ctrl(buffer->output, IO_CTRL_FD, data);
+
+	io_output_ctrl(buffer->output, IO_CTRL_FLUSH, NULL);
+
+	return true;
+}
+
+/**
+ * Close a buffer, flushing any pending data.
+ *   @buffer: The buffer.
+ */
+
+static void buffer_close(struct buffer_t *buffer)
+{
+	try
+		buffer_ctrl(buffer, IO_CTRL_FLUSH, NULL);
+	catch(e) {
+		buffer_free(buffer);
+		throw("%s", e);
+	}
+
+	buffer_free(buffer);
+}
+
+/**
+ * Free a buffer without flushing, closing the wrapped output if owned.
+ *   @buffer: The buffer.
+ */
+
+static void buffer_free(struct buffer_t *buffer)
+{
+	bool own = buffer->own;
+	struct io_output_t output = buffer->output;
+
+	thread_mutex_delete(&buffer->lock);
+	mem_free(buffer);
+
+	if(own)
+		io_output_close(output);
+}
+
+/**
+ * Wrap a raw output in a buffer tracked as a debugging resource. The buffer
+ * data pointer is tracked rather than the descriptor, since descriptors are
+ * reused, and rather than the buffer itself, which memory tracking keys.
+ *   @output: The raw output.
+ *   @path: The path.
+ *   @file: The file.
+ *   @line: The line.
+ *   &returns: The buffered output.
+ */
+
+static struct io_output_t buffer_dbg(struct io_output_t output, const char *path, const char *file, unsigned int line)
+{
+	struct buffer_t *buffer;
+
+	buffer = buffer_new(output, IO_OUTPUT_BUFSIZE, io_buf_full_e, true);
+	_dbg_res_alloc(buffer->buf, file, line, (struct io_chunk_t){ buffer_chunk, (void *)path });
+
+	return (struct io_output_t){ buffer, &dbg_iface };
+}
+
+/**
+ * Close a buffer tracked as a debugging resource.
+ *   @buffer: The buffer.
+ */
+
+static void buffer_dbgclose(struct buffer_t *buffer)
+{
+	_dbg_res_free(buffer->buf);
+	buffer_close(buffer);
+}
+
+/**
+ * Callback for printing out debugging information.
+ *   @output: The output.
+ *   @arg: File path as argument.
+ */
+
+static void buffer_chunk(struct io_output_t output, void *arg)
+{
+	io_printf(output, "opened file, \"%s\"", (const char *)arg);
+}
@@ -29,6 +29,7 @@ struct io_output_t _io_output_append_dbg(const char *path, const char *file, uns
 size_t io_output_write(struct io_output_t output, const void *restrict buf, size_t nbytes);
 void io_output_writefull(struct io_output_t output, const void *restrict buf, size_t nbytes);
 bool io_output_ctrl(struct io_output_t output, unsigned int cmd, void *arg);
+void io_output_flush(struct io_output_t output);
 void io_output_close(struct io_output_t output);
 
 void io_output_bool(struct io_output_t output, bool value);
@@ -38,9 +39,12 @@ void io_output_uint32(struct io_output_t output, uint32_t value);
 void io_output_uint64(struct io_output_t output, uint64_t value);
 void io_output_ch(struct io_output_t output, char ch);
 void io_output_str(struct io_output_t output, const char *str);
+void io_output_slice(struct io_output_t output, struct str_slice_t slice);
 void io_output_strptr(struct io_output_t output, const char *str);
 void io_output_float(struct io_output_t output, float value);
 void io_output_double(struct io_output_t output, double value);
+void io_output_varint(struct io_output_t output, uint64_t value);
+void io_output_zigzag(struct io_output_t output, int64_t value);
 void io_output_segment(struct io_output_t output, struct io_file_t file, uint64_t offset, uint64_t nbytes);
 
 /*
@@ -48,6 +52,13 @@ void io_output_segment(struct io_output_t output, struct io_file_t file, uint64_
  */
 
 struct io_output_t io_output_counter(struct io_output_t output, uint64_t *nbytes);
+struct io_output_t io_output_buffer(struct io_output_t output, size_t size, enum io_buf_e mode);
+
+/*
+ * buffer definitions
+ */
+
+#define IO_OUTPUT_BUFSIZE	4096
 
 /*
  * convenience definitions
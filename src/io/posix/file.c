@@ -50,7 +50,7 @@ uint64_t file_seek(struct file_t *file, int64_t offset, enum io_whence_e whence)
 
 bool file_flush(struct file_t *file);
 
-static bool file_ctrl(struct file_t *file, enum io_ctrl_e cmd, void *data);
+static bool file_ctrl(struct file_t *file, unsigned int cmd, void *data);
 static void file_close(struct file_t *file);
 
 /*
@@ -339,9 +339,29 @@ bool file_flush(struct file_t *file)
  *   &returns: True if handled, false otherwise.
  */
 
-static bool file_ctrl(struct file_t *file, enum io_ctrl_e cmd, void *data)
+static bool file_ctrl(struct file_t *file, unsigned int cmd, void *data)
 {
-	return false;
+	switch(cmd) {
+	case IO_CTRL_FLUSH:
+		file_flush(file);
+		break;
+
+	case IO_CTRL_FD:
+		file_flush(file);
+		if(file->op == io_read_e)
+			lseek(file->fd, -(off_t)file->avail, SEEK_CUR);
+
+		file->op = 0;
+		file->idx = 0;
+		file->avail = 0;
+		*(int *)data = file->fd;
+		break;
+
+	default:
+		return false;
+	}
+
+	return true;
 }
 
 /**
@@ -4,6 +4,7 @@
 #include "../../debug/exception.h"
 #include "../../debug/res.h"
 #include "../../io/chunk.h"
+#include "../../io/output.h"
 #include "../../io/print.h"
 
 
@@ -111,6 +112,9 @@ bool _impl_io_input_file_ctrl(FILE *file, unsigned int cmd, void *arg)
 
 size_t _impl_io_input_file_read(FILE *file, void *restrict buf, size_t nbytes)
 {
+	if(file == stdin)
+		io_output_flush(io_stdout);
+
 	return fread(buf, 1, nbytes, file);
 }
 
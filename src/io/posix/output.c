@@ -1,161 +1,319 @@
+#define _GNU_SOURCE
 #include "../../common.h"
 #include "../defs.h"
-#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#	include <sys/sendfile.h>
+#endif
+
 #include "../../debug/exception.h"
-#include "../../debug/res.h"
 #include "../../io/chunk.h"
+#include "../../io/device.h"
+#include "../../io/file.h"
+#include "../../io/output.h"
 #include "../../io/print.h"
+#include "../../math/func.h"
+#include "../../mem/manage.h"
+
+
+/*
+ * local definitions
+ */
 
+#define COPY_CHUNK	(1 << 30)
+#define COPY_BUFSIZE	(128 * 1024)
 
 /*
- * function declarations
+ * implementation function declarations
  */
 
-size_t _impl_io_output_file_write(FILE *file, const void *restrict buf, size_t nbytes);
-void _impl_io_output_file_close(FILE *file);
+bool _impl_io_fdcopy(int dfd, int sfd, uint64_t *offset, uint64_t nbytes, uint64_t *total);
+
 
 /*
  * local function declarations
  */
 
-static void res_chunk(struct io_output_t output, void *arg);
+static struct io_output_t fd_open(const char *path, int oflag);
+static bool fd_ctrl(void *ref, unsigned int id, void *data);
+static size_t fd_write(void *ref, const void *restrict buf, size_t nbytes);
+static void fd_close(void *ref);
+
+static bool fdcopy_retry(int err);
 
 /*
- * global variables
+ * local variables
  */
 
-struct io_output_i _impl_io_output_file_iface = {
-	{
-		NULL,
-		(io_close_f)_impl_io_output_file_close
-	},
-	(io_write_f)_impl_io_output_file_write
-};
+static struct io_output_i fd_iface = { { fd_ctrl, fd_close }, fd_write };
+static struct io_output_i std_iface = { { fd_ctrl, io_blank_close }, fd_write };
 
 
 /**
- * Retrieve the standard output device.
+ * Retrieve the raw standard output device. Standard output is line buffered
+ * when attached to a terminal and fully buffered otherwise.
+ *   @mode: Out. The buffering mode to use.
  *   &returns: The standard output device.
  */
 
-struct io_output_t _impl_io_output_stdout()
+struct io_output_t _impl_io_output_stdout(enum io_buf_e *mode)
 {
-	return (struct io_output_t){ stdout, &_impl_io_output_file_iface };
+	*mode = isatty(STDOUT_FILENO) ? io_buf_line_e : io_buf_full_e;
+
+	return (struct io_output_t){ (void *)(intptr_t)STDOUT_FILENO, &std_iface };
 }
 
 /**
- * Retrieve the standard error device.
+ * Retrieve the raw standard error device. Standard error is unbuffered so
+ * that diagnostics are written immediately.
+ *   @mode: Out. The buffering mode to use.
  *   &returns: The standard error device.
  */
 
-struct io_output_t _impl_io_output_stderr()
+struct io_output_t _impl_io_output_stderr(enum io_buf_e *mode)
 {
-	return (struct io_output_t){ stderr, &_impl_io_output_file_iface };
+	*mode = io_buf_none_e;
+
+	return (struct io_output_t){ (void *)(intptr_t)STDERR_FILENO, &std_iface };
 }
 
 
 /**
- * Open an output device.
+ * Open a raw output device.
  *   @path: The path.
  *   &returns: The output device.
  */
 
 struct io_output_t _impl_io_output_open(const char *path)
 {
-	FILE *file;
-
-	file = fopen(path, "w");
-	if(file == NULL)
-		throw("Unable to open file '%s'.", path);
-
-	return (struct io_output_t){ file, &_impl_io_output_file_iface };
+	return fd_open(path, O_WRONLY | O_CREAT | O_TRUNC);
 }
 
 /**
- * Open an output device with debugging information.
+ * Append to a raw output device.
  *   @path: The path.
  *   &returns: The output device.
  */
 
-struct io_output_t _impl_io_output_open_dbg(const char *path, const char *file, unsigned int line)
+struct io_output_t _impl_io_output_append(const char *path)
 {
-	struct io_output_t output;
-
-	output = _impl_io_output_open(path);
-	_dbg_res_alloc(output.ref, file, line, (struct io_chunk_t){ res_chunk, (void *)path });
-
-	return output;
+	return fd_open(path, O_WRONLY | O_CREAT | O_APPEND);
 }
 
 
 /**
- * Append to an output device.
+ * Open a file descriptor output device.
  *   @path: The path.
+ *   @oflag: The open flags.
  *   &returns: The output device.
  */
 
-struct io_output_t _impl_io_output_append(const char *path)
+static struct io_output_t fd_open(const char *path, int oflag)
 {
-	FILE *file;
+	int fd;
 
-	file = fopen(path, "a");
-	if(file == NULL)
+	fd = open(path, oflag, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+	if(fd < 0)
 		throw("Unable to open file '%s'.", path);
 
-	return (struct io_output_t){ file, &_impl_io_output_file_iface };
+	return (struct io_output_t){ (void *)(intptr_t)fd, &fd_iface };
 }
 
 /**
- * Append to an output device with debugging information.
- *   @path: The path.
- *   &returns: The output device.
+ * Handle a control signal to a file descriptor.
+ *   @ref: The file descriptor reference.
+ *   @id: The control identifier.
+ *   @data: The control data.
+ *   &returns: True if handled, false otherwise.
  */
 
-struct io_output_t _impl_io_output_append_dbg(const char *path, const char *file, unsigned int line)
+static bool fd_ctrl(void *ref, unsigned int id, void *data)
 {
-	struct io_output_t output;
+	switch(id) {
+	case IO_CTRL_FD:
+		*(int *)data = (intptr_t)ref;
+		break;
 
-	output = _impl_io_output_open(path);
-	_dbg_res_alloc(output.ref, file, line, (struct io_chunk_t){ res_chunk, (void *)path });
+	default:
+		return false;
+	}
 
-	return output;
+	return true;
 }
 
-
 /**
- * Write to a buffered file.
- *   @file: The file.
+ * Write to a file descriptor. Errors are reported as a zero-length write.
+ *   @ref: The file descriptor reference.
  *   @buf: The buffer.
  *   @nbytes: The number of bytes.
  *   &returns: The number of bytes written.
  */
 
-size_t _impl_io_output_file_write(FILE *file, const void *restrict buf, size_t nbytes)
+static size_t fd_write(void *ref, const void *restrict buf, size_t nbytes)
+{
+	ssize_t ret;
+
+	do
+		ret = write((intptr_t)ref, buf, nbytes);
+	while((ret < 0) && (errno == EINTR));
+
+	return (ret > 0) ? ret : 0;
+}
+
+/**
+ * Close a file descriptor.
+ *   @ref: The file descriptor reference.
+ */
+
+static void fd_close(void *ref)
 {
-	return fwrite(buf, 1, nbytes, file);
+	close((intptr_t)ref);
 }
 
+
 /**
- * Close a buffered file.
+ * Write a file segment to an output inside the kernel when both ends are file
+ * descriptors. The file position is left at the end of the segment.
+ *   @output: The output device.
  *   @file: The file.
+ *   @offset: The segment offset.
+ *   @nbytes: The segment size.
+ *   &returns: True if the segment was written, false if the caller must fall
+ *     back to a buffered copy.
  */
 
-void _impl_io_output_file_close(FILE *file)
+bool _impl_io_output_segment(struct io_output_t output, struct io_file_t file, uint64_t offset, uint64_t nbytes)
 {
-	if(_debug)
-		_dbg_res_free(file);
+	int dfd, sfd;
+	uint64_t total;
 
-	fclose(file);
+	if(!io_file_ctrl(file, IO_CTRL_FD, &sfd) || !io_output_ctrl(output, IO_CTRL_FD, &dfd))
+		return false;
+
+	if(!_impl_io_fdcopy(dfd, sfd, &offset, nbytes, &total))
+		throw("Failed to write file segment. %s.", strerror(errno));
+	else if(total != nbytes)
+		throw("Failed to read from file.");
+
+	io_file_seek(file, offset, io_seek_set_e);
+
+	return true;
 }
 
+/**
+ * Copy data between two file descriptors, preferring in-kernel transfers. On
+ * Linux, 'copy_file_range' is tried first, allowing reflinks and server-side
+ * copies, then 'sendfile', and finally a plain read/write loop. A kernel
+ * method that copies nothing at all also falls back, since older kernels
+ * report zero bytes for files such as those in procfs and sysfs.
+ *   @dfd: The destination descriptor, written at its current position.
+ *   @sfd: The source descriptor.
+ *   @offset: Optional. The source offset, updated on return. If null, the
+ *     source file position is used and advanced.
+ *   @nbytes: The maximum number of bytes, or 'UINT64_MAX' to copy to the end.
+ *   @total: Out. The number of bytes copied.
+ *   &returns: True on success, false on error with 'errno' set.
+ */
+
+bool _impl_io_fdcopy(int dfd, int sfd, uint64_t *offset, uint64_t nbytes, uint64_t *total)
+{
+	ssize_t ret = 0;
+	off_t pos;
+	uint8_t *buf = NULL;
+	unsigned int stage = 0;
+
+	*total = 0;
+	pos = offset ? *offset : 0;
+
+	while(nbytes > 0) {
+#ifdef __linux__
+		if(stage == 0) {
+			ret = copy_file_range(sfd, offset ? &pos : NULL, dfd, NULL, m_uint64min(nbytes, COPY_CHUNK), 0);
+			if(((ret == 0) || ((ret < 0) && fdcopy_retry(errno))) && (*total == 0)) {
+				stage = 1;
+				continue;
+			}
+		}
+		else if(stage == 1) {
+			ret = sendfile(dfd, sfd, offset ? &pos : NULL, m_uint64min(nbytes, COPY_CHUNK));
+			if(((ret == 0) || ((ret < 0) && fdcopy_retry(errno))) && (*total == 0)) {
+				stage = 2;
+				continue;
+			}
+		}
+		else
+#endif
+		{
+			ssize_t rem, written;
+
+			if(buf == NULL)
+				buf = mem_alloc(COPY_BUFSIZE);
+
+			ret = offset ? pread(sfd, buf, m_uint64min(nbytes, COPY_BUFSIZE), pos) : read(sfd, buf, m_uint64min(nbytes, COPY_BUFSIZE));
+
+			for(rem = ret; rem > 0; rem -= written) {
+				written = write(dfd, buf + ret - rem, rem);
+				if(written < 0) {
+					if(errno == EINTR) {
+						written = 0;
+						continue;
+					}
+
+					ret = -1;
+					break;
+				}
+			}
+
+			if((ret > 0) && offset)
+				pos += ret;
+		}
+
+		if(ret < 0) {
+			if(errno == EINTR)
+				continue;
+
+			break;
+		}
+		else if(ret == 0)
+			break;
+
+		*total += ret;
+		nbytes -= ret;
+	}
+
+	if(buf != NULL)
+		mem_free(buf);
+
+	if(offset)
+		*offset = pos;
+
+	return ret >= 0;
+}
 
 /**
- * Callback for printing out debugging information.
- *   @output: The output.
- *   @arg: File path as argument.
+ * Determine if a kernel copy error means the next copy method should be
+ * attempted.
+ *   @err: The error number.
+ *   &returns: True to fall back, false for a real error.
  */
 
-static void res_chunk(struct io_output_t output, void *arg)
+static bool fdcopy_retry(int err)
 {
-	io_printf(output, "opened file, \"%s\"", (const char *)arg);
+	switch(err) {
+	case EXDEV:
+	case EINVAL:
+	case ENOSYS:
+	case EOPNOTSUPP:
+	case EBADF:
+		return true;
+
+	default:
+		return false;
+	}
 }
+
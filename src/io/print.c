@@ -1,14 +1,141 @@
 #include "../common.h"
 #include "print.h"
+#include <math.h>
 #include "../debug/exception.h"
 #include "../io/chunk.h"
 #include "../math/func.h"
 #include "../mem/base.h"
+#include "../mem/manage.h"
 #include "../string/base.h"
 #include "../string/locale.h"
+#include "../thread/base.h"
 #include "output.h"
 
 
+/**
+ * Compiled format segment structure.
+ *   @str: The literal string, or null for a conversion.
+ *   @len: The literal length.
+ *   @mod: The conversion modifiers.
+ *   @callback: The conversion callback.
+ */
+
+struct io_fmt_seg_t {
+	const char *str;
+	size_t len;
+
+	struct io_print_mod_t mod;
+	io_print_f callback;
+};
+
+/**
+ * Compiled format structure.
+ *   @nsegs: The number of segments.
+ *   @segs: The segment array.
+ */
+
+struct io_fmt_t {
+	unsigned int nsegs;
+	struct io_fmt_seg_t segs[];
+};
+
+
+/**
+ * Floating-point significand and exponent structure.
+ *   @f: The significand.
+ *   @e: The binary exponent.
+ */
+
+struct diyfp_t {
+	uint64_t f;
+	int e;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static void lookup_init();
+static struct io_print_t *print_parse(struct io_print_t *print, const char **format, struct io_print_mod_t *mod);
+
+static unsigned int digits32(uint32_t value);
+static unsigned int digits64(uint64_t value);
+static void format_pad(struct io_output_t output, const char *str, size_t len, uint16_t width, bool neg, bool zero);
+static size_t conv_base(char *buf, uint64_t value, uint8_t base);
+
+static void grisu2(double value, char *buf, int *len, int *k);
+static size_t prettify(char *buf, int len, int k);
+
+/*
+ * local variables
+ */
+
+static struct thread_once_t lookup_once = THREAD_ONCE_INIT;
+static struct io_print_t *lookup_default[256];
+
+static const char digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char digit_hex[16] = "0123456789abcdef";
+
+static const uint32_t pow10_32[10] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static const uint64_t cached_f[87] = {
+	UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+	UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+	UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+	UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+	UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+	UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+	UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+	UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+	UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+	UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+	UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+	UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+	UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+	UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+	UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+	UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+	UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+	UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+	UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+	UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+	UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+	UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+	UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+	UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+	UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+	UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+	UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+	UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+	UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+static const int16_t cached_e[87] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+	-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+	-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+	-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+	-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+	109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+	641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+	907, 933, 960, 986, 1013, 1039, 1066
+};
+
 /*
  * global variables
  */
@@ -20,10 +147,13 @@ struct io_print_t io_print_default[] = {
 	{ 'u', "unsigned", 0, io_printf_uint },
 	{ 'x', "hex", 0, io_printf_hex },
 	{ 'b', "binary", 0, io_printf_binary },
-	{ 'u', "unsigned", 0, io_printf_uint },
 	{ 'c', "char", 0, io_printf_char },
 	{ 'C', "chunk", 0, io_printf_chunk },
 	{ 'f', "float", 0, io_printf_float },
+	{ '\0', "int64", 0, io_printf_int64 },
+	{ '\0', "uint64", 0, io_printf_uint64 },
+	{ '\0', "hex64", 0, io_printf_hex64 },
+	{ '\0', "slice", 0, io_printf_slice },
 	{ '\0', NULL, 0, NULL }
 };
 
@@ -52,6 +182,18 @@ void io_print_str(struct io_output_t output, const char *str)
 	io_output_write(output, str, str_len(str));
 }
 
+/**
+ * Print out a string slice.
+ *   @output: The output device.
+ *   @slice: The slice.
+ */
+
+_export
+void io_print_slice(struct io_output_t output, struct str_slice_t slice)
+{
+	io_output_write(output, slice.ptr, slice.len);
+}
+
 /**
  * Print out a signed integer.
  *   @output: The output device.
@@ -61,19 +203,9 @@ void io_print_str(struct io_output_t output, const char *str)
 _export
 void io_print_int(struct io_output_t output, int value)
 {
-	uint8_t i = 0;
-	char buf[20];
-	bool neg = value < 0;
-	unsigned int uval = (value >= 0) ? value : -value;
-
-	do
-		buf[20 - ++i] = (uval % 10) + '0';
-	while((uval /= 10) > 0);
-
-	if(neg)
-		buf[20 - ++i] = '-';
+	char buf[IO_CONV_MAX];
 
-	io_output_write(output, buf + 20 - i, i);
+	io_output_write(output, buf, io_conv_int32(buf, value));
 }
 
 /**
@@ -85,14 +217,52 @@ void io_print_int(struct io_output_t output, int value)
 _export
 void io_print_uint(struct io_output_t output, unsigned int value)
 {
-	uint8_t i = 0;
-	char buf[19];
+	char buf[IO_CONV_MAX];
+
+	io_output_write(output, buf, io_conv_uint32(buf, value));
+}
+
+/**
+ * Print out a signed 64-bit integer.
+ *   @output: The output device.
+ *   @value: The value.
+ */
 
-	do
-		buf[19 - ++i] = (value % 10) + '0';
-	while((value /= 10) > 0);
+_export
+void io_print_int64(struct io_output_t output, int64_t value)
+{
+	char buf[IO_CONV_MAX];
 
-	io_output_write(output, buf + 19 - i, i);
+	io_output_write(output, buf, io_conv_int64(buf, value));
+}
+
+/**
+ * Print out an unsigned 64-bit integer.
+ *   @output: The output device.
+ *   @value: The value.
+ */
+
+_export
+void io_print_uint64(struct io_output_t output, uint64_t value)
+{
+	char buf[IO_CONV_MAX];
+
+	io_output_write(output, buf, io_conv_uint64(buf, value));
+}
+
+/**
+ * Print out a double using a short representation that reads back
+ * exactly, usually the shortest.
+ *   @output: The output device.
+ *   @value: The value.
+ */
+
+_export
+void io_print_double(struct io_output_t output, double value)
+{
+	char buf[IO_CONV_MAX];
+
+	io_output_write(output, buf, io_conv_double(buf, value));
 }
 
 
@@ -141,71 +311,22 @@ void io_vprintf(struct io_output_t output, const char *restrict format, va_list
 _export
 void io_vprintf_custom(struct io_output_t output, struct io_print_t *print, const char *format, struct arglist_t *args)
 {
-	size_t i = 0;
+	size_t i;
 	struct io_print_t *search;
 	struct io_print_mod_t mod;
-	char name[16];
 
 	while(*format != '\0') {
 		if(*format == '%') {
 			format++;
 
 			if(*format != '%') {
-				if(*format == '-')
-					mod.neg = true, format++;
-				else
-					mod.neg = false;
-
-				if(*format == '0')
-					mod.zero = true, format++;
-				else
-					mod.zero = false;
-
-				mod.width = 0;
-				while(str_isdigit(*format))
-					mod.width = mod.width * 10 + *format - '0', format++;
-
-				if(*format == ':') {
-					format++;
-
-					for(i = 0; format[i] != ':'; i++) {
-						if(i == 15)
-							throw("Format name too long.");
-						else if(format[i] == '\0')
-							throw("Invalid format, no ending ':'.");
-					}
-
-					mem_copy(name, format, i);
-					name[i] = '\0';
-
-					search = print;
-					while(1) {
-						if(search->callback == NULL)
-							throw("Invalid token '%c'.", *format);
-						if((search->name != NULL) && str_isequal(search->name, name))
-							break;
-
-						search++;
-					}
-
-					format += i;
-				}
-				else {
-					search = print;
-					while(search->ch != *format) {
-						if(search->callback == NULL)
-							throw("Invalid token '%c'.", *format);
-
-						search++;
-					}
-				}
-
+				search = print_parse(print, &format, &mod);
 				search->callback(output, &mod, args);
 			}
-			else 
+			else {
 				io_output_ch(output, '%');
-
-			format++;
+				format++;
+			}
 		}
 		else {
 			i = 0;
@@ -219,6 +340,237 @@ void io_vprintf_custom(struct io_output_t output, struct io_print_t *print, cons
 	}
 }
 
+/**
+ * Parse a single conversion specifier.
+ *   @print: The print callback table.
+ *   @format: The format reference, positioned after the '%'. On return, it
+ *     is positioned after the specifier.
+ *   @mod: Out. The modifiers.
+ *   &returns: The matching print callback.
+ */
+
+static struct io_print_t *print_parse(struct io_print_t *print, const char **format, struct io_print_mod_t *mod)
+{
+	size_t i;
+	const char *ptr = *format;
+	struct io_print_t *search;
+	char name[16];
+
+	if(*ptr == '-')
+		mod->neg = true, ptr++;
+	else
+		mod->neg = false;
+
+	if(*ptr == '0')
+		mod->zero = true, ptr++;
+	else
+		mod->zero = false;
+
+	mod->width = 0;
+	while(str_isdigit(*ptr))
+		mod->width = mod->width * 10 + *ptr - '0', ptr++;
+
+	if(*ptr == ':') {
+		ptr++;
+
+		for(i = 0; ptr[i] != ':'; i++) {
+			if(i == 15)
+				throw("Format name too long.");
+			else if(ptr[i] == '\0')
+				throw("Invalid format, no ending ':'.");
+		}
+
+		mem_copy(name, ptr, i);
+		name[i] = '\0';
+
+		search = print;
+		while(1) {
+			if(search->callback == NULL)
+				throw("Invalid token '%s'.", name);
+			if((search->name != NULL) && str_isequal(search->name, name))
+				break;
+
+			search++;
+		}
+
+		ptr += i;
+	}
+	else if(*ptr == '\0')
+		throw("Invalid format, missing conversion.");
+	else if(print == io_print_default) {
+		thread_once(&lookup_once, lookup_init);
+
+		search = lookup_default[(uint8_t)*ptr];
+		if(search == NULL)
+			throw("Invalid token '%c'.", *ptr);
+	}
+	else {
+		search = print;
+		while(search->ch != *ptr) {
+			if(search->callback == NULL)
+				throw("Invalid token '%c'.", *ptr);
+
+			search++;
+		}
+	}
+
+	*format = ptr + 1;
+
+	return search;
+}
+
+/**
+ * Initialize the direct lookup table for the default print callbacks.
+ */
+
+static void lookup_init()
+{
+	struct io_print_t *print;
+
+	for(print = io_print_default; print->callback != NULL; print++) {
+		if((print->ch != '\0') && (lookup_default[(uint8_t)print->ch] == NULL))
+			lookup_default[(uint8_t)print->ch] = print;
+	}
+}
+
+
+/**
+ * Compile a format string using the default print callbacks.
+ *   @format: The print-style format.
+ *   &returns: The compiled format.
+ */
+
+_export
+struct io_fmt_t *io_fmt_new(const char *format)
+{
+	return io_fmt_custom(io_print_default, format);
+}
+
+/**
+ * Compile a format string using custom callbacks. The format string is
+ * parsed and every conversion is resolved once, so printing with the
+ * compiled format performs no parsing or table lookups.
+ *   @print: The print callback table. It must outlive the compiled format.
+ *   @format: The print-style format.
+ *   &returns: The compiled format.
+ */
+
+_export
+struct io_fmt_t *io_fmt_custom(struct io_print_t *print, const char *format)
+{
+	char *copy;
+	const char *ptr;
+	size_t len, nsegs = 0;
+	struct io_fmt_t *fmt;
+	struct io_fmt_seg_t *seg;
+	struct io_print_mod_t mod;
+
+	for(ptr = format; *ptr != '\0'; ptr++) {
+		if(*ptr == '%')
+			nsegs += 2, ptr++;
+
+		if(*ptr == '\0')
+			break;
+	}
+
+	nsegs++;
+	len = str_len(format);
+	fmt = mem_alloc(sizeof(struct io_fmt_t) + nsegs * sizeof(struct io_fmt_seg_t) + len + 1);
+	copy = (char *)&fmt->segs[nsegs];
+	mem_copy(copy, format, len + 1);
+
+	seg = fmt->segs;
+	ptr = copy;
+
+	try {
+		while(*ptr != '\0') {
+			if((ptr[0] == '%') && (ptr[1] != '%')) {
+				ptr++;
+				seg->str = NULL;
+				seg->callback = print_parse(print, &ptr, &mod)->callback;
+				seg->mod = mod;
+				seg++;
+			}
+			else if(ptr[0] == '%') {
+				seg->str = ptr;
+				seg->len = 1;
+				seg++;
+				ptr += 2;
+			}
+			else {
+				seg->str = ptr;
+				seg->len = 0;
+
+				while((ptr[seg->len] != '%') && (ptr[seg->len] != '\0'))
+					seg->len++;
+
+				ptr += seg->len;
+				seg++;
+			}
+		}
+	}
+	catch(e) {
+		mem_free(fmt);
+		throw("%s", e);
+	}
+
+	fmt->nsegs = seg - fmt->segs;
+
+	return fmt;
+}
+
+/**
+ * Delete a compiled format.
+ *   @fmt: The compiled format.
+ */
+
+_export
+void io_fmt_delete(struct io_fmt_t *fmt)
+{
+	mem_free(fmt);
+}
+
+/**
+ * Print using a compiled format.
+ *   @output: The output device.
+ *   @fmt: The compiled format.
+ *   @...: The print-style arguments.
+ */
+
+_export
+void io_fmt_printf(struct io_output_t output, const struct io_fmt_t *fmt, ...)
+{
+	struct arglist_t list;
+
+	va_start(list.args, fmt);
+	io_fmt_vprintf(output, fmt, &list);
+	va_end(list.args);
+}
+
+/**
+ * Print using a compiled format and an argument list.
+ *   @output: The output device.
+ *   @fmt: The compiled format.
+ *   @args: The print-style arguments.
+ */
+
+_export
+void io_fmt_vprintf(struct io_output_t output, const struct io_fmt_t *fmt, struct arglist_t *args)
+{
+	unsigned int i;
+	struct io_print_mod_t mod;
+	const struct io_fmt_seg_t *seg;
+
+	for(i = 0, seg = fmt->segs; i < fmt->nsegs; i++, seg++) {
+		if(seg->str != NULL)
+			io_output_write(output, seg->str, seg->len);
+		else {
+			mod = seg->mod;
+			seg->callback(output, &mod, args);
+		}
+	}
+}
+
 
 /**
  * Printf-style chunk output.
@@ -245,6 +597,19 @@ void io_printf_str(struct io_output_t output, struct io_print_mod_t *mod, struct
 	io_format_str(output, va_arg(list->args, const char *), mod->width, mod->neg, ' ');
 }
 
+/**
+ * Printf-style string slice output.
+ *   @device: The output device.
+ *   @mod: The modifier.
+ *   @args: The variable argument list with an upcoming slice.
+ */
+
+_export
+void io_printf_slice(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
+{
+	io_format_slice(output, va_arg(list->args, struct str_slice_t), mod->width, mod->neg, ' ');
+}
+
 /**
  * Printf-style integer output.
  *   @device: The output device.
@@ -255,7 +620,7 @@ void io_printf_str(struct io_output_t output, struct io_print_mod_t *mod, struct
 _export
 void io_printf_int(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
 {
-	io_format_int(output, va_arg(list->args, int), 10, mod->width, mod->zero);
+	io_format_int64(output, va_arg(list->args, int), mod->width, mod->neg, mod->zero);
 }
 
 /**
@@ -268,7 +633,7 @@ void io_printf_int(struct io_output_t output, struct io_print_mod_t *mod, struct
 _export
 void io_printf_uint(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
 {
-	io_format_uint(output, va_arg(list->args, unsigned int), 10, mod->width, mod->neg, mod->zero);
+	io_format_uint64(output, va_arg(list->args, unsigned int), 10, mod->width, mod->neg, mod->zero);
 }
 
 /**
@@ -281,7 +646,46 @@ void io_printf_uint(struct io_output_t output, struct io_print_mod_t *mod, struc
 _export
 void io_printf_hex(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
 {
-	io_format_uint(output, va_arg(list->args, unsigned int), 16, mod->width, mod->neg, mod->zero);
+	io_format_uint64(output, va_arg(list->args, unsigned int), 16, mod->width, mod->neg, mod->zero);
+}
+
+/**
+ * Printf-style 64-bit integer output.
+ *   @device: The output device.
+ *   @mod: The modifier.
+ *   @args: The variable argument list with an upcoming 64-bit integer.
+ */
+
+_export
+void io_printf_int64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
+{
+	io_format_int64(output, va_arg(list->args, int64_t), mod->width, mod->neg, mod->zero);
+}
+
+/**
+ * Printf-style 64-bit unsigned integer output.
+ *   @device: The output device.
+ *   @mod: The modifier.
+ *   @args: The variable argument list with an upcoming 64-bit integer.
+ */
+
+_export
+void io_printf_uint64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
+{
+	io_format_uint64(output, va_arg(list->args, uint64_t), 10, mod->width, mod->neg, mod->zero);
+}
+
+/**
+ * Printf-style 64-bit unsigned integer output in hexidecimal.
+ *   @device: The output device.
+ *   @mod: The modifier.
+ *   @args: The variable argument list with an upcoming 64-bit integer.
+ */
+
+_export
+void io_printf_hex64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
+{
+	io_format_uint64(output, va_arg(list->args, uint64_t), 16, mod->width, mod->neg, mod->zero);
 }
 
 /**
@@ -314,25 +718,19 @@ void io_printf_char(struct io_output_t output, struct io_print_mod_t *mod, struc
 }
 
 /**
- * Printf-style float output.
+ * Printf-style float output. The value is printed using a short
+ * representation that reads back exactly, usually the shortest.
  *   @device: The output device.
  *   @mod: The modifier.
  *   @args: The variable argument list with an upcoming string.
  */
 
-int sprintf(const char *restrict, const char *restrict, ...);
 _export
 void io_printf_float(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list)
 {
-	char format[10], str[20];
-
-	if(mod->width)
-		sprintf(format, "%%0%dg", mod->width);
-	else
-		sprintf(format, "%%g");
+	char buf[IO_CONV_MAX];
 
-	sprintf(str, format, va_arg(list->args, double));
-	io_print_str(output, str);
+	format_pad(output, buf, io_conv_double(buf, va_arg(list->args, double)), mod->width, mod->neg, mod->zero);
 }
 
 
@@ -381,25 +779,37 @@ void io_format_chunk(struct io_output_t output, struct io_chunk_t chunk, uint16_
 _export
 void io_format_str(struct io_output_t output, const char *str, uint16_t width, bool neg, char pad)
 {
-	size_t len;
+	io_format_slice(output, (struct str_slice_t){ str, str_len(str) }, width, neg, pad);
+}
 
-	len = str_len(str);
-	if(width > len) {
+/**
+ * Format a string slice.
+ *   @output: The output device.
+ *   @slice: The slice.
+ *   @width: The width.
+ *   @neg: Negative (left) alignment.
+ *   @pad: The padding character.
+ */
+
+_export
+void io_format_slice(struct io_output_t output, struct str_slice_t slice, uint16_t width, bool neg, char pad)
+{
+	if(width > slice.len) {
 		uint16_t i;
 
 		if(neg)
-			io_output_write(output, str, len);
+			io_output_write(output, slice.ptr, slice.len);
 
-		for(i = len; i < width; i++)
+		for(i = slice.len; i < width; i++)
 			io_output_ch(output, pad);
 
 		if(!neg)
-			io_output_write(output, str, len);
+			io_output_write(output, slice.ptr, slice.len);
 	}
 	else if(width > 0)
-		io_output_write(output, str, width);
+		io_output_write(output, slice.ptr, width);
 	else
-		io_output_write(output, str, len);
+		io_output_write(output, slice.ptr, slice.len);
 }
 
 /**
@@ -414,17 +824,17 @@ void io_format_str(struct io_output_t output, const char *str, uint16_t width, b
 _export
 void io_format_int(struct io_output_t output, int value, uint8_t base, int16_t width, bool pad)
 {
-	if(value < 0) {
-		char neg = '-';
+	char buf[66];
 
-		if(width > 0)
-			width--;
+	if(width < 0)
+		width = 0;
 
-		value = -value;
-		io_output_write(output, &neg, 1);
+	if(value < 0) {
+		buf[0] = '-';
+		format_pad(output, buf, conv_base(buf + 1, -(uint64_t)value, base) + 1, width, false, pad);
 	}
-
-	io_format_uint(output, value, base, width, false, pad);
+	else
+		format_pad(output, buf, conv_base(buf, value, base), width, false, pad);
 }
 
 /**
@@ -440,36 +850,546 @@ void io_format_int(struct io_output_t output, int value, uint8_t base, int16_t w
 _export
 void io_format_uint(struct io_output_t output, unsigned int value, uint8_t base, int16_t width, bool neg, bool pad)
 {
-	uint8_t i = 0;
-	uint16_t len = m_uint16max(width, 19);
-	char buf[len];
+	if(width < 0)
+		width = 0;
+
+	io_format_uint64(output, value, base, width, neg, pad);
+}
+
+/**
+ * Format a signed 64-bit decimal integer.
+ *   @output: The output device.
+ *   @value: The value.
+ *   @width: The width.
+ *   @neg: Negative alignment.
+ *   @pad: Zero padding.
+ */
+
+_export
+void io_format_int64(struct io_output_t output, int64_t value, uint16_t width, bool neg, bool pad)
+{
+	char buf[IO_CONV_MAX];
+
+	format_pad(output, buf, io_conv_int64(buf, value), width, neg, pad);
+}
+
+/**
+ * Format an unsigned 64-bit integer.
+ *   @output: The output device.
+ *   @value: The value.
+ *   @base: The base, between 2 and 36.
+ *   @width: The width.
+ *   @neg: Negative alignment.
+ *   @pad: Zero padding.
+ */
+
+_export
+void io_format_uint64(struct io_output_t output, uint64_t value, uint8_t base, uint16_t width, bool neg, bool pad)
+{
+	char buf[64];
+
+	format_pad(output, buf, conv_base(buf, value, base), width, neg, pad);
+}
+
+/**
+ * Convert an unsigned integer to digits in any base.
+ *   @buf: The buffer, at least 64 bytes.
+ *   @value: The value.
+ *   @base: The base, between 2 and 36.
+ *   &returns: The number of digits written.
+ */
+
+static size_t conv_base(char *buf, uint64_t value, uint8_t base)
+{
+	size_t len;
+	char tmp[64], *ptr = tmp + sizeof(tmp);
+
+	if(base == 10)
+		return io_conv_uint64(buf, value);
+	else if(base == 16)
+		return io_conv_hex64(buf, value);
 
 	do {
-		uint8_t val;
+		uint8_t digit = value % base;
 
-		val = value % base;
-		buf[len - ++i] = val + ((val < 10) ? '0' : ('a' - 10));
+		*--ptr = digit + ((digit < 10) ? '0' : ('a' - 10));
 	} while((value /= base) > 0);
 
-	if(!neg) {
-		while(i < width)
-			buf[len - ++i] = pad ? '0' : ' ';
+	len = tmp + sizeof(tmp) - ptr;
+	mem_copy(buf, ptr, len);
+
+	return len;
+}
+
+/**
+ * Write a converted number with padding. Zero padding is inserted after any
+ * sign, space padding before it; left alignment always pads with spaces.
+ *   @output: The output device.
+ *   @str: The converted number.
+ *   @len: The length.
+ *   @width: The field width.
+ *   @neg: Negative (left) alignment.
+ *   @zero: Zero padding.
+ */
+
+static void format_pad(struct io_output_t output, const char *str, size_t len, uint16_t width, bool neg, bool zero)
+{
+	char pad[64];
+	size_t n;
 
-		io_output_write(output, buf + len - i, width ?: i);
+	if(width <= len) {
+		io_output_write(output, str, len);
+		return;
 	}
-	else {
-		io_output_write(output, buf + len - i, (i <= width) ? i : width);
 
-		if(width > i) {
-			uint8_t rem = width - i;
+	n = width - len;
+	mem_set(pad, (zero && !neg) ? '0' : ' ', m_sizemin(n, sizeof(pad)));
 
-			while(i < width)
-				buf[len - ++i] = ' ';
+	if(neg)
+		io_output_write(output, str, len);
+	else if(zero && (len > 0) && (*str == '-'))
+		io_output_write(output, str, 1), str++, len--;
 
-			io_output_write(output, buf + len - i, rem);
+	for(; n > sizeof(pad); n -= sizeof(pad))
+		io_output_write(output, pad, sizeof(pad));
+
+	io_output_write(output, pad, n);
+
+	if(!neg)
+		io_output_write(output, str, len);
+}
+
+
+/**
+ * Count the decimal digits of a 32-bit integer.
+ *   @value: The value.
+ *   &returns: The number of digits.
+ */
+
+static unsigned int digits32(uint32_t value)
+{
+	unsigned int n = 1;
+
+	while(true) {
+		if(value < 10)
+			return n;
+		else if(value < 100)
+			return n + 1;
+		else if(value < 1000)
+			return n + 2;
+		else if(value < 10000)
+			return n + 3;
+
+		value /= 10000;
+		n += 4;
+	}
+}
+
+/**
+ * Count the decimal digits of a 64-bit integer.
+ *   @value: The value.
+ *   &returns: The number of digits.
+ */
+
+static unsigned int digits64(uint64_t value)
+{
+	unsigned int n = 1;
+
+	while(true) {
+		if(value < 10)
+			return n;
+		else if(value < 100)
+			return n + 1;
+		else if(value < 1000)
+			return n + 2;
+		else if(value < 10000)
+			return n + 3;
+
+		value /= 10000;
+		n += 4;
+	}
+}
+
+/**
+ * Convert an unsigned 32-bit integer to decimal, two digits at a time.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_uint32(char *buf, uint32_t value)
+{
+	unsigned int idx, len = digits32(value);
+	char *ptr = buf + len;
+
+	while(value >= 100) {
+		idx = (value % 100) * 2;
+		value /= 100;
+		*--ptr = digit_pairs[idx + 1];
+		*--ptr = digit_pairs[idx];
+	}
+
+	if(value >= 10) {
+		*--ptr = digit_pairs[value * 2 + 1];
+		*--ptr = digit_pairs[value * 2];
+	}
+	else
+		*--ptr = '0' + value;
+
+	return len;
+}
+
+/**
+ * Convert an unsigned 64-bit integer to decimal, two digits at a time.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_uint64(char *buf, uint64_t value)
+{
+	unsigned int idx, len;
+	char *ptr;
+
+	if(value <= UINT32_MAX)
+		return io_conv_uint32(buf, value);
+
+	len = digits64(value);
+	ptr = buf + len;
+
+	while(value >= 100) {
+		idx = (value % 100) * 2;
+		value /= 100;
+		*--ptr = digit_pairs[idx + 1];
+		*--ptr = digit_pairs[idx];
+	}
+
+	if(value >= 10) {
+		*--ptr = digit_pairs[value * 2 + 1];
+		*--ptr = digit_pairs[value * 2];
+	}
+	else
+		*--ptr = '0' + value;
+
+	return len;
+}
+
+/**
+ * Convert a signed 32-bit integer to decimal.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_int32(char *buf, int32_t value)
+{
+	if(value >= 0)
+		return io_conv_uint32(buf, value);
+
+	*buf = '-';
+
+	return io_conv_uint32(buf + 1, -(uint32_t)value) + 1;
+}
+
+/**
+ * Convert a signed 64-bit integer to decimal.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_int64(char *buf, int64_t value)
+{
+	if(value >= 0)
+		return io_conv_uint64(buf, value);
+
+	*buf = '-';
+
+	return io_conv_uint64(buf + 1, -(uint64_t)value) + 1;
+}
+
+/**
+ * Convert an unsigned 64-bit integer to lowercase hexadecimal.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_hex64(char *buf, uint64_t value)
+{
+	unsigned int len = (64 - __builtin_clzll(value | 1) + 3) / 4;
+	char *ptr = buf + len;
+
+	do {
+		*--ptr = digit_hex[value & 0xf];
+		value >>= 4;
+	} while(ptr != buf);
+
+	return len;
+}
+
+/**
+ * Convert a double to a decimal string that reads back to the same value,
+ * using the Grisu2 algorithm. The digits always round-trip and are the
+ * shortest possible for the vast majority of inputs; in rare cases one digit
+ * more is produced. Numbers with a decimal exponent
+ * between -6 and 21 are written positionally, others in exponent form.
+ *   @buf: The output buffer, at least 'IO_CONV_MAX' bytes. Not terminated.
+ *   @value: The value.
+ *   &returns: The number of characters written.
+ */
+
+_export
+size_t io_conv_double(char *buf, double value)
+{
+	int len, k;
+	size_t sign = 0;
+
+	if(isnan(value)) {
+		mem_copy(buf, "nan", 3);
+
+		return 3;
+	}
+
+	if(signbit(value)) {
+		*buf++ = '-';
+		value = -value;
+		sign = 1;
+	}
+
+	if(isinf(value)) {
+		mem_copy(buf, "inf", 3);
+
+		return sign + 3;
+	}
+	else if(value == 0.0) {
+		*buf = '0';
+
+		return sign + 1;
+	}
+
+	grisu2(value, buf, &len, &k);
+
+	return sign + prettify(buf, len, k);
+}
+
+
+/**
+ * Subtract two floating-point values of the same exponent.
+ *   @a: The first value.
+ *   @b: The second value.
+ *   &returns: The difference.
+ */
+
+static inline struct diyfp_t diyfp_sub(struct diyfp_t a, struct diyfp_t b)
+{
+	return (struct diyfp_t){ a.f - b.f, a.e };
+}
+
+/**
+ * Multiply two floating-point values, rounding the product.
+ *   @a: The first value.
+ *   @b: The second value.
+ *   &returns: The product.
+ */
+
+static inline struct diyfp_t diyfp_mul(struct diyfp_t a, struct diyfp_t b)
+{
+	uint64_t h, l;
+
+	l = m_uint64mul(a.f, b.f, &h);
+
+	if(l & (UINT64_C(1) << 63))
+		h++;
+
+	return (struct diyfp_t){ h, a.e + b.e + 64 };
+}
+
+/**
+ * Normalize a floating-point value so its highest bit is set.
+ *   @v: The value.
+ *   &returns: The normalized value.
+ */
+
+static inline struct diyfp_t diyfp_norm(struct diyfp_t v)
+{
+	int s = __builtin_clzll(v.f);
+
+	return (struct diyfp_t){ v.f << s, v.e - s };
+}
+
+/**
+ * Round the last digit of a Grisu result towards the exact value.
+ *   @buf: The digit buffer.
+ *   @len: The number of digits.
+ *   @delta: The width of the rounding interval.
+ *   @rest: The remainder.
+ *   @ten_kappa: The current power of ten.
+ *   @wp_w: The distance to the upper boundary.
+ */
+
+static inline void grisu_round(char *buf, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+	while((rest < wp_w) && ((delta - rest) >= ten_kappa) && (((rest + ten_kappa) < wp_w) || ((wp_w - rest) > (rest + ten_kappa - wp_w)))) {
+		buf[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+/**
+ * Generate round-trip digits for a positive, finite double, usually the
+ * shortest.
+ *   @value: The value.
+ *   @buf: The digit buffer.
+ *   @len: Out. The number of digits.
+ *   @k: Out. The decimal exponent of the last digit.
+ */
+
+static void grisu2(double value, char *buf, int *len, int *k)
+{
+	int kappa, s, idx;
+	uint32_t p1, d;
+	uint64_t bits, p2, delta, tmp;
+	struct diyfp_t v, pl, mi, c, w, wp, wm, one, wp_w;
+	double dk;
+
+	mem_copy(&bits, &value, sizeof(double));
+
+	if(bits & UINT64_C(0x7FF0000000000000))
+		v = (struct diyfp_t){ (bits & UINT64_C(0x000FFFFFFFFFFFFF)) + (UINT64_C(1) << 52), (int)((bits & UINT64_C(0x7FF0000000000000)) >> 52) - 1075 };
+	else
+		v = (struct diyfp_t){ bits & UINT64_C(0x000FFFFFFFFFFFFF), -1074 };
+
+	pl = (struct diyfp_t){ (v.f << 1) + 1, v.e - 1 };
+	while(!(pl.f & (UINT64_C(1) << 53)))
+		pl.f <<= 1, pl.e--;
+
+	pl.f <<= 10;
+	pl.e -= 10;
+
+	if(v.f == (UINT64_C(1) << 52))
+		mi = (struct diyfp_t){ (v.f << 2) - 1, v.e - 2 };
+	else
+		mi = (struct diyfp_t){ (v.f << 1) - 1, v.e - 1 };
+
+	mi.f <<= mi.e - pl.e;
+	mi.e = pl.e;
+
+	dk = (-61 - pl.e) * 0.30102999566398114 + 347;
+	s = (int)dk;
+	if((dk - s) > 0.0)
+		s++;
+
+	idx = (s >> 3) + 1;
+	*k = -(-348 + idx * 8);
+	c = (struct diyfp_t){ cached_f[idx], cached_e[idx] };
+
+	w = diyfp_mul(diyfp_norm(v), c);
+	wp = diyfp_mul(pl, c);
+	wm = diyfp_mul(mi, c);
+	wm.f++;
+	wp.f--;
+
+	delta = wp.f - wm.f;
+	one = (struct diyfp_t){ UINT64_C(1) << -wp.e, wp.e };
+	wp_w = diyfp_sub(wp, w);
+	p1 = wp.f >> -one.e;
+	p2 = wp.f & (one.f - 1);
+	kappa = digits32(p1);
+	*len = 0;
+
+	while(kappa > 0) {
+		d = p1 / pow10_32[kappa - 1];
+		p1 %= pow10_32[kappa - 1];
+
+		if(d || *len)
+			buf[(*len)++] = '0' + d;
+
+		kappa--;
+		tmp = ((uint64_t)p1 << -one.e) + p2;
+		if(tmp <= delta) {
+			*k += kappa;
+			grisu_round(buf, *len, delta, tmp, (uint64_t)pow10_32[kappa] << -one.e, wp_w.f);
+
+			return;
+		}
+	}
+
+	while(true) {
+		p2 *= 10;
+		delta *= 10;
+		d = p2 >> -one.e;
+
+		if(d || *len)
+			buf[(*len)++] = '0' + d;
+
+		p2 &= one.f - 1;
+		kappa--;
+		if(p2 < delta) {
+			*k += kappa;
+			grisu_round(buf, *len, delta, p2, one.f, wp_w.f * ((-kappa < 10) ? pow10_32[-kappa] : 0));
+
+			return;
 		}
 	}
 }
 
-//_export
-//void io_format_float(struct io_output_t output, float value, 
+/**
+ * Lay out Grisu digits as a decimal or exponent string.
+ *   @buf: The digit buffer, rewritten in place.
+ *   @len: The number of digits.
+ *   @k: The decimal exponent of the last digit.
+ *   &returns: The final length.
+ */
+
+static size_t prettify(char *buf, int len, int k)
+{
+	int i, kk = len + k, exp;
+
+	if((len <= kk) && (kk <= 21)) {
+		for(i = len; i < kk; i++)
+			buf[i] = '0';
+
+		return kk;
+	}
+	else if((0 < kk) && (kk <= 21)) {
+		mem_move(buf + kk + 1, buf + kk, len - kk);
+		buf[kk] = '.';
+
+		return len + 1;
+	}
+	else if((-6 < kk) && (kk <= 0)) {
+		mem_move(buf + 2 - kk, buf, len);
+		buf[0] = '0';
+		buf[1] = '.';
+		for(i = 2; i < 2 - kk; i++)
+			buf[i] = '0';
+
+		return len + 2 - kk;
+	}
+
+	if(len > 1) {
+		mem_move(buf + 2, buf + 1, len - 1);
+		buf[1] = '.';
+		len++;
+	}
+
+	exp = kk - 1;
+	buf[len++] = 'e';
+	buf[len++] = (exp < 0) ? '-' : '+';
+	if(exp < 0)
+		exp = -exp;
+
+	if(exp >= 100)
+		buf[len++] = '0' + exp / 100, exp %= 100;
+
+	buf[len++] = digit_pairs[exp * 2];
+	buf[len++] = digit_pairs[exp * 2 + 1];
+
+	return len;
+}
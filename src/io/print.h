@@ -19,6 +19,7 @@
  */
 
 struct io_chunk_t;
+struct io_fmt_t;
 
 
 /**
@@ -61,26 +62,61 @@ struct io_print_t {
  */
 
 void io_print_str(struct io_output_t output, const char *str);
+void io_print_slice(struct io_output_t output, struct str_slice_t slice);
 void io_print_int(struct io_output_t output, int value);
 void io_print_uint(struct io_output_t output, unsigned int value);
+void io_print_int64(struct io_output_t output, int64_t value);
+void io_print_uint64(struct io_output_t output, uint64_t value);
+void io_print_double(struct io_output_t output, double value);
 
 void io_printf(struct io_output_t output, const char *restrict format, ...);
 void io_vprintf(struct io_output_t output, const char *restrict format, va_list args);
 void io_vprintf_custom(struct io_output_t output, struct io_print_t *print, const char *format, struct arglist_t *args);
 
+struct io_fmt_t *io_fmt_new(const char *format);
+struct io_fmt_t *io_fmt_custom(struct io_print_t *print, const char *format);
+void io_fmt_delete(struct io_fmt_t *fmt);
+
+void io_fmt_printf(struct io_output_t output, const struct io_fmt_t *fmt, ...);
+void io_fmt_vprintf(struct io_output_t output, const struct io_fmt_t *fmt, struct arglist_t *args);
+
 void io_printf_chunk(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_str(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_slice(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_int(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_uint(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_hex(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_int64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_uint64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
+void io_printf_hex64(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_binary(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_char(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 void io_printf_float(struct io_output_t output, struct io_print_mod_t *mod, struct arglist_t *list);
 
 void io_format_chunk(struct io_output_t output, struct io_chunk_t chunk, uint16_t width, bool neg, char pad);
 void io_format_str(struct io_output_t output, const char *str, uint16_t width, bool neg, char pad);
+void io_format_slice(struct io_output_t output, struct str_slice_t slice, uint16_t width, bool neg, char pad);
 void io_format_int(struct io_output_t output, int value, uint8_t base, int16_t width, bool pad);
 void io_format_uint(struct io_output_t output, unsigned int value, uint8_t base, int16_t width, bool neg, bool pad);
+void io_format_int64(struct io_output_t output, int64_t value, uint16_t width, bool neg, bool pad);
+void io_format_uint64(struct io_output_t output, uint64_t value, uint8_t base, uint16_t width, bool neg, bool pad);
+
+/*
+ * conversion function declarations
+ */
+
+size_t io_conv_uint32(char *buf, uint32_t value);
+size_t io_conv_uint64(char *buf, uint64_t value);
+size_t io_conv_int32(char *buf, int32_t value);
+size_t io_conv_int64(char *buf, int64_t value);
+size_t io_conv_hex64(char *buf, uint64_t value);
+size_t io_conv_double(char *buf, double value);
+
+/*
+ * conversion definitions
+ */
+
+#define IO_CONV_MAX	32
 
 /*
  * convenience defintions
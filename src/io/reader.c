@@ -1,36 +1,46 @@
 #include "../common.h"
 #include "reader.h"
 #include "../debug/exception.h"
+#include "../math/func.h"
+#include "../mem/base.h"
 #include "../mem/manage.h"
-#include "../types/avltree.h"
 #include "defs.h"
 #include "input.h"
+#include <limits.h>
 
 
+/*
+ * local definitions
+ */
+
+#define STR_SHORT	256
+#define STR_CHUNK	4096
+#define WIN_SIZE	10
+
 /**
  * Reader structure.
  *   @input: The input device.
- *   @inst: The read instances.
+ *   @serial: The encoding.
+ *   @refs: The loaded instances, indexed by tag.
+ *   @count: The number of instances started.
+ *   @size: The capacity of the instance array.
+ *   @scope, depth, nscopes: The first tag of each open scope, the number of
+ *     open scopes, and the capacity of the scope stack.
+ *   @win: The read-ahead window, large enough for any varint.
+ *   @idx, avail: The window position and the number of bytes available.
  */
 
 struct io_reader_t {
 	struct io_input_t input;
+	enum io_serial_e serial;
 
-	struct avltree_node_t *inst;
-};
-
-/**
- * Loaded instance structure.
- *   @ref: The reference.
- *   @tag: The tag.
- *   @node: The node.
- */
+	uint8_t win[WIN_SIZE];
+	unsigned int idx, avail;
 
-struct inst_t {
-	void *ref;
-	unsigned int tag;
+	void **refs;
+	unsigned int count, size;
 
-	struct avltree_node_t node;
+	unsigned int *scope, depth, nscopes;
 };
 
 
@@ -38,26 +48,56 @@ struct inst_t {
  * local function declarations
  */
 
-static struct inst_t *inst_cast(struct avltree_node_t *node);
-static const struct inst_t *inst_cast_const(const struct avltree_node_t *node);
-static int inst_compare_key(const void *key, const struct avltree_node_t *node, void *arg);
-static int inst_compare_node(const struct avltree_node_t *n1, const struct avltree_node_t *n2, void *arg);
+static unsigned int tag_read(struct io_reader_t *reader);
+static void str_read(struct io_input_t input, char **str, size_t len);
+
+static struct io_input_t win_input(struct io_reader_t *reader);
+static bool win_ctrl(struct io_reader_t *reader, unsigned int id, void *data);
+static size_t win_read(struct io_reader_t *reader, void *restrict buf, size_t nbytes);
+static uint64_t win_varint(struct io_reader_t *reader);
+
+/*
+ * local variables
+ */
+
+static char unset;
+static struct io_input_i win_iface = { { (io_ctrl_f)win_ctrl, NULL }, (io_read_f)win_read };
 
 
 /**
- * Create a new I/O reader.
+ * Create a new I/O reader. The compact encoding requires the stream to start
+ * with the magic string and a supported format version. Varints are decoded
+ * from a small read-ahead window, so data following the serialized values
+ * should be read through 'io_reader_input' before deleting the reader.
  *   @input: The input device.
+ *   @serial: The encoding.
  *   &return: The reader.
  */
 
 _export
-struct io_reader_t *io_reader_new(struct io_input_t input)
+struct io_reader_t *io_reader_new(struct io_input_t input, enum io_serial_e serial)
 {
 	struct io_reader_t *reader;
 
+	if(serial == io_serial_compact_e) {
+		char magic[sizeof(IO_SERIAL_MAGIC) - 1];
+
+		io_input_readfull(input, magic, sizeof(magic));
+		if(!mem_isequal(magic, IO_SERIAL_MAGIC, sizeof(magic)))
+			throw("Invalid serialization header.");
+
+		if(io_input_varint(input) != IO_SERIAL_VERSION)
+			throw("Unsupported serialization version.");
+	}
+
 	reader = mem_alloc(sizeof(struct io_reader_t));
 	reader->input = input;
-	reader->inst = NULL;
+	reader->serial = serial;
+	reader->idx = reader->avail = 0;
+	reader->refs = NULL;
+	reader->count = reader->size = 0;
+	reader->scope = NULL;
+	reader->depth = reader->nscopes = 0;
 
 	return reader;
 }
@@ -70,19 +110,20 @@ struct io_reader_t *io_reader_new(struct io_input_t input)
 _export
 void io_reader_delete(struct io_reader_t *reader)
 {
-	struct avltree_iter_t iter;
-	struct avltree_node_t *node;
+	if(reader->refs != NULL)
+		mem_free(reader->refs);
 
-	iter = avltree_node_iter_begin(reader->inst);
-	while((node = avltree_node_iter_next_depth(&iter)) != NULL)
-		mem_free(inst_cast(node));
+	if(reader->scope != NULL)
+		mem_free(reader->scope);
 
 	mem_free(reader);
 }
 
 
 /**
- * Retrieve the associated input device.
+ * Retrieve the associated input device. The reader reads ahead of the values
+ * it decodes, so the returned input first yields any bytes left in the
+ * read-ahead window.
  *   @reader: The reader.
  *   &returns: The input device.
  */
@@ -90,12 +131,14 @@ void io_reader_delete(struct io_reader_t *reader)
 _export
 struct io_input_t io_reader_input(struct io_reader_t *reader)
 {
-	return reader->input;
+	return win_input(reader);
 }
 
 
 /**
- * Load a reference from the reader.
+ * Load a reference from the reader. Tags are issued sequentially by the
+ * writer, so instances are kept in an array indexed by tag. A nested instance
+ * completes before its parent, so slots may be filled out of order.
  *   @reader: The reader.
  *   @load: The load callback.
  *   &returns: The reference.
@@ -104,90 +147,340 @@ struct io_input_t io_reader_input(struct io_reader_t *reader)
 _export
 void *io_reader_load(struct io_reader_t *reader, io_load_f load, void *arg)
 {
+	void *ref;
 	unsigned int tag;
-	struct inst_t *inst;
 
-	tag = io_input_uint32(reader->input);
+	tag = tag_read(reader);
 	if(tag == 0) {
-		inst = mem_alloc(sizeof(struct inst_t));
-		inst->ref = load(reader, arg);
-		inst->tag = io_input_uint32(reader->input);
+		if(reader->count == reader->size) {
+			unsigned int i;
+
+			reader->size = reader->size ? (2 * reader->size) : 64;
+			reader->refs = mem_realloc(reader->refs, reader->size * sizeof(void *));
+
+			for(i = reader->count; i < reader->size; i++)
+				reader->refs[i] = &unset;
+		}
 
-		avltree_node_insert(&reader->inst, &inst->node, inst_compare_node, NULL);
+		reader->count++;
+		ref = load(reader, arg);
+
+		tag = tag_read(reader);
+		if((tag == 0) || (tag > reader->count) || (reader->refs[tag - 1] != &unset))
+			throw("Corrupt data.");
+
+		reader->refs[tag - 1] = ref;
 	}
 	else {
-		struct avltree_node_t *node;
-
-		node = avltree_node_lookup(reader->inst, &tag, inst_compare_key, NULL);
-		if(node == NULL)
+		if((tag > reader->count) || (reader->refs[tag - 1] == &unset))
 			throw("Corrupt data.");
 
-		inst = inst_cast(node);
+		ref = reader->refs[tag - 1];
+	}
+
+	return ref;
+}
+
+
+/**
+ * Begin a reader scope, matching a scope of the writer.
+ *   @reader: The reader.
+ */
+
+_export
+void io_reader_scope_begin(struct io_reader_t *reader)
+{
+	if(reader->depth == reader->nscopes) {
+		reader->nscopes = reader->nscopes ? (2 * reader->nscopes) : 8;
+		reader->scope = mem_realloc(reader->scope, reader->nscopes * sizeof(unsigned int));
 	}
 
-	return inst->ref;
+	reader->scope[reader->depth++] = reader->count;
+}
+
+/**
+ * End a reader scope. Instances loaded inside the scope can no longer be
+ * referenced and their tags are reused; the references themselves remain
+ * owned by the caller.
+ *   @reader: The reader.
+ */
+
+_export
+void io_reader_scope_end(struct io_reader_t *reader)
+{
+	unsigned int start;
+
+	if(reader->depth == 0)
+		throw("Unbalanced scope.");
+
+	start = reader->scope[--reader->depth];
+
+	while(reader->count > start)
+		reader->refs[--reader->count] = &unset;
 }
 
 
 /**
- * Cast a node to an instance.
- *   @node: The node.
- *   &returns: The instance.
+ * Read a boolean from the reader.
+ *   @reader: The reader.
+ *   &returns: The value.
  */
 
-static struct inst_t *inst_cast(struct avltree_node_t *node)
+_export
+bool io_reader_bool(struct io_reader_t *reader)
 {
-	return (void *)node - offsetof(struct inst_t, node);
+	return io_input_bool(win_input(reader));
 }
 
 /**
- * Cast a const node to an instance.
- *   @node: The node.
- *   &returns: The instance.
+ * Read an unsigned integer from the reader.
+ *   @reader: The reader.
+ *   &returns: The value.
  */
 
-static const struct inst_t *inst_cast_const(const struct avltree_node_t *node)
+_export
+uint64_t io_reader_uint64(struct io_reader_t *reader)
 {
-	return (void *)node - offsetof(struct inst_t, node);
+	if(reader->serial == io_serial_compact_e)
+		return win_varint(reader);
+	else
+		return io_input_uint64(win_input(reader));
 }
 
 /**
- * Coimpare instances by key.
- *   @key: The key.
- *   @node: The node.
- *   @arg: Unused argument.
- *   &returns: Their order.
+ * Read a signed integer from the reader.
+ *   @reader: The reader.
+ *   &returns: The value.
  */
 
-static int inst_compare_key(const void *key, const struct avltree_node_t *node, void *arg)
+_export
+int64_t io_reader_int64(struct io_reader_t *reader)
 {
-	const struct inst_t *inst = inst_cast_const(node);
-	unsigned int tag = *(unsigned int *)key;
+	if(reader->serial == io_serial_compact_e) {
+		uint64_t value;
+
+		value = win_varint(reader);
 
-	if(tag > inst->tag)
-		return 1;
-	else if(tag < inst->tag)
-		return -1;
+		return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+	}
 	else
-		return 0;
+		return io_input_uint64(win_input(reader));
 }
 
 /**
- * Coimpare instances by node.
- *   @n1: The first node.
- *   @n2: The second node.
- *   @arg: Unused argument.
- *   &returns: Their order.
+ * Read a double from the reader.
+ *   @reader: The reader.
+ *   &returns: The value.
  */
 
-static int inst_compare_node(const struct avltree_node_t *n1, const struct avltree_node_t *n2, void *arg)
+_export
+double io_reader_double(struct io_reader_t *reader)
 {
-	const struct inst_t *i1 = inst_cast_const(n1), *i2 = inst_cast_const(n2);
+	if(reader->serial == io_serial_compact_e) {
+		double value;
+		uint8_t buf[8];
+		unsigned int i;
+		uint64_t bits = 0;
+
+		io_input_readfull(win_input(reader), buf, sizeof(buf));
+		for(i = 0; i < 8; i++)
+			bits |= (uint64_t)buf[i] << (8 * i);
+
+		mem_copy(&value, &bits, sizeof(double));
 
-	if(i1->tag > i2->tag)
-		return 1;
-	else if(i1->tag < i2->tag)
-		return -1;
+		return value;
+	}
 	else
-		return 0;
+		return io_input_double(win_input(reader));
+}
+
+/**
+ * Read a string from the reader. The compact length prefix is untrusted, so
+ * storage grows with the data actually read rather than being allocated up
+ * front.
+ *   @reader: The reader.
+ *   &returns: The allocated string.
+ */
+
+_export
+char *io_reader_str(struct io_reader_t *reader)
+{
+	if(reader->serial == io_serial_compact_e) {
+		char *str;
+		uint64_t len;
+
+		len = win_varint(reader);
+		if(len >= SIZE_MAX)
+			throw("Corrupt data.");
+
+		if(len < STR_SHORT) {
+			char buf[STR_SHORT];
+
+			io_input_readfull(win_input(reader), buf, len);
+
+			str = mem_alloc(len + 1);
+			mem_copy(str, buf, len);
+			str[len] = '\0';
+
+			return str;
+		}
+
+		str = mem_alloc(m_sizemin(len, STR_CHUNK) + 1);
+
+		try
+			str_read(win_input(reader), &str, len);
+		catch(e) {
+			mem_free(str);
+			throw("%s", e);
+		}
+
+		str[len] = '\0';
+
+		return str;
+	}
+	else
+		return io_input_str(win_input(reader));
+}
+
+
+/**
+ * Read an instance tag.
+ *   @reader: The reader.
+ *   &returns: The tag.
+ */
+
+static unsigned int tag_read(struct io_reader_t *reader)
+{
+	if(reader->serial == io_serial_compact_e) {
+		uint64_t tag;
+
+		tag = win_varint(reader);
+		if(tag > UINT_MAX)
+			throw("Corrupt data.");
+
+		return tag;
+	}
+	else
+		return io_input_uint32(win_input(reader));
+}
+
+/**
+ * Read the characters of a compact string, doubling the storage as data
+ * arrives. Truncated input throws.
+ *   @input: The input device.
+ *   @str: Ref. The storage, initially 'STR_CHUNK' bytes or 'len' if smaller,
+ *     plus the terminator.
+ *   @len: The string length.
+ */
+
+static void str_read(struct io_input_t input, char **str, size_t len)
+{
+	size_t off = 0, cap = m_sizemin(len, STR_CHUNK);
+
+	while(true) {
+		io_input_readfull(input, *str + off, cap - off);
+		if(cap == len)
+			break;
+
+		off = cap;
+		cap = m_sizemin(len, 2 * cap);
+		*str = mem_realloc(*str, cap + 1);
+	}
+}
+
+
+/**
+ * Create an input that reads through the window of a reader.
+ *   @reader: The reader.
+ *   &returns: The input, valid while the reader exists.
+ */
+
+static struct io_input_t win_input(struct io_reader_t *reader)
+{
+	return (struct io_input_t){ reader, &win_iface };
+}
+
+/**
+ * Handle a control message to the window input.
+ *   @reader: The reader.
+ *   @id: The control identifier.
+ *   @data: The control data.
+ *   &returns: True if handled, false otherwise.
+ */
+
+static bool win_ctrl(struct io_reader_t *reader, unsigned int id, void *data)
+{
+	if((id == IO_CTRL_EOS) && (reader->avail > 0)) {
+		*(bool *)data = false;
+
+		return true;
+	}
+
+	return io_input_ctrl(reader->input, id, data);
+}
+
+/**
+ * Read through the window, draining any buffered bytes first.
+ *   @reader: The reader.
+ *   @buf: The buffer.
+ *   @nbytes: The number of bytes.
+ *   &returns: The number of bytes read.
+ */
+
+static size_t win_read(struct io_reader_t *reader, void *restrict buf, size_t nbytes)
+{
+	size_t size;
+
+	size = m_sizemin(nbytes, reader->avail);
+	mem_copy(buf, reader->win + reader->idx, size);
+	reader->idx += size;
+	reader->avail -= size;
+
+	if(size < nbytes)
+		size += io_input_read(reader->input, (uint8_t *)buf + size, nbytes - size);
+
+	return size;
+}
+
+/**
+ * Decode an unsigned LEB128 varint from the window. The window is topped up
+ * to its full size with a single read, so a varint normally costs one read
+ * of the input rather than one per byte.
+ *   @reader: The reader.
+ *   &returns: The value.
+ */
+
+static uint64_t win_varint(struct io_reader_t *reader)
+{
+	uint8_t byte;
+	size_t nbytes;
+	uint64_t value = 0;
+	unsigned int i = 0, shift = 0;
+
+	if(reader->idx > 0) {
+		mem_move(reader->win, reader->win + reader->idx, reader->avail);
+		reader->idx = 0;
+	}
+
+	do {
+		if(i == reader->avail) {
+			nbytes = io_input_read(reader->input, reader->win + i, WIN_SIZE - i);
+			if(nbytes == 0)
+				throw("Unable to read data from input.");
+
+			reader->avail += nbytes;
+		}
+
+		byte = reader->win[i++];
+		if((shift == 63) && (byte > 1))
+			throw("Invalid varint.");
+
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while(byte & 0x80);
+
+	reader->idx = i;
+	reader->avail -= i;
+
+	return value;
 }
@@ -28,13 +28,22 @@ typedef void *(*io_load_f)(struct io_reader_t *reader, void *arg);
  * reader function declarations
  */
 
-struct io_reader_t *io_reader_new(struct io_input_t input);
+struct io_reader_t *io_reader_new(struct io_input_t input, enum io_serial_e serial);
 void io_reader_delete(struct io_reader_t *reader);
 
 struct io_input_t io_reader_input(struct io_reader_t *reader);
 
 void *io_reader_load(struct io_reader_t *reader, io_load_f load, void *arg);
 
+void io_reader_scope_begin(struct io_reader_t *reader);
+void io_reader_scope_end(struct io_reader_t *reader);
+
+bool io_reader_bool(struct io_reader_t *reader);
+uint64_t io_reader_uint64(struct io_reader_t *reader);
+int64_t io_reader_int64(struct io_reader_t *reader);
+double io_reader_double(struct io_reader_t *reader);
+char *io_reader_str(struct io_reader_t *reader);
+
 /* %~shim.h% */
 
 /*
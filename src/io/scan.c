@@ -1,7 +1,8 @@
 #include "../common.h"
 #include "scan.h"
-#include <stdio.h>
+#include <limits.h>
 #include "../debug/exception.h"
+#include "../string/scan.h"
 #include "../types/strbuf.h"
 #include "input.h"
 
@@ -13,7 +14,7 @@ static int8_t convdigit(char ch)
 	else if((ch >= 'a') && (ch <= 'z'))
 		return ch - 'a' + 10;
 	else if((ch >= 'A') && (ch <= 'Z'))
-		return ch - 'a' + 10;
+		return ch - 'A' + 10;
 	return
 		-1;
 }
@@ -62,7 +63,8 @@ char *io_scan_str(struct io_input_t input)
 
 
 /**
- * Scan an unsigned long from an input.
+ * Scan an unsigned long from an input. A leading '0x' selects hexadecimal,
+ * '0b' binary, and '0' octal.
  *   @input: The input string.
  *   @ch: The buffered character.
  *   &returns: The unsigned long.
@@ -71,8 +73,11 @@ char *io_scan_str(struct io_input_t input)
 _export
 unsigned long io_scan_ulong(struct io_input_t input, char *ch)
 {
+	char buf[128];
+	unsigned int idx = 0;
 	int8_t val, base = 10;
-	unsigned long num = 0;
+	uint64_t num = 0;
+	bool ovf = false;
 
 	if(*ch == '\0') {
 		*ch = readdigit(input);
@@ -80,7 +85,7 @@ unsigned long io_scan_ulong(struct io_input_t input, char *ch)
 			throw("Unexpected end of input.");
 	}
 
-	if(!convdigit(*ch) == -1)
+	if((*ch < '0') || (*ch > '9'))
 		throw("Invalid number.");
 
 	if(*ch == '0') {
@@ -95,16 +100,26 @@ unsigned long io_scan_ulong(struct io_input_t input, char *ch)
 		}
 		else
 			base = 8;
-	}
 
-	while((val = convdigit(*ch)) != -1) {
-		if(val >= base)
-			break;
+		while(((val = convdigit(*ch)) != -1) && (val < base)) {
+			if(__builtin_mul_overflow(num, (uint64_t)base, &num) || __builtin_add_overflow(num, (uint64_t)val, &num))
+				ovf = true;
 
-		num = base * num + val;
-		*ch = readdigit(input);
+			*ch = readdigit(input);
+		}
+	}
+	else {
+		while((*ch >= '0') && (*ch <= '9')) {
+			buf_add(buf, &idx, *ch);
+			*ch = readdigit(input);
+		}
+
+		str_scan_uint64(buf, idx, &num, &ovf);
 	}
 
+	if(ovf || (num > ULONG_MAX))
+		throw("Value too large.");
+
 	return num;
 }
 
@@ -128,7 +143,7 @@ double io_scan_double(struct io_input_t input, char *ch)
 			throw("Unexpected end of input.");
 	}
 
-	if(*ch == '-') {
+	if((*ch == '-') || (*ch == '+')) {
 		buf_add(buf, &idx, *ch);
 		*ch = readdigit(input);
 	}
@@ -146,15 +161,22 @@ double io_scan_double(struct io_input_t input, char *ch)
 	}
 
 	if((*ch == 'e') || (*ch == 'E')) {
-		do {
+		buf_add(buf, &idx, *ch);
+		*ch = readdigit(input);
+
+		if((*ch == '-') || (*ch == '+')) {
 			buf_add(buf, &idx, *ch);
 			*ch = readdigit(input);
-		} while((*ch >= '0') && (*ch <= '9'));
-	}
+		}
 
-	buf_add(buf, &idx, '\0');
+		while((*ch >= '0') && (*ch <= '9')) {
+			buf_add(buf, &idx, *ch);
+			*ch = readdigit(input);
+		}
+	}
 
-	sscanf(buf, "%lf", &val);
+	if(str_scan_double(buf, idx, &val, NULL) == 0)
+		throw("Invalid number.");
 
 	return val;
 }
@@ -1,37 +1,54 @@
 #include "../common.h"
 #include "writer.h"
+#include "../debug/exception.h"
+#include "../mem/base.h"
 #include "../mem/manage.h"
-#include "../types/avltree.h"
+#include "../string/base.h"
 #include "defs.h"
 #include "output.h"
 
 
+/*
+ * local definitions
+ */
+
+#define TABLE_INIT	64
+
+/**
+ * Table entry structure.
+ *   @ref: The reference.
+ *   @tag: The tag, or zero if unused.
+ */
+
+struct entry_t {
+	void *ref;
+	unsigned int tag;
+};
+
 /**
  * Writer structure.
  *   @output: The output device.
+ *   @serial: The encoding.
  *   @tag: The current tag.
- *   @inst: The written instances.
+ *   @table: The open addressed table of written instances.
+ *   @mask: The table mask.
+ *   @refs, size: The written instances indexed by tag and its capacity.
+ *   @scope, depth, nscopes: The first tag of each open scope, the number of
+ *     open scopes, and the capacity of the scope stack.
  */
 
 struct io_writer_t {
 	struct io_output_t output;
+	enum io_serial_e serial;
 
 	unsigned int tag;
-	struct avltree_node_t *inst;
-};
+	struct entry_t *table;
+	size_t mask;
 
-/**
- * Loaded instance structure.
- *   @ref: The reference.
- *   @tag: The tag.
- *   @node: The node.
- */
-
-struct inst_t {
-	void *ref;
-	unsigned int tag;
+	void **refs;
+	unsigned int size;
 
-	struct avltree_node_t node;
+	unsigned int *scope, depth, nscopes;
 };
 
 
@@ -39,27 +56,43 @@ struct inst_t {
  * local function declarations
  */
 
-static struct inst_t *inst_cast(struct avltree_node_t *node);
-static const struct inst_t *inst_cast_const(const struct avltree_node_t *node);
-static int inst_compare_key(const void *key, const struct avltree_node_t *node, void *arg);
-static int inst_compare_node(const struct avltree_node_t *n1, const struct avltree_node_t *n2, void *arg);
+static size_t hash(const void *ref);
+static struct entry_t *probe(struct io_writer_t *writer, void *ref);
+static void grow(struct io_writer_t *writer);
+static void erase(struct io_writer_t *writer, struct entry_t *entry);
+
+static void tag_write(struct io_writer_t *writer, unsigned int tag);
 
 
 /**
- * Create a new I/O writer.
+ * Create a new I/O writer. The compact encoding starts the stream with a
+ * magic string and format version.
  *   @output: The output device.
+ *   @serial: The encoding.
  *   &return: The writer.
  */
 
 _export
-struct io_writer_t *io_writer_new(struct io_output_t output)
+struct io_writer_t *io_writer_new(struct io_output_t output, enum io_serial_e serial)
 {
 	struct io_writer_t *writer;
 
+	if(serial == io_serial_compact_e) {
+		io_output_writefull(output, IO_SERIAL_MAGIC, sizeof(IO_SERIAL_MAGIC) - 1);
+		io_output_varint(output, IO_SERIAL_VERSION);
+	}
+
 	writer = mem_alloc(sizeof(struct io_writer_t));
 	writer->output = output;
+	writer->serial = serial;
 	writer->tag = 1;
-	writer->inst = NULL;
+	writer->table = mem_alloc(TABLE_INIT * sizeof(struct entry_t));
+	writer->mask = TABLE_INIT - 1;
+	mem_zero(writer->table, TABLE_INIT * sizeof(struct entry_t));
+	writer->refs = NULL;
+	writer->size = 0;
+	writer->scope = NULL;
+	writer->depth = writer->nscopes = 0;
 
 	return writer;
 }
@@ -72,13 +105,13 @@ struct io_writer_t *io_writer_new(struct io_output_t output)
 _export
 void io_writer_delete(struct io_writer_t *writer)
 {
-	struct avltree_iter_t iter;
-	struct avltree_node_t *node;
+	if(writer->refs != NULL)
+		mem_free(writer->refs);
 
-	iter = avltree_node_iter_begin(writer->inst);
-	while((node = avltree_node_iter_next(&iter)) != NULL)
-		mem_free(inst_cast(node));
+	if(writer->scope != NULL)
+		mem_free(writer->scope);
 
+	mem_free(writer->table);
 	mem_free(writer);
 }
 
@@ -106,85 +139,257 @@ struct io_output_t io_writer_output(struct io_writer_t *writer)
 _export
 void io_writer_save(struct io_writer_t *writer, void *ref, io_save_f save, void *arg)
 {
-	struct inst_t *inst;
-	struct avltree_node_t *node;
+	unsigned int tag;
+	struct entry_t *entry;
 
-	node = avltree_node_lookup(writer->inst, ref, inst_compare_key, NULL);
-	if(node == NULL) {
-		inst = mem_alloc(sizeof(struct inst_t));
-		inst->ref = ref;
-		inst->tag = writer->tag++;
+	entry = probe(writer, ref);
+	if(entry->tag == 0) {
+		if(writer->tag > (writer->mask + 1) / 2) {
+			grow(writer);
+			entry = probe(writer, ref);
+		}
 
-		avltree_node_insert(&writer->inst, &inst->node, inst_compare_node, NULL);
+		if(writer->tag > writer->size) {
+			writer->size = writer->size ? (2 * writer->size) : 64;
+			writer->refs = mem_realloc(writer->refs, writer->size * sizeof(void *));
+		}
 
-		io_output_uint32(writer->output, 0);
+		entry->ref = ref;
+		entry->tag = tag = writer->tag++;
+		writer->refs[tag - 1] = ref;
+
+		tag_write(writer, 0);
 		save(ref, writer, arg);
 	}
 	else
-		inst = inst_cast(node);
+		tag = entry->tag;
 
-	io_output_uint32(writer->output, inst->tag);
+	tag_write(writer, tag);
 }
 
 
 /**
- * Cast a node to an instance.
- *   @node: The node.
- *   &returns: The instance.
+ * Begin a writer scope. Instances first saved inside the scope are forgotten
+ * when it ends, so long streams of unshared records can be written with flat
+ * memory use. The reader must open and close its scopes at the same points.
+ *   @writer: The writer.
+ */
+
+_export
+void io_writer_scope_begin(struct io_writer_t *writer)
+{
+	if(writer->depth == writer->nscopes) {
+		writer->nscopes = writer->nscopes ? (2 * writer->nscopes) : 8;
+		writer->scope = mem_realloc(writer->scope, writer->nscopes * sizeof(unsigned int));
+	}
+
+	writer->scope[writer->depth++] = writer->tag;
+}
+
+/**
+ * End a writer scope, releasing every instance saved since it began. Later
+ * saves of those references are written out in full again.
+ *   @writer: The writer.
+ */
+
+_export
+void io_writer_scope_end(struct io_writer_t *writer)
+{
+	unsigned int start;
+
+	if(writer->depth == 0)
+		throw("Unbalanced scope.");
+
+	start = writer->scope[--writer->depth];
+
+	while(writer->tag > start)
+		erase(writer, probe(writer, writer->refs[--writer->tag - 1]));
+}
+
+
+/**
+ * Write a boolean to the writer.
+ *   @writer: The writer.
+ *   @value: The value.
+ */
+
+_export
+void io_writer_bool(struct io_writer_t *writer, bool value)
+{
+	io_output_bool(writer->output, value);
+}
+
+/**
+ * Write an unsigned integer to the writer.
+ *   @writer: The writer.
+ *   @value: The value.
+ */
+
+_export
+void io_writer_uint64(struct io_writer_t *writer, uint64_t value)
+{
+	if(writer->serial == io_serial_compact_e)
+		io_output_varint(writer->output, value);
+	else
+		io_output_uint64(writer->output, value);
+}
+
+/**
+ * Write a signed integer to the writer.
+ *   @writer: The writer.
+ *   @value: The value.
  */
 
-static struct inst_t *inst_cast(struct avltree_node_t *node)
+_export
+void io_writer_int64(struct io_writer_t *writer, int64_t value)
 {
-	return (void *)node - offsetof(struct inst_t, node);
+	if(writer->serial == io_serial_compact_e)
+		io_output_zigzag(writer->output, value);
+	else
+		io_output_uint64(writer->output, value);
 }
 
 /**
- * Cast a const node to an instance.
- *   @node: The node.
- *   &returns: The instance.
+ * Write a double to the writer. The compact encoding stores the IEEE 754 bits
+ * in little-endian order.
+ *   @writer: The writer.
+ *   @value: The value.
  */
 
-static const struct inst_t *inst_cast_const(const struct avltree_node_t *node)
+_export
+void io_writer_double(struct io_writer_t *writer, double value)
 {
-	return (void *)node - offsetof(struct inst_t, node);
+	if(writer->serial == io_serial_compact_e) {
+		uint64_t bits;
+		uint8_t buf[8];
+		unsigned int i;
+
+		mem_copy(&bits, &value, sizeof(uint64_t));
+		for(i = 0; i < 8; i++)
+			buf[i] = bits >> (8 * i);
+
+		io_output_writefull(writer->output, buf, sizeof(buf));
+	}
+	else
+		io_output_double(writer->output, value);
 }
 
 /**
- * Coimpare instances by key.
- *   @key: The key.
- *   @node: The node.
- *   @arg: Unused argument.
- *   &returns: Their order.
+ * Write a string to the writer.
+ *   @writer: The writer.
+ *   @str: The string.
  */
 
-static int inst_compare_key(const void *key, const struct avltree_node_t *node, void *arg)
+_export
+void io_writer_str(struct io_writer_t *writer, const char *str)
 {
-	const struct inst_t *inst = inst_cast_const(node);
+	if(writer->serial == io_serial_compact_e) {
+		size_t len;
 
-	if(key > inst->ref)
-		return 1;
-	else if(key < inst->ref)
-		return -1;
+		len = str_len(str);
+		io_output_varint(writer->output, len);
+		io_output_writefull(writer->output, str, len);
+	}
 	else
-		return 0;
+		io_output_str(writer->output, str);
 }
 
+
 /**
- * Coimpare instances by node.
- *   @n1: The first node.
- *   @n2: The second node.
- *   @arg: Unused argument.
- *   &returns: Their order.
+ * Hash a reference with a Fibonacci multiplier.
+ *   @ref: The reference.
+ *   &returns: The hash.
  */
 
-static int inst_compare_node(const struct avltree_node_t *n1, const struct avltree_node_t *n2, void *arg)
+static size_t hash(const void *ref)
 {
-	const struct inst_t *i1 = inst_cast_const(n1), *i2 = inst_cast_const(n2);
+	return ((uintptr_t)ref * UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+}
+
+/**
+ * Find the table entry for a reference, or the empty entry where it would be
+ * inserted.
+ *   @writer: The writer.
+ *   @ref: The reference.
+ *   &returns: The entry.
+ */
 
-	if(i1->ref > i2->ref)
-		return 1;
-	else if(i1->ref < i2->ref)
-		return -1;
+static struct entry_t *probe(struct io_writer_t *writer, void *ref)
+{
+	size_t i;
+
+	i = hash(ref);
+
+	while(true) {
+		i &= writer->mask;
+		if((writer->table[i].tag == 0) || (writer->table[i].ref == ref))
+			return &writer->table[i];
+
+		i++;
+	}
+}
+
+/**
+ * Remove an entry from the instance table, shifting back any later entries of
+ * the probe sequence so that lookups never stop early.
+ *   @writer: The writer.
+ *   @entry: The entry.
+ */
+
+static void erase(struct io_writer_t *writer, struct entry_t *entry)
+{
+	size_t i, j, k;
+
+	i = entry - writer->table;
+
+	for(j = (i + 1) & writer->mask; writer->table[j].tag != 0; j = (j + 1) & writer->mask) {
+		k = hash(writer->table[j].ref) & writer->mask;
+
+		if(((j > i) && ((k <= i) || (k > j))) || ((j < i) && (k <= i) && (k > j))) {
+			writer->table[i] = writer->table[j];
+			i = j;
+		}
+	}
+
+	writer->table[i].tag = 0;
+}
+
+/**
+ * Double the size of the instance table.
+ *   @writer: The writer.
+ */
+
+static void grow(struct io_writer_t *writer)
+{
+	size_t i, size;
+	struct entry_t *table;
+
+	table = writer->table;
+	size = writer->mask + 1;
+
+	writer->table = mem_alloc(2 * size * sizeof(struct entry_t));
+	writer->mask = 2 * size - 1;
+	mem_zero(writer->table, 2 * size * sizeof(struct entry_t));
+
+	for(i = 0; i < size; i++) {
+		if(table[i].tag != 0)
+			*probe(writer, table[i].ref) = table[i];
+	}
+
+	mem_free(table);
+}
+
+
+/**
+ * Write an instance tag.
+ *   @writer: The writer.
+ *   @tag: The tag.
+ */
+
+static void tag_write(struct io_writer_t *writer, unsigned int tag)
+{
+	if(writer->serial == io_serial_compact_e)
+		io_output_varint(writer->output, tag);
 	else
-		return 0;
+		io_output_uint32(writer->output, tag);
 }
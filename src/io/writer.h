@@ -28,13 +28,22 @@ typedef void (*io_save_f)(void *ref, struct io_writer_t *writer, void *arg);
  * writer function declarations
  */
 
-struct io_writer_t *io_writer_new(struct io_output_t output);
+struct io_writer_t *io_writer_new(struct io_output_t output, enum io_serial_e serial);
 void io_writer_delete(struct io_writer_t *writer);
 
 struct io_output_t io_writer_output(struct io_writer_t *writer);
 
 void io_writer_save(struct io_writer_t *writer, void *ref, io_save_f save, void *arg);
 
+void io_writer_scope_begin(struct io_writer_t *writer);
+void io_writer_scope_end(struct io_writer_t *writer);
+
+void io_writer_bool(struct io_writer_t *writer, bool value);
+void io_writer_uint64(struct io_writer_t *writer, uint64_t value);
+void io_writer_int64(struct io_writer_t *writer, int64_t value);
+void io_writer_double(struct io_writer_t *writer, double value);
+void io_writer_str(struct io_writer_t *writer, const char *str);
+
 /* %~shim.h% */
 
 /*
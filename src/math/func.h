@@ -80,6 +80,18 @@ static inline size_t m_sizemin(size_t a, size_t b)
 	return (a < b) ? a : b;
 }
 
+/**
+ * Unsigned 64-bit integer minimum.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   &returns: The minimum.
+ */
+
+static inline uint64_t m_uint64min(uint64_t a, uint64_t b)
+{
+	return (a < b) ? a : b;
+}
+
 
 /**
  * Unsinged integer count the number of leading zeros.
@@ -128,6 +140,97 @@ static inline double m_dblmin(double a, double b)
 	return (a < b) ? a : b;
 }
 
+/**
+ * Unsigned 64-bit integer full multiplication.
+ *   @a: The first parameter.
+ *   @b: The second peramater.
+ *   @hi: Out. The high 64 bits of the product.
+ *   &returns: The low 64 bits of the product.
+ */
+
+static inline uint64_t m_uint64mul(uint64_t a, uint64_t b, uint64_t *hi)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 p = (unsigned __int128)a * b;
+
+	*hi = p >> 64;
+
+	return p;
+#else
+	uint64_t ll, lh, hl, mid;
+
+	ll = (a & 0xffffffff) * (b & 0xffffffff);
+	lh = (a & 0xffffffff) * (b >> 32);
+	hl = (a >> 32) * (b & 0xffffffff);
+	mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+
+	*hi = (a >> 32) * (b >> 32) + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+	return (mid << 32) | (ll & 0xffffffff);
+#endif
+}
+
+/**
+ * Unsigned 128-bit by 64-bit integer division. The high half of the dividend
+ * must be less than the divisor so that the quotient fits in 64 bits.
+ *   @hi: The high 64 bits of the dividend.
+ *   @lo: The low 64 bits of the dividend.
+ *   @d: The divisor.
+ *   @rem: Optional. Out. The remainder.
+ *   &returns: The quotient.
+ */
+
+static inline uint64_t m_uint64div(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *rem)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 n = ((unsigned __int128)hi << 64) | lo;
+
+	if(rem != NULL)
+		*rem = n % d;
+
+	return n / d;
+#else
+	uint64_t dh, dl, nh, nl, qh, ql, r, un;
+	int s;
+
+	s = __builtin_clzll(d);
+	if(s > 0) {
+		d <<= s;
+		hi = (hi << s) | (lo >> (64 - s));
+		lo <<= s;
+	}
+
+	dh = d >> 32;
+	dl = d & 0xffffffff;
+	nh = lo >> 32;
+	nl = lo & 0xffffffff;
+
+	qh = hi / dh;
+	r = hi % dh;
+	while(((qh >> 32) != 0) || ((qh * dl) > ((r << 32) | nh))) {
+		qh--;
+		r += dh;
+		if((r >> 32) != 0)
+			break;
+	}
+
+	un = ((hi << 32) | nh) - qh * d;
+	ql = un / dh;
+	r = un % dh;
+	while(((ql >> 32) != 0) || ((ql * dl) > ((r << 32) | nl))) {
+		ql--;
+		r += dh;
+		if((r >> 32) != 0)
+			break;
+	}
+
+	if(rem != NULL)
+		*rem = (((un << 32) | nl) - ql * d) >> s;
+
+	return (qh << 32) | ql;
+#endif
+}
+
 /**
  * Double modulus operator.
  *   @a: The input value.
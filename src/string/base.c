@@ -1,9 +1,71 @@
 #include "../common.h"
 #include "base.h"
 #include <string.h>
+#include "../mem/base.h"
 #include "../mem/manage.h"
 #include "locale.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#	include <immintrin.h>
+#	define STR_X86 1
+#endif
+
+
+/*
+ * local definitions
+ */
+
+#define PAGE_SIZE	4096
+#define ONES	UINT64_C(0x0101010101010101)
+#define HIGHS	UINT64_C(0x8080808080808080)
+
+typedef uint64_t __attribute__((may_alias)) word_t;
+
+/**
+ * Character set bitmap. Bit 'c >> 4 & 7' of byte 'c >> 7 << 4 | c & 15' is set
+ * for every member 'c', so that both the scalar lookup and the nibble shuffle
+ * of the vector kernels use the same layout.
+ *   @map: The bitmap.
+ */
+
+struct set_t {
+	uint8_t map[32];
+};
+
+/**
+ * String kernel dispatch table.
+ *   @len: Compute the length.
+ *   @chrnul: Find a character or the terminator.
+ *   @pbrk: Find a set member or the terminator.
+ *   @diff: Find the first difference or terminator.
+ *   @diffi: Find the first case-insensitive difference or terminator.
+ */
+
+struct kern_t {
+	size_t (*len)(const char *str);
+	const char *(*chrnul)(const char *str, char ch);
+	const char *(*pbrk)(const char *str, const struct set_t *set);
+	size_t (*diff)(const char *s1, const char *s2);
+	size_t (*diffi)(const char *s1, const char *s2);
+};
+
+
+/*
+ * local function declarations
+ */
+
+static size_t swar_len(const char *str);
+static const char *swar_chrnul(const char *str, char ch);
+static const char *swar_pbrk(const char *str, const struct set_t *set);
+static size_t swar_diff(const char *s1, const char *s2);
+static size_t swar_diffi(const char *s1, const char *s2);
+
+/*
+ * local variables
+ */
+
+static struct kern_t kern = { swar_len, swar_chrnul, swar_pbrk, swar_diff, swar_diffi };
+
 
 /**
  * Determine the length of a string.
@@ -14,12 +76,7 @@
 _export
 size_t str_len(const char *str)
 {
-	const char *orig = str;
-
-	while(*str != '\0')
-		str++;
-
-	return str - orig;
+	return kern.len(str);
 }
 
 
@@ -83,7 +140,9 @@ bool str_isequal(const char *s1, const char *s2)
 _export
 bool str_isequali(const char *s1, const char *s2)
 {
-	return strcasecmp(s1, s2) == 0;
+	size_t i = kern.diffi(s1, s2);
+
+	return (s1[i] == '\0') && (s2[i] == '\0');
 }
 
 /**
@@ -96,12 +155,7 @@ bool str_isequali(const char *s1, const char *s2)
 _export
 bool str_isprefix(const char *str, const char *prefix)
 {
-	while(*prefix != '\0') {
-		if(*str++ != *prefix++)
-			return false;
-	}
-
-	return true;
+	return prefix[kern.diff(prefix, str)] == '\0';
 }
 
 /**
@@ -129,8 +183,7 @@ int str_cmp(const char *s1, const char *s2)
 _export
 char *str_chr(const char *str, char ch)
 {
-	while((*str != '\0') && (*str != ch))
-		str++;
+	str = kern.chrnul(str, ch);
 
 	return (*str == ch) ? (char *)str : NULL;
 }
@@ -181,19 +234,15 @@ char *str_str(const char *str, char *sub)
 _export
 char *str_pbrk(const char *str, const char *set)
 {
-	const char *ptr;
+	struct set_t map;
 
-	while(*str != '\0') {
-		for(ptr = set; *ptr != '\0'; ptr++) {
-			if(*str == *ptr)
-				break;
-		}
+	mem_zero(&map, sizeof(map));
+	map.map[0] = 1;
 
-		if(*str == *ptr)
-			break;
+	for(; *set != '\0'; set++)
+		map.map[((uint8_t)*set >> 7 << 4) | ((uint8_t)*set & 15)] |= 1 << (((uint8_t)*set >> 4) & 7);
 
-		str++;
-	}
+	str = kern.pbrk(str, &map);
 
 	return (*str != '\0') ? (char *)str : NULL;
 }
@@ -342,8 +391,573 @@ char *str_ltrimptr(const char *str)
 _export
 void str_longest(char *str, const char *sub)
 {
-	while(*str == *sub)
-		str++, sub++;
+	str[kern.diff(str, sub)] = '\0';
+}
+
+
+/**
+ * Check if a set bitmap contains a character.
+ *   @set: The set.
+ *   @ch: The character.
+ *   &returns: True if a member.
+ */
+
+static inline bool set_has(const struct set_t *set, uint8_t ch)
+{
+	return (set->map[(ch >> 7 << 4) | (ch & 15)] >> ((ch >> 4) & 7)) & 1;
+}
+
+/**
+ * Lowercase an ASCII character.
+ *   @ch: The character.
+ *   &returns: The lowercase character.
+ */
+
+static inline uint8_t lower(uint8_t ch)
+{
+	return ch | (((uint8_t)(ch - 'A') < 26) << 5);
+}
+
+/**
+ * Check if an unaligned read of a given width from both pointers stays on
+ * their current pages.
+ *   @s1: The first pointer.
+ *   @s2: The second pointer.
+ *   @width: The read width.
+ *   &returns: True if safe.
+ */
+
+static inline bool page_safe(const char *s1, const char *s2, size_t width)
+{
+	return (((uintptr_t)s1 & (PAGE_SIZE - 1)) <= (PAGE_SIZE - width)) && (((uintptr_t)s2 & (PAGE_SIZE - 1)) <= (PAGE_SIZE - width));
+}
+
+/**
+ * Check for a zero byte in a word.
+ *   @v: The word.
+ *   &returns: Non-zero if any byte is zero.
+ */
+
+static inline uint64_t swar_zero(uint64_t v)
+{
+	return (v - ONES) & ~v & HIGHS;
+}
+
+
+/**
+ * Compute a string length a word at a time. Reads are aligned so they never
+ * cross into an unmapped page.
+ *   @str: The string.
+ *   &returns: The length.
+ */
+
+static size_t swar_len(const char *str)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)7);
+
+	if(ptr != str) {
+		for(ptr = str; ((uintptr_t)ptr & 7) != 0; ptr++) {
+			if(*ptr == '\0')
+				return ptr - str;
+		}
+	}
+
+	while(!swar_zero(*(const word_t *)ptr))
+		ptr += 8;
+
+	while(*ptr != '\0')
+		ptr++;
+
+	return ptr - str;
+}
+
+/**
+ * Find a character or the terminator a word at a time.
+ *   @str: The string.
+ *   @ch: The character.
+ *   &returns: Pointer to the character or the terminator.
+ */
+
+static const char *swar_chrnul(const char *str, char ch)
+{
+	uint64_t v, rep = ONES * (uint8_t)ch;
+
+	for(; ((uintptr_t)str & 7) != 0; str++) {
+		if((*str == ch) || (*str == '\0'))
+			return str;
+	}
+
+	while(true) {
+		v = *(const word_t *)str;
+		if(swar_zero(v) | swar_zero(v ^ rep))
+			break;
+
+		str += 8;
+	}
+
+	while((*str != ch) && (*str != '\0'))
+		str++;
+
+	return str;
+}
+
+/**
+ * Find a member of a character set. The terminator must be a member.
+ *   @str: The string.
+ *   @set: The character set.
+ *   &returns: Pointer to the member.
+ */
+
+static const char *swar_pbrk(const char *str, const struct set_t *set)
+{
+	while(!set_has(set, *str))
+		str++;
+
+	return str;
+}
+
+/**
+ * Find the first index where two strings differ or the first ends, a word at
+ * a time where both reads stay on their pages.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+static size_t swar_diff(const char *s1, const char *s2)
+{
+	size_t i = 0;
+	uint64_t a, b;
+
+	while(true) {
+		if(page_safe(s1 + i, s2 + i, 8)) {
+			mem_copy(&a, s1 + i, 8);
+			mem_copy(&b, s2 + i, 8);
+			if(((a ^ b) == 0) && !swar_zero(a)) {
+				i += 8;
+				continue;
+			}
+		}
+
+		if((s1[i] != s2[i]) || (s1[i] == '\0'))
+			return i;
+
+		i++;
+	}
+}
+
+/**
+ * Find the first index where two strings differ ignoring ASCII case, or the
+ * first ends.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+static size_t swar_diffi(const char *s1, const char *s2)
+{
+	size_t i;
+
+	for(i = 0; (lower(s1[i]) == lower(s2[i])) && (s1[i] != '\0'); i++);
+
+	return i;
+}
+
+
+#if STR_X86
+
+/**
+ * Compute a string length sixteen bytes at a time.
+ *   @str: The string.
+ *   &returns: The length.
+ */
+
+__attribute__((target("sse2")))
+static size_t sse2_len(const char *str)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)15);
+	unsigned int mask;
+
+	mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)ptr), _mm_setzero_si128())) >> (str - ptr);
+	if(mask != 0)
+		return __builtin_ctz(mask);
 
-	*str = '\0';
+	do {
+		ptr += 16;
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)ptr), _mm_setzero_si128()));
+	} while(mask == 0);
+
+	return ptr - str + __builtin_ctz(mask);
+}
+
+/**
+ * Find a character or the terminator sixteen bytes at a time.
+ *   @str: The string.
+ *   @ch: The character.
+ *   &returns: Pointer to the character or the terminator.
+ */
+
+__attribute__((target("sse2")))
+static const char *sse2_chrnul(const char *str, char ch)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)15);
+	__m128i v, rep = _mm_set1_epi8(ch), zero = _mm_setzero_si128();
+	unsigned int mask;
+
+	v = _mm_load_si128((const __m128i *)ptr);
+	mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(v, rep))) >> (str - ptr);
+	if(mask != 0)
+		return str + __builtin_ctz(mask);
+
+	do {
+		ptr += 16;
+		v = _mm_load_si128((const __m128i *)ptr);
+		mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(v, rep)));
+	} while(mask == 0);
+
+	return ptr + __builtin_ctz(mask);
+}
+
+/**
+ * Find the first index where two strings differ or the first ends, sixteen
+ * bytes at a time.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+__attribute__((target("sse2")))
+static size_t sse2_diff(const char *s1, const char *s2)
+{
+	size_t i = 0;
+	unsigned int mask;
+	__m128i a, b;
+
+	while(true) {
+		if(page_safe(s1 + i, s2 + i, 16)) {
+			a = _mm_loadu_si128((const __m128i *)(s1 + i));
+			b = _mm_loadu_si128((const __m128i *)(s2 + i));
+			mask = (~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) | _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()))) & 0xFFFF;
+			if(mask != 0)
+				return i + __builtin_ctz(mask);
+
+			i += 16;
+		}
+		else if((s1[i] != s2[i]) || (s1[i] == '\0'))
+			return i;
+		else
+			i++;
+	}
+}
+
+/**
+ * Lowercase the ASCII letters of a vector.
+ *   @v: The vector.
+ *   &returns: The lowercase vector.
+ */
+
+__attribute__((target("sse2")))
+static inline __m128i sse2_lower(__m128i v)
+{
+	__m128i upper = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8(128 - 'A')), _mm_set1_epi8(-128 + 26));
+
+	return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+/**
+ * Find the first index where two strings differ ignoring ASCII case, or the
+ * first ends, sixteen bytes at a time.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+__attribute__((target("sse2")))
+static size_t sse2_diffi(const char *s1, const char *s2)
+{
+	size_t i = 0;
+	unsigned int mask;
+	__m128i a, b;
+
+	while(true) {
+		if(page_safe(s1 + i, s2 + i, 16)) {
+			a = _mm_loadu_si128((const __m128i *)(s1 + i));
+			b = _mm_loadu_si128((const __m128i *)(s2 + i));
+			mask = (~_mm_movemask_epi8(_mm_cmpeq_epi8(sse2_lower(a), sse2_lower(b))) | _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()))) & 0xFFFF;
+			if(mask != 0)
+				return i + __builtin_ctz(mask);
+
+			i += 16;
+		}
+		else if((lower(s1[i]) != lower(s2[i])) || (s1[i] == '\0'))
+			return i;
+		else
+			i++;
+	}
+}
+
+/**
+ * Match a vector against a character set using nibble shuffles over the
+ * set bitmap.
+ *   @v: The vector.
+ *   @lo: The bitmap for characters below 0x80.
+ *   @hi: The bitmap for characters from 0x80.
+ *   &returns: The match mask.
+ */
+
+__attribute__((target("ssse3")))
+static inline unsigned int ssse3_match(__m128i v, __m128i lo, __m128i hi)
+{
+	__m128i bits, sel, res;
+
+	bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	sel = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(7)));
+	res = _mm_or_si128(_mm_shuffle_epi8(lo, v), _mm_shuffle_epi8(hi, _mm_xor_si128(v, _mm_set1_epi8(-128))));
+
+	return ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(res, sel), _mm_setzero_si128())) & 0xFFFF;
+}
+
+/**
+ * Find a member of a character set sixteen bytes at a time. The terminator
+ * must be a member.
+ *   @str: The string.
+ *   @set: The character set.
+ *   &returns: Pointer to the member.
+ */
+
+__attribute__((target("ssse3")))
+static const char *ssse3_pbrk(const char *str, const struct set_t *set)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)15);
+	__m128i lo, hi;
+	unsigned int mask;
+
+	lo = _mm_loadu_si128((const __m128i *)set->map);
+	hi = _mm_loadu_si128((const __m128i *)(set->map + 16));
+
+	mask = ssse3_match(_mm_load_si128((const __m128i *)ptr), lo, hi) >> (str - ptr);
+	if(mask != 0)
+		return str + __builtin_ctz(mask);
+
+	do {
+		ptr += 16;
+		mask = ssse3_match(_mm_load_si128((const __m128i *)ptr), lo, hi);
+	} while(mask == 0);
+
+	return ptr + __builtin_ctz(mask);
+}
+
+
+/**
+ * Compute a string length thirty-two bytes at a time.
+ *   @str: The string.
+ *   &returns: The length.
+ */
+
+__attribute__((target("avx2")))
+static size_t avx2_len(const char *str)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)31);
+	uint32_t mask;
+
+	mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)ptr), _mm256_setzero_si256())) >> (str - ptr);
+	if(mask != 0)
+		return __builtin_ctz(mask);
+
+	do {
+		ptr += 32;
+		mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)ptr), _mm256_setzero_si256()));
+	} while(mask == 0);
+
+	return ptr - str + __builtin_ctz(mask);
+}
+
+/**
+ * Find a character or the terminator thirty-two bytes at a time.
+ *   @str: The string.
+ *   @ch: The character.
+ *   &returns: Pointer to the character or the terminator.
+ */
+
+__attribute__((target("avx2")))
+static const char *avx2_chrnul(const char *str, char ch)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)31);
+	__m256i v, rep = _mm256_set1_epi8(ch), zero = _mm256_setzero_si256();
+	uint32_t mask;
+
+	v = _mm256_load_si256((const __m256i *)ptr);
+	mask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, rep))) >> (str - ptr);
+	if(mask != 0)
+		return str + __builtin_ctz(mask);
+
+	do {
+		ptr += 32;
+		v = _mm256_load_si256((const __m256i *)ptr);
+		mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, rep)));
+	} while(mask == 0);
+
+	return ptr + __builtin_ctz(mask);
+}
+
+/**
+ * Find the first index where two strings differ or the first ends,
+ * thirty-two bytes at a time.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+__attribute__((target("avx2")))
+static size_t avx2_diff(const char *s1, const char *s2)
+{
+	size_t i = 0;
+	uint32_t mask;
+	__m256i a, b;
+
+	while(true) {
+		if(page_safe(s1 + i, s2 + i, 32)) {
+			a = _mm256_loadu_si256((const __m256i *)(s1 + i));
+			b = _mm256_loadu_si256((const __m256i *)(s2 + i));
+			mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) | (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, _mm256_setzero_si256()));
+			if(mask != 0)
+				return i + __builtin_ctz(mask);
+
+			i += 32;
+		}
+		else if((s1[i] != s2[i]) || (s1[i] == '\0'))
+			return i;
+		else
+			i++;
+	}
+}
+
+/**
+ * Lowercase the ASCII letters of a vector.
+ *   @v: The vector.
+ *   &returns: The lowercase vector.
+ */
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_lower(__m256i v)
+{
+	__m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), _mm256_add_epi8(v, _mm256_set1_epi8(128 - 'A')));
+
+	return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+/**
+ * Find the first index where two strings differ ignoring ASCII case, or the
+ * first ends, thirty-two bytes at a time.
+ *   @s1: The first string.
+ *   @s2: The second string.
+ *   &returns: The index.
+ */
+
+__attribute__((target("avx2")))
+static size_t avx2_diffi(const char *s1, const char *s2)
+{
+	size_t i = 0;
+	uint32_t mask;
+	__m256i a, b;
+
+	while(true) {
+		if(page_safe(s1 + i, s2 + i, 32)) {
+			a = _mm256_loadu_si256((const __m256i *)(s1 + i));
+			b = _mm256_loadu_si256((const __m256i *)(s2 + i));
+			mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(avx2_lower(a), avx2_lower(b))) | (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, _mm256_setzero_si256()));
+			if(mask != 0)
+				return i + __builtin_ctz(mask);
+
+			i += 32;
+		}
+		else if((lower(s1[i]) != lower(s2[i])) || (s1[i] == '\0'))
+			return i;
+		else
+			i++;
+	}
+}
+
+/**
+ * Match a vector against a character set using nibble shuffles over the
+ * set bitmap.
+ *   @v: The vector.
+ *   @lo: The bitmap for characters below 0x80, in both lanes.
+ *   @hi: The bitmap for characters from 0x80, in both lanes.
+ *   &returns: The match mask.
+ */
+
+__attribute__((target("avx2")))
+static inline uint32_t avx2_match(__m256i v, __m256i lo, __m256i hi)
+{
+	__m256i bits, sel, res;
+
+	bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	sel = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(7)));
+	res = _mm256_or_si256(_mm256_shuffle_epi8(lo, v), _mm256_shuffle_epi8(hi, _mm256_xor_si256(v, _mm256_set1_epi8(-128))));
+
+	return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(res, sel), _mm256_setzero_si256()));
+}
+
+/**
+ * Find a member of a character set thirty-two bytes at a time. The
+ * terminator must be a member.
+ *   @str: The string.
+ *   @set: The character set.
+ *   &returns: Pointer to the member.
+ */
+
+__attribute__((target("avx2")))
+static const char *avx2_pbrk(const char *str, const struct set_t *set)
+{
+	const char *ptr = (const char *)((uintptr_t)str & ~(uintptr_t)31);
+	__m256i lo, hi;
+	uint32_t mask;
+
+	lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->map));
+	hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(set->map + 16)));
+
+	mask = avx2_match(_mm256_load_si256((const __m256i *)ptr), lo, hi) >> (str - ptr);
+	if(mask != 0)
+		return str + __builtin_ctz(mask);
+
+	do {
+		ptr += 32;
+		mask = avx2_match(_mm256_load_si256((const __m256i *)ptr), lo, hi);
+	} while(mask == 0);
+
+	return ptr + __builtin_ctz(mask);
+}
+
+#endif
+
+/**
+ * Select the fastest string kernels supported by the processor. Until this
+ * runs, the portable word-at-a-time kernels are used.
+ */
+
+__attribute__((constructor))
+static void kern_init()
+{
+#if STR_X86
+	__builtin_cpu_init();
+
+	if(__builtin_cpu_supports("sse2")) {
+		kern.len = sse2_len;
+		kern.chrnul = sse2_chrnul;
+		kern.diff = sse2_diff;
+		kern.diffi = sse2_diffi;
+	}
+
+	if(__builtin_cpu_supports("ssse3"))
+		kern.pbrk = ssse3_pbrk;
+
+	if(__builtin_cpu_supports("avx2")) {
+		kern.len = avx2_len;
+		kern.chrnul = avx2_chrnul;
+		kern.pbrk = avx2_pbrk;
+		kern.diff = avx2_diff;
+		kern.diffi = avx2_diffi;
+	}
+#endif
 }
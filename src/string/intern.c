@@ -0,0 +1,344 @@
+#include "../common.h"
+#include "intern.h"
+#include "../mem/base.h"
+#include "../mem/manage.h"
+#include "../thread/lock.h"
+#include "base.h"
+
+
+/*
+ * local definitions
+ */
+
+#define ARENA_SIZE	4096
+#define TABLE_INIT	64
+
+/**
+ * Arena block structure.
+ *   @next: The previous block.
+ *   @data: The string storage.
+ */
+
+struct block_t {
+	struct block_t *next;
+	char data[];
+};
+
+/**
+ * Table entry structure.
+ *   @hash: The full hash.
+ *   @len: The string length.
+ *   @str: The canonical string, or null if unused.
+ */
+
+struct entry_t {
+	uint64_t hash;
+	size_t len;
+	const char *str;
+};
+
+/**
+ * Intern pool structure.
+ *   @table: The open addressed hash table.
+ *   @mask, count: The table mask and number of strings.
+ *   @block: The current arena block.
+ *   @idx, size: The used and total bytes of the current block.
+ */
+
+struct str_intern_t {
+	struct entry_t *table;
+	size_t mask, count;
+
+	struct block_t *block;
+	size_t idx, size;
+};
+
+
+/*
+ * implementation function declarations
+ */
+
+void *_impl_mem_alloc(size_t nbytes);
+void _impl_mem_free(void *ptr);
+
+/*
+ * local function declarations
+ */
+
+static uint64_t hash(struct str_slice_t slice);
+static struct entry_t *probe(struct str_intern_t *pool, struct str_slice_t slice, uint64_t hash);
+static void grow(struct str_intern_t *pool);
+static const char *store(struct str_intern_t *pool, struct str_slice_t slice);
+
+/*
+ * local variables
+ */
+
+static struct str_intern_t global_pool = { NULL, 0, 0, NULL, 0, 0 };
+static struct thread_mutex_t global_lock = THREAD_MUTEX_INIT;
+
+
+/**
+ * Create a new intern pool. Pools are not synchronized; the global pool used
+ * by 'str_intern' should be used when sharing between threads.
+ *   &returns: The pool.
+ */
+
+_export
+struct str_intern_t *str_intern_new()
+{
+	struct str_intern_t *pool;
+
+	pool = mem_alloc(sizeof(struct str_intern_t));
+	*pool = (struct str_intern_t){ NULL, 0, 0, NULL, 0, 0 };
+
+	return pool;
+}
+
+/**
+ * Delete an intern pool, invalidating all of its strings.
+ *   @pool: The pool.
+ */
+
+_export
+void str_intern_delete(struct str_intern_t *pool)
+{
+	struct block_t *block;
+
+	while(pool->block != NULL) {
+		block = pool->block;
+		pool->block = block->next;
+		_impl_mem_free(block);
+	}
+
+	if(pool->table != NULL)
+		_impl_mem_free(pool->table);
+
+	mem_free(pool);
+}
+
+
+/**
+ * Intern a string slice, returning the canonical copy. Two strings interned
+ * in the same pool are equal exactly when their pointers are equal.
+ *   @pool: The pool.
+ *   @slice: The string slice.
+ *   &returns: The canonical null-terminated string.
+ */
+
+_export
+const char *str_intern_add(struct str_intern_t *pool, struct str_slice_t slice)
+{
+	uint64_t h = hash(slice);
+	struct entry_t *entry;
+
+	if(pool->table == NULL)
+		grow(pool);
+
+	entry = probe(pool, slice, h);
+	if(entry->str != NULL)
+		return entry->str;
+
+	if(2 * (pool->count + 1) > (pool->mask + 1)) {
+		grow(pool);
+		entry = probe(pool, slice, h);
+	}
+
+	*entry = (struct entry_t){ h, slice.len, store(pool, slice) };
+	pool->count++;
+
+	return entry->str;
+}
+
+/**
+ * Find the canonical copy of a string without interning it.
+ *   @pool: The pool.
+ *   @slice: The string slice.
+ *   &returns: The canonical string, or null if never interned.
+ */
+
+_export
+const char *str_intern_find(struct str_intern_t *pool, struct str_slice_t slice)
+{
+	if(pool->table == NULL)
+		return NULL;
+
+	return probe(pool, slice, hash(slice))->str;
+}
+
+/**
+ * Retrieve the number of strings in a pool.
+ *   @pool: The pool.
+ *   &returns: The number of strings.
+ */
+
+_export
+size_t str_intern_count(struct str_intern_t *pool)
+{
+	return pool->count;
+}
+
+
+/**
+ * Intern a string in the global pool. Global strings live until the process
+ * exits.
+ *   @str: The string.
+ *   &returns: The canonical string.
+ */
+
+_export
+const char *str_intern(const char *str)
+{
+	return str_intern_slice((struct str_slice_t){ str, str_len(str) });
+}
+
+/**
+ * Intern a string slice in the global pool.
+ *   @slice: The string slice.
+ *   &returns: The canonical string.
+ */
+
+_export
+const char *str_intern_slice(struct str_slice_t slice)
+{
+	const char *str;
+
+	thread_mutex_lock(&global_lock);
+	str = str_intern_add(&global_pool, slice);
+	thread_mutex_unlock(&global_lock);
+
+	return str;
+}
+
+/**
+ * Find the canonical copy of a string in the global pool without interning
+ * it.
+ *   @slice: The string slice.
+ *   &returns: The canonical string, or null if never interned.
+ */
+
+_export
+const char *str_intern_lookup(struct str_slice_t slice)
+{
+	const char *str;
+
+	thread_mutex_lock(&global_lock);
+	str = str_intern_find(&global_pool, slice);
+	thread_mutex_unlock(&global_lock);
+
+	return str;
+}
+
+
+/**
+ * Hash a string slice using 64-bit FNV-1a.
+ *   @slice: The slice.
+ *   &returns: The hash.
+ */
+
+static uint64_t hash(struct str_slice_t slice)
+{
+	size_t i;
+	uint64_t h = UINT64_C(0xcbf29ce484222325);
+
+	for(i = 0; i < slice.len; i++)
+		h = (h ^ (uint8_t)slice.ptr[i]) * UINT64_C(0x100000001b3);
+
+	return h;
+}
+
+/**
+ * Probe the table for a slice.
+ *   @pool: The pool.
+ *   @slice: The slice.
+ *   @hash: The slice hash.
+ *   &returns: The matching entry, or the empty entry where it belongs.
+ */
+
+static struct entry_t *probe(struct str_intern_t *pool, struct str_slice_t slice, uint64_t hash)
+{
+	size_t i = hash & pool->mask;
+	struct entry_t *entry;
+
+	while(true) {
+		entry = &pool->table[i];
+		if(entry->str == NULL)
+			return entry;
+		else if((entry->hash == hash) && (entry->len == slice.len) && mem_isequal(entry->str, slice.ptr, slice.len))
+			return entry;
+
+		i = (i + 1) & pool->mask;
+	}
+}
+
+/**
+ * Double the size of the table, rehashing all entries.
+ *   @pool: The pool.
+ */
+
+static void grow(struct str_intern_t *pool)
+{
+	size_t i, j, n = pool->table ? 2 * (pool->mask + 1) : TABLE_INIT;
+	struct entry_t *table;
+
+	table = _impl_mem_alloc(n * sizeof(struct entry_t));
+	mem_zero(table, n * sizeof(struct entry_t));
+
+	if(pool->table != NULL) {
+		for(i = 0; i <= pool->mask; i++) {
+			if(pool->table[i].str == NULL)
+				continue;
+
+			for(j = pool->table[i].hash & (n - 1); table[j].str != NULL; j = (j + 1) & (n - 1));
+
+			table[j] = pool->table[i];
+		}
+
+		_impl_mem_free(pool->table);
+	}
+
+	pool->table = table;
+	pool->mask = n - 1;
+}
+
+/**
+ * Copy a string into the pool arena.
+ *   @pool: The pool.
+ *   @slice: The slice.
+ *   &returns: The null-terminated copy.
+ */
+
+static const char *store(struct str_intern_t *pool, struct str_slice_t slice)
+{
+	char *str;
+	struct block_t *block;
+
+	if((pool->idx + slice.len + 1) > pool->size) {
+		size_t size = (slice.len + 1 > ARENA_SIZE) ? (slice.len + 1) : ARENA_SIZE;
+
+		block = _impl_mem_alloc(sizeof(struct block_t) + size);
+
+		if((size == ARENA_SIZE) || (pool->block == NULL)) {
+			block->next = pool->block;
+			pool->block = block;
+			pool->idx = 0;
+			pool->size = size;
+		}
+		else {
+			block->next = pool->block->next;
+			pool->block->next = block;
+			str = block->data;
+			mem_copy(str, slice.ptr, slice.len);
+			str[slice.len] = '\0';
+
+			return str;
+		}
+	}
+
+	str = pool->block->data + pool->idx;
+	mem_copy(str, slice.ptr, slice.len);
+	str[slice.len] = '\0';
+	pool->idx += slice.len + 1;
+
+	return str;
+}
@@ -0,0 +1,37 @@
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct str_intern_t;
+
+/*
+ * string intern function declarations
+ */
+
+struct str_intern_t *str_intern_new();
+void str_intern_delete(struct str_intern_t *pool);
+
+const char *str_intern_add(struct str_intern_t *pool, struct str_slice_t slice);
+const char *str_intern_find(struct str_intern_t *pool, struct str_slice_t slice);
+size_t str_intern_count(struct str_intern_t *pool);
+
+const char *str_intern(const char *str);
+const char *str_intern_slice(struct str_slice_t slice);
+const char *str_intern_lookup(struct str_slice_t slice);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
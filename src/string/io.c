@@ -263,7 +263,8 @@ static bool ref_ctrl(char **ref, unsigned int cmd, void *arg)
 }
 
 /**
- * Read from a string reference.
+ * Read from a string reference. Only the bytes being read are scanned for the
+ * terminator, so reading a long string byte by byte stays linear.
  *   @ptr: The string reference.
  *   @buf: The buffer.
  *   @nbyts: The number of bytes.
@@ -271,11 +272,14 @@ static bool ref_ctrl(char **ref, unsigned int cmd, void *arg)
 
 static size_t ref_read(const char **ref, void *restrict buf, size_t nbytes)
 {
-	nbytes = m_sizemin(str_len(*ref), nbytes);
-	mem_copy(buf, *ref, nbytes);
-	*ref += nbytes;
+	size_t i;
 
-	return nbytes;
+	for(i = 0; (i < nbytes) && ((*ref)[i] != '\0'); i++)
+		((char *)buf)[i] = (*ref)[i];
+
+	*ref += i;
+
+	return i;
 }
 
 
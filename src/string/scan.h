@@ -20,6 +20,9 @@ unsigned long str_toulong(const char *str, char **endptr);
 double str_todouble(const char *str, char **endptr);
 bool str_endchk(const char *str);
 
+size_t str_scan_uint64(const char *buf, size_t len, uint64_t *val, bool *ovf);
+size_t str_scan_double(const char *buf, size_t len, double *val, bool *ovf);
+
 /* %~shim.h% */
 
 /*
@@ -0,0 +1,313 @@
+#include "../common.h"
+#include "slice.h"
+#include <string.h>
+#include "../mem/base.h"
+#include "../mem/manage.h"
+#include "base.h"
+#include "locale.h"
+
+
+/**
+ * Lowercase an ASCII character.
+ *   @ch: The character.
+ *   &returns: The lowercase character.
+ */
+
+static inline char lower(char ch)
+{
+	return ((ch >= 'A') && (ch <= 'Z')) ? (ch + 'a' - 'A') : ch;
+}
+
+
+/**
+ * Create a slice covering a null-terminated string.
+ *   @str: The string.
+ *   &returns: The slice.
+ */
+
+_export
+struct str_slice_t str_slice_from(const char *str)
+{
+	return (struct str_slice_t){ str, str_len(str) };
+}
+
+/**
+ * Retrieve a sub-slice, clamping the range to the slice.
+ *   @slice: The slice.
+ *   @off: The offset.
+ *   @len: The maximum length.
+ *   &returns: The sub-slice.
+ */
+
+_export
+struct str_slice_t str_slice_sub(struct str_slice_t slice, size_t off, size_t len)
+{
+	if(off > slice.len)
+		off = slice.len;
+
+	if(len > (slice.len - off))
+		len = slice.len - off;
+
+	return (struct str_slice_t){ slice.ptr + off, len };
+}
+
+/**
+ * Duplicate a slice into an allocated, null-terminated string.
+ *   @slice: The slice.
+ *   &returns: The allocated string.
+ */
+
+_export
+char *str_slice_dup(struct str_slice_t slice)
+{
+	char *str;
+
+	str = mem_alloc(slice.len + 1);
+	mem_copy(str, slice.ptr, slice.len);
+	str[slice.len] = '\0';
+
+	return str;
+}
+
+
+/**
+ * Determine if two slices are equal.
+ *   @s1: The first slice.
+ *   @s2: The second slice.
+ *   &returns: True if they are equal, false otherwise.
+ */
+
+_export
+bool str_slice_isequal(struct str_slice_t s1, struct str_slice_t s2)
+{
+	return (s1.len == s2.len) && (memcmp(s1.ptr, s2.ptr, s1.len) == 0);
+}
+
+/**
+ * Determine if two slices are equal without ASCII case sensitivity.
+ *   @s1: The first slice.
+ *   @s2: The second slice.
+ *   &returns: True if they are equal, false otherwise.
+ */
+
+_export
+bool str_slice_isequali(struct str_slice_t s1, struct str_slice_t s2)
+{
+	size_t i;
+
+	if(s1.len != s2.len)
+		return false;
+
+	for(i = 0; i < s1.len; i++) {
+		if(lower(s1.ptr[i]) != lower(s2.ptr[i]))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Determine if a slice begins with a prefix.
+ *   @slice: The slice.
+ *   @prefix: The prefix.
+ *   &returns: True if a prefix, false otherwise.
+ */
+
+_export
+bool str_slice_isprefix(struct str_slice_t slice, struct str_slice_t prefix)
+{
+	return (prefix.len <= slice.len) && (memcmp(slice.ptr, prefix.ptr, prefix.len) == 0);
+}
+
+/**
+ * Determine if a slice ends with a suffix.
+ *   @slice: The slice.
+ *   @suffix: The suffix.
+ *   &returns: True if a suffix, false otherwise.
+ */
+
+_export
+bool str_slice_issuffix(struct str_slice_t slice, struct str_slice_t suffix)
+{
+	return (suffix.len <= slice.len) && (memcmp(slice.ptr + slice.len - suffix.len, suffix.ptr, suffix.len) == 0);
+}
+
+/**
+ * Compare two slices lexicographically.
+ *   @s1: The first slice.
+ *   @s2: The second slice.
+ *   &returns: Their order.
+ */
+
+_export
+int str_slice_cmp(struct str_slice_t s1, struct str_slice_t s2)
+{
+	int cmp;
+
+	cmp = memcmp(s1.ptr, s2.ptr, (s1.len < s2.len) ? s1.len : s2.len);
+	if(cmp != 0)
+		return cmp;
+
+	return (s1.len > s2.len) - (s1.len < s2.len);
+}
+
+
+/**
+ * Search a slice for a character.
+ *   @slice: The slice.
+ *   @ch: The character.
+ *   &returns: Pointer to the first match if found, null otherwise.
+ */
+
+_export
+const char *str_slice_chr(struct str_slice_t slice, char ch)
+{
+	return memchr(slice.ptr, (uint8_t)ch, slice.len);
+}
+
+/**
+ * Search a slice for a character in reverse.
+ *   @slice: The slice.
+ *   @ch: The character.
+ *   &returns: Pointer to the last match if found, null otherwise.
+ */
+
+_export
+const char *str_slice_rchr(struct str_slice_t slice, char ch)
+{
+	const char *ptr = slice.ptr + slice.len;
+
+	while(ptr != slice.ptr) {
+		if(*--ptr == ch)
+			return ptr;
+	}
+
+	return NULL;
+}
+
+/**
+ * Search a slice for a sub-slice.
+ *   @slice: The slice.
+ *   @sub: The sub-slice.
+ *   &returns: Pointer to the first match if found, null otherwise.
+ */
+
+_export
+const char *str_slice_find(struct str_slice_t slice, struct str_slice_t sub)
+{
+	const char *ptr, *last;
+
+	if(sub.len == 0)
+		return slice.ptr;
+	else if(sub.len > slice.len)
+		return NULL;
+
+	ptr = slice.ptr;
+	last = slice.ptr + slice.len - sub.len;
+
+	while((ptr = memchr(ptr, (uint8_t)sub.ptr[0], last - ptr + 1)) != NULL) {
+		if(memcmp(ptr, sub.ptr, sub.len) == 0)
+			return ptr;
+
+		ptr++;
+	}
+
+	return NULL;
+}
+
+/**
+ * Search a slice for any character in a set.
+ *   @slice: The slice.
+ *   @set: The set of characters, terminated by a null byte.
+ *   &returns: Pointer to the first match if found, null otherwise.
+ */
+
+_export
+const char *str_slice_pbrk(struct str_slice_t slice, const char *set)
+{
+	size_t i;
+	uint64_t map[4] = { 0, 0, 0, 0 };
+
+	for(; *set != '\0'; set++)
+		map[(uint8_t)*set >> 6] |= UINT64_C(1) << ((uint8_t)*set & 63);
+
+	for(i = 0; i < slice.len; i++) {
+		if(map[(uint8_t)slice.ptr[i] >> 6] & (UINT64_C(1) << ((uint8_t)slice.ptr[i] & 63)))
+			return slice.ptr + i;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Split a slice at the first delimiter. Repeatedly splitting the tail walks
+ * the fields of a buffer without copying.
+ *   @slice: The slice.
+ *   @delim: The delimiter.
+ *   @head: Out. The text before the delimiter, or the whole slice.
+ *   @tail: Out. The text after the delimiter, or an empty slice.
+ *   &returns: True if the delimiter was found, false otherwise.
+ */
+
+_export
+bool str_slice_split(struct str_slice_t slice, char delim, struct str_slice_t *head, struct str_slice_t *tail)
+{
+	const char *ptr;
+
+	ptr = str_slice_chr(slice, delim);
+	if(ptr == NULL) {
+		*head = slice;
+		*tail = (struct str_slice_t){ slice.ptr + slice.len, 0 };
+
+		return false;
+	}
+
+	*head = (struct str_slice_t){ slice.ptr, ptr - slice.ptr };
+	*tail = (struct str_slice_t){ ptr + 1, slice.len - (ptr - slice.ptr) - 1 };
+
+	return true;
+}
+
+
+/**
+ * Trim whitespace off the left side of a slice.
+ *   @slice: The slice.
+ *   &returns: The trimmed slice.
+ */
+
+_export
+struct str_slice_t str_slice_ltrim(struct str_slice_t slice)
+{
+	while((slice.len > 0) && str_isspace(*slice.ptr))
+		slice.ptr++, slice.len--;
+
+	return slice;
+}
+
+/**
+ * Trim whitespace off the right side of a slice.
+ *   @slice: The slice.
+ *   &returns: The trimmed slice.
+ */
+
+_export
+struct str_slice_t str_slice_rtrim(struct str_slice_t slice)
+{
+	while((slice.len > 0) && str_isspace(slice.ptr[slice.len - 1]))
+		slice.len--;
+
+	return slice;
+}
+
+/**
+ * Trim whitespace off both sides of a slice.
+ *   @slice: The slice.
+ *   &returns: The trimmed slice.
+ */
+
+_export
+struct str_slice_t str_slice_trim(struct str_slice_t slice)
+{
+	return str_slice_rtrim(str_slice_ltrim(slice));
+}
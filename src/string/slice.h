@@ -0,0 +1,65 @@
+#ifndef STRING_SLICE_H
+#define STRING_SLICE_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * string slice function declarations
+ */
+
+struct str_slice_t str_slice_from(const char *str);
+struct str_slice_t str_slice_sub(struct str_slice_t slice, size_t off, size_t len);
+char *str_slice_dup(struct str_slice_t slice);
+
+bool str_slice_isequal(struct str_slice_t s1, struct str_slice_t s2);
+bool str_slice_isequali(struct str_slice_t s1, struct str_slice_t s2);
+bool str_slice_isprefix(struct str_slice_t slice, struct str_slice_t prefix);
+bool str_slice_issuffix(struct str_slice_t slice, struct str_slice_t suffix);
+int str_slice_cmp(struct str_slice_t s1, struct str_slice_t s2);
+
+const char *str_slice_chr(struct str_slice_t slice, char ch);
+const char *str_slice_rchr(struct str_slice_t slice, char ch);
+const char *str_slice_find(struct str_slice_t slice, struct str_slice_t sub);
+const char *str_slice_pbrk(struct str_slice_t slice, const char *set);
+
+bool str_slice_split(struct str_slice_t slice, char delim, struct str_slice_t *head, struct str_slice_t *tail);
+
+struct str_slice_t str_slice_ltrim(struct str_slice_t slice);
+struct str_slice_t str_slice_rtrim(struct str_slice_t slice);
+struct str_slice_t str_slice_trim(struct str_slice_t slice);
+
+
+/**
+ * Create a slice from a pointer and length.
+ *   @ptr: The pointer.
+ *   @len: The length.
+ *   &returns: The slice.
+ */
+
+static inline struct str_slice_t str_slice(const char *ptr, size_t len)
+{
+	return (struct str_slice_t){ ptr, len };
+}
+
+/**
+ * Retrieve the end of a slice.
+ *   @slice: The slice.
+ *   &returns: Pointer just past the last character.
+ */
+
+static inline const char *str_slice_end(struct str_slice_t slice)
+{
+	return slice.ptr + slice.len;
+}
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -32,6 +32,41 @@ int64_t _impl_sys_utime()
 	return 1000000 * (int64_t)tv.tv_sec + (int64_t)tv.tv_usec;
 }
 
+/**
+ * Retrieve the monotonic time in nanoseconds.
+ *   &returns: The number of nanoseconds from an arbitrary point.
+ */
+
+uint64_t _impl_sys_monotonic_ns()
+{
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		throw("Failed to get monotonic time. %s.", strerror(errno));
+
+	return 1000000000 * (uint64_t)ts.tv_sec + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * Retrieve the coarse monotonic time in nanoseconds, falling back to the
+ * precise clock where no coarse clock exists.
+ *   &returns: The number of nanoseconds from an arbitrary point.
+ */
+
+uint64_t _impl_sys_coarsetime()
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC_COARSE
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+
+	return 1000000000 * (uint64_t)ts.tv_sec + (uint64_t)ts.tv_nsec;
+}
+
 
 /**
  * Sleep an interval given in seocnds.
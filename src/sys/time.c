@@ -1,16 +1,38 @@
 #include "../common.h"
+#include "time.h"
+#include "../math/func.h"
 
 
+/*
+ * local definitions
+ */
+
+#define CALIB_NSEC	10000000
+
 /*
  * implementation function declarations
  */
 
 int64_t _impl_sys_time();
 int64_t _impl_sys_utime();
+uint64_t _impl_sys_monotonic_ns();
+uint64_t _impl_sys_coarsetime();
 
 void _impl_sys_sleep(uint64_t sec);
 void _impl_sys_usleep(uint64_t usec);
 
+/*
+ * local function declarations
+ */
+
+static uint64_t tsc_mult();
+
+/*
+ * local variables
+ */
+
+static uint64_t tsc_scale = 0;
+
 
 /**
  * Retrieve the time in seconds.
@@ -34,6 +56,71 @@ int64_t sys_utime()
 	return _impl_sys_utime();
 }
 
+/**
+ * Retrieve the monotonic time in nanoseconds. The monotonic clock is not
+ * affected by changes to the system time.
+ *   &returns: The number of nanoseconds from an arbitrary point.
+ */
+
+_export
+uint64_t sys_monotonic_ns()
+{
+	return _impl_sys_monotonic_ns();
+}
+
+/**
+ * Retrieve a cheaper, coarse monotonic time in nanoseconds. The resolution
+ * is typically the scheduler tick, a few milliseconds.
+ *   &returns: The number of nanoseconds from an arbitrary point.
+ */
+
+_export
+uint64_t sys_coarsetime()
+{
+	return _impl_sys_coarsetime();
+}
+
+
+/**
+ * Calibrate the time stamp counter against the monotonic clock, busy-waiting
+ * ten milliseconds. Calling this at startup keeps the calibration off the
+ * first conversion; later calls return immediately.
+ */
+
+_export
+void sys_tsc_calibrate()
+{
+	tsc_mult();
+}
+
+/**
+ * Convert time stamp counter ticks to nanoseconds. The counter is
+ * calibrated on first use if 'sys_tsc_calibrate' has not been called.
+ *   @ticks: The number of ticks.
+ *   &returns: The number of nanoseconds.
+ */
+
+_export
+uint64_t sys_tsc_ns(uint64_t ticks)
+{
+	uint64_t hi, lo;
+
+	lo = m_uint64mul(ticks, tsc_mult(), &hi);
+
+	return (hi << 32) | (lo >> 32);
+}
+
+/**
+ * Retrieve the calibrated time stamp counter frequency.
+ *   &returns: The number of ticks per second.
+ */
+
+_export
+uint64_t sys_tsc_hz()
+{
+	return (1000000000ull << 32) / tsc_mult();
+}
+
 
 /**
  * Sleep an interval given in seocnds.
@@ -56,3 +143,38 @@ void sys_usleep(uint64_t usec)
 {
 	_impl_sys_usleep(usec);
 }
+
+
+/**
+ * Retrieve the time stamp counter scale, calibrating it if needed.
+ *   &returns: The number of nanoseconds per tick, as 32.32 fixed point.
+ */
+
+static uint64_t tsc_mult()
+{
+	uint64_t mult, ns, tsc;
+
+	mult = __atomic_load_n(&tsc_scale, __ATOMIC_RELAXED);
+	if(mult != 0)
+		return mult;
+
+#if defined(__x86_64__) || defined(__i386__)
+	ns = _impl_sys_monotonic_ns();
+	tsc = sys_tsc();
+
+	while((_impl_sys_monotonic_ns() - ns) < CALIB_NSEC)
+		;
+
+	ns = _impl_sys_monotonic_ns() - ns;
+	tsc = sys_tsc() - tsc;
+	mult = ((tsc > 0) && ((ns >> 32) < tsc)) ? m_uint64div(ns >> 32, ns << 32, tsc, NULL) : 0;
+	if(mult == 0)
+		mult = 1;
+#else
+	mult = (uint64_t)1 << 32;
+#endif
+
+	__atomic_store_n(&tsc_scale, mult, __ATOMIC_RELAXED);
+
+	return mult;
+}
@@ -13,10 +13,35 @@
 
 int64_t sys_time();
 int64_t sys_utime();
+uint64_t sys_monotonic_ns();
+uint64_t sys_coarsetime();
+
+void sys_tsc_calibrate();
+uint64_t sys_tsc_ns(uint64_t ticks);
+uint64_t sys_tsc_hz();
 
 void sys_sleep(uint64_t sec);
 void sys_usleep(uint64_t usec);
 
+
+/**
+ * Read the processor time stamp counter. On processors without a usable
+ * counter, the monotonic clock in nanoseconds is returned instead. Use
+ * 'sys_tsc_ns' to convert tick differences to nanoseconds. The first
+ * conversion busy-waits ten milliseconds to calibrate the counter unless
+ * 'sys_tsc_calibrate' was called beforehand, typically at startup.
+ *   &returns: The number of ticks from an arbitrary point.
+ */
+
+static inline uint64_t sys_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return sys_monotonic_ns();
+#endif
+}
+
 /* %~shim.h% */
 
 /*
@@ -30,6 +30,59 @@ typedef void *(*thread_f)(void *arg);
 
 typedef void (*thread_once_f)();
 
+/**
+ * Pool task function.
+ *   @arg: The argument.
+ */
+
+typedef void (*thread_task_f)(void *arg);
+
+/**
+ * Thread scheduling policy enumerator.
+ *   @thread_sched_inherit_e: Inherit the policy of the creating thread.
+ *   @thread_sched_other_e: Normal time sharing.
+ *   @thread_sched_batch_e: Time sharing for throughput-bound threads.
+ *   @thread_sched_idle_e: Run only when the system is otherwise idle.
+ *   @thread_sched_fifo_e: Real-time first-in, first-out.
+ *   @thread_sched_rr_e: Real-time round robin.
+ */
+
+enum thread_sched_e {
+	thread_sched_inherit_e,
+	thread_sched_other_e,
+	thread_sched_batch_e,
+	thread_sched_idle_e,
+	thread_sched_fifo_e,
+	thread_sched_rr_e
+};
+
+/**
+ * Thread attribute structure. The name, processor set, and nice values are
+ * only applied on Linux, where the batch and idle policies also fall back to
+ * the default time sharing policy elsewhere.
+ *   @stack: The stack size in bytes, zero for the default.
+ *   @name: The thread name shown by debuggers and profilers, or null.
+ *   @cpu, ncpu: The processors the thread may run on, or null for any.
+ *   @node: The NUMA node whose processors the thread may run on, or -1.
+ *   @sched: The scheduling policy.
+ *   @priority: The real-time priority, or the nice value for the time
+ *     sharing policies.
+ */
+
+struct thread_attr_t {
+	size_t stack;
+	const char *name;
+
+	const unsigned int *cpu;
+	unsigned int ncpu;
+	int node;
+
+	enum thread_sched_e sched;
+	int priority;
+};
+
+#define THREAD_ATTR_INIT	{ 0, NULL, NULL, 0, -1, thread_sched_inherit_e, 0 }
+
 
 /*
  * thread function declarations
@@ -41,6 +94,22 @@ void *thread_join(struct thread_t *thread);
 
 void thread_once(struct thread_once_t *once, thread_once_f func);
 
+
+/**
+ * Hint to the processor that the caller is spinning.
+ */
+
+static inline void thread_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#else
+	__asm__ __volatile__("" ::: "memory");
+#endif
+}
+
 /* %~shim.h% */
 
 /*
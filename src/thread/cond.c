@@ -11,14 +11,17 @@ void _impl_thread_cond_delete(struct thread_cond_t *cond);
 
 void _impl_thread_cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex);
 bool _impl_thread_cond_timedwait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t utime);
+bool _impl_thread_cond_waitfor(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t usec);
+bool _impl_thread_cond_waituntil(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec);
 
 void _impl_thread_cond_signal(struct thread_cond_t *cond);
 void _impl_thread_cond_broadcast(struct thread_cond_t *cond);
 
 
 /**
- * Create a new condition variable.
- *   @attr: The condition variable attributes.
+ * Create a new condition variable. Timed waits use the monotonic clock
+ * unless the attributes request the realtime clock.
+ *   @attr: Optional. The condition variable attributes.
  *   &returns: The condition variable.
  */
 
@@ -56,7 +59,7 @@ void thread_cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex)
  * Timed wait on a condition variable
  *   @cond: The condition variable.
  *   @mutex: The mutex.
- *   @time: The absolute time to wait until.
+ *   @utime: The absolute time to wait until, in microseconds since 1970.
  *   &returns: True if successfully waited, false if wait timed out.
  */
 
@@ -66,6 +69,35 @@ bool thread_cond_timedwait(struct thread_cond_t *cond, struct thread_mutex_t *mu
 	return _impl_thread_cond_timedwait(cond, mutex, utime);
 }
 
+/**
+ * Timed wait on a condition variable with a relative timeout.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ *   @usec: The timeout in microseconds.
+ *   &returns: True if successfully waited, false if wait timed out.
+ */
+
+_export
+bool thread_cond_waitfor(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t usec)
+{
+	return _impl_thread_cond_waitfor(cond, mutex, usec);
+}
+
+/**
+ * Timed wait on a condition variable until a deadline on the monotonic
+ * clock, as returned by 'sys_monotonic_ns'.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if successfully waited, false if wait timed out.
+ */
+
+_export
+bool thread_cond_waituntil(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec)
+{
+	return _impl_thread_cond_waituntil(cond, mutex, nsec);
+}
+
 
 /**
  * Signal the condition variable, waking up one waiting thread.
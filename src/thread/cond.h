@@ -12,9 +12,21 @@
  */
 
 struct thread_cond_t;
-struct thread_cond_attr_t;
 struct thread_mutex_t;
 
+/**
+ * Condition variable attribute structure.
+ *   @realtime: Flag indicating timed waits use the realtime clock instead of
+ *     the monotonic clock.
+ */
+
+struct thread_cond_attr_t {
+	bool realtime;
+};
+
+#define THREAD_COND_ATTR_INIT	{ false }
+
+
 /*
  * condition variable function declarations
  */
@@ -24,6 +36,8 @@ void thread_cond_delete(struct thread_cond_t *cond);
 
 void thread_cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex);
 bool thread_cond_timedwait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t utime);
+bool thread_cond_waitfor(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t usec);
+bool thread_cond_waituntil(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec);
 
 void thread_cond_signal(struct thread_cond_t *cond);
 void thread_cond_broadcast(struct thread_cond_t *cond);
@@ -0,0 +1,252 @@
+#include "../common.h"
+#include "base.h"
+#include "drwlock.h"
+#include "../mem/manage.h"
+
+
+/*
+ * local definitions
+ */
+
+#define LINE_SIZE	64
+#define SLOT_MAX	256
+#define BACKOFF_MAX	1024
+
+/**
+ * Reader slot structure, padded to a cache line.
+ *   @count: The number of readers holding the lock through the slot.
+ */
+
+struct thread_drwslot_t {
+	unsigned int count;
+	char pad[LINE_SIZE - sizeof(unsigned int)];
+};
+
+
+/*
+ * implementation function declarations
+ */
+
+unsigned int _impl_thread_ncpu();
+void _impl_thread_yield();
+void _impl_thread_futex_wait(unsigned int *addr, unsigned int val);
+void _impl_thread_futex_wake(unsigned int *addr, unsigned int cnt);
+
+/*
+ * local function declarations
+ */
+
+static struct thread_drwslot_t *slot_get(struct thread_drwlock_t *lock);
+static void writer_wait(struct thread_drwlock_t *lock);
+static void readers_wait(struct thread_drwlock_t *lock);
+
+/*
+ * local variables
+ */
+
+static unsigned int slot_next = 0;
+static __thread unsigned int slot_id __attribute__((tls_model("initial-exec"))) = 0;
+
+
+/**
+ * Create a new distributed read-write lock, with reader slots for twice the
+ * number of processors.
+ *   &returns: The lock.
+ */
+
+_export
+struct thread_drwlock_t thread_drwlock_new()
+{
+	unsigned int i;
+	struct thread_drwlock_t lock;
+
+	for(lock.nslot = 1; (lock.nslot < 2 * _impl_thread_ncpu()) && (lock.nslot < SLOT_MAX); lock.nslot *= 2);
+
+	lock.writer = 0;
+	lock.mem = mem_alloc(lock.nslot * sizeof(struct thread_drwslot_t) + LINE_SIZE - 1);
+	lock.slot = (void *)(((uintptr_t)lock.mem + LINE_SIZE - 1) & ~(uintptr_t)(LINE_SIZE - 1));
+
+	for(i = 0; i < lock.nslot; i++)
+		lock.slot[i].count = 0;
+
+	return lock;
+}
+
+/**
+ * Delete a distributed read-write lock.
+ *   @lock: The lock.
+ */
+
+_export
+void thread_drwlock_delete(struct thread_drwlock_t *lock)
+{
+	mem_free(lock->mem);
+}
+
+
+/**
+ * Lock a distributed read-write lock for reading.
+ *   @lock: The lock.
+ */
+
+_export
+void thread_drwlock_rdlock(struct thread_drwlock_t *lock)
+{
+	struct thread_drwslot_t *slot = slot_get(lock);
+
+	while(true) {
+		__atomic_fetch_add(&slot->count, 1, __ATOMIC_SEQ_CST);
+		if(__atomic_load_n(&lock->writer, __ATOMIC_SEQ_CST) == 0)
+			break;
+
+		__atomic_fetch_sub(&slot->count, 1, __ATOMIC_RELEASE);
+		writer_wait(lock);
+	}
+}
+
+/**
+ * Try to lock a distributed read-write lock for reading.
+ *   @lock: The lock.
+ *   &returns: True if locked, false if a writer holds the lock.
+ */
+
+_export
+bool thread_drwlock_tryrdlock(struct thread_drwlock_t *lock)
+{
+	struct thread_drwslot_t *slot = slot_get(lock);
+
+	__atomic_fetch_add(&slot->count, 1, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&lock->writer, __ATOMIC_SEQ_CST) == 0)
+		return true;
+
+	__atomic_fetch_sub(&slot->count, 1, __ATOMIC_RELEASE);
+
+	return false;
+}
+
+/**
+ * Unlock a distributed read-write lock for reading. The calling thread must
+ * be the one that locked it.
+ *   @lock: The lock.
+ */
+
+_export
+void thread_drwlock_rdunlock(struct thread_drwlock_t *lock)
+{
+	__atomic_fetch_sub(&slot_get(lock)->count, 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Lock a distributed read-write lock for writing. New readers are held off
+ * as soon as the writer arrives, and the writer then waits for every slot to
+ * drain.
+ *   @lock: The lock.
+ */
+
+_export
+void thread_drwlock_wrlock(struct thread_drwlock_t *lock)
+{
+	unsigned int expect = 0;
+
+	if(!__atomic_compare_exchange_n(&lock->writer, &expect, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+		while(__atomic_exchange_n(&lock->writer, 2, __ATOMIC_SEQ_CST) != 0)
+			_impl_thread_futex_wait(&lock->writer, 2);
+	}
+
+	readers_wait(lock);
+}
+
+/**
+ * Try to lock a distributed read-write lock for writing.
+ *   @lock: The lock.
+ *   &returns: True if locked, false if held by a reader or writer.
+ */
+
+_export
+bool thread_drwlock_trywrlock(struct thread_drwlock_t *lock)
+{
+	unsigned int i, expect = 0;
+
+	if(!__atomic_compare_exchange_n(&lock->writer, &expect, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return false;
+
+	for(i = 0; i < lock->nslot; i++) {
+		if(__atomic_load_n(&lock->slot[i].count, __ATOMIC_SEQ_CST) != 0) {
+			thread_drwlock_wrunlock(lock);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Unlock a distributed read-write lock after writing, waking any sleepers.
+ *   @lock: The lock.
+ */
+
+_export
+void thread_drwlock_wrunlock(struct thread_drwlock_t *lock)
+{
+	if(__atomic_exchange_n(&lock->writer, 0, __ATOMIC_RELEASE) == 2)
+		_impl_thread_futex_wake(&lock->writer, INT_MAX);
+}
+
+
+/**
+ * Retrieve the calling thread's slot, assigning thread identifiers round
+ * robin on first use.
+ *   @lock: The lock.
+ *   &returns: The slot.
+ */
+
+static struct thread_drwslot_t *slot_get(struct thread_drwlock_t *lock)
+{
+	if(slot_id == 0)
+		slot_id = __atomic_add_fetch(&slot_next, 1, __ATOMIC_RELAXED);
+
+	return &lock->slot[slot_id & (lock->nslot - 1)];
+}
+
+/**
+ * Sleep until no writer holds the lock.
+ *   @lock: The lock.
+ */
+
+static void writer_wait(struct thread_drwlock_t *lock)
+{
+	unsigned int writer;
+
+	while((writer = __atomic_load_n(&lock->writer, __ATOMIC_ACQUIRE)) != 0) {
+		if((writer == 2) || __atomic_compare_exchange_n(&lock->writer, &writer, 2, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			_impl_thread_futex_wait(&lock->writer, 2);
+	}
+}
+
+/**
+ * Wait for the readers in every slot to finish. The counts are loaded with
+ * sequential consistency to pair with readers, which increment their count
+ * before checking the writer flag.
+ *   @lock: The lock.
+ */
+
+static void readers_wait(struct thread_drwlock_t *lock)
+{
+	unsigned int i, j, n;
+
+	for(i = 0; i < lock->nslot; i++) {
+		n = 1;
+
+		while(__atomic_load_n(&lock->slot[i].count, __ATOMIC_SEQ_CST) != 0) {
+			if(n < BACKOFF_MAX) {
+				for(j = 0; j < n; j++)
+					thread_pause();
+
+				n *= 2;
+			}
+			else
+				_impl_thread_yield();
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef THREAD_DRWLOCK_H
+#define THREAD_DRWLOCK_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_drwslot_t;
+
+/**
+ * Distributed read-write lock structure. Readers count themselves in a
+ * per-thread slot on its own cache line, so read locking without writers
+ * only reads shared state.
+ *   @writer: Zero when free, one when held by a writer, and two when held
+ *     with possible sleepers.
+ *   @nslot: The number of slots, a power of two.
+ *   @slot: The reader slots.
+ *   @mem: The allocation backing the slots.
+ */
+
+struct thread_drwlock_t {
+	unsigned int writer;
+	unsigned int nslot;
+	struct thread_drwslot_t *slot;
+	void *mem;
+};
+
+
+/*
+ * distributed read-write lock function declarations
+ */
+
+struct thread_drwlock_t thread_drwlock_new();
+void thread_drwlock_delete(struct thread_drwlock_t *lock);
+
+void thread_drwlock_rdlock(struct thread_drwlock_t *lock);
+bool thread_drwlock_tryrdlock(struct thread_drwlock_t *lock);
+void thread_drwlock_rdunlock(struct thread_drwlock_t *lock);
+
+void thread_drwlock_wrlock(struct thread_drwlock_t *lock);
+bool thread_drwlock_trywrlock(struct thread_drwlock_t *lock);
+void thread_drwlock_wrunlock(struct thread_drwlock_t *lock);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
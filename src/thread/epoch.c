@@ -0,0 +1,401 @@
+#include "../common.h"
+#include "epoch.h"
+#include "../debug/exception.h"
+#include "../mem/manage.h"
+#include "local.h"
+#include "lock.h"
+
+
+/*
+ * local definitions
+ */
+
+#define DEFER_MAX	64
+
+/**
+ * Deferred deletion structure.
+ *   @ref: The reference.
+ *   @delete: The deletion callback.
+ *   @tag: The global epoch when deferred.
+ *   @next: The next deferred deletion.
+ */
+
+struct defer_t {
+	void *ref;
+	void (*delete)(void *);
+	unsigned long tag;
+
+	struct defer_t *next;
+};
+
+/**
+ * Per-thread record structure. Records are never freed before the domain,
+ * so they may be scanned without locking.
+ *   @epoch: The domain.
+ *   @owned: Flag indicating a thread currently owns the record.
+ *   @state: The observed epoch shifted left by one, with the low bit set
+ *     while inside a critical section.
+ *   @nest: The critical section nesting depth.
+ *   @head, tail: The deferred deletions, oldest first.
+ *   @count: The number of deferred deletions.
+ *   @next: The next record.
+ */
+
+struct record_t {
+	struct thread_epoch_t *epoch;
+	bool owned;
+	unsigned long state;
+	unsigned int nest;
+
+	struct defer_t *head, **tail;
+	unsigned int count;
+
+	struct record_t *next;
+};
+
+/**
+ * Epoch domain structure.
+ *   @global: The global epoch.
+ *   @record: The list of records.
+ *   @local: The thread-local record.
+ *   @lock: The lock for registration and orphans.
+ *   @orphan: Deferred deletions left by exited threads.
+ */
+
+struct thread_epoch_t {
+	unsigned long global;
+
+	struct record_t *record;
+	struct thread_local_t *local;
+
+	struct thread_mutex_t lock;
+	struct defer_t *orphan;
+};
+
+
+/*
+ * implementation function declarations
+ */
+
+void _impl_thread_yield();
+
+/*
+ * local function declarations
+ */
+
+static struct record_t *record_get(struct thread_epoch_t *epoch);
+static void record_release(void *arg);
+
+static bool advance(struct thread_epoch_t *epoch);
+static void collect(struct record_t *record, unsigned long global);
+static void orphans(struct thread_epoch_t *epoch, unsigned long global);
+static void release(struct defer_t *defer);
+
+
+/**
+ * Create an epoch reclamation domain.
+ *   &returns: The domain.
+ */
+
+_export
+struct thread_epoch_t *thread_epoch_new()
+{
+	struct thread_epoch_t *epoch;
+
+	epoch = mem_alloc(sizeof(struct thread_epoch_t));
+	epoch->global = 2;
+	epoch->record = NULL;
+	epoch->local = thread_local_new(record_release);
+	epoch->lock = thread_mutex_new(NULL);
+	epoch->orphan = NULL;
+
+	return epoch;
+}
+
+/**
+ * Delete an epoch reclamation domain, running every deferred deletion. No
+ * other thread may use the domain anymore.
+ *   @epoch: The domain.
+ */
+
+_export
+void thread_epoch_delete(struct thread_epoch_t *epoch)
+{
+	struct record_t *record;
+
+	thread_local_delete(epoch->local);
+
+	while(epoch->record != NULL) {
+		record = epoch->record;
+		epoch->record = record->next;
+
+		release(record->head);
+		mem_free(record);
+	}
+
+	release(epoch->orphan);
+	thread_mutex_delete(&epoch->lock);
+	mem_free(epoch);
+}
+
+
+/**
+ * Enter a critical section. References read from shared structures stay
+ * valid until the matching exit. Sections may nest.
+ *   @epoch: The domain.
+ */
+
+_export
+void thread_epoch_enter(struct thread_epoch_t *epoch)
+{
+	struct record_t *record = record_get(epoch);
+
+	if(record->nest++ == 0)
+		__atomic_store_n(&record->state, (__atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST) << 1) | 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Exit a critical section.
+ *   @epoch: The domain.
+ */
+
+_export
+void thread_epoch_exit(struct thread_epoch_t *epoch)
+{
+	struct record_t *record = record_get(epoch);
+
+	if(record->nest == 0)
+		_fatal("Unbalanced epoch exit.");
+
+	if(--record->nest == 0)
+		__atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Defer the deletion of a reference that has been unlinked from shared
+ * structures until no critical section can still hold it. Ownership of the
+ * reference passes to the domain.
+ *   @epoch: The domain.
+ *   @ref: The reference.
+ *   @delete: The deletion callback.
+ */
+
+_export
+void thread_epoch_defer(struct thread_epoch_t *epoch, void *ref, void (*delete)(void *))
+{
+	struct defer_t *defer;
+	struct record_t *record = record_get(epoch);
+
+	defer = mem_alloc(sizeof(struct defer_t));
+	defer->ref = ref;
+	defer->delete = delete;
+	defer->tag = __atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST);
+	defer->next = NULL;
+
+	*record->tail = defer;
+	record->tail = &defer->next;
+
+	if(++record->count >= DEFER_MAX) {
+		advance(epoch);
+		collect(record, __atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST));
+	}
+}
+
+/**
+ * Wait for every critical section in progress to exit, then run the
+ * deletions deferred by the calling thread and by exited threads.
+ *   @epoch: The domain.
+ */
+
+_export
+void thread_epoch_synchronize(struct thread_epoch_t *epoch)
+{
+	unsigned long start, global;
+	struct record_t *record = record_get(epoch);
+
+	if(record->nest > 0)
+		_fatal("Cannot synchronize inside an epoch critical section.");
+
+	start = __atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST);
+
+	while((global = __atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST)) < (start + 2)) {
+		if(!advance(epoch))
+			_impl_thread_yield();
+	}
+
+	collect(record, global);
+	orphans(epoch, global);
+}
+
+
+/**
+ * Retrieve the calling thread's record, claiming a released record or
+ * registering a new one on first use.
+ *   @epoch: The domain.
+ *   &returns: The record.
+ */
+
+static struct record_t *record_get(struct thread_epoch_t *epoch)
+{
+	struct record_t *record;
+
+	record = thread_local_get(epoch->local);
+	if(record != NULL)
+		return record;
+
+	for(record = __atomic_load_n(&epoch->record, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+		bool expect = false;
+
+		if(!__atomic_load_n(&record->owned, __ATOMIC_RELAXED) && __atomic_compare_exchange_n(&record->owned, &expect, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+	}
+
+	if(record == NULL) {
+		record = mem_alloc(sizeof(struct record_t));
+		record->epoch = epoch;
+		record->owned = true;
+		record->state = 0;
+		record->nest = 0;
+		record->head = NULL;
+		record->tail = &record->head;
+		record->count = 0;
+
+		thread_mutex_lock(&epoch->lock);
+		record->next = epoch->record;
+		__atomic_store_n(&epoch->record, record, __ATOMIC_RELEASE);
+		thread_mutex_unlock(&epoch->lock);
+	}
+
+	thread_local_set(epoch->local, record);
+
+	return record;
+}
+
+/**
+ * Release a record on thread exit, handing its deferred deletions to the
+ * domain.
+ *   @arg: The record.
+ */
+
+static void record_release(void *arg)
+{
+	struct record_t *record = arg;
+	struct thread_epoch_t *epoch = record->epoch;
+
+	if(record->head != NULL) {
+		thread_mutex_lock(&epoch->lock);
+		*record->tail = epoch->orphan;
+		epoch->orphan = record->head;
+		thread_mutex_unlock(&epoch->lock);
+	}
+
+	record->head = NULL;
+	record->tail = &record->head;
+	record->count = 0;
+	record->nest = 0;
+
+	__atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&record->owned, false, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Try to advance the global epoch. This succeeds only once every thread
+ * inside a critical section has observed the current epoch.
+ *   @epoch: The domain.
+ *   &returns: True if the epoch is known to have advanced.
+ */
+
+static bool advance(struct thread_epoch_t *epoch)
+{
+	unsigned long global, state;
+	struct record_t *record;
+
+	global = __atomic_load_n(&epoch->global, __ATOMIC_SEQ_CST);
+
+	for(record = __atomic_load_n(&epoch->record, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+		state = __atomic_load_n(&record->state, __ATOMIC_SEQ_CST);
+		if((state & 1) && ((state >> 1) != global))
+			return false;
+	}
+
+	__atomic_compare_exchange_n(&epoch->global, &global, global + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+	return true;
+}
+
+/**
+ * Run the deferred deletions of a record that are two epochs old.
+ *   @record: The record.
+ *   @global: The observed global epoch.
+ */
+
+static void collect(struct record_t *record, unsigned long global)
+{
+	struct defer_t *list = record->head, **end = &record->head;
+
+	while((*end != NULL) && (((*end)->tag + 2) <= global)) {
+		end = &(*end)->next;
+		record->count--;
+	}
+
+	if(end == &record->head)
+		return;
+
+	record->head = *end;
+	if(record->head == NULL)
+		record->tail = &record->head;
+
+	*end = NULL;
+	release(list);
+}
+
+/**
+ * Run the orphaned deferred deletions that are two epochs old.
+ *   @epoch: The domain.
+ *   @global: The observed global epoch.
+ */
+
+static void orphans(struct thread_epoch_t *epoch, unsigned long global)
+{
+	struct defer_t *defer, **ptr, *list = NULL;
+
+	if(__atomic_load_n(&epoch->orphan, __ATOMIC_RELAXED) == NULL)
+		return;
+
+	thread_mutex_lock(&epoch->lock);
+
+	ptr = &epoch->orphan;
+	while(*ptr != NULL) {
+		defer = *ptr;
+
+		if((defer->tag + 2) <= global) {
+			*ptr = defer->next;
+			defer->next = list;
+			list = defer;
+		}
+		else
+			ptr = &defer->next;
+	}
+
+	thread_mutex_unlock(&epoch->lock);
+	release(list);
+}
+
+/**
+ * Run and free a list of deferred deletions.
+ *   @defer: The list.
+ */
+
+static void release(struct defer_t *defer)
+{
+	struct defer_t *next;
+
+	while(defer != NULL) {
+		next = defer->next;
+		defer->delete(defer->ref);
+		mem_free(defer);
+		defer = next;
+	}
+}
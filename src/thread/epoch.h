@@ -0,0 +1,36 @@
+#ifndef THREAD_EPOCH_H
+#define THREAD_EPOCH_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_epoch_t;
+
+
+/*
+ * epoch reclamation function declarations
+ */
+
+struct thread_epoch_t *thread_epoch_new();
+void thread_epoch_delete(struct thread_epoch_t *epoch);
+
+void thread_epoch_enter(struct thread_epoch_t *epoch);
+void thread_epoch_exit(struct thread_epoch_t *epoch);
+
+void thread_epoch_defer(struct thread_epoch_t *epoch, void *ref, void (*delete)(void *));
+void thread_epoch_synchronize(struct thread_epoch_t *epoch);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -0,0 +1,391 @@
+#include "../common.h"
+#include "base.h"
+#include "future.h"
+#include "../debug/exception.h"
+#include "../mem/manage.h"
+#include "../string/base.h"
+#include "cond.h"
+#include "lock.h"
+#include "pool.h"
+
+
+/**
+ * Future state enumerator.
+ *   @pending_e: Not yet completed.
+ *   @value_e: Completed with a value.
+ *   @error_e: Completed with an error.
+ */
+
+enum state_e {
+	pending_e,
+	value_e,
+	error_e
+};
+
+/**
+ * Continuation structure.
+ *   @func: The function.
+ *   @arg: The argument.
+ *   @next: The next continuation.
+ */
+
+struct cont_t {
+	thread_future_f func;
+	void *arg;
+
+	struct cont_t *next;
+};
+
+/**
+ * Future structure.
+ *   @refcnt: The reference count.
+ *   @state: The state.
+ *   @value: The value.
+ *   @error: The error message.
+ *   @lock: The lock.
+ *   @cond: Signaled on completion.
+ *   @cont, tail: The continuations in registration order.
+ */
+
+struct thread_future_t {
+	unsigned int refcnt;
+	enum state_e state;
+	void *value;
+	char *error;
+
+	struct thread_mutex_t lock;
+	struct thread_cond_t cond;
+	struct cont_t *cont, **tail;
+};
+
+/**
+ * Asynchronous call structure.
+ *   @future: The future.
+ *   @func: The function.
+ *   @arg: The argument.
+ */
+
+struct async_t {
+	struct thread_future_t *future;
+	thread_f func;
+	void *arg;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static void complete(struct thread_future_t *future, enum state_e state, void *value, char *error);
+static void async_task(void *arg);
+static void async_call(struct async_t *async, void **value, bool *suc);
+
+
+/**
+ * Create a new, pending future.
+ *   &returns: The future.
+ */
+
+_export
+struct thread_future_t *thread_future_new()
+{
+	struct thread_future_t *future;
+
+	future = mem_alloc(sizeof(struct thread_future_t));
+	future->refcnt = 1;
+	future->state = pending_e;
+	future->value = NULL;
+	future->error = NULL;
+	future->lock = thread_mutex_new(NULL);
+	future->cond = thread_cond_new(NULL);
+	future->cont = NULL;
+	future->tail = &future->cont;
+
+	return future;
+}
+
+/**
+ * Run a function on a pool, completing a future with its return value. An
+ * exception thrown by the function fails the future instead.
+ *   @pool: The pool.
+ *   @func: The function.
+ *   @arg: The argument.
+ *   &returns: The future.
+ */
+
+_export
+struct thread_future_t *thread_future_async(struct thread_pool_t *pool, thread_f func, void *arg)
+{
+	struct async_t *async;
+	struct thread_future_t *future;
+
+	future = thread_future_new();
+
+	async = mem_alloc(sizeof(struct async_t));
+	async->future = thread_future_ref(future);
+	async->func = func;
+	async->arg = arg;
+
+	thread_pool_submit(pool, NULL, async_task, async);
+
+	return future;
+}
+
+/**
+ * Add a reference to a future.
+ *   @future: The future.
+ *   &returns: The future.
+ */
+
+_export
+struct thread_future_t *thread_future_ref(struct thread_future_t *future)
+{
+	__atomic_add_fetch(&future->refcnt, 1, __ATOMIC_RELAXED);
+
+	return future;
+}
+
+/**
+ * Release a reference to a future, deleting it with the last reference.
+ * Continuations of a future that never completed are discarded.
+ *   @future: The future.
+ */
+
+_export
+void thread_future_delete(struct thread_future_t *future)
+{
+	struct cont_t *cont;
+
+	if(__atomic_sub_fetch(&future->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+
+	while(future->cont != NULL) {
+		cont = future->cont;
+		future->cont = cont->next;
+		mem_free(cont);
+	}
+
+	if(future->error != NULL)
+		mem_free(future->error);
+
+	thread_cond_delete(&future->cond);
+	thread_mutex_delete(&future->lock);
+	mem_free(future);
+}
+
+
+/**
+ * Complete a future with a value.
+ *   @future: The future.
+ *   @value: The value.
+ */
+
+_export
+void thread_future_set(struct thread_future_t *future, void *value)
+{
+	complete(future, value_e, value, NULL);
+}
+
+/**
+ * Complete a future with an error, thrown by any later retrieval.
+ *   @future: The future.
+ *   @error: The error message, copied.
+ */
+
+_export
+void thread_future_fail(struct thread_future_t *future, const char *error)
+{
+	complete(future, error_e, NULL, str_dup(error));
+}
+
+
+/**
+ * Check if a future has completed.
+ *   @future: The future.
+ *   &returns: True if completed.
+ */
+
+_export
+bool thread_future_isready(struct thread_future_t *future)
+{
+	return __atomic_load_n(&future->state, __ATOMIC_ACQUIRE) != pending_e;
+}
+
+/**
+ * Wait for a future and retrieve its value, throwing its error if it failed.
+ *   @future: The future.
+ *   &returns: The value.
+ */
+
+_export
+void *thread_future_get(struct thread_future_t *future)
+{
+	thread_future_wait(future);
+
+	if(future->state == error_e)
+		throw("%s", future->error);
+
+	return future->value;
+}
+
+/**
+ * Wait for a future to complete. Tasks on a pool should prefer continuations,
+ * since waiting blocks the worker.
+ *   @future: The future.
+ */
+
+_export
+void thread_future_wait(struct thread_future_t *future)
+{
+	if(thread_future_isready(future))
+		return;
+
+	thread_mutex_lock(&future->lock);
+
+	while(future->state == pending_e)
+		thread_cond_wait(&future->cond, &future->lock);
+
+	thread_mutex_unlock(&future->lock);
+}
+
+/**
+ * Wait for a future to complete with a timeout.
+ *   @future: The future.
+ *   @utime: The absolute time to wait until, in microseconds.
+ *   &returns: True if completed, false if the wait timed out.
+ */
+
+_export
+bool thread_future_timedwait(struct thread_future_t *future, uint64_t utime)
+{
+	bool ready;
+
+	if(thread_future_isready(future))
+		return true;
+
+	thread_mutex_lock(&future->lock);
+
+	while(future->state == pending_e) {
+		if(!thread_cond_timedwait(&future->cond, &future->lock, utime))
+			break;
+	}
+
+	ready = (future->state != pending_e);
+	thread_mutex_unlock(&future->lock);
+
+	return ready;
+}
+
+
+/**
+ * Register a continuation on a future. Continuations run in order on the
+ * thread completing the future, or immediately if it already completed.
+ *   @future: The future.
+ *   @func: The continuation.
+ *   @arg: The argument.
+ */
+
+_export
+void thread_future_then(struct thread_future_t *future, thread_future_f func, void *arg)
+{
+	struct cont_t *cont;
+
+	thread_mutex_lock(&future->lock);
+
+	if(future->state == pending_e) {
+		cont = mem_alloc(sizeof(struct cont_t));
+		cont->func = func;
+		cont->arg = arg;
+		cont->next = NULL;
+
+		*future->tail = cont;
+		future->tail = &cont->next;
+
+		thread_mutex_unlock(&future->lock);
+	}
+	else {
+		thread_mutex_unlock(&future->lock);
+		func(future, arg);
+	}
+}
+
+
+/**
+ * Complete a future, waking waiters and running continuations.
+ *   @future: The future.
+ *   @state: The completed state.
+ *   @value: The value.
+ *   @error: Consumed. The error or null.
+ */
+
+static void complete(struct thread_future_t *future, enum state_e state, void *value, char *error)
+{
+	struct cont_t *cont;
+
+	thread_mutex_lock(&future->lock);
+
+	if(future->state != pending_e) {
+		thread_mutex_unlock(&future->lock);
+
+		if(error != NULL)
+			mem_free(error);
+
+		throw("Future already completed.");
+	}
+
+	future->value = value;
+	future->error = error;
+	__atomic_store_n(&future->state, state, __ATOMIC_RELEASE);
+
+	cont = future->cont;
+	future->cont = NULL;
+	future->tail = &future->cont;
+
+	thread_cond_broadcast(&future->cond);
+	thread_mutex_unlock(&future->lock);
+
+	while(cont != NULL) {
+		struct cont_t *next = cont->next;
+
+		cont->func(future, cont->arg);
+		mem_free(cont);
+		cont = next;
+	}
+}
+
+/**
+ * Asynchronous call task.
+ *   @arg: The asynchronous call.
+ */
+
+static void async_task(void *arg)
+{
+	void *value;
+	bool suc = true;
+	struct async_t async = *(struct async_t *)arg;
+
+	mem_free(arg);
+	async_call(&async, &value, &suc);
+
+	if(suc)
+		thread_future_set(async.future, value);
+
+	thread_future_delete(async.future);
+}
+
+/**
+ * Invoke an asynchronous call, failing its future if the call throws.
+ *   @async: The asynchronous call.
+ *   @value: Out. The returned value.
+ *   @suc: Out. Cleared if the call threw.
+ */
+
+static void async_call(struct async_t *async, void **value, bool *suc)
+{
+	try
+		*value = async->func(async->arg);
+	catch(e) {
+		thread_future_fail(async->future, e);
+		*suc = false;
+	}
+}
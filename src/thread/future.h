@@ -0,0 +1,52 @@
+#ifndef THREAD_FUTURE_H
+#define THREAD_FUTURE_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_future_t;
+struct thread_pool_t;
+
+
+/**
+ * Future continuation function.
+ *   @future: The completed future.
+ *   @arg: The argument.
+ */
+
+typedef void (*thread_future_f)(struct thread_future_t *future, void *arg);
+
+
+/*
+ * future function declarations
+ */
+
+struct thread_future_t *thread_future_new();
+struct thread_future_t *thread_future_async(struct thread_pool_t *pool, thread_f func, void *arg);
+struct thread_future_t *thread_future_ref(struct thread_future_t *future);
+void thread_future_delete(struct thread_future_t *future);
+
+void thread_future_set(struct thread_future_t *future, void *value);
+void thread_future_fail(struct thread_future_t *future, const char *error);
+
+bool thread_future_isready(struct thread_future_t *future);
+void *thread_future_get(struct thread_future_t *future);
+void thread_future_wait(struct thread_future_t *future);
+bool thread_future_timedwait(struct thread_future_t *future, uint64_t utime);
+
+void thread_future_then(struct thread_future_t *future, thread_future_f func, void *arg);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -0,0 +1,262 @@
+#include "../common.h"
+#include "base.h"
+#include "graph.h"
+#include "../debug/exception.h"
+#include "../mem/manage.h"
+#include "../string/base.h"
+#include "pool.h"
+
+
+/*
+ * local definitions
+ */
+
+#define NEXT_INIT	4
+
+/**
+ * Task graph structure.
+ *   @pool: The pool.
+ *   @group: The group of running nodes.
+ *   @node, tail: The nodes in insertion order.
+ *   @count: The number of nodes.
+ *   @error: The first error of the last run or null.
+ */
+
+struct thread_graph_t {
+	struct thread_pool_t *pool;
+	struct thread_group_t group;
+
+	struct thread_graph_node_t *node, **tail;
+	unsigned int count;
+
+	char *error;
+};
+
+/**
+ * Task graph node structure.
+ *   @graph: The graph.
+ *   @func: The function.
+ *   @arg: The argument.
+ *   @ndeps, remain: The number of dependencies, and those not yet finished.
+ *   @next: The dependent nodes.
+ *   @nnext, cap: The number of dependents and the array capacity.
+ *   @link: The next node in the graph.
+ */
+
+struct thread_graph_node_t {
+	struct thread_graph_t *graph;
+	thread_task_f func;
+	void *arg;
+
+	unsigned int ndeps, remain;
+	struct thread_graph_node_t **next;
+	unsigned int nnext, cap;
+
+	struct thread_graph_node_t *link;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static void node_task(void *arg);
+static void node_run(struct thread_graph_node_t *node);
+
+
+/**
+ * Create a new task graph.
+ *   @pool: The pool that runs the tasks.
+ *   &returns: The graph.
+ */
+
+_export
+struct thread_graph_t *thread_graph_new(struct thread_pool_t *pool)
+{
+	struct thread_graph_t *graph;
+
+	graph = mem_alloc(sizeof(struct thread_graph_t));
+	graph->pool = pool;
+	graph->group = (struct thread_group_t)THREAD_GROUP_INIT;
+	graph->node = NULL;
+	graph->tail = &graph->node;
+	graph->count = 0;
+	graph->error = NULL;
+
+	return graph;
+}
+
+/**
+ * Delete a task graph and all of its nodes.
+ *   @graph: The graph.
+ */
+
+_export
+void thread_graph_delete(struct thread_graph_t *graph)
+{
+	struct thread_graph_node_t *node;
+
+	while(graph->node != NULL) {
+		node = graph->node;
+		graph->node = node->link;
+
+		if(node->next != NULL)
+			mem_free(node->next);
+
+		mem_free(node);
+	}
+
+	if(graph->error != NULL)
+		mem_free(graph->error);
+
+	mem_free(graph);
+}
+
+
+/**
+ * Add a task to the graph.
+ *   @graph: The graph.
+ *   @func: The function.
+ *   @arg: The argument.
+ *   &returns: The node.
+ */
+
+_export
+struct thread_graph_node_t *thread_graph_add(struct thread_graph_t *graph, thread_task_f func, void *arg)
+{
+	struct thread_graph_node_t *node;
+
+	node = mem_alloc(sizeof(struct thread_graph_node_t));
+	node->graph = graph;
+	node->func = func;
+	node->arg = arg;
+	node->ndeps = node->remain = 0;
+	node->next = NULL;
+	node->nnext = node->cap = 0;
+	node->link = NULL;
+
+	*graph->tail = node;
+	graph->tail = &node->link;
+	graph->count++;
+
+	return node;
+}
+
+/**
+ * Make a node depend on another, so that it runs only after the dependency
+ * finishes.
+ *   @graph: The graph.
+ *   @node: The dependent node.
+ *   @dep: The dependency.
+ */
+
+_export
+void thread_graph_depend(struct thread_graph_t *graph, struct thread_graph_node_t *node, struct thread_graph_node_t *dep)
+{
+	if((node->graph != graph) || (dep->graph != graph))
+		_fatal("Node does not belong to the graph.");
+
+	if(dep->nnext == dep->cap) {
+		dep->cap = dep->cap ? (2 * dep->cap) : NEXT_INIT;
+		dep->next = dep->next ? mem_realloc(dep->next, dep->cap * sizeof(void *)) : mem_alloc(dep->cap * sizeof(void *));
+	}
+
+	dep->next[dep->nnext++] = node;
+	node->ndeps++;
+}
+
+
+/**
+ * Run every task of the graph, starting each as soon as all of its
+ * dependencies finish, and wait for completion. If any task throws, the
+ * tasks not yet started are skipped and the first error is rethrown.
+ *   @graph: The graph.
+ */
+
+_export
+void thread_graph_run(struct thread_graph_t *graph)
+{
+	unsigned int i, n, visit;
+	struct thread_graph_node_t *node, **queue;
+
+	if(graph->error != NULL) {
+		mem_free(graph->error);
+		graph->error = NULL;
+	}
+
+	if(graph->count == 0)
+		return;
+
+	queue = mem_alloc(graph->count * sizeof(void *));
+
+	n = 0;
+	for(node = graph->node; node != NULL; node = node->link) {
+		node->remain = node->ndeps;
+		if(node->ndeps == 0)
+			queue[n++] = node;
+	}
+
+	for(visit = 0; visit < n; visit++) {
+		for(i = 0; i < queue[visit]->nnext; i++) {
+			if(--queue[visit]->next[i]->remain == 0)
+				queue[n++] = queue[visit]->next[i];
+		}
+	}
+
+	if(n != graph->count) {
+		mem_free(queue);
+		throw("Dependency cycle.");
+	}
+
+	for(node = graph->node; node != NULL; node = node->link)
+		node->remain = node->ndeps;
+
+	for(i = 0; (i < n) && (queue[i]->ndeps == 0); i++)
+		thread_pool_submit(graph->pool, &graph->group, node_task, queue[i]);
+
+	mem_free(queue);
+	thread_pool_wait(graph->pool, &graph->group);
+
+	if(graph->error != NULL)
+		throw("%s", graph->error);
+}
+
+
+/**
+ * Graph node task, running the node and then releasing its dependents.
+ *   @arg: The node.
+ */
+
+static void node_task(void *arg)
+{
+	unsigned int i;
+	struct thread_graph_node_t *node = arg, *next;
+	struct thread_graph_t *graph = node->graph;
+
+	if(__atomic_load_n(&graph->error, __ATOMIC_ACQUIRE) == NULL)
+		node_run(node);
+
+	for(i = 0; i < node->nnext; i++) {
+		next = node->next[i];
+		if(__atomic_sub_fetch(&next->remain, 1, __ATOMIC_ACQ_REL) == 0)
+			thread_pool_submit(graph->pool, &graph->group, node_task, next);
+	}
+}
+
+/**
+ * Run a graph node, recording the first error thrown by any node.
+ *   @node: The node.
+ */
+
+static void node_run(struct thread_graph_node_t *node)
+{
+	char *error, *expect = NULL;
+
+	try
+		node->func(node->arg);
+	catch(e) {
+		error = str_dup(e);
+		if(!__atomic_compare_exchange_n(&node->graph->error, &expect, error, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			mem_free(error);
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef THREAD_GRAPH_H
+#define THREAD_GRAPH_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_graph_t;
+struct thread_graph_node_t;
+struct thread_pool_t;
+
+
+/*
+ * task graph function declarations
+ */
+
+struct thread_graph_t *thread_graph_new(struct thread_pool_t *pool);
+void thread_graph_delete(struct thread_graph_t *graph);
+
+struct thread_graph_node_t *thread_graph_add(struct thread_graph_t *graph, thread_task_f func, void *arg);
+void thread_graph_depend(struct thread_graph_t *graph, struct thread_graph_node_t *node, struct thread_graph_node_t *dep);
+
+void thread_graph_run(struct thread_graph_t *graph);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -0,0 +1,680 @@
+#include "../common.h"
+#include "base.h"
+#include "pool.h"
+#include "../debug/exception.h"
+#include "../mem/manage.h"
+#include "../string/io.h"
+#include "../sys/time.h"
+#include "cond.h"
+#include "local.h"
+#include "lock.h"
+
+
+/*
+ * local definitions
+ */
+
+#define DEQUE_INIT	256
+#define FREE_MAX	1024
+#define INJECT_BATCH	32
+#define SPIN_MAX	64
+#define WAIT_USEC	200
+#define STEAL_ABORT	((struct task_t *)1)
+
+/**
+ * Task structure.
+ *   @func: The function.
+ *   @arg: The argument.
+ *   @group: The group or null.
+ *   @next: The next task in the submission or free list.
+ */
+
+struct task_t {
+	thread_task_f func;
+	void *arg;
+	struct thread_group_t *group;
+
+	struct task_t *next;
+};
+
+/**
+ * Deque array structure. Arrays replaced by growth are kept until the pool
+ * is deleted since thieves may still be reading them.
+ *   @size: The size, a power of two.
+ *   @prev: The replaced array.
+ *   @buf: The task buffer.
+ */
+
+struct array_t {
+	int64_t size;
+	struct array_t *prev;
+	struct task_t *buf[];
+};
+
+/**
+ * Chase-Lev work-stealing deque. The owner pushes and takes at the bottom,
+ * thieves steal from the top.
+ *   @top: The top index.
+ *   @bottom: The bottom index.
+ *   @array: The current array.
+ */
+
+struct deque_t {
+	int64_t top;
+	char pad[56];
+	int64_t bottom;
+	struct array_t *array;
+};
+
+/**
+ * Worker structure.
+ *   @pool: The pool.
+ *   @thread: The thread.
+ *   @deque: The task deque.
+ *   @free: The free task list.
+ *   @nfree: The number of free tasks.
+ *   @seed: The victim selection state.
+ */
+
+struct worker_t {
+	struct thread_pool_t *pool;
+	struct thread_t *thread;
+	struct deque_t deque;
+
+	struct task_t *free;
+	unsigned int nfree;
+	uint64_t seed;
+	char pad[64];
+};
+
+/**
+ * Thread pool structure.
+ *   @nworkers: The number of workers.
+ *   @worker: The worker array.
+ *   @self: The current worker of each thread.
+ *   @lock: The lock for the submission queue and sleeping.
+ *   @work, done: Signaled on new work and on finished groups.
+ *   @head, tail: The submission queue for tasks from outside the pool.
+ *   @ninject: The number of queued submissions.
+ *   @nsleep, nwait: The number of sleeping workers and group waiters.
+ *   @stop: Stop flag.
+ *   @all: The group of all tasks.
+ */
+
+struct thread_pool_t {
+	unsigned int nworkers;
+	struct worker_t *worker;
+	struct thread_local_t *self;
+
+	struct thread_mutex_t lock;
+	struct thread_cond_t work, done;
+	struct task_t *head, **tail;
+	unsigned int ninject;
+	unsigned int nsleep, nwait;
+	bool stop;
+
+	struct thread_group_t all;
+};
+
+
+/*
+ * implementation function declarations
+ */
+
+unsigned int _impl_thread_ncpu();
+
+/*
+ * local function declarations
+ */
+
+static void *worker_main(void *arg);
+static struct task_t *worker_find(struct thread_pool_t *pool, struct worker_t *self);
+static void worker_run(struct thread_pool_t *pool, struct worker_t *self, struct task_t *task);
+
+static void pool_notify(struct thread_pool_t *pool);
+static bool pool_haswork(struct thread_pool_t *pool);
+static void pool_finish(struct thread_pool_t *pool, struct thread_group_t *group);
+static struct task_t *pool_inject(struct thread_pool_t *pool, struct worker_t *self);
+
+static void deque_init(struct deque_t *deque);
+static void deque_destroy(struct deque_t *deque);
+static void deque_push(struct deque_t *deque, struct task_t *task);
+static struct task_t *deque_take(struct deque_t *deque);
+static struct task_t *deque_steal(struct deque_t *deque);
+
+
+/**
+ * Create a new thread pool.
+ *   @nworkers: The number of workers, or zero for one per online processor.
+ *   &returns: The pool.
+ */
+
+_export
+struct thread_pool_t *thread_pool_new(unsigned int nworkers)
+{
+	unsigned int i;
+	char name[16];
+	struct thread_pool_t *pool;
+	struct thread_attr_t attr = THREAD_ATTR_INIT;
+
+	attr.name = name;
+
+	if(nworkers == 0)
+		nworkers = _impl_thread_ncpu();
+
+	pool = mem_alloc(sizeof(struct thread_pool_t));
+	pool->nworkers = nworkers;
+	pool->worker = mem_alloc(nworkers * sizeof(struct worker_t));
+	pool->self = thread_local_new(NULL);
+	pool->lock = thread_mutex_new(NULL);
+	pool->work = thread_cond_new(NULL);
+	pool->done = thread_cond_new(NULL);
+	pool->head = NULL;
+	pool->tail = &pool->head;
+	pool->ninject = pool->nsleep = pool->nwait = 0;
+	pool->stop = false;
+	pool->all = (struct thread_group_t)THREAD_GROUP_INIT;
+
+	for(i = 0; i < nworkers; i++) {
+		pool->worker[i].pool = pool;
+		pool->worker[i].free = NULL;
+		pool->worker[i].nfree = 0;
+		pool->worker[i].seed = UINT64_C(0x9e3779b97f4a7c15) * (i + 1);
+		deque_init(&pool->worker[i].deque);
+	}
+
+	for(i = 0; i < nworkers; i++) {
+		str_nprintf(name, sizeof(name), "pool-%u", i);
+		pool->worker[i].thread = thread_new(worker_main, &pool->worker[i], &attr);
+	}
+
+	return pool;
+}
+
+/**
+ * Delete a thread pool, waiting for all submitted tasks to finish.
+ *   @pool: The pool.
+ */
+
+_export
+void thread_pool_delete(struct thread_pool_t *pool)
+{
+	unsigned int i;
+	struct task_t *task;
+	struct worker_t *worker;
+
+	thread_pool_wait(pool, NULL);
+
+	thread_mutex_lock(&pool->lock);
+	pool->stop = true;
+	thread_cond_broadcast(&pool->work);
+	thread_mutex_unlock(&pool->lock);
+
+	for(i = 0; i < pool->nworkers; i++) {
+		worker = &pool->worker[i];
+		thread_join(worker->thread);
+
+		while(worker->free != NULL) {
+			task = worker->free;
+			worker->free = task->next;
+			mem_free(task);
+		}
+
+		deque_destroy(&worker->deque);
+	}
+
+	thread_cond_delete(&pool->work);
+	thread_cond_delete(&pool->done);
+	thread_mutex_delete(&pool->lock);
+	thread_local_delete(pool->self);
+	mem_free(pool->worker);
+	mem_free(pool);
+}
+
+
+/**
+ * Retrieve the number of workers in a pool.
+ *   @pool: The pool.
+ *   &returns: The number of workers.
+ */
+
+_export
+unsigned int thread_pool_nworkers(struct thread_pool_t *pool)
+{
+	return pool->nworkers;
+}
+
+
+/**
+ * Submit a task to a pool. Tasks submitted from a worker are pushed onto its
+ * own deque, others go through a shared queue. Tasks must not throw.
+ *   @pool: The pool.
+ *   @group: Optional. The group the task belongs to.
+ *   @func: The function.
+ *   @arg: The argument.
+ */
+
+_export
+void thread_pool_submit(struct thread_pool_t *pool, struct thread_group_t *group, thread_task_f func, void *arg)
+{
+	struct task_t *task;
+	struct worker_t *self;
+
+	self = thread_local_get(pool->self);
+	if((self != NULL) && (self->free != NULL)) {
+		task = self->free;
+		self->free = task->next;
+		self->nfree--;
+	}
+	else
+		task = mem_alloc(sizeof(struct task_t));
+
+	task->func = func;
+	task->arg = arg;
+	task->group = group;
+	task->next = NULL;
+
+	if(group != NULL)
+		__atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+
+	__atomic_add_fetch(&pool->all.pending, 1, __ATOMIC_RELAXED);
+
+	if(self != NULL)
+		deque_push(&self->deque, task);
+	else {
+		thread_mutex_lock(&pool->lock);
+		*pool->tail = task;
+		pool->tail = &task->next;
+		__atomic_store_n(&pool->ninject, pool->ninject + 1, __ATOMIC_RELEASE);
+		thread_mutex_unlock(&pool->lock);
+	}
+
+	pool_notify(pool);
+}
+
+/**
+ * Wait for all tasks of a group to finish. Workers run other tasks while
+ * waiting, so tasks may wait on groups of their own subtasks.
+ *   @pool: The pool.
+ *   @group: Optional. The group, or null to wait for every task in the pool.
+ *     Waiting on every task is not allowed from within a task.
+ */
+
+_export
+void thread_pool_wait(struct thread_pool_t *pool, struct thread_group_t *group)
+{
+	struct task_t *task;
+	struct worker_t *self;
+
+	self = thread_local_get(pool->self);
+	if(group == NULL) {
+		if(self != NULL)
+			_fatal("Cannot wait for the whole pool from within a task.");
+
+		group = &pool->all;
+	}
+
+	while(__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) != 0) {
+		if(self != NULL) {
+			task = worker_find(pool, self);
+			if(task != NULL) {
+				worker_run(pool, self, task);
+				continue;
+			}
+		}
+
+		thread_mutex_lock(&pool->lock);
+		__atomic_add_fetch(&pool->nwait, 1, __ATOMIC_SEQ_CST);
+
+		if(__atomic_load_n(&group->pending, __ATOMIC_SEQ_CST) != 0) {
+			if(self != NULL)
+				thread_cond_waitfor(&pool->done, &pool->lock, WAIT_USEC);
+			else
+				thread_cond_wait(&pool->done, &pool->lock);
+		}
+
+		__atomic_sub_fetch(&pool->nwait, 1, __ATOMIC_SEQ_CST);
+		thread_mutex_unlock(&pool->lock);
+	}
+}
+
+
+/**
+ * Worker thread entry.
+ *   @arg: The worker.
+ *   &returns: Always null.
+ */
+
+static void *worker_main(void *arg)
+{
+	bool stop;
+	unsigned int spin = 0;
+	struct task_t *task;
+	struct worker_t *self = arg;
+	struct thread_pool_t *pool = self->pool;
+
+	thread_local_set(pool->self, self);
+
+	while(true) {
+		task = worker_find(pool, self);
+		if(task != NULL) {
+			worker_run(pool, self, task);
+			spin = 0;
+			continue;
+		}
+		else if(spin++ < SPIN_MAX)
+			continue;
+
+		spin = 0;
+
+		thread_mutex_lock(&pool->lock);
+		__atomic_add_fetch(&pool->nsleep, 1, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if(!pool->stop && !pool_haswork(pool))
+			thread_cond_wait(&pool->work, &pool->lock);
+
+		__atomic_sub_fetch(&pool->nsleep, 1, __ATOMIC_SEQ_CST);
+		stop = pool->stop;
+		thread_mutex_unlock(&pool->lock);
+
+		if(stop && !pool_haswork(pool))
+			break;
+	}
+
+	return NULL;
+}
+
+/**
+ * Find a task for a worker, trying its own deque, then the submission queue,
+ * then stealing from the other workers starting at a random victim.
+ *   @pool: The pool.
+ *   @self: The worker.
+ *   &returns: The task or null.
+ */
+
+static struct task_t *worker_find(struct thread_pool_t *pool, struct worker_t *self)
+{
+	unsigned int i, n, victim;
+	struct task_t *task;
+
+	task = deque_take(&self->deque);
+	if(task != NULL)
+		return task;
+
+	if(__atomic_load_n(&pool->ninject, __ATOMIC_ACQUIRE) > 0) {
+		task = pool_inject(pool, self);
+		if(task != NULL)
+			return task;
+	}
+
+	n = pool->nworkers;
+	self->seed ^= self->seed << 13;
+	self->seed ^= self->seed >> 7;
+	self->seed ^= self->seed << 17;
+
+	for(i = 0; i < n; i++) {
+		victim = (self->seed + i) % n;
+		if(&pool->worker[victim] == self)
+			continue;
+
+		do
+			task = deque_steal(&pool->worker[victim].deque);
+		while(task == STEAL_ABORT);
+
+		if(task != NULL)
+			return task;
+	}
+
+	return NULL;
+}
+
+/**
+ * Run a task on a worker and release it.
+ *   @pool: The pool.
+ *   @self: The worker.
+ *   @task: The task.
+ */
+
+static void worker_run(struct thread_pool_t *pool, struct worker_t *self, struct task_t *task)
+{
+	struct thread_group_t *group;
+
+	task->func(task->arg);
+	group = task->group;
+
+	if(self->nfree < FREE_MAX) {
+		task->next = self->free;
+		self->free = task;
+		self->nfree++;
+	}
+	else
+		mem_free(task);
+
+	if(group != NULL)
+		pool_finish(pool, group);
+
+	pool_finish(pool, &pool->all);
+}
+
+
+/**
+ * Wake a sleeping worker after new work has been published.
+ *   @pool: The pool.
+ */
+
+static void pool_notify(struct thread_pool_t *pool)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if(__atomic_load_n(&pool->nsleep, __ATOMIC_RELAXED) > 0) {
+		thread_mutex_lock(&pool->lock);
+		thread_cond_signal(&pool->work);
+		thread_mutex_unlock(&pool->lock);
+	}
+}
+
+/**
+ * Check if any work is queued in the pool.
+ *   @pool: The pool.
+ *   &returns: True if work is available.
+ */
+
+static bool pool_haswork(struct thread_pool_t *pool)
+{
+	unsigned int i;
+	struct deque_t *deque;
+
+	if(__atomic_load_n(&pool->ninject, __ATOMIC_ACQUIRE) > 0)
+		return true;
+
+	for(i = 0; i < pool->nworkers; i++) {
+		deque = &pool->worker[i].deque;
+		if(__atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE) > __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Mark a task of a group as finished, waking waiters when the group is done.
+ * The group may be released as soon as its count drops to zero.
+ *   @pool: The pool.
+ *   @group: The group.
+ */
+
+static void pool_finish(struct thread_pool_t *pool, struct thread_group_t *group)
+{
+	if(__atomic_sub_fetch(&group->pending, 1, __ATOMIC_SEQ_CST) != 0)
+		return;
+
+	if(__atomic_load_n(&pool->nwait, __ATOMIC_SEQ_CST) > 0) {
+		thread_mutex_lock(&pool->lock);
+		thread_cond_broadcast(&pool->done);
+		thread_mutex_unlock(&pool->lock);
+	}
+}
+
+/**
+ * Take tasks from the submission queue. One task is returned and a small
+ * batch is moved onto the worker deque where others may steal it.
+ *   @pool: The pool.
+ *   @self: The worker.
+ *   &returns: The task or null.
+ */
+
+static struct task_t *pool_inject(struct thread_pool_t *pool, struct worker_t *self)
+{
+	unsigned int i = 0;
+	struct task_t *task, *extra;
+
+	thread_mutex_lock(&pool->lock);
+
+	task = pool->head;
+	if(task != NULL) {
+		pool->head = task->next;
+
+		for(i = 1; (i < INJECT_BATCH) && (pool->head != NULL); i++) {
+			extra = pool->head;
+			pool->head = extra->next;
+			deque_push(&self->deque, extra);
+		}
+
+		if(pool->head == NULL)
+			pool->tail = &pool->head;
+
+		__atomic_store_n(&pool->ninject, pool->ninject - i, __ATOMIC_RELEASE);
+	}
+
+	thread_mutex_unlock(&pool->lock);
+
+	if((task != NULL) && (i > 1))
+		pool_notify(pool);
+
+	return task;
+}
+
+
+/**
+ * Initialize a deque.
+ *   @deque: The deque.
+ */
+
+static void deque_init(struct deque_t *deque)
+{
+	deque->top = 0;
+	deque->bottom = 0;
+	deque->array = mem_alloc(sizeof(struct array_t) + DEQUE_INIT * sizeof(struct task_t *));
+	deque->array->size = DEQUE_INIT;
+	deque->array->prev = NULL;
+}
+
+/**
+ * Destroy a deque, releasing all of its arrays.
+ *   @deque: The deque.
+ */
+
+static void deque_destroy(struct deque_t *deque)
+{
+	struct array_t *array;
+
+	while(deque->array != NULL) {
+		array = deque->array;
+		deque->array = array->prev;
+		mem_free(array);
+	}
+}
+
+/**
+ * Push a task onto the bottom of a deque. Only called by the owner.
+ *   @deque: The deque.
+ *   @task: The task.
+ */
+
+static void deque_push(struct deque_t *deque, struct task_t *task)
+{
+	int64_t i, b, t;
+	struct array_t *array, *grow;
+
+	b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+
+	if((b - t) > (array->size - 1)) {
+		grow = mem_alloc(sizeof(struct array_t) + 2 * array->size * sizeof(struct task_t *));
+		grow->size = 2 * array->size;
+		grow->prev = array;
+
+		for(i = t; i < b; i++)
+			grow->buf[i & (grow->size - 1)] = array->buf[i & (array->size - 1)];
+
+		__atomic_store_n(&deque->array, grow, __ATOMIC_RELEASE);
+		array = grow;
+	}
+
+	__atomic_store_n(&array->buf[b & (array->size - 1)], task, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take a task from the bottom of a deque. Only called by the owner.
+ *   @deque: The deque.
+ *   &returns: The task or null.
+ */
+
+static struct task_t *deque_take(struct deque_t *deque)
+{
+	int64_t b, t;
+	struct task_t *task;
+	struct array_t *array;
+
+	b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+	array = __atomic_load_n(&deque->array, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	t = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+	if(t > b) {
+		__atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	task = __atomic_load_n(&array->buf[b & (array->size - 1)], __ATOMIC_RELAXED);
+	if(t == b) {
+		if(!__atomic_compare_exchange_n(&deque->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+			task = NULL;
+
+		__atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+	}
+
+	return task;
+}
+
+/**
+ * Steal a task from the top of a deque.
+ *   @deque: The deque.
+ *   &returns: The task, null if empty, or 'STEAL_ABORT' if another thread
+ *     won the race.
+ */
+
+static struct task_t *deque_steal(struct deque_t *deque)
+{
+	int64_t b, t;
+	struct task_t *task;
+	struct array_t *array;
+
+	t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	b = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+	if(t >= b)
+		return NULL;
+
+	array = __atomic_load_n(&deque->array, __ATOMIC_ACQUIRE);
+	task = __atomic_load_n(&array->buf[t & (array->size - 1)], __ATOMIC_RELAXED);
+	if(!__atomic_compare_exchange_n(&deque->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return STEAL_ABORT;
+
+	return task;
+}
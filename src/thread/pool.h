@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/**
+ * Task group structure. A group counts its unfinished tasks and may be
+ * waited on as a unit.
+ *   @pending: The number of unfinished tasks.
+ */
+
+struct thread_group_t {
+	unsigned int pending;
+};
+
+#define THREAD_GROUP_INIT	{ 0 }
+
+
+/*
+ * thread pool function declarations
+ */
+
+struct thread_pool_t *thread_pool_new(unsigned int nworkers);
+void thread_pool_delete(struct thread_pool_t *pool);
+
+unsigned int thread_pool_nworkers(struct thread_pool_t *pool);
+
+void thread_pool_submit(struct thread_pool_t *pool, struct thread_group_t *group, thread_task_f func, void *arg);
+void thread_pool_wait(struct thread_pool_t *pool, struct thread_group_t *group);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -1,6 +1,17 @@
+#define _GNU_SOURCE
 #include "../../common.h"
+#include <fcntl.h>
+#include <limits.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#	include <sys/syscall.h>
+#endif
 #include "../../debug/exception.h"
 #include "../../mem/manage.h"
 #include "../base.h"
@@ -16,9 +27,42 @@ struct thread_t {
 	pthread_t ref;
 };
 
+/**
+ * Thread start structure, for settings applied from within the new thread
+ * before it runs the thread function.
+ *   @func: The thread function.
+ *   @arg: The argument.
+ *   @name: The truncated name or empty.
+ *   @policy: The batch or idle policy, or -1.
+ *   @nice: The nice value.
+ */
+
+struct start_t {
+	thread_f func;
+	void *arg;
+
+	char name[16];
+	int policy, nice;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static int attr_init(pthread_attr_t *pattr, const struct thread_attr_t *attr, int policy, const struct sched_param *param);
+#ifdef __linux__
+static bool attr_affinity(cpu_set_t *set, const struct thread_attr_t *attr);
+static void attr_node(cpu_set_t *set, int node);
+#endif
+static int attr_policy(enum thread_sched_e sched);
+static void *start_main(void *arg);
+
 
 /**
- * Create a new thread.
+ * Create a new thread. Names, affinity, the batch and idle policies, and
+ * per-thread nice values rely on Linux interfaces and are ignored on other
+ * systems.
  *   @func: Thread function.
  *   @arg: The argument.
  *   @attr: Creation attributes.
@@ -27,14 +71,56 @@ struct thread_t {
 
 struct thread_t *_impl_thread_new(thread_f func, void *arg, const struct thread_attr_t *attr)
 {
-	int err;
+	int err, nice = 0, policy = -1;
+	bool defer;
+	pthread_attr_t pattr;
+	struct sched_param param = { 0 };
+	struct start_t *start = NULL;
 	struct thread_t *thread;
 
-	thread = mem_alloc(sizeof(struct thread_t));
+	if(attr != NULL) {
+		policy = attr_policy(attr->sched);
 
-	err = pthread_create(&thread->ref, NULL, func, arg);
+		if((policy == SCHED_FIFO) || (policy == SCHED_RR)) {
+			if((attr->priority < sched_get_priority_min(policy)) || (attr->priority > sched_get_priority_max(policy)))
+				throw("Invalid thread priority %d.", attr->priority);
+
+			param.sched_priority = attr->priority;
+		}
+		else if(policy >= 0)
+			nice = attr->priority;
+	}
+
+	err = attr_init(&pattr, attr, policy, &param);
 	if(err != 0)
+		throw("Invalid thread attributes. %s.", strerror(err));
+
+	defer = (attr != NULL) && ((attr->sched == thread_sched_batch_e) || (attr->sched == thread_sched_idle_e));
+	if((attr != NULL) && ((attr->name != NULL) || defer || (nice != 0))) {
+		start = mem_alloc(sizeof(struct start_t));
+		start->func = func;
+		start->arg = arg;
+		snprintf(start->name, sizeof(start->name), "%s", attr->name ? attr->name : "");
+		start->policy = defer ? policy : -1;
+		start->nice = nice;
+	}
+
+	thread = mem_alloc(sizeof(struct thread_t));
+
+	if(start != NULL)
+		err = pthread_create(&thread->ref, &pattr, start_main, start);
+	else
+		err = pthread_create(&thread->ref, &pattr, func, arg);
+
+	pthread_attr_destroy(&pattr);
+
+	if(err != 0) {
+		if(start != NULL)
+			mem_free(start);
+
+		mem_free(thread);
 		throw("Unable to create thread. %s.", strerror(err));
+	}
 
 	return thread;
 }
@@ -82,3 +168,224 @@ void _impl_thread_once(struct thread_once_t *once, thread_once_f func)
 {
 	pthread_once(&once->once, func);
 }
+
+
+/**
+ * Retrieve the number of online processors.
+ *   &returns: The number of processors, at least one.
+ */
+
+unsigned int _impl_thread_ncpu()
+{
+	long n;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n > 0) ? n : 1;
+}
+
+
+/**
+ * Initialize the pthread attributes from the thread attributes. The batch
+ * and idle policies are applied by the thread itself, so they are created
+ * with the default policy. The pthread attributes are only left initialized
+ * on success.
+ *   @pattr: Out. The pthread attributes.
+ *   @attr: Optional. The thread attributes.
+ *   @policy: The pthread policy, or -1 to inherit.
+ *   @param: The scheduling parameters.
+ *   &returns: Zero on success, an error number otherwise.
+ */
+
+static int attr_init(pthread_attr_t *pattr, const struct thread_attr_t *attr, int policy, const struct sched_param *param)
+{
+	int err;
+#ifdef __linux__
+	cpu_set_t set;
+	bool affinity = (attr != NULL) && attr_affinity(&set, attr);
+
+	if((policy == SCHED_BATCH) || (policy == SCHED_IDLE))
+		policy = SCHED_OTHER;
+#endif
+
+	err = pthread_attr_init(pattr);
+	if((err != 0) || (attr == NULL))
+		return err;
+
+	if(attr->stack > 0) {
+		size_t page = sysconf(_SC_PAGESIZE);
+		size_t size = (attr->stack < (size_t)PTHREAD_STACK_MIN) ? (size_t)PTHREAD_STACK_MIN : attr->stack;
+
+		err = pthread_attr_setstacksize(pattr, (size + page - 1) / page * page);
+	}
+
+#ifdef __linux__
+	if((err == 0) && affinity)
+		err = pthread_attr_setaffinity_np(pattr, sizeof(cpu_set_t), &set);
+#endif
+
+	if((err == 0) && (policy >= 0)) {
+		err = pthread_attr_setinheritsched(pattr, PTHREAD_EXPLICIT_SCHED);
+		if(err == 0)
+			err = pthread_attr_setschedpolicy(pattr, policy);
+
+		if(err == 0)
+			err = pthread_attr_setschedparam(pattr, param);
+	}
+
+	if(err != 0)
+		pthread_attr_destroy(pattr);
+
+	return err;
+}
+
+#ifdef __linux__
+
+/**
+ * Build the processor set from the attributes. Processor lists and NUMA
+ * nodes intersect when both are given.
+ *   @set: The output set.
+ *   @attr: The attributes.
+ *   &returns: True if the thread is restricted to the set.
+ */
+
+static bool attr_affinity(cpu_set_t *set, const struct thread_attr_t *attr)
+{
+	unsigned int i;
+	cpu_set_t node;
+
+	if((attr->cpu == NULL) && (attr->node < 0))
+		return false;
+
+	CPU_ZERO(set);
+
+	if(attr->cpu != NULL) {
+		for(i = 0; i < attr->ncpu; i++) {
+			if(attr->cpu[i] >= CPU_SETSIZE)
+				throw("Invalid processor %u.", attr->cpu[i]);
+
+			CPU_SET(attr->cpu[i], set);
+		}
+	}
+
+	if(attr->node >= 0) {
+		attr_node(&node, attr->node);
+
+		if(attr->cpu != NULL)
+			CPU_AND(set, set, &node);
+		else
+			*set = node;
+	}
+
+	if(CPU_COUNT(set) == 0)
+		throw("Empty processor set.");
+
+	return true;
+}
+
+/**
+ * Read the processors of a NUMA node from sysfs.
+ *   @set: The output set.
+ *   @node: The node.
+ */
+
+static void attr_node(cpu_set_t *set, int node)
+{
+	int fd;
+	ssize_t len;
+	char path[64], buf[1024], *ptr;
+	unsigned long lo, hi;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		throw("Unknown NUMA node %d.", node);
+
+	len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+
+	if(len < 0)
+		throw("Unknown NUMA node %d.", node);
+
+	buf[len] = '\0';
+	CPU_ZERO(set);
+
+	for(ptr = buf; (*ptr >= '0') && (*ptr <= '9'); ptr++) {
+		lo = hi = strtoul(ptr, &ptr, 10);
+		if(*ptr == '-')
+			hi = strtoul(ptr + 1, &ptr, 10);
+
+		for(; (lo <= hi) && (lo < CPU_SETSIZE); lo++)
+			CPU_SET(lo, set);
+
+		if(*ptr != ',')
+			break;
+	}
+}
+
+#endif
+
+/**
+ * Translate a scheduling policy.
+ *   @sched: The policy.
+ *   &returns: The pthread policy, or -1 to inherit.
+ */
+
+static int attr_policy(enum thread_sched_e sched)
+{
+	switch(sched) {
+	case thread_sched_inherit_e:
+		return -1;
+
+	case thread_sched_other_e:
+		return SCHED_OTHER;
+
+#ifdef __linux__
+	case thread_sched_batch_e:
+		return SCHED_BATCH;
+
+	case thread_sched_idle_e:
+		return SCHED_IDLE;
+#else
+	case thread_sched_batch_e:
+	case thread_sched_idle_e:
+		return SCHED_OTHER;
+#endif
+
+	case thread_sched_fifo_e:
+		return SCHED_FIFO;
+
+	case thread_sched_rr_e:
+		return SCHED_RR;
+	}
+
+	throw("Invalid scheduling policy.");
+}
+
+/**
+ * Thread entry applying the name, policy and nice value before running the
+ * thread function. Settings the caller is not permitted to make are ignored.
+ *   @arg: The start structure.
+ *   &returns: The thread function return value.
+ */
+
+static void *start_main(void *arg)
+{
+	struct start_t start = *(struct start_t *)arg;
+
+	mem_free(arg);
+
+#ifdef __linux__
+	if(start.name[0] != '\0')
+		pthread_setname_np(pthread_self(), start.name);
+
+	if(start.policy >= 0)
+		pthread_setschedparam(pthread_self(), start.policy, &(struct sched_param){ 0 });
+
+	if(start.nice != 0)
+		setpriority(PRIO_PROCESS, syscall(SYS_gettid), start.nice);
+#endif
+
+	return start.func(start.arg);
+}
@@ -2,24 +2,44 @@
 #include <errno.h>
 #include <pthread.h>
 #include <string.h>
+#include <time.h>
 #include "../../debug/exception.h"
 #include "../../mem/manage.h"
 #include "../cond.h"
 #include "defs.h"
 
 
+/*
+ * local function declarations
+ */
+
+static bool cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec);
+static uint64_t clock_ns(clockid_t clock);
+static uint64_t ns_add(uint64_t nsec, uint64_t delta);
+static uint64_t ns_usec(uint64_t usec);
+
+
 /**
  * Create a new condition variable.
- *   @attr: The condition variable attributes.
+ *   @attr: Optional. The condition variable attributes.
  *   &returns: The condition variable.
  */
 
 struct thread_cond_t _impl_thread_cond_new(struct thread_cond_attr_t *attr)
 {
 	int err;
+	pthread_condattr_t pattr;
 	struct thread_cond_t cond;
 
-	err = pthread_cond_init(&cond.var, NULL);
+	cond.clock = ((attr != NULL) && attr->realtime) ? CLOCK_REALTIME : CLOCK_MONOTONIC;
+
+	pthread_condattr_init(&pattr);
+	err = pthread_condattr_setclock(&pattr, cond.clock);
+	if(err == 0)
+		err = pthread_cond_init(&cond.var, &pattr);
+
+	pthread_condattr_destroy(&pattr);
+
 	if(err != 0)
 		throw("Failed to create condition variable. %s.", strerror(err));
 
@@ -57,25 +77,58 @@ void _impl_thread_cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *m
 }
 
 /**
- * Timed wait on a condition variable
+ * Timed wait on a condition variable. On a monotonic condition variable,
+ * the deadline is converted once so that later clock steps do not move it.
  *   @cond: The condition variable.
  *   @mutex: The mutex.
- *   @time: The absolute time to wait until.
+ *   @utime: The absolute time to wait until, in microseconds since 1970.
  *   &returns: True if successfully waited, false if wait timed out.
  */
 
 bool _impl_thread_cond_timedwait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t utime)
 {
-	int err;
-	struct timespec time = { utime / 1000000, 1000 * (utime % 1000000) };
+	uint64_t now, nsec = ns_usec(utime);
 
-	err = pthread_cond_timedwait(&cond->var, &mutex->lock, &time);
-	if(err == ETIMEDOUT)
-		return false;
-	else if(err != 0)
-		throw("Failed to wait on condition variable. %s.", strerror(err));
+	if(cond->clock != CLOCK_REALTIME) {
+		now = clock_ns(CLOCK_REALTIME);
+		nsec = ns_add(clock_ns(cond->clock), (nsec > now) ? (nsec - now) : 0);
+	}
 
-	return true;
+	return cond_wait(cond, mutex, nsec);
+}
+
+/**
+ * Timed wait on a condition variable with a relative timeout.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ *   @usec: The timeout in microseconds.
+ *   &returns: True if successfully waited, false if wait timed out.
+ */
+
+bool _impl_thread_cond_waitfor(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t usec)
+{
+	return cond_wait(cond, mutex, ns_add(clock_ns(cond->clock), ns_usec(usec)));
+}
+
+/**
+ * Timed wait on a condition variable until a deadline on the monotonic
+ * clock.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if successfully waited, false if wait timed out.
+ */
+
+bool _impl_thread_cond_waituntil(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec)
+{
+	uint64_t now;
+
+	if(cond->clock != CLOCK_MONOTONIC) {
+		now = clock_ns(CLOCK_MONOTONIC);
+		nsec = ns_add(clock_ns(cond->clock), (nsec > now) ? (nsec - now) : 0);
+	}
+
+	return cond_wait(cond, mutex, nsec);
 }
 
 
@@ -106,3 +159,65 @@ void _impl_thread_cond_broadcast(struct thread_cond_t *cond)
 	if(err != 0)
 		throw("Failed to broadcast condition variable. %s.", strerror(err));
 }
+
+
+/**
+ * Wait on a condition variable until a deadline on its clock.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if successfully waited, false if wait timed out.
+ */
+
+static bool cond_wait(struct thread_cond_t *cond, struct thread_mutex_t *mutex, uint64_t nsec)
+{
+	int err;
+	struct timespec time = { nsec / 1000000000, nsec % 1000000000 };
+
+	err = pthread_cond_timedwait(&cond->var, &mutex->lock, &time);
+	if(err == ETIMEDOUT)
+		return false;
+	else if(err != 0)
+		throw("Failed to wait on condition variable. %s.", strerror(err));
+
+	return true;
+}
+
+/**
+ * Read a clock.
+ *   @clock: The clock.
+ *   &returns: The clock value in nanoseconds.
+ */
+
+static uint64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+
+	return 1000000000 * (uint64_t)ts.tv_sec + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Add a delta to a time in nanoseconds, saturating at 'UINT64_MAX' so that
+ * far-future deadlines never wrap into the past.
+ *   @nsec: The time in nanoseconds.
+ *   @delta: The delta in nanoseconds.
+ *   &returns: The sum.
+ */
+
+static uint64_t ns_add(uint64_t nsec, uint64_t delta)
+{
+	return (delta > (UINT64_MAX - nsec)) ? UINT64_MAX : (nsec + delta);
+}
+
+/**
+ * Convert microseconds to nanoseconds, saturating at 'UINT64_MAX'.
+ *   @usec: The time in microseconds.
+ *   &returns: The time in nanoseconds.
+ */
+
+static uint64_t ns_usec(uint64_t usec)
+{
+	return (usec > (UINT64_MAX / 1000)) ? UINT64_MAX : (1000 * usec);
+}
@@ -35,10 +35,12 @@ struct thread_rwlock_t {
 /**
  * Condition variable structure.
  *   @var: The pthread condition variable.
+ *   @clock: The clock used by timed waits.
  */
 
 struct thread_cond_t {
 	pthread_cond_t var;
+	clockid_t clock;
 };
 
 /**
@@ -0,0 +1,171 @@
+#include "../../common.h"
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#else
+#	include <pthread.h>
+#endif
+
+
+/*
+ * local definitions
+ */
+
+#ifndef __linux__
+
+#define PARK_SIZE	64
+
+/**
+ * Parking bucket structure, emulating futexes with a condition variable.
+ *   @lock: The lock.
+ *   @cond: The condition variable, on the monotonic clock.
+ */
+
+struct park_t {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+#endif
+
+/*
+ * local function declarations
+ */
+
+#ifndef __linux__
+static struct park_t *park_get(unsigned int *addr);
+static void park_init();
+#endif
+
+/*
+ * local variables
+ */
+
+#ifndef __linux__
+static struct park_t park_bucket[PARK_SIZE];
+static pthread_once_t park_once = PTHREAD_ONCE_INIT;
+#endif
+
+
+/**
+ * Yield the processor.
+ */
+
+void _impl_thread_yield()
+{
+	sched_yield();
+}
+
+/**
+ * Wait on an address while it holds a value. The wait may return spuriously.
+ *   @addr: The address.
+ *   @val: The expected value.
+ */
+
+void _impl_thread_futex_wait(unsigned int *addr, unsigned int val)
+{
+#ifdef __linux__
+	syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+#else
+	struct park_t *park = park_get(addr);
+
+	pthread_mutex_lock(&park->lock);
+	if(__atomic_load_n(addr, __ATOMIC_SEQ_CST) == val)
+		pthread_cond_wait(&park->cond, &park->lock);
+
+	pthread_mutex_unlock(&park->lock);
+#endif
+}
+
+/**
+ * Wait on an address while it holds a value, until a deadline. The wait may
+ * return spuriously.
+ *   @addr: The address.
+ *   @val: The expected value.
+ *   @deadline: The deadline on the monotonic clock, in nanoseconds.
+ *   &returns: False if the deadline passed, true otherwise.
+ */
+
+bool _impl_thread_futex_timedwait(unsigned int *addr, unsigned int val, uint64_t deadline)
+{
+	struct timespec ts = { deadline / 1000000000, deadline % 1000000000 };
+
+#ifdef __linux__
+	if(syscall(SYS_futex, addr, FUTEX_WAIT_BITSET_PRIVATE, val, &ts, NULL, FUTEX_BITSET_MATCH_ANY) == 0)
+		return true;
+
+	return errno != ETIMEDOUT;
+#else
+	int err = 0;
+	struct park_t *park = park_get(addr);
+
+	pthread_mutex_lock(&park->lock);
+	if(__atomic_load_n(addr, __ATOMIC_SEQ_CST) == val)
+		err = pthread_cond_timedwait(&park->cond, &park->lock, &ts);
+
+	pthread_mutex_unlock(&park->lock);
+
+	return err != ETIMEDOUT;
+#endif
+}
+
+/**
+ * Wake waiters on an address.
+ *   @addr: The address.
+ *   @cnt: The maximum number of waiters to wake.
+ */
+
+void _impl_thread_futex_wake(unsigned int *addr, unsigned int cnt)
+{
+#ifdef __linux__
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, cnt, NULL, NULL, 0);
+#else
+	struct park_t *park = park_get(addr);
+
+	pthread_mutex_lock(&park->lock);
+	pthread_cond_broadcast(&park->cond);
+	pthread_mutex_unlock(&park->lock);
+#endif
+}
+
+
+#ifndef __linux__
+
+/**
+ * Retrieve the parking bucket for an address.
+ *   @addr: The address.
+ *   &returns: The bucket.
+ */
+
+static struct park_t *park_get(unsigned int *addr)
+{
+	pthread_once(&park_once, park_init);
+
+	return &park_bucket[((uintptr_t)addr / sizeof(unsigned int)) % PARK_SIZE];
+}
+
+/**
+ * Initialize the parking buckets.
+ */
+
+static void park_init()
+{
+	unsigned int i;
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+	for(i = 0; i < PARK_SIZE; i++) {
+		pthread_mutex_init(&park_bucket[i].lock, NULL);
+		pthread_cond_init(&park_bucket[i].cond, &attr);
+	}
+
+	pthread_condattr_destroy(&attr);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "../common.h"
+#include "base.h"
+#include "seq.h"
+
+
+/*
+ * local definitions
+ */
+
+#define BACKOFF_MAX	1024
+
+/*
+ * implementation function declarations
+ */
+
+void _impl_thread_yield();
+
+
+/**
+ * Sequence lock read slow path, waiting for a write to finish.
+ *   @lock: The sequence lock.
+ *   &returns: The even sequence once no write is in progress.
+ */
+
+_export
+unsigned int _thread_seq_wait(struct thread_seq_t *lock)
+{
+	unsigned int i, n = 1, seq;
+
+	while((seq = __atomic_load_n(&lock->seq, __ATOMIC_ACQUIRE)) & 1) {
+		if(n < BACKOFF_MAX) {
+			for(i = 0; i < n; i++)
+				thread_pause();
+
+			n *= 2;
+		}
+		else
+			_impl_thread_yield();
+	}
+
+	return seq;
+}
@@ -0,0 +1,137 @@
+#ifndef THREAD_SEQ_H
+#define THREAD_SEQ_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/**
+ * Sequence lock structure. The sequence is odd while a write is in
+ * progress.
+ *   @seq: The sequence.
+ */
+
+struct thread_seq_t {
+	unsigned int seq;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SEQ_INIT	{ 0 }
+
+
+/*
+ * sequence lock function declarations
+ */
+
+unsigned int _thread_seq_wait(struct thread_seq_t *lock);
+
+
+/**
+ * Begin a sequence lock read, waiting out any write in progress.
+ *   @lock: The sequence lock.
+ *   &returns: The sequence to pass to 'thread_seq_rdretry'.
+ */
+
+static inline unsigned int thread_seq_rdbegin(struct thread_seq_t *lock)
+{
+	unsigned int seq;
+
+	seq = __atomic_load_n(&lock->seq, __ATOMIC_ACQUIRE);
+
+	return (seq & 1) ? _thread_seq_wait(lock) : seq;
+}
+
+/**
+ * Finish a sequence lock read.
+ *   @lock: The sequence lock.
+ *   @seq: The sequence from 'thread_seq_rdbegin'.
+ *   &returns: True if a write intervened and the read must be retried.
+ */
+
+static inline bool thread_seq_rdretry(struct thread_seq_t *lock, unsigned int seq)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(&lock->seq, __ATOMIC_RELAXED) != seq;
+}
+
+/**
+ * Lock a sequence lock for writing. Writers exclude each other.
+ *   @lock: The sequence lock.
+ */
+
+static inline void thread_seq_wrlock(struct thread_seq_t *lock)
+{
+	unsigned int seq;
+
+	do
+		seq = thread_seq_rdbegin(lock);
+	while(!__atomic_compare_exchange_n(&lock->seq, &seq, seq + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * Unlock a sequence lock after writing.
+ *   @lock: The sequence lock.
+ */
+
+static inline void thread_seq_wrunlock(struct thread_seq_t *lock)
+{
+	__atomic_store_n(&lock->seq, __atomic_load_n(&lock->seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Read plain data protected by a sequence lock, retrying until a
+ * consistent copy is obtained. The data is copied a word at a time.
+ *   @lock: The sequence lock.
+ *   @dest: The destination.
+ *   @src: The protected data, aligned to the size of a pointer.
+ *   @nbytes: The number of bytes, a multiple of the size of a pointer.
+ */
+
+static inline void thread_seq_read(struct thread_seq_t *lock, void *dest, const void *src, size_t nbytes)
+{
+	size_t i;
+	unsigned int seq;
+
+	do {
+		seq = thread_seq_rdbegin(lock);
+		for(i = 0; i < nbytes / sizeof(uintptr_t); i++)
+			((uintptr_t *)dest)[i] = __atomic_load_n((const uintptr_t *)src + i, __ATOMIC_RELAXED);
+	} while(thread_seq_rdretry(lock, seq));
+}
+
+/**
+ * Write plain data protected by a sequence lock.
+ *   @lock: The sequence lock.
+ *   @dest: The protected data, aligned to the size of a pointer.
+ *   @src: The source.
+ *   @nbytes: The number of bytes, a multiple of the size of a pointer.
+ */
+
+static inline void thread_seq_write(struct thread_seq_t *lock, void *dest, const void *src, size_t nbytes)
+{
+	size_t i;
+
+	thread_seq_wrlock(lock);
+
+	for(i = 0; i < nbytes / sizeof(uintptr_t); i++)
+		__atomic_store_n((uintptr_t *)dest + i, ((const uintptr_t *)src)[i], __ATOMIC_RELAXED);
+
+	thread_seq_wrunlock(lock);
+}
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
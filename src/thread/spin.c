@@ -0,0 +1,142 @@
+#include "../common.h"
+#include "base.h"
+#include "spin.h"
+
+
+/*
+ * local definitions
+ */
+
+#define BACKOFF_MAX	1024
+#define ADAPT_MAX	256
+#define TICKET_PAUSE	64
+
+/*
+ * implementation function declarations
+ */
+
+unsigned int _impl_thread_ncpu();
+void _impl_thread_yield();
+void _impl_thread_futex_wait(unsigned int *addr, unsigned int val);
+void _impl_thread_futex_wake(unsigned int *addr, unsigned int cnt);
+
+/*
+ * local function declarations
+ */
+
+static bool multicore();
+
+
+/**
+ * Spinlock slow path.
+ *   @spin: The spinlock.
+ */
+
+_export
+void _thread_spin_slow(struct thread_spin_t *spin)
+{
+	unsigned int i, n = 1;
+
+	do {
+		while(__atomic_load_n(&spin->lock, __ATOMIC_RELAXED) != 0) {
+			if(n < BACKOFF_MAX) {
+				for(i = 0; i < n; i++)
+					thread_pause();
+
+				n *= 2;
+			}
+			else
+				_impl_thread_yield();
+		}
+	} while(__atomic_exchange_n(&spin->lock, 1, __ATOMIC_ACQUIRE) != 0);
+}
+
+/**
+ * Adaptive mutex slow path. The spin limit follows a moving average of the
+ * spins that previously succeeded, and spinning is skipped entirely on a
+ * single processor where the holder cannot make progress meanwhile.
+ *   @mutex: The mutex.
+ */
+
+_export
+void _thread_fmutex_slow(struct thread_fmutex_t *mutex)
+{
+	int spin;
+	unsigned int i, max, expect;
+
+	if(multicore()) {
+		spin = __atomic_load_n(&mutex->spin, __ATOMIC_RELAXED);
+		max = 2 * spin + 16;
+		if(max > ADAPT_MAX)
+			max = ADAPT_MAX;
+
+		for(i = 0; i < max; i++) {
+			thread_pause();
+
+			expect = 0;
+			if((__atomic_load_n(&mutex->state, __ATOMIC_RELAXED) == 0) && __atomic_compare_exchange_n(&mutex->state, &expect, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				break;
+		}
+
+		__atomic_store_n(&mutex->spin, spin + ((int)i - spin) / 8, __ATOMIC_RELAXED);
+		if(i < max)
+			return;
+	}
+
+	while(__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0)
+		_impl_thread_futex_wait(&mutex->state, 2);
+}
+
+/**
+ * Adaptive mutex wake path.
+ *   @mutex: The mutex.
+ */
+
+_export
+void _thread_fmutex_wake(struct thread_fmutex_t *mutex)
+{
+	_impl_thread_futex_wake(&mutex->state, 1);
+}
+
+/**
+ * Ticket lock slow path. Waiters back off in proportion to their distance
+ * from the head of the queue and yield when far behind.
+ *   @ticket: The ticket lock.
+ *   @mine: The caller's ticket.
+ */
+
+_export
+void _thread_ticket_slow(struct thread_ticket_t *ticket, unsigned int mine)
+{
+	unsigned int i, dist, serve;
+
+	while((serve = __atomic_load_n(&ticket->serve, __ATOMIC_ACQUIRE)) != mine) {
+		dist = mine - serve;
+		if(!multicore() || (dist > 8))
+			_impl_thread_yield();
+		else {
+			for(i = 0; i < dist * TICKET_PAUSE; i++)
+				thread_pause();
+		}
+	}
+}
+
+
+/**
+ * Check if the system has more than one processor.
+ *   &returns: True if multicore.
+ */
+
+static bool multicore()
+{
+	static unsigned int ncpu = 0;
+	unsigned int n;
+
+	n = __atomic_load_n(&ncpu, __ATOMIC_RELAXED);
+	if(n == 0) {
+		n = _impl_thread_ncpu();
+		__atomic_store_n(&ncpu, n, __ATOMIC_RELAXED);
+	}
+
+	return n > 1;
+}
@@ -0,0 +1,179 @@
+#ifndef THREAD_SPIN_H
+#define THREAD_SPIN_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/**
+ * Spinlock structure.
+ *   @lock: Nonzero when held.
+ */
+
+struct thread_spin_t {
+	unsigned int lock;
+};
+
+/**
+ * Adaptive mutex structure. The state is zero when unlocked, one when locked
+ * and two when locked with possible sleepers.
+ *   @state: The state.
+ *   @spin: The running estimate of useful spins.
+ */
+
+struct thread_fmutex_t {
+	unsigned int state;
+	unsigned int spin;
+};
+
+/**
+ * Ticket lock structure.
+ *   @next: The next ticket to hand out.
+ *   @serve: The ticket being served.
+ */
+
+struct thread_ticket_t {
+	unsigned int next;
+	unsigned int serve;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SPIN_INIT	{ 0 }
+#define THREAD_FMUTEX_INIT	{ 0, 0 }
+#define THREAD_TICKET_INIT	{ 0, 0 }
+
+
+/*
+ * spin function declarations
+ */
+
+void _thread_spin_slow(struct thread_spin_t *spin);
+void _thread_fmutex_slow(struct thread_fmutex_t *mutex);
+void _thread_fmutex_wake(struct thread_fmutex_t *mutex);
+void _thread_ticket_slow(struct thread_ticket_t *ticket, unsigned int mine);
+
+
+/**
+ * Lock a spinlock. Waiters spin on a plain load with exponential backoff,
+ * and yield the processor once the backoff is exhausted.
+ *   @spin: The spinlock.
+ */
+
+static inline void thread_spin_lock(struct thread_spin_t *spin)
+{
+	if(__atomic_exchange_n(&spin->lock, 1, __ATOMIC_ACQUIRE) != 0)
+		_thread_spin_slow(spin);
+}
+
+/**
+ * Try to lock a spinlock.
+ *   @spin: The spinlock.
+ *   &returns: True if locked, false if already held.
+ */
+
+static inline bool thread_spin_trylock(struct thread_spin_t *spin)
+{
+	return (__atomic_load_n(&spin->lock, __ATOMIC_RELAXED) == 0) && (__atomic_exchange_n(&spin->lock, 1, __ATOMIC_ACQUIRE) == 0);
+}
+
+/**
+ * Unlock a spinlock.
+ *   @spin: The spinlock.
+ */
+
+static inline void thread_spin_unlock(struct thread_spin_t *spin)
+{
+	__atomic_store_n(&spin->lock, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Lock an adaptive mutex. Contended lockers spin for a bounded, adaptively
+ * tuned time before sleeping on a futex.
+ *   @mutex: The mutex.
+ */
+
+static inline void thread_fmutex_lock(struct thread_fmutex_t *mutex)
+{
+	unsigned int expect = 0;
+
+	if(!__atomic_compare_exchange_n(&mutex->state, &expect, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		_thread_fmutex_slow(mutex);
+}
+
+/**
+ * Try to lock an adaptive mutex.
+ *   @mutex: The mutex.
+ *   &returns: True if locked, false if already held.
+ */
+
+static inline bool thread_fmutex_trylock(struct thread_fmutex_t *mutex)
+{
+	unsigned int expect = 0;
+
+	return __atomic_compare_exchange_n(&mutex->state, &expect, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Unlock an adaptive mutex, waking a sleeper if there may be one.
+ *   @mutex: The mutex.
+ */
+
+static inline void thread_fmutex_unlock(struct thread_fmutex_t *mutex)
+{
+	if(__atomic_exchange_n(&mutex->state, 0, __ATOMIC_RELEASE) == 2)
+		_thread_fmutex_wake(mutex);
+}
+
+
+/**
+ * Lock a ticket lock. Lockers are served in arrival order.
+ *   @ticket: The ticket lock.
+ */
+
+static inline void thread_ticket_lock(struct thread_ticket_t *ticket)
+{
+	unsigned int mine;
+
+	mine = __atomic_fetch_add(&ticket->next, 1, __ATOMIC_RELAXED);
+	if(__atomic_load_n(&ticket->serve, __ATOMIC_ACQUIRE) != mine)
+		_thread_ticket_slow(ticket, mine);
+}
+
+/**
+ * Try to lock a ticket lock.
+ *   @ticket: The ticket lock.
+ *   &returns: True if locked, false if held or contended.
+ */
+
+static inline bool thread_ticket_trylock(struct thread_ticket_t *ticket)
+{
+	unsigned int serve;
+
+	serve = __atomic_load_n(&ticket->serve, __ATOMIC_ACQUIRE);
+
+	return __atomic_compare_exchange_n(&ticket->next, &serve, serve + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Unlock a ticket lock, serving the next ticket.
+ *   @ticket: The ticket lock.
+ */
+
+static inline void thread_ticket_unlock(struct thread_ticket_t *ticket)
+{
+	__atomic_store_n(&ticket->serve, __atomic_load_n(&ticket->serve, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
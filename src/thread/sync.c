@@ -0,0 +1,399 @@
+#include "../common.h"
+#include "sync.h"
+#include "../debug/exception.h"
+#include "../sys/time.h"
+
+
+/*
+ * implementation function declarations
+ */
+
+void _impl_thread_futex_wait(unsigned int *addr, unsigned int val);
+bool _impl_thread_futex_timedwait(unsigned int *addr, unsigned int val, uint64_t deadline);
+void _impl_thread_futex_wake(unsigned int *addr, unsigned int cnt);
+
+/*
+ * local function declarations
+ */
+
+static uint64_t deadline_ns(uint64_t usec);
+static bool event_take(struct thread_event_t *event);
+
+
+/**
+ * Create a counting semaphore.
+ *   @count: The initial count.
+ *   &returns: The semaphore.
+ */
+
+_export
+struct thread_sem_t thread_sem_new(unsigned int count)
+{
+	return (struct thread_sem_t)THREAD_SEM_INIT(count);
+}
+
+
+/**
+ * Wait on a semaphore, decrementing its count once positive.
+ *   @sem: The semaphore.
+ */
+
+_export
+void thread_sem_wait(struct thread_sem_t *sem)
+{
+	while(!thread_sem_trywait(sem)) {
+		__atomic_add_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+		_impl_thread_futex_wait(&sem->count, 0);
+		__atomic_sub_fetch(&sem->waiters, 1, __ATOMIC_RELAXED);
+	}
+}
+
+/**
+ * Try to decrement a semaphore without waiting.
+ *   @sem: The semaphore.
+ *   &returns: True if decremented, false if the count was zero.
+ */
+
+_export
+bool thread_sem_trywait(struct thread_sem_t *sem)
+{
+	unsigned int count;
+
+	count = __atomic_load_n(&sem->count, __ATOMIC_RELAXED);
+	while(count > 0) {
+		if(__atomic_compare_exchange_n(&sem->count, &count, count - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Wait on a semaphore with a relative timeout.
+ *   @sem: The semaphore.
+ *   @usec: The timeout in microseconds.
+ *   &returns: True if decremented, false on timeout.
+ */
+
+_export
+bool thread_sem_waitfor(struct thread_sem_t *sem, uint64_t usec)
+{
+	return thread_sem_waituntil(sem, deadline_ns(usec));
+}
+
+/**
+ * Wait on a semaphore until a deadline on the monotonic clock.
+ *   @sem: The semaphore.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if decremented, false on timeout.
+ */
+
+_export
+bool thread_sem_waituntil(struct thread_sem_t *sem, uint64_t nsec)
+{
+	bool wait = true;
+
+	while(!thread_sem_trywait(sem)) {
+		if(!wait)
+			return false;
+
+		__atomic_add_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+		wait = _impl_thread_futex_timedwait(&sem->count, 0, nsec);
+		__atomic_sub_fetch(&sem->waiters, 1, __ATOMIC_RELAXED);
+	}
+
+	return true;
+}
+
+/**
+ * Post to a semaphore, incrementing its count and waking a waiter.
+ *   @sem: The semaphore.
+ */
+
+_export
+void thread_sem_post(struct thread_sem_t *sem)
+{
+	__atomic_add_fetch(&sem->count, 1, __ATOMIC_SEQ_CST);
+
+	if(__atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0)
+		_impl_thread_futex_wake(&sem->count, 1);
+}
+
+
+/**
+ * Create a reusable barrier.
+ *   @total: The number of threads per phase, at least one.
+ *   &returns: The barrier.
+ */
+
+_export
+struct thread_barrier_t thread_barrier_new(unsigned int total)
+{
+	if(total == 0)
+		throw("Barrier requires at least one thread.");
+
+	return (struct thread_barrier_t)THREAD_BARRIER_INIT(total);
+}
+
+
+/**
+ * Wait on a barrier until every thread of the phase has arrived. The barrier
+ * is immediately ready for the next phase.
+ *   @barrier: The barrier.
+ *   &returns: True for exactly one thread per phase, the last to arrive.
+ */
+
+_export
+bool thread_barrier_wait(struct thread_barrier_t *barrier)
+{
+	unsigned int phase;
+
+	phase = __atomic_load_n(&barrier->phase, __ATOMIC_ACQUIRE);
+
+	if(__atomic_add_fetch(&barrier->count, 1, __ATOMIC_ACQ_REL) == barrier->total) {
+		__atomic_store_n(&barrier->count, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&barrier->phase, phase + 1, __ATOMIC_RELEASE);
+		_impl_thread_futex_wake(&barrier->phase, INT_MAX);
+
+		return true;
+	}
+
+	while(__atomic_load_n(&barrier->phase, __ATOMIC_ACQUIRE) == phase)
+		_impl_thread_futex_wait(&barrier->phase, phase);
+
+	return false;
+}
+
+
+/**
+ * Create a countdown latch.
+ *   @count: The number of arrivals that open the latch.
+ *   &returns: The latch.
+ */
+
+_export
+struct thread_latch_t thread_latch_new(unsigned int count)
+{
+	return (struct thread_latch_t)THREAD_LATCH_INIT(count);
+}
+
+
+/**
+ * Count down a latch, waking every waiter on the final arrival.
+ *   @latch: The latch.
+ */
+
+_export
+void thread_latch_arrive(struct thread_latch_t *latch)
+{
+	unsigned int count;
+
+	count = __atomic_load_n(&latch->count, __ATOMIC_RELAXED);
+	do {
+		if(count == 0)
+			_fatal("Latch already open.");
+	} while(!__atomic_compare_exchange_n(&latch->count, &count, count - 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	if(count == 1)
+		_impl_thread_futex_wake(&latch->count, INT_MAX);
+}
+
+/**
+ * Check if a latch is open.
+ *   @latch: The latch.
+ *   &returns: True if the count has reached zero.
+ */
+
+_export
+bool thread_latch_isready(struct thread_latch_t *latch)
+{
+	return __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * Wait for a latch to open.
+ *   @latch: The latch.
+ */
+
+_export
+void thread_latch_wait(struct thread_latch_t *latch)
+{
+	unsigned int count;
+
+	while((count = __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE)) != 0)
+		_impl_thread_futex_wait(&latch->count, count);
+}
+
+/**
+ * Wait for a latch to open with a relative timeout.
+ *   @latch: The latch.
+ *   @usec: The timeout in microseconds.
+ *   &returns: True if open, false on timeout.
+ */
+
+_export
+bool thread_latch_waitfor(struct thread_latch_t *latch, uint64_t usec)
+{
+	return thread_latch_waituntil(latch, deadline_ns(usec));
+}
+
+/**
+ * Wait for a latch to open until a deadline on the monotonic clock.
+ *   @latch: The latch.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if open, false on timeout.
+ */
+
+_export
+bool thread_latch_waituntil(struct thread_latch_t *latch, uint64_t nsec)
+{
+	unsigned int count;
+
+	while((count = __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE)) != 0) {
+		if(!_impl_thread_futex_timedwait(&latch->count, count, nsec))
+			return thread_latch_isready(latch);
+	}
+
+	return true;
+}
+
+
+/**
+ * Create an event. An auto-reset event releases a single waiter per set,
+ * while a manual-reset event releases every waiter until reset.
+ *   @manual: Flag indicating manual reset.
+ *   &returns: The event.
+ */
+
+_export
+struct thread_event_t thread_event_new(bool manual)
+{
+	return (struct thread_event_t)THREAD_EVENT_INIT(manual);
+}
+
+
+/**
+ * Set an event, waking one waiter for an auto-reset event or every waiter
+ * for a manual-reset event.
+ *   @event: The event.
+ */
+
+_export
+void thread_event_set(struct thread_event_t *event)
+{
+	__atomic_store_n(&event->state, 1, __ATOMIC_SEQ_CST);
+
+	if(__atomic_load_n(&event->waiters, __ATOMIC_SEQ_CST) > 0)
+		_impl_thread_futex_wake(&event->state, event->manual ? INT_MAX : 1);
+}
+
+/**
+ * Reset an event.
+ *   @event: The event.
+ */
+
+_export
+void thread_event_reset(struct thread_event_t *event)
+{
+	__atomic_store_n(&event->state, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * Wait for an event to be set. An auto-reset event is reset on return.
+ *   @event: The event.
+ */
+
+_export
+void thread_event_wait(struct thread_event_t *event)
+{
+	while(!event_take(event)) {
+		__atomic_add_fetch(&event->waiters, 1, __ATOMIC_SEQ_CST);
+		_impl_thread_futex_wait(&event->state, 0);
+		__atomic_sub_fetch(&event->waiters, 1, __ATOMIC_RELAXED);
+	}
+}
+
+/**
+ * Check an event without waiting. An auto-reset event is reset on success.
+ *   @event: The event.
+ *   &returns: True if the event was set.
+ */
+
+_export
+bool thread_event_trywait(struct thread_event_t *event)
+{
+	return event_take(event);
+}
+
+/**
+ * Wait for an event to be set with a relative timeout. An auto-reset event
+ * is reset on success.
+ *   @event: The event.
+ *   @usec: The timeout in microseconds.
+ *   &returns: True if the event was set, false on timeout.
+ */
+
+_export
+bool thread_event_waitfor(struct thread_event_t *event, uint64_t usec)
+{
+	return thread_event_waituntil(event, deadline_ns(usec));
+}
+
+/**
+ * Wait for an event to be set until a deadline on the monotonic clock. An
+ * auto-reset event is reset on success.
+ *   @event: The event.
+ *   @nsec: The deadline in nanoseconds.
+ *   &returns: True if the event was set, false on timeout.
+ */
+
+_export
+bool thread_event_waituntil(struct thread_event_t *event, uint64_t nsec)
+{
+	bool wait = true;
+
+	while(!event_take(event)) {
+		if(!wait)
+			return false;
+
+		__atomic_add_fetch(&event->waiters, 1, __ATOMIC_SEQ_CST);
+		wait = _impl_thread_futex_timedwait(&event->state, 0, nsec);
+		__atomic_sub_fetch(&event->waiters, 1, __ATOMIC_RELAXED);
+	}
+
+	return true;
+}
+
+
+/**
+ * Compute a deadline on the monotonic clock, saturating instead of wrapping
+ * for timeouts too far in the future.
+ *   @usec: The timeout in microseconds.
+ *   &returns: The deadline in nanoseconds.
+ */
+
+static uint64_t deadline_ns(uint64_t usec)
+{
+	uint64_t nsec;
+
+	if(__builtin_mul_overflow(usec, (uint64_t)1000, &nsec) || __builtin_add_overflow(nsec, sys_monotonic_ns(), &nsec))
+		return UINT64_MAX;
+
+	return nsec;
+}
+
+/**
+ * Take an event if set, resetting an auto-reset event.
+ *   @event: The event.
+ *   &returns: True if the event was set.
+ */
+
+static bool event_take(struct thread_event_t *event)
+{
+	unsigned int state = 1;
+
+	if(event->manual)
+		return __atomic_load_n(&event->state, __ATOMIC_ACQUIRE) == 1;
+	else
+		return __atomic_compare_exchange_n(&event->state, &state, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,117 @@
+#ifndef THREAD_SYNC_H
+#define THREAD_SYNC_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/**
+ * Counting semaphore structure.
+ *   @count: The count.
+ *   @waiters: The number of sleeping waiters.
+ */
+
+struct thread_sem_t {
+	unsigned int count;
+	unsigned int waiters;
+};
+
+/**
+ * Reusable barrier structure.
+ *   @count: The number of threads arrived in the current phase.
+ *   @total: The number of threads per phase.
+ *   @phase: The phase, incremented when every thread has arrived.
+ */
+
+struct thread_barrier_t {
+	unsigned int count;
+	unsigned int total;
+	unsigned int phase;
+};
+
+/**
+ * Countdown latch structure.
+ *   @count: The remaining count.
+ */
+
+struct thread_latch_t {
+	unsigned int count;
+};
+
+/**
+ * Event structure.
+ *   @state: One when set, zero otherwise.
+ *   @waiters: The number of sleeping waiters.
+ *   @manual: Flag indicating the event stays set until reset.
+ */
+
+struct thread_event_t {
+	unsigned int state;
+	unsigned int waiters;
+	bool manual;
+};
+
+/*
+ * static initializer definitions
+ */
+
+#define THREAD_SEM_INIT(n)	{ (n), 0 }
+#define THREAD_BARRIER_INIT(n)	{ 0, (n), 0 }
+#define THREAD_LATCH_INIT(n)	{ (n) }
+#define THREAD_EVENT_INIT(m)	{ 0, 0, (m) }
+
+
+/*
+ * semaphore function declarations
+ */
+
+struct thread_sem_t thread_sem_new(unsigned int count);
+
+void thread_sem_wait(struct thread_sem_t *sem);
+bool thread_sem_trywait(struct thread_sem_t *sem);
+bool thread_sem_waitfor(struct thread_sem_t *sem, uint64_t usec);
+bool thread_sem_waituntil(struct thread_sem_t *sem, uint64_t nsec);
+void thread_sem_post(struct thread_sem_t *sem);
+
+/*
+ * barrier function declarations
+ */
+
+struct thread_barrier_t thread_barrier_new(unsigned int total);
+
+bool thread_barrier_wait(struct thread_barrier_t *barrier);
+
+/*
+ * latch function declarations
+ */
+
+struct thread_latch_t thread_latch_new(unsigned int count);
+
+void thread_latch_arrive(struct thread_latch_t *latch);
+bool thread_latch_isready(struct thread_latch_t *latch);
+void thread_latch_wait(struct thread_latch_t *latch);
+bool thread_latch_waitfor(struct thread_latch_t *latch, uint64_t usec);
+bool thread_latch_waituntil(struct thread_latch_t *latch, uint64_t nsec);
+
+/*
+ * event function declarations
+ */
+
+struct thread_event_t thread_event_new(bool manual);
+
+void thread_event_set(struct thread_event_t *event);
+void thread_event_reset(struct thread_event_t *event);
+void thread_event_wait(struct thread_event_t *event);
+bool thread_event_trywait(struct thread_event_t *event);
+bool thread_event_waitfor(struct thread_event_t *event, uint64_t usec);
+bool thread_event_waituntil(struct thread_event_t *event, uint64_t nsec);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -1,9 +1,9 @@
 #include "../common.h"
 #include "enum.h"
 #include "../mem/manage.h"
-#include "../types/avltree.h"
 #include "filter.h"
 #include "iter.h"
+#include "sort.h"
 
 
 /**
@@ -52,6 +52,17 @@ struct sort_t {
 	compare_f compare;
 };
 
+/**
+ * Sorted array iterator structure.
+ *   @arr: The sorted references.
+ *   @idx, len: The position and length.
+ */
+
+struct sorted_t {
+	void **arr;
+	size_t idx, len;
+};
+
 /**
  * Compose structure for enumeration.
  *   @outer, inner: The outer and inner enumerators.
@@ -80,6 +91,9 @@ static void apply_delete(struct apply_t *apply);
 static struct iter_t sort_iter(struct sort_t *sort);
 static void sort_delete(struct sort_t *sort);
 
+static void *sorted_next(struct sorted_t *sorted);
+static void sorted_delete(struct sorted_t *sorted);
+
 static struct iter_t compose_iter(struct compose_t *compose);
 static void compose_delete(struct compose_t *compose);
 
@@ -279,7 +293,8 @@ struct enum_t enum_sort(struct enum_t inner, compare_f compare)
 }
 
 /**
- * Create an iterator from the sort enumerator.
+ * Create an iterator from the sort enumerator. The references are gathered
+ * into an array and stable sorted, so duplicates are kept in input order.
  *   @sort: The sort structure.
  *   &returns: The iterator.
  */
@@ -287,18 +302,27 @@ struct enum_t enum_sort(struct enum_t inner, compare_f compare)
 static struct iter_t sort_iter(struct sort_t *sort)
 {
 	void *ref;
+	size_t cap = 64;
 	struct iter_t iter;
-	struct avltree_t *tree;
+	struct sorted_t *sorted;
+	static const struct iter_i iface = { (iter_f)sorted_next, (delete_f)sorted_delete };
 
-	tree = avltree_new(sort->compare, NULL);
+	sorted = mem_alloc(sizeof(struct sorted_t));
+	sorted->arr = mem_alloc(cap * sizeof(void *));
+	sorted->idx = sorted->len = 0;
 
 	iter = enum_iter(sort->inner);
-	while((ref = iter_next(iter)) != NULL)
-		avltree_insert(tree, ref, ref);
+	while((ref = iter_next(iter)) != NULL) {
+		if(sorted->len == cap)
+			sorted->arr = mem_realloc(sorted->arr, (cap *= 2) * sizeof(void *));
+
+		sorted->arr[sorted->len++] = ref;
+	}
 
 	iter_delete(iter);
+	sort_stable(sorted->arr, sorted->len, sort->compare);
 
-	return avltree_asiter(tree);
+	return (struct iter_t){ sorted, &iface };
 }
 
 /**
@@ -312,6 +336,28 @@ static void sort_delete(struct sort_t *sort)
 	mem_free(sort);
 }
 
+/**
+ * Retrieve the next reference from a sorted array iterator.
+ *   @sorted: The sorted iterator.
+ *   &returns: The reference or null.
+ */
+
+static void *sorted_next(struct sorted_t *sorted)
+{
+	return (sorted->idx < sorted->len) ? sorted->arr[sorted->idx++] : NULL;
+}
+
+/**
+ * Delete a sorted array iterator.
+ *   @sorted: The sorted iterator.
+ */
+
+static void sorted_delete(struct sorted_t *sorted)
+{
+	mem_free(sorted->arr);
+	mem_free(sorted);
+}
+
 
 /**
  * Compose two enumerators.
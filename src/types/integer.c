@@ -12,17 +12,16 @@
 
 
 /*
- * bit manipulation definitions
+ * local definitions
  */
 
-#define ROR(val) ((val) >> (8 * sizeof(unsigned short)))
-#define ROL(val) ((val) << (8 * sizeof(unsigned short)))
+#define KARA_THRESH	32
+#define CONV_THRESH	32
 
-#define GETLOW(val) ((val) & (unsigned int)(USHRT_MAX))
-#define GETHI(val) (ROR(val) & (unsigned int)(USHRT_MAX))
+#define DEC_DIGITS	19
+#define DEC_BASE	UINT64_C(10000000000000000000)
 
-#define SETLOW(val, low) (((val) & ~(unsigned int)(USHRT_MAX)) | (unsigned int)(GETLOW(low)))
-#define SETHI(val, hi) (((val) & ~ROL((unsigned int)(USHRT_MAX))) | ROL((unsigned int)(GETLOW(hi))))
+#define LIMB_SIZE(len) (sizeof(struct integer_t) + (len) * sizeof(uint64_t))
 
 /*
  * local function declarations
@@ -30,11 +29,32 @@
 
 static void chunk_proc(struct io_output_t output, void *arg);
 
+static struct integer_t *op_alloc(unsigned int len);
 static void op_resize(struct integer_t **integer, unsigned int len);
 static void op_shrink(struct integer_t **integer);
-static void op_add(unsigned int *val, unsigned int add, bool *c);
-static void op_sub(unsigned int *val, unsigned int sub, bool *c);
-static void op_rev(unsigned int *val, unsigned int sub, bool *c);
+static void op_addsub(struct integer_t **integer, const uint64_t *arr, unsigned int len, bool neg);
+static void op_divmod(const struct integer_t *left, const struct integer_t *right, struct integer_t **quot, struct integer_t **rem);
+static void op_bitwise(struct integer_t **integer, const struct integer_t *val, char op);
+static void op_twos(uint64_t *arr, unsigned int len);
+
+static unsigned int mag_norm(const uint64_t *arr, unsigned int len);
+static int mag_cmp(const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+static uint64_t mag_add(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+static uint64_t mag_sub(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+static uint64_t mag_mul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m);
+static uint64_t mag_addmul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m);
+static uint64_t mag_submul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m);
+static void mag_basemul(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+static void mag_kara(uint64_t *r, const uint64_t *a, const uint64_t *b, unsigned int n, uint64_t *tmp);
+static void mag_mul(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+static uint64_t mag_lshift(uint64_t *r, const uint64_t *a, unsigned int n, unsigned int s);
+static uint64_t mag_rshift(uint64_t *r, const uint64_t *a, unsigned int n, unsigned int s);
+static uint64_t mag_divrem1(uint64_t *q, const uint64_t *a, unsigned int n, uint64_t d);
+static void mag_divrem(uint64_t *q, uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn);
+
+static void conv_pow(uint64_t **pow, unsigned int *pown, unsigned int k);
+static unsigned int conv_get(uint64_t *r, const char *dig, size_t n, uint64_t **pow, unsigned int *pown);
+static void conv_put(char *buf, const uint64_t *x, unsigned int xn, uint64_t **pow, unsigned int *pown, unsigned int k);
 
 
 /**
@@ -45,13 +65,7 @@ static void op_rev(unsigned int *val, unsigned int sub, bool *c);
 _export
 struct integer_t *integer_zero()
 {
-	struct integer_t *integer;
-
-	integer = mem_alloc(sizeof(struct integer_t));
-	integer->neg = false;
-	integer->len = 0;
-
-	return integer;
+	return op_alloc(0);
 }
 
 /**
@@ -65,17 +79,12 @@ struct integer_t *integer_new(int val)
 {
 	struct integer_t *integer;
 
-	integer = mem_alloc(sizeof(struct integer_t) + sizeof(unsigned int));
-	integer->len = 1;
+	if(val == 0)
+		return op_alloc(0);
 
-	if(val >= 0) {
-		integer->neg = false;
-		integer->arr[0] = val;
-	}
-	else {
-		integer->neg = true;
-		integer->arr[0] = -val;
-	}
+	integer = op_alloc(1);
+	integer->neg = (val < 0);
+	integer->arr[0] = (val < 0) ? -(uint64_t)(int64_t)val : (uint64_t)val;
 
 	return integer;
 }
@@ -91,10 +100,9 @@ struct integer_t *integer_copy(const struct integer_t *integer)
 {
 	struct integer_t *copy;
 
-	copy = mem_alloc(sizeof(struct integer_t) + integer->len * sizeof(unsigned int));
+	copy = op_alloc(integer->len);
 	copy->neg = integer->neg;
-	copy->len = integer->len;
-	mem_copy(copy->arr, integer->arr, integer->len * sizeof(unsigned int));
+	mem_copy(copy->arr, integer->arr, integer->len * sizeof(uint64_t));
 
 	return copy;
 }
@@ -124,7 +132,10 @@ struct integer_t *integer_parse(const char *str, char **endptr)
 }
 
 /**
- * Read an integer from the input.
+ * Read an integer from the input. The digits are collected first and then
+ * converted as a whole: power-of-two bases are packed directly into limbs and
+ * decimal numbers are converted by recursively splitting the digit string, so
+ * large numbers convert in sub-quadratic time.
  *   @input: The input.
  *   @cur: Optional. The current input.
  *   &returns: The integer.
@@ -136,6 +147,8 @@ struct integer_t *integer_scan(struct io_input_t input, int16_t *cur)
 	bool neg;
 	int8_t digit;
 	uint8_t base;
+	char *dig;
+	size_t n, size;
 	struct integer_t *integer;
 	int16_t ch = ((cur != NULL) && (*cur != IO_EOS)) ? *cur : io_input_byte(input);
 
@@ -166,16 +179,52 @@ struct integer_t *integer_scan(struct io_input_t input, int16_t *cur)
 	if(digit >= base)
 		throw("Invalid number.");
 
-	integer = integer_new((digit < 0) ? 0 : (neg ? -digit : digit));
+	n = 0;
+	size = 64;
+	dig = mem_alloc(size);
+
+	while((digit >= 0) && (digit < base)) {
+		if(n == size)
+			dig = mem_realloc(dig, size *= 2);
 
-	while(true) {
+		dig[n++] = digit;
 		digit = str_getdigit(ch = io_input_byte(input));
-		if((digit < 0) || (digit >= base))
-			break;
+	}
+
+	if(base == 10) {
+		unsigned int i;
+		uint64_t *pow[64];
+		unsigned int pown[64];
+
+		for(i = 0; i < 64; i++)
+			pow[i] = NULL;
+
+		integer = op_alloc(n / DEC_DIGITS + 1);
+		integer->len = conv_get(integer->arr, dig, n, pow, pown);
 
-		integer_mul_ushort(&integer, base);
-		integer_add_ushort(&integer, digit);
+		for(i = 0; i < 64; i++) {
+			if(pow[i] != NULL)
+				mem_free(pow[i]);
+		}
 	}
+	else {
+		size_t i, pos;
+		unsigned int bits = (base == 16) ? 4 : (base == 8) ? 3 : 1;
+
+		integer = op_alloc((n * bits + 63) / 64);
+		mem_zero(integer->arr, integer->len * sizeof(uint64_t));
+
+		for(i = n, pos = 0; i-- > 0; pos += bits) {
+			integer->arr[pos / 64] |= (uint64_t)dig[i] << (pos % 64);
+			if((pos % 64) + bits > 64)
+				integer->arr[pos / 64 + 1] |= (uint64_t)dig[i] >> (64 - pos % 64);
+		}
+	}
+
+	mem_free(dig);
+
+	integer->neg = neg;
+	op_shrink(&integer);
 
 	if(cur != NULL)
 		*cur = ch;
@@ -204,19 +253,7 @@ void integer_delete(struct integer_t *integer)
 _export
 uint8_t integer_uint8(struct integer_t *integer)
 {
-	uint8_t val;
-
-#if UINT8_MAX <= UINT_MAX
-	val = integer->arr[0];
-#else
-	unsigned int i;
-
-	val = 0;
-	for(i = m_uintmin(sizeof(uint8_t) / sizeof(unsigned int), integer->len) - 1; i != UINT_MAX; i--)
-		val = val * ((uint8_t)1 << (8 * sizeof(unsigned int))) + integer->arr[i];
-#endif
-
-	return integer->neg ? -val : val;
+	return integer_uint64(integer);
 }
 
 /**
@@ -230,11 +267,7 @@ int8_t integer_uint8chk(struct integer_t *integer)
 {
 	if(integer->neg)
 		return -1;
-#if UINT8_MAX < UINT_MAX
-	else if((integer->len > 1) || (integer->arr[0] > UINT8_MAX))
-#else
-	else if(integer->len > (sizeof(uint8_t) / sizeof(unsigned int)))
-#endif
+	else if((integer->len > 1) || ((integer->len == 1) && (integer->arr[0] > UINT8_MAX)))
 		return 0;
 	else
 		return 1;
@@ -249,19 +282,7 @@ int8_t integer_uint8chk(struct integer_t *integer)
 _export
 uint16_t integer_uint16(struct integer_t *integer)
 {
-	uint16_t val;
-
-#if UINT16_MAX <= UINT_MAX
-	val = integer->arr[0];
-#else
-	unsigned int i;
-
-	val = 0;
-	for(i = m_uintmin(sizeof(uint16_t) / sizeof(unsigned int), integer->len) - 1; i != UINT_MAX; i--)
-		val = val * ((uint16_t)1 << (8 * sizeof(unsigned int))) + integer->arr[i];
-#endif
-
-	return integer->neg ? -val : val;
+	return integer_uint64(integer);
 }
 
 /**
@@ -275,11 +296,7 @@ int8_t integer_uint16chk(struct integer_t *integer)
 {
 	if(integer->neg)
 		return -1;
-#if UINT16_MAX < UINT_MAX
-	else if((integer->len > 1) || (integer->arr[0] > UINT16_MAX))
-#else
-	else if(integer->len > (sizeof(uint16_t) / sizeof(unsigned int)))
-#endif
+	else if((integer->len > 1) || ((integer->len == 1) && (integer->arr[0] > UINT16_MAX)))
 		return 0;
 	else
 		return 1;
@@ -294,19 +311,7 @@ int8_t integer_uint16chk(struct integer_t *integer)
 _export
 uint32_t integer_uint32(struct integer_t *integer)
 {
-	uint32_t val;
-
-#if UINT32_MAX <= UINT_MAX
-	val = integer->arr[0];
-#else
-	unsigned int i;
-
-	val = 0;
-	for(i = m_uintmin(sizeof(uint32_t) / sizeof(unsigned int), integer->len) - 1; i != UINT_MAX; i--)
-		val = val * ((uint32_t)1 << (8 * sizeof(unsigned int))) + integer->arr[i];
-#endif
-
-	return integer->neg ? -val : val;
+	return integer_uint64(integer);
 }
 
 /**
@@ -320,11 +325,7 @@ int8_t integer_uint32chk(struct integer_t *integer)
 {
 	if(integer->neg)
 		return -1;
-#if UINT32_MAX < UINT_MAX
-	else if((integer->len > 1) || (integer->arr[0] > UINT32_MAX))
-#else
-	else if(integer->len > (sizeof(uint32_t) / sizeof(unsigned int)))
-#endif
+	else if((integer->len > 1) || ((integer->len == 1) && (integer->arr[0] > UINT32_MAX)))
 		return 0;
 	else
 		return 1;
@@ -341,15 +342,7 @@ uint64_t integer_uint64(struct integer_t *integer)
 {
 	uint64_t val;
 
-#if UINT64_MAX <= UINT_MAX
-	val = integer->arr[0];
-#else
-	unsigned int i;
-
-	val = 0;
-	for(i = m_uintmin(sizeof(uint64_t) / sizeof(unsigned int), integer->len) - 1; i != UINT_MAX; i--)
-		val = val * ((uint64_t)1 << (8 * sizeof(unsigned int))) + integer->arr[i];
-#endif
+	val = (integer->len > 0) ? integer->arr[0] : 0;
 
 	return integer->neg ? -val : val;
 }
@@ -365,11 +358,7 @@ int8_t integer_uint64chk(struct integer_t *integer)
 {
 	if(integer->neg)
 		return -1;
-#if UINT64_MAX < UINT_MAX
-	else if((integer->len > 1) || (integer->arr[0] > UINT64_MAX))
-#else
-	else if(integer->len > (sizeof(uint64_t) / sizeof(unsigned int)))
-#endif
+	else if(integer->len > 1)
 		return 0;
 	else
 		return 1;
@@ -383,29 +372,9 @@ int8_t integer_uint64chk(struct integer_t *integer)
  */
 
 _export
-void integer_add(struct integer_t **integer, struct integer_t *val)
+void integer_add(struct integer_t **integer, const struct integer_t *val)
 {
-	if(val->neg) {
-		val->neg = false;
-		integer_sub(integer, val);
-		val->neg = true;
-	}
-	else {
-		bool c;
-		unsigned int i;
-
-		if(val->len > (*integer)->len)
-			op_resize(integer, val->len);
-
-		for(i = 0, c = false; (i < val->len) || (c && (i < (*integer)->len)); i++)
-			op_add(&(*integer)->arr[i], (i < val->len) ? val->arr[i] : 0, &c);
-
-		if(c) {
-			*integer = mem_realloc(*integer, sizeof(struct integer_t) + (i + 1) * sizeof(unsigned int));
-			(*integer)->len = i + 1;
-			(*integer)->arr[i] = 1;
-		}
-	}
+	op_addsub(integer, val->arr, val->len, val->neg);
 }
 
 /**
@@ -417,23 +386,9 @@ void integer_add(struct integer_t **integer, struct integer_t *val)
 _export
 void integer_add_uint(struct integer_t **integer, unsigned int val)
 {
-	unsigned int i, t;
-
-	for(i = 0; i < (*integer)->len; i++) {
-		t = (*integer)->arr[i];
-		(*integer)->arr[i] += val;
-
-		if((*integer)->arr[i] >= t)
-			return;
+	uint64_t limb = val;
 
-		val = 1;
-	}
-
-	if(val > 0) {
-		*integer = mem_realloc(*integer, sizeof(struct integer_t) + (i + 1) * sizeof(unsigned int));
-		(*integer)->len = i + 1;
-		(*integer)->arr[i] = val;
-	}
+	op_addsub(integer, &limb, (val > 0) ? 1 : 0, false);
 }
 
 /**
@@ -456,36 +411,43 @@ void integer_add_ushort(struct integer_t **integer, unsigned short val)
  */
 
 _export
-void integer_sub(struct integer_t **integer, struct integer_t *val)
+void integer_sub(struct integer_t **integer, const struct integer_t *val)
 {
-	if(val->neg) {
-		val->neg = false;
-		integer_add(integer, val);
-		val->neg = true;
-	}
-	else if(integer_cmp(*integer, val) >= 0) {
-		bool c;
-		unsigned int i;
+	op_addsub(integer, val->arr, val->len, !val->neg);
+}
 
-		for(i = 0, c = false; (i < val->len) || (c && (i < (*integer)->len)); i++)
-			op_sub(&(*integer)->arr[i], (i < val->len) ? val->arr[i] : 0, &c);
 
-		op_shrink(integer);
-	}
-	else {
-		bool c;
-		unsigned int i;
+/**
+ * Multiply the integer by another integer. Large operands use Karatsuba
+ * multiplication.
+ *   @integer: The integer.
+ *   @val: The value to multiply.
+ */
 
-		op_resize(integer, val->len);
+_export
+void integer_mul(struct integer_t **integer, const struct integer_t *val)
+{
+	struct integer_t *res;
 
-		for(i = 0, c = false; i < (*integer)->len; i++)
-			op_rev(&(*integer)->arr[i], (i < val->len) ? val->arr[i] : 0, &c);
+	if(integer_iszero(*integer) || integer_iszero(val)) {
+		op_resize(integer, 0);
+		(*integer)->neg = false;
 
-		(*integer)->neg = true;
-		op_shrink(integer);
+		return;
 	}
-}
 
+	res = op_alloc((*integer)->len + val->len);
+	res->neg = (*integer)->neg != val->neg;
+
+	if((*integer)->len >= val->len)
+		mag_mul(res->arr, (*integer)->arr, (*integer)->len, val->arr, val->len);
+	else
+		mag_mul(res->arr, val->arr, val->len, (*integer)->arr, (*integer)->len);
+
+	mem_free(*integer);
+	*integer = res;
+	op_shrink(integer);
+}
 
 /**
  * Multiply the integer by an unsigned short.
@@ -496,25 +458,64 @@ void integer_sub(struct integer_t **integer, struct integer_t *val)
 _export
 void integer_mul_ushort(struct integer_t **integer, unsigned short val)
 {
-	unsigned int i, mul, carry = 0;
-
-	for(i = 0; i < (*integer)->len; i++) {
-		mul = GETLOW((*integer)->arr[i]) * val + carry;
-		(*integer)->arr[i] = SETLOW((*integer)->arr[i], mul);
-		carry = GETHI(mul);
-
-		mul = GETHI((*integer)->arr[i]) * val + carry;
-		(*integer)->arr[i] = SETHI((*integer)->arr[i], mul);
-		carry = GETHI(mul);
-	}
+	uint64_t carry;
 
+	carry = mag_mul1((*integer)->arr, (*integer)->arr, (*integer)->len, val);
 	if(carry > 0) {
-		*integer = mem_realloc(*integer, sizeof(struct integer_t) + (i + 1) * sizeof(unsigned int));
-		(*integer)->len = i + 1;
-		(*integer)->arr[i] = carry;
+		op_resize(integer, (*integer)->len + 1);
+		(*integer)->arr[(*integer)->len - 1] = carry;
 	}
+
+	op_shrink(integer);
+}
+
+
+/**
+ * Divide the integer by another integer, truncating towards zero. The
+ * remainder takes the sign of the dividend.
+ *   @integer: The integer, replaced by the quotient.
+ *   @val: The divisor.
+ *   @rem: Optional. Out. The remainder.
+ */
+
+_export
+void integer_divmod(struct integer_t **integer, const struct integer_t *val, struct integer_t **rem)
+{
+	struct integer_t *quot;
+
+	op_divmod(*integer, val, &quot, rem);
+	mem_free(*integer);
+	*integer = quot;
 }
 
+/**
+ * Divide the integer by another integer, truncating towards zero.
+ *   @integer: The integer.
+ *   @val: The divisor.
+ */
+
+_export
+void integer_div(struct integer_t **integer, const struct integer_t *val)
+{
+	integer_divmod(integer, val, NULL);
+}
+
+/**
+ * Replace the integer with the remainder of a division. The remainder takes
+ * the sign of the dividend.
+ *   @integer: The integer.
+ *   @val: The divisor.
+ */
+
+_export
+void integer_mod(struct integer_t **integer, const struct integer_t *val)
+{
+	struct integer_t *rem;
+
+	op_divmod(*integer, val, NULL, &rem);
+	mem_free(*integer);
+	*integer = rem;
+}
 
 /**
  * Divide the integer by an unsigned short.
@@ -526,29 +527,110 @@ void integer_mul_ushort(struct integer_t **integer, unsigned short val)
 _export
 unsigned short integer_div_ushort(struct integer_t **integer, unsigned short val)
 {
-	unsigned int i, rem = 0;
+	unsigned short rem;
+
+	if(val == 0)
+		throw("Division by zero.");
+
+	rem = mag_divrem1((*integer)->arr, (*integer)->arr, (*integer)->len, val);
+	op_shrink(integer);
+
+	return rem;
+}
+
+
+/**
+ * Shift the integer left.
+ *   @integer: The integer.
+ *   @bits: The number of bits.
+ */
+
+_export
+void integer_shl(struct integer_t **integer, unsigned int bits)
+{
+	unsigned int len, off = bits / 64;
+
+	if(integer_iszero(*integer))
+		return;
+
+	len = (*integer)->len;
+	op_resize(integer, len + off + 1);
+	(*integer)->arr[len + off] = mag_lshift((*integer)->arr + off, (*integer)->arr, len, bits % 64);
+	mem_zero((*integer)->arr, off * sizeof(uint64_t));
+	op_shrink(integer);
+}
+
+/**
+ * Shift the integer right. Negative values are rounded towards negative
+ * infinity, matching an arithmetic shift on two's complement.
+ *   @integer: The integer.
+ *   @bits: The number of bits.
+ */
 
-	for(i = (*integer)->len - 1; i != UINT_MAX; i--) {
-		rem = ROL(rem) + GETHI((*integer)->arr[i]);
-		(*integer)->arr[i] = SETHI((*integer)->arr[i], rem / val);
-		rem %= val;
+_export
+void integer_shr(struct integer_t **integer, unsigned int bits)
+{
+	bool lost, neg = (*integer)->neg;
+	unsigned int i, off = bits / 64;
 
-		rem = ROL(rem) + GETLOW((*integer)->arr[i]);
-		(*integer)->arr[i] = SETLOW((*integer)->arr[i], rem / val);
-		rem %= val;
+	if(off >= (*integer)->len) {
+		lost = !integer_iszero(*integer);
+		op_resize(integer, 0);
 	}
+	else {
+		lost = ((*integer)->arr[off] & (((uint64_t)1 << (bits % 64)) - 1)) != 0;
+		for(i = 0; i < off; i++)
+			lost |= ((*integer)->arr[i] != 0);
 
-	for(i = (*integer)->len - 1; i != UINT_MAX; i--) {
-		if((*integer)->arr[i] > 0)
-			break;
+		mag_rshift((*integer)->arr, (*integer)->arr + off, (*integer)->len - off, bits % 64);
+		(*integer)->len -= off;
+		op_shrink(integer);
 	}
 
-	if(++i != (*integer)->len) {
-		*integer = mem_realloc(*integer, sizeof(struct integer_t) + i * sizeof(unsigned int));
-		(*integer)->len = i;
+	if(neg && lost) {
+		uint64_t one = 1;
+
+		op_addsub(integer, &one, 1, true);
 	}
+}
 
-	return rem;
+/**
+ * Compute the bitwise and of two integers, treating negative values as two's
+ * complement.
+ *   @integer: The integer.
+ *   @val: The value.
+ */
+
+_export
+void integer_and(struct integer_t **integer, const struct integer_t *val)
+{
+	op_bitwise(integer, val, '&');
+}
+
+/**
+ * Compute the bitwise or of two integers, treating negative values as two's
+ * complement.
+ *   @integer: The integer.
+ *   @val: The value.
+ */
+
+_export
+void integer_or(struct integer_t **integer, const struct integer_t *val)
+{
+	op_bitwise(integer, val, '|');
+}
+
+/**
+ * Compute the bitwise exclusive or of two integers, treating negative values
+ * as two's complement.
+ *   @integer: The integer.
+ *   @val: The value.
+ */
+
+_export
+void integer_xor(struct integer_t **integer, const struct integer_t *val)
+{
+	op_bitwise(integer, val, '^');
 }
 
 
@@ -559,28 +641,25 @@ unsigned short integer_div_ushort(struct integer_t **integer, unsigned short val
  *   &returns: Their order.
  */
 
+_export
 int integer_cmp(const struct integer_t *left, const struct integer_t *right)
 {
-	unsigned int i;
+	int cmp;
 
-	if(left->len > right->len)
-		return 2;
-	else if(left->len < right->len)
-		return -2;
+	if(left->neg != right->neg)
+		return left->neg ? -2 : 2;
 
-	for(i = left->len - 1; i != UINT_MAX; i--) {
-		if(left->arr[i] > right->arr[i])
-			return 1;
-		else if(left->arr[i] < right->arr[i])
-			return -1;
-	}
+	cmp = mag_cmp(left->arr, left->len, right->arr, right->len);
+	if(left->len != right->len)
+		cmp *= 2;
 
-	return 0;
+	return left->neg ? -cmp : cmp;
 }
 
 
 /**
- * Print an integer to the output.
+ * Print an integer to the output. Large values are split recursively by
+ * powers of 10^19 squared, so each half is converted independently.
  *   @integer: The integer.
  *   @output: The output.
  */
@@ -588,23 +667,41 @@ int integer_cmp(const struct integer_t *left, const struct integer_t *right)
 _export
 void integer_print(const struct integer_t *integer, struct io_output_t output)
 {
-	struct integer_t *copy;
-	char *str, buf[3 * integer->len * sizeof(unsigned int) + 1];
+	char *buf, *str;
+	unsigned int i, k;
+	uint64_t bits, max;
+	uint64_t *pow[64];
+	unsigned int pown[64];
 
-	str = buf + sizeof(buf) - 1;
+	if(integer_iszero(integer)) {
+		io_output_write(output, "0", 1);
 
-	copy = integer_copy(integer);
+		return;
+	}
+
+	bits = 64 * (uint64_t)integer->len - __builtin_clzll(integer->arr[integer->len - 1]);
+	max = bits * 30103 / 100000 + 1;
 
-	do
-		*str-- = '0' + integer_div_ushort(&copy, 10);
-	while(!integer_iszero(copy));
+	for(k = 0; ((uint64_t)DEC_DIGITS << k) < max; k++);
 
-	integer_delete(copy);
+	for(i = 0; i < 64; i++)
+		pow[i] = NULL;
+
+	buf = mem_alloc(((size_t)DEC_DIGITS << k) + 1);
+	conv_put(buf + 1, integer->arr, integer->len, pow, pown, k);
+
+	for(i = 0; i < 64; i++) {
+		if(pow[i] != NULL)
+			mem_free(pow[i]);
+	}
+
+	for(str = buf + 1; *str == '0'; str++);
 
 	if(integer->neg)
-		*str-- = '-';
+		*--str = '-';
 
-	io_output_write(output, str+1, sizeof(buf) - (str - buf + 1) );
+	io_output_write(output, str, (buf + 1 + ((size_t)DEC_DIGITS << k)) - str);
+	mem_free(buf);
 }
 
 /**
@@ -632,6 +729,23 @@ static void chunk_proc(struct io_output_t output, void *arg)
 
 
 
+/**
+ * Allocate a non-negative integer with uninitialized limbs.
+ *   @len: The length.
+ *   &returns: The integer.
+ */
+
+static struct integer_t *op_alloc(unsigned int len)
+{
+	struct integer_t *integer;
+
+	integer = mem_alloc(LIMB_SIZE(len));
+	integer->neg = false;
+	integer->len = len;
+
+	return integer;
+}
+
 /**
  * Resize an integer to a given length, zero filling all new elements.
  *   @integer: The integer.
@@ -642,7 +756,7 @@ static void op_resize(struct integer_t **integer, unsigned int len)
 {
 	unsigned int i;
 
-	*integer = mem_realloc(*integer, sizeof(struct integer_t) + len * sizeof(unsigned int));
+	*integer = mem_realloc(*integer, LIMB_SIZE(len));
 
 	for(i = (*integer)->len; i < len; i++)
 		(*integer)->arr[i] = 0;
@@ -651,69 +765,772 @@ static void op_resize(struct integer_t **integer, unsigned int len)
 }
 
 /**
- * Shrink the integer to the minimum necessary size.
+ * Shrink the integer to the minimum necessary size. Zero is never negative.
  *   @integer: The integer.
  */
 
 static void op_shrink(struct integer_t **integer)
+{
+	unsigned int len;
+
+	len = mag_norm((*integer)->arr, (*integer)->len);
+	if(len < (*integer)->len) {
+		*integer = mem_realloc(*integer, LIMB_SIZE(len));
+		(*integer)->len = len;
+	}
+
+	if(len == 0)
+		(*integer)->neg = false;
+}
+
+/**
+ * Add a signed magnitude to the integer.
+ *   @integer: The integer.
+ *   @arr: The magnitude limbs.
+ *   @len: The number of limbs.
+ *   @neg: The sign of the value.
+ */
+
+static void op_addsub(struct integer_t **integer, const uint64_t *arr, unsigned int len, bool neg)
+{
+	unsigned int ilen = (*integer)->len;
+
+	if(len == 0)
+		return;
+
+	if(ilen == 0)
+		(*integer)->neg = neg;
+
+	if((*integer)->neg == neg) {
+		uint64_t c;
+
+		op_resize(integer, m_uintmax(ilen, len) + 1);
+
+		if(ilen >= len)
+			c = mag_add((*integer)->arr, (*integer)->arr, ilen, arr, len);
+		else
+			c = mag_add((*integer)->arr, arr, len, (*integer)->arr, ilen);
+
+		(*integer)->arr[(*integer)->len - 1] = c;
+	}
+	else if(mag_cmp((*integer)->arr, ilen, arr, len) >= 0)
+		mag_sub((*integer)->arr, (*integer)->arr, ilen, arr, len);
+	else {
+		op_resize(integer, len);
+		mag_sub((*integer)->arr, arr, len, (*integer)->arr, ilen);
+		(*integer)->neg = neg;
+	}
+
+	op_shrink(integer);
+}
+
+/**
+ * Divide two integers, truncating towards zero.
+ *   @left: The dividend.
+ *   @right: The divisor.
+ *   @quot: Optional. Out. The quotient.
+ *   @rem: Optional. Out. The remainder.
+ */
+
+static void op_divmod(const struct integer_t *left, const struct integer_t *right, struct integer_t **quot, struct integer_t **rem)
+{
+	struct integer_t *q, *r;
+
+	if(integer_iszero(right))
+		throw("Division by zero.");
+
+	if(mag_cmp(left->arr, left->len, right->arr, right->len) < 0) {
+		q = op_alloc(0);
+		r = integer_copy(left);
+	}
+	else {
+		q = op_alloc(left->len - right->len + 1);
+		r = op_alloc(right->len);
+		q->neg = left->neg != right->neg;
+		r->neg = left->neg;
+
+		if(right->len == 1) {
+			r->arr[0] = mag_divrem1(q->arr, left->arr, left->len, right->arr[0]);
+		}
+		else
+			mag_divrem(q->arr, r->arr, left->arr, left->len, right->arr, right->len);
+
+		op_shrink(&q);
+		op_shrink(&r);
+	}
+
+	if(quot != NULL)
+		*quot = q;
+	else
+		mem_free(q);
+
+	if(rem != NULL)
+		*rem = r;
+	else
+		mem_free(r);
+}
+
+/**
+ * Perform a bitwise operation on two integers in two's complement form.
+ *   @integer: The integer.
+ *   @val: The value.
+ *   @op: The operation, either '&', '|', or '^'.
+ */
+
+static void op_bitwise(struct integer_t **integer, const struct integer_t *val, char op)
+{
+	bool neg;
+	uint64_t *tmp;
+	unsigned int i, len;
+
+	len = m_uintmax((*integer)->len, val->len) + 1;
+	op_resize(integer, len);
+
+	tmp = mem_alloc(len * sizeof(uint64_t));
+	mem_copy(tmp, val->arr, val->len * sizeof(uint64_t));
+	mem_zero(tmp + val->len, (len - val->len) * sizeof(uint64_t));
+
+	if((*integer)->neg)
+		op_twos((*integer)->arr, len);
+
+	if(val->neg)
+		op_twos(tmp, len);
+
+	switch(op) {
+	case '&':
+		neg = (*integer)->neg && val->neg;
+		for(i = 0; i < len; i++)
+			(*integer)->arr[i] &= tmp[i];
+
+		break;
+
+	case '|':
+		neg = (*integer)->neg || val->neg;
+		for(i = 0; i < len; i++)
+			(*integer)->arr[i] |= tmp[i];
+
+		break;
+
+	default:
+		neg = (*integer)->neg != val->neg;
+		for(i = 0; i < len; i++)
+			(*integer)->arr[i] ^= tmp[i];
+
+		break;
+	}
+
+	mem_free(tmp);
+
+	if(neg)
+		op_twos((*integer)->arr, len);
+
+	(*integer)->neg = neg;
+	op_shrink(integer);
+}
+
+/**
+ * Negate a fixed-width two's complement value in place.
+ *   @arr: The limbs.
+ *   @len: The number of limbs.
+ */
+
+static void op_twos(uint64_t *arr, unsigned int len)
+{
+	unsigned int i;
+	bool c = true;
+
+	for(i = 0; i < len; i++) {
+		arr[i] = ~arr[i] + (c ? 1 : 0);
+		c = c && (arr[i] == 0);
+	}
+}
+
+
+/**
+ * Compute the normalized length of a magnitude, dropping high zero limbs.
+ *   @arr: The limbs.
+ *   @len: The number of limbs.
+ *   &returns: The normalized length.
+ */
+
+static unsigned int mag_norm(const uint64_t *arr, unsigned int len)
+{
+	while((len > 0) && (arr[len - 1] == 0))
+		len--;
+
+	return len;
+}
+
+/**
+ * Compare two normalized magnitudes.
+ *   @a: The left limbs.
+ *   @an: The left length.
+ *   @b: The right limbs.
+ *   @bn: The right length.
+ *   &returns: Their order.
+ */
+
+static int mag_cmp(const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
+{
+	if(an != bn)
+		return (an > bn) ? 1 : -1;
+
+	while(an-- > 0) {
+		if(a[an] != b[an])
+			return (a[an] > b[an]) ? 1 : -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Add two magnitudes, 'r = a + b'. The result may alias 'a'.
+ *   @r: The result, 'an' limbs.
+ *   @a: The left limbs.
+ *   @an: The left length, at least 'bn'.
+ *   @b: The right limbs.
+ *   @bn: The right length.
+ *   &returns: The carry out.
+ */
+
+static uint64_t mag_add(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
+{
+	unsigned int i;
+	uint64_t t, c = 0;
+
+	for(i = 0; i < bn; i++) {
+		t = a[i] + c;
+		c = (t < c);
+		r[i] = t + b[i];
+		c |= (r[i] < t);
+	}
+
+	for(; i < an; i++) {
+		r[i] = a[i] + c;
+		c = c && (r[i] == 0);
+	}
+
+	return c;
+}
+
+/**
+ * Subtract two magnitudes, 'r = a - b'. The result may alias either operand.
+ *   @r: The result, 'an' limbs.
+ *   @a: The left limbs.
+ *   @an: The left length, at least 'bn'.
+ *   @b: The right limbs.
+ *   @bn: The right length.
+ *   &returns: The borrow out.
+ */
+
+static uint64_t mag_sub(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
+{
+	unsigned int i;
+	uint64_t x, y, t, c = 0;
+
+	for(i = 0; i < bn; i++) {
+		x = a[i];
+		y = b[i];
+		t = x - y;
+		r[i] = t - c;
+		c = (x < y) | (t < c);
+	}
+
+	for(; i < an; i++) {
+		x = a[i];
+		r[i] = x - c;
+		c = c && (x == 0);
+	}
+
+	return c;
+}
+
+/**
+ * Multiply a magnitude by a single limb, 'r = a * m'.
+ *   @r: The result, 'n' limbs.
+ *   @a: The limbs.
+ *   @n: The length.
+ *   @m: The multiplier.
+ *   &returns: The carry limb.
+ */
+
+static uint64_t mag_mul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m)
 {
 	unsigned int i;
+	uint64_t hi, lo, c = 0;
+
+	for(i = 0; i < n; i++) {
+		lo = m_uint64mul(a[i], m, &hi) + c;
+		r[i] = lo;
+		c = hi + (lo < c);
+	}
 
-	for(i = (*integer)->len; i > 0; i--) {
-		if((*integer)->arr[i-1] != 0)
-			break;
+	return c;
+}
+
+/**
+ * Multiply and accumulate a single limb, 'r += a * m'.
+ *   @r: The result, 'n' limbs.
+ *   @a: The limbs.
+ *   @n: The length.
+ *   @m: The multiplier.
+ *   &returns: The carry limb.
+ */
+
+static uint64_t mag_addmul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m)
+{
+	unsigned int i;
+	uint64_t hi, lo, x, c = 0;
+
+	for(i = 0; i < n; i++) {
+		lo = m_uint64mul(a[i], m, &hi) + c;
+		hi += (lo < c);
+		x = r[i];
+		r[i] = lo + x;
+		c = hi + (r[i] < x);
 	}
 
-	if(i < (*integer)->len) {
-		*integer = mem_realloc(*integer, sizeof(struct integer_t) + i * sizeof(unsigned int));
-		(*integer)->len = i;
+	return c;
+}
+
+/**
+ * Multiply and subtract a single limb, 'r -= a * m'.
+ *   @r: The result, 'n' limbs.
+ *   @a: The limbs.
+ *   @n: The length.
+ *   @m: The multiplier.
+ *   &returns: The borrow limb.
+ */
+
+static uint64_t mag_submul1(uint64_t *r, const uint64_t *a, unsigned int n, uint64_t m)
+{
+	unsigned int i;
+	uint64_t hi, lo, c = 0;
+
+	for(i = 0; i < n; i++) {
+		lo = m_uint64mul(a[i], m, &hi) + c;
+		c = hi + (lo < c) + (r[i] < lo);
+		r[i] -= lo;
 	}
+
+	return c;
+}
+
+/**
+ * Schoolbook multiplication, 'r = a * b'. The result may not alias either
+ * operand.
+ *   @r: The result, 'an + bn' limbs.
+ *   @a: The left limbs.
+ *   @an: The left length.
+ *   @b: The right limbs.
+ *   @bn: The right length, at least one.
+ */
+
+static void mag_basemul(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
+{
+	unsigned int i;
+
+	r[an] = mag_mul1(r, a, an, b[0]);
+
+	for(i = 1; i < bn; i++)
+		r[an + i] = mag_addmul1(r + i, a, an, b[i]);
 }
 
 /**
- * Perform an add with carry on a single digit.
- *   @val: The base value.
- *   @add: The value to add.
- *   @c: The carry flag.
+ * Karatsuba multiplication of two equal-length magnitudes, 'r = a * b'. The
+ * middle product is formed from '|a0 - a1| * |b0 - b1|' so that every
+ * recursive call stays at 'ceil(n/2)' limbs.
+ *   @r: The result, '2n' limbs.
+ *   @a: The left limbs.
+ *   @b: The right limbs.
+ *   @n: The length.
+ *   @tmp: Scratch space of at least '6n + 256' limbs.
  */
 
-static void op_add(unsigned int *val, unsigned int add, bool *c)
+static void mag_kara(uint64_t *r, const uint64_t *a, const uint64_t *b, unsigned int n, uint64_t *tmp)
 {
-	unsigned int t;
+	bool sa, sb;
+	unsigned int k, h, m;
+	uint64_t *da, *db, *mid, *sum;
+
+	if(n < KARA_THRESH)
+		return mag_basemul(r, a, n, b, n);
+
+	k = (n + 1) / 2;
+	h = n - k;
+
+	da = tmp;
+	db = da + k;
+	mid = db + k;
+	sum = mid + 2 * k;
+	tmp = sum + 2 * k + 1;
+
+	sa = mag_cmp(a, mag_norm(a, k), a + k, mag_norm(a + k, h)) < 0;
+	if(sa) {
+		mem_copy(da, a + k, h * sizeof(uint64_t));
+		mem_zero(da + h, (k - h) * sizeof(uint64_t));
+		mag_sub(da, da, k, a, k);
+	}
+	else
+		mag_sub(da, a, k, a + k, h);
+
+	sb = mag_cmp(b, mag_norm(b, k), b + k, mag_norm(b + k, h)) < 0;
+	if(sb) {
+		mem_copy(db, b + k, h * sizeof(uint64_t));
+		mem_zero(db + h, (k - h) * sizeof(uint64_t));
+		mag_sub(db, db, k, b, k);
+	}
+	else
+		mag_sub(db, b, k, b + k, h);
+
+	mag_kara(mid, da, db, k, tmp);
+	mag_kara(r, a, b, k, tmp);
+	mag_kara(r + 2 * k, a + k, b + k, h, tmp);
+
+	sum[2 * k] = mag_add(sum, r, 2 * k, r + 2 * k, 2 * h);
 
-	t = *val;
-	*val += add + (*c ? 1 : 0);
-	*c = (*val < t) || ((*val == t) && *c);
+	if(sa != sb)
+		mag_add(sum, sum, 2 * k + 1, mid, 2 * k);
+	else
+		mag_sub(sum, sum, 2 * k + 1, mid, 2 * k);
+
+	m = m_uintmin(2 * k + 1, 2 * n - k);
+	mag_add(r + k, r + k, 2 * n - k, sum, mag_norm(sum, m));
 }
 
 /**
- * Perform a subtract with carry on a single digit.
- *   @val: The base value.
- *   @sub: The value to subract.
- *   @c: The carry flag.
+ * Multiply two magnitudes, 'r = a * b'. Unbalanced operands are multiplied in
+ * 'bn'-limb slices of the longer operand.
+ *   @r: The result, 'an + bn' limbs.
+ *   @a: The left limbs.
+ *   @an: The left length, at least 'bn'.
+ *   @b: The right limbs.
+ *   @bn: The right length, at least one.
  */
 
-static void op_sub(unsigned int *val, unsigned int sub, bool *c)
+static void mag_mul(uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
 {
-	unsigned int t;
+	unsigned int i;
+	uint64_t *tmp, *prod;
+
+	if(bn < KARA_THRESH)
+		return mag_basemul(r, a, an, b, bn);
+
+	tmp = mem_alloc((2 * bn + 6 * bn + 256) * sizeof(uint64_t));
+	prod = tmp + 6 * bn + 256;
+
+	mem_zero(r, (an + bn) * sizeof(uint64_t));
+
+	for(i = 0; i + bn <= an; i += bn) {
+		mag_kara(prod, a + i, b, bn, tmp);
+		mag_add(r + i, r + i, an + bn - i, prod, 2 * bn);
+	}
+
+	if(i < an) {
+		mag_mul(prod, b, bn, a + i, an - i);
+		mag_add(r + i, r + i, an + bn - i, prod, bn + an - i);
+	}
 
-	t = *val;
-	*val -= sub + (*c ? 1 : 0);
-	*c = (*val > t) || ((*val == t) && *c);
+	mem_free(tmp);
 }
 
 /**
- * Perform a reverse subtract with carry on a single digit.
- *   @val: The base value.
- *   @sub: The value to subract from.
- *   @c: The carry flag.
+ * Shift a magnitude left by less than a limb. The result may alias the input
+ * at an equal or higher address.
+ *   @r: The result, 'n' limbs.
+ *   @a: The limbs.
+ *   @n: The length.
+ *   @s: The shift, less than 64.
+ *   &returns: The bits shifted out of the top limb.
  */
 
-static void op_rev(unsigned int *val, unsigned int sub, bool *c)
+static uint64_t mag_lshift(uint64_t *r, const uint64_t *a, unsigned int n, unsigned int s)
 {
-	unsigned int t;
+	uint64_t out;
 
-	t = sub;
-	*val = sub - (*val + (*c ? 1 : 0));
-	*c = (*val > t) || ((*val == t) && *c);
+	if(n == 0)
+		return 0;
+	else if(s == 0) {
+		mem_move(r, a, n * sizeof(uint64_t));
+
+		return 0;
+	}
+
+	out = a[n - 1] >> (64 - s);
+
+	while(--n > 0)
+		r[n] = (a[n] << s) | (a[n - 1] >> (64 - s));
+
+	r[0] = a[0] << s;
+
+	return out;
+}
+
+/**
+ * Shift a magnitude right by less than a limb. The result may alias the input
+ * at an equal or lower address.
+ *   @r: The result, 'n' limbs.
+ *   @a: The limbs.
+ *   @n: The length.
+ *   @s: The shift, less than 64.
+ *   &returns: The bits shifted out of the bottom limb.
+ */
+
+static uint64_t mag_rshift(uint64_t *r, const uint64_t *a, unsigned int n, unsigned int s)
+{
+	unsigned int i;
+	uint64_t out;
+
+	if(n == 0)
+		return 0;
+	else if(s == 0) {
+		mem_move(r, a, n * sizeof(uint64_t));
+
+		return 0;
+	}
+
+	out = a[0] << (64 - s);
+
+	for(i = 0; i < n - 1; i++)
+		r[i] = (a[i] >> s) | (a[i + 1] << (64 - s));
+
+	r[n - 1] = a[n - 1] >> s;
+
+	return out;
+}
+
+/**
+ * Divide a magnitude by a single limb. The quotient may alias the dividend.
+ *   @q: The quotient, 'n' limbs.
+ *   @a: The dividend.
+ *   @n: The length.
+ *   @d: The non-zero divisor.
+ *   &returns: The remainder.
+ */
+
+static uint64_t mag_divrem1(uint64_t *q, const uint64_t *a, unsigned int n, uint64_t d)
+{
+	uint64_t rem = 0;
+
+	while(n-- > 0)
+		q[n] = m_uint64div(rem, a[n], d, &rem);
+
+	return rem;
+}
+
+/**
+ * Divide two magnitudes using Knuth's algorithm D.
+ *   @q: The quotient, 'an - bn + 1' limbs.
+ *   @r: Optional. The remainder, 'bn' limbs.
+ *   @a: The dividend.
+ *   @an: The dividend length, at least 'bn'.
+ *   @b: The normalized divisor.
+ *   @bn: The divisor length, at least two.
+ */
+
+static void mag_divrem(uint64_t *q, uint64_t *r, const uint64_t *a, unsigned int an, const uint64_t *b, unsigned int bn)
+{
+	bool over;
+	unsigned int j, s;
+	uint64_t *u, *v, top, borrow, qhat, rhat, hi, lo;
+
+	s = __builtin_clzll(b[bn - 1]);
+	v = mem_alloc((an + 1 + bn) * sizeof(uint64_t));
+	u = v + bn;
+
+	mag_lshift(v, b, bn, s);
+	u[an] = mag_lshift(u, a, an, s);
+
+	for(j = an - bn; j != UINT_MAX; j--) {
+		if(u[j + bn] >= v[bn - 1]) {
+			qhat = UINT64_MAX;
+			rhat = u[j + bn - 1] + v[bn - 1];
+			over = (rhat < v[bn - 1]);
+		}
+		else {
+			qhat = m_uint64div(u[j + bn], u[j + bn - 1], v[bn - 1], &rhat);
+			over = false;
+		}
+
+		while(!over) {
+			lo = m_uint64mul(qhat, v[bn - 2], &hi);
+			if((hi < rhat) || ((hi == rhat) && (lo <= u[j + bn - 2])))
+				break;
+
+			qhat--;
+			rhat += v[bn - 1];
+			over = (rhat < v[bn - 1]);
+		}
+
+		borrow = mag_submul1(u + j, v, bn, qhat);
+		top = u[j + bn];
+		u[j + bn] = top - borrow;
+
+		if(top < borrow) {
+			qhat--;
+			u[j + bn] += mag_add(u + j, u + j, bn, v, bn);
+		}
+
+		q[j] = qhat;
+	}
+
+	if(r != NULL)
+		mag_rshift(r, u, bn, s);
+
+	mem_free(v);
+}
+
+
+/**
+ * Make sure the power table contains '10^(19 * 2^k)'.
+ *   @pow: The power table.
+ *   @pown: The power lengths.
+ *   @k: The level.
+ */
+
+static void conv_pow(uint64_t **pow, unsigned int *pown, unsigned int k)
+{
+	if(pow[k] != NULL)
+		return;
+
+	if(k == 0) {
+		pow[0] = mem_alloc(sizeof(uint64_t));
+		pow[0][0] = DEC_BASE;
+		pown[0] = 1;
+	}
+	else {
+		conv_pow(pow, pown, k - 1);
+
+		pow[k] = mem_alloc(2 * pown[k - 1] * sizeof(uint64_t));
+		mag_mul(pow[k], pow[k - 1], pown[k - 1], pow[k - 1], pown[k - 1]);
+		pown[k] = mag_norm(pow[k], 2 * pown[k - 1]);
+	}
+}
+
+/**
+ * Convert a string of decimal digit values to a magnitude. Long strings are
+ * split so that 'x = hi * 10^(19 * 2^k) + lo'.
+ *   @r: The result, at least 'n / 19 + 1' limbs.
+ *   @dig: The digit values.
+ *   @n: The number of digits.
+ *   @pow: The power table.
+ *   @pown: The power lengths.
+ *   &returns: The normalized length.
+ */
+
+static unsigned int conv_get(uint64_t *r, const char *dig, size_t n, uint64_t **pow, unsigned int *pown)
+{
+	unsigned int k, hn, ln, rn;
+	uint64_t *hi, chunk;
+	size_t i, j, half;
+
+	if(n <= (size_t)DEC_DIGITS * CONV_THRESH) {
+		rn = 0;
+
+		for(i = 0; i < n; i = j) {
+			chunk = 0;
+			for(j = i; j < i + (((i == 0) && (n % DEC_DIGITS)) ? n % DEC_DIGITS : DEC_DIGITS); j++)
+				chunk = chunk * 10 + dig[j];
+
+			r[rn] = mag_mul1(r, r, rn, DEC_BASE);
+			mag_add(r, r, rn + 1, &chunk, 1);
+			rn = mag_norm(r, rn + 1);
+		}
+
+		return rn;
+	}
+
+	for(k = 0; ((size_t)DEC_DIGITS << (k + 1)) < n; k++);
+
+	half = (size_t)DEC_DIGITS << k;
+	conv_pow(pow, pown, k);
+
+	hi = mem_alloc(((n - half) / DEC_DIGITS + 1) * sizeof(uint64_t));
+	hn = conv_get(hi, dig, n - half, pow, pown);
+	ln = conv_get(r, dig + n - half, half, pow, pown);
+
+	if(hn > 0) {
+		uint64_t *prod;
+
+		rn = hn + pown[k];
+		prod = mem_alloc((rn + 1) * sizeof(uint64_t));
+
+		if(hn >= pown[k])
+			mag_mul(prod, hi, hn, pow[k], pown[k]);
+		else
+			mag_mul(prod, pow[k], pown[k], hi, hn);
+
+		prod[rn] = 0;
+		mag_add(prod, prod, rn + 1, r, ln);
+		rn = mag_norm(prod, rn + 1);
+		mem_copy(r, prod, rn * sizeof(uint64_t));
+		mem_free(prod);
+	}
+	else
+		rn = ln;
+
+	mem_free(hi);
+
+	return rn;
+}
+
+/**
+ * Write a magnitude as exactly '19 * 2^k' zero-padded decimal digits.
+ *   @buf: The output buffer.
+ *   @x: The limbs, less than '10^(19 * 2^k)'.
+ *   @xn: The normalized length.
+ *   @pow: The power table.
+ *   @pown: The power lengths.
+ *   @k: The level.
+ */
+
+static void conv_put(char *buf, const uint64_t *x, unsigned int xn, uint64_t **pow, unsigned int *pown, unsigned int k)
+{
+	size_t width = (size_t)DEC_DIGITS << k;
+
+	if((k == 0) || (xn < CONV_THRESH)) {
+		unsigned int i;
+		uint64_t tmp[CONV_THRESH], rem;
+		char *str = buf + width;
+
+		mem_copy(tmp, x, xn * sizeof(uint64_t));
+
+		while(xn > 0) {
+			rem = mag_divrem1(tmp, tmp, xn, DEC_BASE);
+			xn = mag_norm(tmp, xn);
+
+			for(i = 0; i < DEC_DIGITS; i++, rem /= 10)
+				*--str = '0' + rem % 10;
+		}
+
+		while(str > buf)
+			*--str = '0';
+	}
+	else {
+		size_t half = width / 2;
+
+		conv_pow(pow, pown, k - 1);
+
+		if(mag_cmp(x, xn, pow[k - 1], pown[k - 1]) < 0) {
+			mem_set(buf, '0', half);
+			conv_put(buf + half, x, xn, pow, pown, k - 1);
+		}
+		else {
+			uint64_t *q, *r;
+			unsigned int pn = pown[k - 1];
+
+			q = mem_alloc((xn - pn + 1 + pn) * sizeof(uint64_t));
+			r = q + xn - pn + 1;
+
+			if(pn == 1)
+				r[0] = mag_divrem1(q, x, xn, pow[k - 1][0]);
+			else
+				mag_divrem(q, r, x, xn, pow[k - 1], pn);
+
+			conv_put(buf, q, mag_norm(q, xn - pn + 1), pow, pown, k - 1);
+			conv_put(buf + half, r, mag_norm(r, pn), pow, pown, k - 1);
+
+			mem_free(q);
+		}
+	}
 }
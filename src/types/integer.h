@@ -10,15 +10,15 @@
 /**
  * Integer structure.
  *   @neg: Negative flag.
- *   @len: The length.
- *   @arr: The array.
+ *   @len: The number of limbs.
+ *   @arr: The 64-bit limbs, least significant first.
  */
 
 struct integer_t {
 	bool neg;
 	unsigned int len;
 
-	unsigned int arr[];
+	uint64_t arr[];
 };
 
 
@@ -42,16 +42,26 @@ int8_t integer_uint32chk(struct integer_t *integer);
 uint64_t integer_uint64(struct integer_t *integer);
 int8_t integer_uint64chk(struct integer_t *integer);
 
-void integer_add(struct integer_t **integer, struct integer_t *val);
+void integer_add(struct integer_t **integer, const struct integer_t *val);
 void integer_add_uint(struct integer_t **integer, unsigned int val);
 void integer_add_ushort(struct integer_t **integer, unsigned short val);
 
-void integer_sub(struct integer_t **integer, struct integer_t *val);
+void integer_sub(struct integer_t **integer, const struct integer_t *val);
 
+void integer_mul(struct integer_t **integer, const struct integer_t *val);
 void integer_mul_ushort(struct integer_t **integer, unsigned short val);
 
+void integer_divmod(struct integer_t **integer, const struct integer_t *val, struct integer_t **rem);
+void integer_div(struct integer_t **integer, const struct integer_t *val);
+void integer_mod(struct integer_t **integer, const struct integer_t *val);
 unsigned short integer_div_ushort(struct integer_t **integer, unsigned short val);
 
+void integer_shl(struct integer_t **integer, unsigned int bits);
+void integer_shr(struct integer_t **integer, unsigned int bits);
+void integer_and(struct integer_t **integer, const struct integer_t *val);
+void integer_or(struct integer_t **integer, const struct integer_t *val);
+void integer_xor(struct integer_t **integer, const struct integer_t *val);
+
 int integer_cmp(const struct integer_t *left, const struct integer_t *right);
 
 void integer_print(const struct integer_t *integer, struct io_output_t output);
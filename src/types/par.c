@@ -0,0 +1,434 @@
+#include "../common.h"
+#include "iter.h"
+#include "par.h"
+#include "../mem/manage.h"
+#include "../thread/base.h"
+#include "../thread/pool.h"
+#include "enum.h"
+#include "filter.h"
+
+
+/*
+ * local definitions
+ */
+
+#define BATCH_LEN	4096
+#define TASK_MIN	256
+#define TASK_MAX	(BATCH_LEN / TASK_MIN)
+
+/**
+ * Batch job structure.
+ *   @buf: The buffer of references.
+ *   @func: The mapping function, applied in place.
+ *   @reduce: The reduction function.
+ *   @arg: The argument.
+ */
+
+struct job_t {
+	void **buf;
+	iter_wrapper_f func;
+	par_reduce_f reduce;
+	void *arg;
+};
+
+/**
+ * Batch range structure.
+ *   @job: The job.
+ *   @lo, hi: The range of the buffer.
+ *   @res: The reduced result.
+ */
+
+struct range_t {
+	struct job_t *job;
+	size_t lo, hi;
+	void *res;
+};
+
+/**
+ * Batched iterator structure.
+ *   @pool: The pool.
+ *   @iter: The inner iterator.
+ *   @func: The mapping function.
+ *   @arg: The argument.
+ *   @filter: The filter, if filtering.
+ *   @own: Flag to delete the filter with the iterator.
+ *   @buf: The buffer.
+ *   @idx, len: The read position and valid length.
+ *   @done: Flag indicating the inner iterator is exhausted.
+ */
+
+struct batch_t {
+	struct thread_pool_t *pool;
+	struct iter_t iter;
+	iter_wrapper_f func;
+	void *arg;
+	struct filter_t filter;
+	bool own;
+
+	void **buf;
+	size_t idx, len;
+	bool done;
+};
+
+/**
+ * Parallel enumerator structure.
+ *   @pool: The pool.
+ *   @inner: The inner enumerator.
+ *   @func: The mapping function or null if filtering.
+ *   @arg: The argument.
+ *   @filter: The filter.
+ */
+
+struct penum_t {
+	struct thread_pool_t *pool;
+	struct enum_t inner;
+	iter_wrapper_f func;
+	void *arg;
+	struct filter_t filter;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static size_t fill(struct iter_t iter, void **buf);
+static unsigned int split(struct thread_pool_t *pool, struct job_t *job, size_t n, struct range_t *range);
+static void range_task(void *arg);
+static void *filter_func(void *ref, void *arg);
+
+static struct iter_t batch_new(struct thread_pool_t *pool, struct iter_t iter, iter_wrapper_f func, void *arg, struct filter_t *filter, bool own);
+static void *batch_next(struct batch_t *batch);
+static void batch_delete(struct batch_t *batch);
+
+static struct enum_t penum_new(struct thread_pool_t *pool, struct enum_t inner, iter_wrapper_f func, void *arg, struct filter_t filter);
+static struct iter_t penum_iter(struct penum_t *penum);
+static void penum_delete(struct penum_t *penum);
+
+
+/**
+ * Map an iterator in parallel. References are read in batches and mapped
+ * concurrently, preserving order; null results are skipped. The function
+ * must be thread-safe and must not throw.
+ *   @pool: The pool. Null maps on the calling thread.
+ *   @iter: Consumed. The inner iterator.
+ *   @func: The mapping function.
+ *   @arg: The argument.
+ *   &returns: The iterator.
+ */
+
+_export
+struct iter_t par_map(struct thread_pool_t *pool, struct iter_t iter, iter_wrapper_f func, void *arg)
+{
+	return batch_new(pool, iter, func, arg, NULL, false);
+}
+
+/**
+ * Filter an iterator in parallel, the batched equivalent of 'iter_filter'.
+ * The filter must be thread-safe and must not throw.
+ *   @pool: The pool. Null filters on the calling thread.
+ *   @iter: Consumed. The inner iterator.
+ *   @filter: Consumed. The filter.
+ *   &returns: The iterator.
+ */
+
+_export
+struct iter_t par_filter(struct thread_pool_t *pool, struct iter_t iter, struct filter_t filter)
+{
+	return batch_new(pool, iter, NULL, NULL, &filter, true);
+}
+
+/**
+ * Reduce an iterator in parallel. Each batch is split into chunks that are
+ * reduced concurrently, and the partial results are combined in order.
+ *   @pool: The pool. Null reduces on the calling thread.
+ *   @iter: Consumed. The iterator.
+ *   @func: The associative reduction function.
+ *   @arg: The argument.
+ *   &returns: The result, or null if the iterator is empty. A null partial
+ *     result is passed to the reduction function like any other.
+ */
+
+_export
+void *par_reduce(struct thread_pool_t *pool, struct iter_t iter, par_reduce_f func, void *arg)
+{
+	size_t n;
+	unsigned int i, cnt;
+	bool empty = true;
+	void *acc = NULL, **buf;
+	struct job_t job;
+	struct range_t range[TASK_MAX];
+
+	buf = mem_alloc(BATCH_LEN * sizeof(void *));
+	job = (struct job_t){ buf, NULL, func, arg };
+
+	while((n = fill(iter, buf)) > 0) {
+		cnt = split(pool, &job, n, range);
+		for(i = 0; i < cnt; i++) {
+			acc = empty ? range[i].res : func(acc, range[i].res, arg);
+			empty = false;
+		}
+
+		if(n < BATCH_LEN)
+			break;
+	}
+
+	mem_free(buf);
+	iter_delete(iter);
+
+	return acc;
+}
+
+
+/**
+ * Create an enumerator that maps its inner enumerator in parallel.
+ *   @pool: The pool.
+ *   @inner: Consumed. The inner enumerator.
+ *   @func: The mapping function.
+ *   @arg: The argument.
+ *   &returns: The enumerator.
+ */
+
+_export
+struct enum_t par_enum_map(struct thread_pool_t *pool, struct enum_t inner, iter_wrapper_f func, void *arg)
+{
+	return penum_new(pool, inner, func, arg, filter_blank);
+}
+
+/**
+ * Create an enumerator that filters its inner enumerator in parallel.
+ *   @pool: The pool.
+ *   @inner: Consumed. The inner enumerator.
+ *   @filter: Consumed. The filter.
+ *   &returns: The enumerator.
+ */
+
+_export
+struct enum_t par_enum_filter(struct thread_pool_t *pool, struct enum_t inner, struct filter_t filter)
+{
+	return penum_new(pool, inner, NULL, NULL, filter);
+}
+
+
+/**
+ * Fill a buffer from an iterator.
+ *   @iter: The iterator.
+ *   @buf: The buffer, with room for a full batch.
+ *   &returns: The number of references read.
+ */
+
+static size_t fill(struct iter_t iter, void **buf)
+{
+	void *ref;
+	size_t n = 0;
+
+	while((n < BATCH_LEN) && ((ref = iter_next(iter)) != NULL))
+		buf[n++] = ref;
+
+	return n;
+}
+
+/**
+ * Split a job into ranges and run them on the pool, using the calling thread
+ * for the first range.
+ *   @pool: The pool or null.
+ *   @job: The job.
+ *   @n: The number of references.
+ *   @range: The range array, with room for the maximum number of tasks.
+ *   &returns: The number of ranges.
+ */
+
+static unsigned int split(struct thread_pool_t *pool, struct job_t *job, size_t n, struct range_t *range)
+{
+	size_t lo, step;
+	unsigned int i, cnt;
+	struct thread_group_t group = THREAD_GROUP_INIT;
+
+	cnt = (pool != NULL) ? (2 * thread_pool_nworkers(pool)) : 1;
+	if(cnt > (n / TASK_MIN))
+		cnt = n / TASK_MIN;
+
+	if(cnt > TASK_MAX)
+		cnt = TASK_MAX;
+	else if(cnt == 0)
+		cnt = 1;
+
+	step = (n + cnt - 1) / cnt;
+	for(i = 0, lo = 0; i < cnt; i++, lo += step)
+		range[i] = (struct range_t){ job, lo, ((lo + step) < n) ? (lo + step) : n, NULL };
+
+	for(i = 1; i < cnt; i++)
+		thread_pool_submit(pool, &group, range_task, &range[i]);
+
+	range_task(&range[0]);
+
+	if(cnt > 1)
+		thread_pool_wait(pool, &group);
+
+	return cnt;
+}
+
+/**
+ * Range task, mapping in place or reducing its part of the buffer.
+ *   @arg: The range.
+ */
+
+static void range_task(void *arg)
+{
+	size_t i;
+	struct range_t *range = arg;
+	struct job_t *job = range->job;
+
+	if(job->reduce != NULL) {
+		range->res = job->buf[range->lo];
+		for(i = range->lo + 1; i < range->hi; i++)
+			range->res = job->reduce(range->res, job->buf[i], job->arg);
+	}
+	else {
+		for(i = range->lo; i < range->hi; i++)
+			job->buf[i] = job->func(job->buf[i], job->arg);
+	}
+}
+
+/**
+ * Mapping function that applies a filter.
+ *   @ref: The reference.
+ *   @arg: The filter.
+ *   &returns: The filtered reference or null.
+ */
+
+static void *filter_func(void *ref, void *arg)
+{
+	return filter_apply(*(struct filter_t *)arg, ref);
+}
+
+
+/**
+ * Create a batched iterator.
+ *   @pool: The pool.
+ *   @iter: Consumed. The inner iterator.
+ *   @func: The mapping function, if not filtering.
+ *   @arg: The argument.
+ *   @filter: Optional. The filter.
+ *   @own: Flag to take ownership of the filter.
+ *   &returns: The iterator.
+ */
+
+static struct iter_t batch_new(struct thread_pool_t *pool, struct iter_t iter, iter_wrapper_f func, void *arg, struct filter_t *filter, bool own)
+{
+	struct batch_t *batch;
+	static const struct iter_i iface = { (iter_f)batch_next, (delete_f)batch_delete };
+
+	batch = mem_alloc(sizeof(struct batch_t));
+	batch->pool = pool;
+	batch->iter = iter;
+	batch->filter = (filter != NULL) ? *filter : filter_blank;
+	batch->own = own;
+	batch->func = (filter != NULL) ? filter_func : func;
+	batch->arg = (filter != NULL) ? &batch->filter : arg;
+	batch->buf = mem_alloc(BATCH_LEN * sizeof(void *));
+	batch->idx = batch->len = 0;
+	batch->done = false;
+
+	return (struct iter_t){ batch, &iface };
+}
+
+/**
+ * Retrieve the next reference from a batched iterator, processing another
+ * batch when the current one is used up.
+ *   @batch: The batch iterator.
+ *   &returns: The reference or null.
+ */
+
+static void *batch_next(struct batch_t *batch)
+{
+	size_t i, n;
+	struct job_t job;
+	struct range_t range[TASK_MAX];
+
+	while(batch->idx == batch->len) {
+		if(batch->done)
+			return NULL;
+
+		n = fill(batch->iter, batch->buf);
+		batch->done = (n < BATCH_LEN);
+		if(n == 0)
+			return NULL;
+
+		job = (struct job_t){ batch->buf, batch->func, NULL, batch->arg };
+		split(batch->pool, &job, n, range);
+
+		for(i = batch->len = 0; i < n; i++) {
+			if(batch->buf[i] != NULL)
+				batch->buf[batch->len++] = batch->buf[i];
+		}
+
+		batch->idx = 0;
+	}
+
+	return batch->buf[batch->idx++];
+}
+
+/**
+ * Delete a batched iterator.
+ *   @batch: The batch iterator.
+ */
+
+static void batch_delete(struct batch_t *batch)
+{
+	iter_delete(batch->iter);
+
+	if(batch->own)
+		filter_delete(batch->filter);
+
+	mem_free(batch->buf);
+	mem_free(batch);
+}
+
+
+/**
+ * Create a parallel enumerator.
+ *   @pool: The pool.
+ *   @inner: Consumed. The inner enumerator.
+ *   @func: The mapping function or null if filtering.
+ *   @arg: The argument.
+ *   @filter: Consumed. The filter.
+ *   &returns: The enumerator.
+ */
+
+static struct enum_t penum_new(struct thread_pool_t *pool, struct enum_t inner, iter_wrapper_f func, void *arg, struct filter_t filter)
+{
+	struct penum_t *penum;
+	static const struct enum_i iface = { (enum_f)penum_iter, (delete_f)penum_delete };
+
+	penum = mem_alloc(sizeof(struct penum_t));
+	*penum = (struct penum_t){ pool, inner, func, arg, filter };
+
+	return (struct enum_t){ penum, &iface };
+}
+
+/**
+ * Create an iterator from a parallel enumerator.
+ *   @penum: The parallel enumerator.
+ *   &returns: The iterator.
+ */
+
+static struct iter_t penum_iter(struct penum_t *penum)
+{
+	if(penum->func != NULL)
+		return batch_new(penum->pool, enum_iter(penum->inner), penum->func, penum->arg, NULL, false);
+	else
+		return batch_new(penum->pool, enum_iter(penum->inner), NULL, NULL, &penum->filter, false);
+}
+
+/**
+ * Delete a parallel enumerator.
+ *   @penum: The parallel enumerator.
+ */
+
+static void penum_delete(struct penum_t *penum)
+{
+	enum_delete(penum->inner);
+	filter_delete(penum->filter);
+	mem_free(penum);
+}
@@ -0,0 +1,46 @@
+#ifndef TYPES_PAR_H
+#define TYPES_PAR_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/**
+ * Parallel reduction function. It must be associative, since partial
+ * results of adjacent chunks are combined in order.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   @arg: The argument.
+ *   &returns: The combined value.
+ */
+
+typedef void *(*par_reduce_f)(void *left, void *right, void *arg);
+
+
+/*
+ * parallel pipeline function declarations
+ */
+
+struct iter_t par_map(struct thread_pool_t *pool, struct iter_t iter, iter_wrapper_f func, void *arg);
+struct iter_t par_filter(struct thread_pool_t *pool, struct iter_t iter, struct filter_t filter);
+void *par_reduce(struct thread_pool_t *pool, struct iter_t iter, par_reduce_f func, void *arg);
+
+struct enum_t par_enum_map(struct thread_pool_t *pool, struct enum_t inner, iter_wrapper_f func, void *arg);
+struct enum_t par_enum_filter(struct thread_pool_t *pool, struct enum_t inner, struct filter_t filter);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -0,0 +1,61 @@
+#include "../../common.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../../debug/exception.h"
+
+
+/**
+ * Map a snapshot file read-only into memory. The pages are shared with the
+ * page cache, so opening is independent of the snapshot size.
+ *   @path: The path.
+ *   @size: Out. The mapping size.
+ *   &returns: The mapping base.
+ */
+
+const void *_impl_snapshot_map(const char *path, size_t *size)
+{
+	int fd, err;
+	void *ptr;
+	struct stat info;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		throw("Unable to open snapshot '%s'. %s.", path, strerror(errno));
+
+	if(fstat(fd, &info) < 0) {
+		err = errno;
+		close(fd);
+		throw("Unable to open snapshot '%s'. %s.", path, strerror(err));
+	}
+	else if(info.st_size == 0) {
+		close(fd);
+		throw("Invalid snapshot '%s'.", path);
+	}
+
+	ptr = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	err = errno;
+	close(fd);
+
+	if(ptr == MAP_FAILED)
+		throw("Unable to map snapshot '%s'. %s.", path, strerror(err));
+
+	*size = info.st_size;
+
+	return ptr;
+}
+
+/**
+ * Unmap a snapshot.
+ *   @ptr: The mapping base.
+ *   @size: The mapping size.
+ */
+
+void _impl_snapshot_unmap(const void *ptr, size_t size)
+{
+	munmap((void *)ptr, size);
+}
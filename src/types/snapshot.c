@@ -0,0 +1,631 @@
+#include "../common.h"
+#include "snapshot.h"
+#include <string.h>
+#include "../debug/exception.h"
+#include "../io/output.h"
+#include "../mem/base.h"
+#include "../mem/manage.h"
+#include "../string/slice.h"
+#include "avlitree.h"
+#include "avltree.h"
+
+
+/*
+ * Snapshot layout. All integers are 64-bit little-endian, and every region
+ * starts on an 8-byte boundary so that a mapped image may be used in place.
+ *   header: magic[8], version, count, flags
+ *   table: per entry, the key offset and length if keyed, then the reference
+ *     offset and length
+ *   data: the key and reference bytes, each padded to 8 bytes
+ * Offsets are relative to the start of the image. Entries are stored in tree
+ * order, so keyed searches are a binary search over the table.
+ */
+
+#define SNAP_HEADER	32
+#define SNAP_KEYED	0x1
+#define SNAP_BUFSIZE	(64 * 1024)
+#define SNAP_PAD(n)	(((n) + 7) & ~(uint64_t)7)
+
+/**
+ * Snapshot structure.
+ *   @base: The image base.
+ *   @size: The image size.
+ *   @count: The number of entries.
+ *   @stride: The table entry size.
+ *   @keyed: Keyed flag.
+ *   @mapped: Mapped flag, set if the image must be unmapped.
+ */
+
+struct snapshot_t {
+	const uint8_t *base;
+	size_t size, count;
+	unsigned int stride;
+	bool keyed, mapped;
+};
+
+/**
+ * Staging buffer structure.
+ *   @output: The output.
+ *   @buf: The buffer.
+ *   @len: The number of staged bytes.
+ */
+
+struct stage_t {
+	struct io_output_t output;
+	uint8_t *buf;
+	size_t len;
+};
+
+
+/*
+ * implementation function declarations
+ */
+
+const void *_impl_snapshot_map(const char *path, size_t *size);
+void _impl_snapshot_unmap(const void *ptr, size_t size);
+
+/*
+ * local function declarations
+ */
+
+static void encode_avltree(struct str_slice_t *arr, const struct avltree_t *tree, snapshot_encode_f key, snapshot_encode_f ref, void *arg);
+static void encode_avlitree(struct str_slice_t *arr, const struct avlitree_t *tree, snapshot_encode_f ref, void *arg);
+static void save(struct io_output_t output, const struct str_slice_t *arr, size_t count, bool keyed);
+static void stage_write(struct stage_t *stage, const void *buf, size_t nbytes);
+static void stage_u64(struct stage_t *stage, uint64_t val);
+
+static bool parse(const uint8_t *base, size_t size, size_t *count, bool *keyed);
+static struct snapshot_t *make(const uint8_t *base, size_t size, bool mapped);
+static struct str_slice_t blob(const struct snapshot_t *snap, size_t idx, unsigned int field);
+static int compare_at(const struct snapshot_t *snap, size_t idx, const void *key, snapshot_compare_f compare, void *arg);
+static inline uint64_t load(const uint8_t *ptr);
+
+
+/**
+ * Save an AVL tree as a snapshot.
+ *   @output: The output.
+ *   @tree: The tree.
+ *   @key: The key encoder.
+ *   @ref: The reference encoder.
+ *   @arg: The encoder argument.
+ */
+
+_export
+void snapshot_save_avltree(struct io_output_t output, const struct avltree_t *tree, snapshot_encode_f key, snapshot_encode_f ref, void *arg)
+{
+	struct str_slice_t *arr;
+
+	arr = mem_alloc(2 * (tree->count + 1) * sizeof(struct str_slice_t));
+
+	try {
+		encode_avltree(arr, tree, key, ref, arg);
+		save(output, arr, tree->count, true);
+	}
+	catch(e) {
+		mem_free(arr);
+		throw("%s", e);
+	}
+
+	mem_free(arr);
+}
+
+/**
+ * Save an AVL index tree as a snapshot.
+ *   @output: The output.
+ *   @tree: The tree.
+ *   @ref: The reference encoder.
+ *   @arg: The encoder argument.
+ */
+
+_export
+void snapshot_save_avlitree(struct io_output_t output, const struct avlitree_t *tree, snapshot_encode_f ref, void *arg)
+{
+	struct str_slice_t *arr;
+
+	arr = mem_alloc((tree->count + 1) * sizeof(struct str_slice_t));
+
+	try {
+		encode_avlitree(arr, tree, ref, arg);
+		save(output, arr, tree->count, false);
+	}
+	catch(e) {
+		mem_free(arr);
+		throw("%s", e);
+	}
+
+	mem_free(arr);
+}
+
+/**
+ * Encode the keys and references of an AVL tree in tree order.
+ *   @arr: The encoded fields.
+ *   @tree: The tree.
+ *   @key: The key encoder.
+ *   @ref: The reference encoder.
+ *   @arg: The encoder argument.
+ */
+
+static void encode_avltree(struct str_slice_t *arr, const struct avltree_t *tree, snapshot_encode_f key, snapshot_encode_f ref, void *arg)
+{
+	size_t i = 0;
+	struct avltree_iter_t iter;
+	struct avltree_inst_t *inst;
+
+	iter = avltree_iter_begin(tree);
+	while((inst = avltree_iter_next_ref(&iter)) != NULL) {
+		arr[i++] = key(inst->key, arg);
+		arr[i++] = ref(inst->ref, arg);
+	}
+}
+
+/**
+ * Encode the references of an AVL index tree in tree order.
+ *   @arr: The encoded fields.
+ *   @tree: The tree.
+ *   @ref: The reference encoder.
+ *   @arg: The encoder argument.
+ */
+
+static void encode_avlitree(struct str_slice_t *arr, const struct avlitree_t *tree, snapshot_encode_f ref, void *arg)
+{
+	size_t i = 0;
+	void *cur;
+	struct avlitree_iter_t iter;
+
+	iter = avlitree_iter_begin(tree);
+	while((cur = avlitree_iter_next(&iter)) != NULL)
+		arr[i++] = ref(cur, arg);
+}
+
+/**
+ * Write a snapshot image.
+ *   @output: The output.
+ *   @arr: The encoded fields, in table order.
+ *   @count: The number of entries.
+ *   @keyed: Keyed flag.
+ */
+
+static void save(struct io_output_t output, const struct str_slice_t *arr, size_t count, bool keyed)
+{
+	size_t i, n;
+	uint64_t off;
+	struct stage_t stage;
+	static const uint8_t zero[8] = { 0 };
+
+	n = keyed ? (2 * count) : count;
+	stage.output = output;
+	stage.buf = mem_alloc(SNAP_BUFSIZE);
+	stage.len = 0;
+
+	try {
+		stage_write(&stage, SNAPSHOT_MAGIC, 8);
+		stage_u64(&stage, SNAPSHOT_VERSION);
+		stage_u64(&stage, count);
+		stage_u64(&stage, keyed ? SNAP_KEYED : 0);
+
+		off = SNAP_HEADER + 16 * (uint64_t)n;
+		for(i = 0; i < n; i++) {
+			stage_u64(&stage, off);
+			stage_u64(&stage, arr[i].len);
+			off += SNAP_PAD(arr[i].len);
+		}
+
+		for(i = 0; i < n; i++) {
+			stage_write(&stage, arr[i].ptr, arr[i].len);
+			stage_write(&stage, zero, SNAP_PAD(arr[i].len) - arr[i].len);
+		}
+
+		if(stage.len > 0)
+			io_output_writefull(output, stage.buf, stage.len);
+	}
+	catch(e) {
+		mem_free(stage.buf);
+		throw("%s", e);
+	}
+
+	mem_free(stage.buf);
+}
+
+/**
+ * Write bytes through the staging buffer.
+ *   @stage: The staging buffer.
+ *   @buf: The buffer.
+ *   @nbytes: The number of bytes.
+ */
+
+static void stage_write(struct stage_t *stage, const void *buf, size_t nbytes)
+{
+	if((stage->len + nbytes) > SNAP_BUFSIZE) {
+		io_output_writefull(stage->output, stage->buf, stage->len);
+		stage->len = 0;
+
+		if(nbytes > SNAP_BUFSIZE) {
+			io_output_writefull(stage->output, buf, nbytes);
+			return;
+		}
+	}
+
+	if(nbytes > 0)
+		mem_copy(stage->buf + stage->len, buf, nbytes);
+
+	stage->len += nbytes;
+}
+
+/**
+ * Write a little-endian 64-bit integer through the staging buffer.
+ *   @stage: The staging buffer.
+ *   @val: The value.
+ */
+
+static void stage_u64(struct stage_t *stage, uint64_t val)
+{
+	unsigned int i;
+	uint8_t buf[8];
+
+	for(i = 0; i < 8; i++)
+		buf[i] = val >> (8 * i);
+
+	stage_write(stage, buf, sizeof(buf));
+}
+
+
+/**
+ * Open a snapshot by mapping a file into memory.
+ *   @path: The path.
+ *   &returns: The snapshot.
+ */
+
+_export
+struct snapshot_t *snapshot_open(const char *path)
+{
+	size_t size;
+	const void *base;
+	struct snapshot_t *snap;
+
+	base = _impl_snapshot_map(path, &size);
+
+	snap = make(base, size, true);
+	if(snap == NULL) {
+		_impl_snapshot_unmap(base, size);
+		throw("Invalid snapshot '%s'.", path);
+	}
+
+	return snap;
+}
+
+/**
+ * Load a snapshot from memory. The buffer is borrowed and must outlive the
+ * snapshot.
+ *   @buf: The buffer.
+ *   @nbytes: The number of bytes.
+ *   &returns: The snapshot.
+ */
+
+_export
+struct snapshot_t *snapshot_load(const void *buf, size_t nbytes)
+{
+	struct snapshot_t *snap;
+
+	snap = make(buf, nbytes, false);
+	if(snap == NULL)
+		throw("Invalid snapshot.");
+
+	return snap;
+}
+
+/**
+ * Close a snapshot.
+ *   @snap: The snapshot.
+ */
+
+_export
+void snapshot_close(struct snapshot_t *snap)
+{
+	if(snap->mapped)
+		_impl_snapshot_unmap(snap->base, snap->size);
+
+	mem_free(snap);
+}
+
+
+/**
+ * Retrieve the number of entries in a snapshot.
+ *   @snap: The snapshot.
+ *   &returns: The number of entries.
+ */
+
+_export
+size_t snapshot_count(const struct snapshot_t *snap)
+{
+	return snap->count;
+}
+
+/**
+ * Retrieve the key bytes at an index. Index tree snapshots have no keys.
+ *   @snap: The snapshot.
+ *   @idx: The index.
+ *   &returns: The key bytes, or a null slice.
+ */
+
+_export
+struct str_slice_t snapshot_key(const struct snapshot_t *snap, size_t idx)
+{
+	if(!snap->keyed || (idx >= snap->count))
+		return (struct str_slice_t){ NULL, 0 };
+
+	return blob(snap, idx, 0);
+}
+
+/**
+ * Retrieve the reference bytes at an index.
+ *   @snap: The snapshot.
+ *   @idx: The index.
+ *   &returns: The reference bytes, or a null slice.
+ */
+
+_export
+struct str_slice_t snapshot_get(const struct snapshot_t *snap, size_t idx)
+{
+	if(idx >= snap->count)
+		return (struct str_slice_t){ NULL, 0 };
+
+	return blob(snap, idx, snap->keyed ? 1 : 0);
+}
+
+
+/**
+ * Lookup the reference bytes for a key.
+ *   @snap: The snapshot.
+ *   @key: The key.
+ *   @compare: Optional. The comparison callback. If null, the key is a
+ *     'struct str_slice_t' compared bytewise.
+ *   @arg: The comparison argument.
+ *   &returns: The reference bytes if found, a null slice otherwise.
+ */
+
+_export
+struct str_slice_t snapshot_lookup(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg)
+{
+	size_t idx;
+
+	idx = snapshot_search(snap, key, compare, arg);
+	if((idx >= snap->count) || (compare_at(snap, idx, key, compare, arg) != 0))
+		return (struct str_slice_t){ NULL, 0 };
+
+	return blob(snap, idx, 1);
+}
+
+/**
+ * Retrieve the reference bytes of the smallest key greater than or equal to
+ * the given key.
+ *   @snap: The snapshot.
+ *   @key: The key.
+ *   @compare: Optional. The comparison callback.
+ *   @arg: The comparison argument.
+ *   &returns: The reference bytes if found, a null slice otherwise.
+ */
+
+_export
+struct str_slice_t snapshot_atleast(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg)
+{
+	size_t idx;
+
+	idx = snapshot_search(snap, key, compare, arg);
+	if(idx >= snap->count)
+		return (struct str_slice_t){ NULL, 0 };
+
+	return blob(snap, idx, 1);
+}
+
+/**
+ * Retrieve the reference bytes of the largest key less than or equal to the
+ * given key.
+ *   @snap: The snapshot.
+ *   @key: The key.
+ *   @compare: Optional. The comparison callback.
+ *   @arg: The comparison argument.
+ *   &returns: The reference bytes if found, a null slice otherwise.
+ */
+
+_export
+struct str_slice_t snapshot_atmost(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg)
+{
+	size_t idx;
+
+	idx = snapshot_search(snap, key, compare, arg);
+	if((idx < snap->count) && (compare_at(snap, idx, key, compare, arg) == 0))
+		return blob(snap, idx, 1);
+	else if((idx == 0) || !snap->keyed)
+		return (struct str_slice_t){ NULL, 0 };
+
+	return blob(snap, idx - 1, 1);
+}
+
+/**
+ * Search for the index of the first key greater than or equal to the given
+ * key. Searching an index tree snapshot always returns the count.
+ *   @snap: The snapshot.
+ *   @key: The key.
+ *   @compare: Optional. The comparison callback.
+ *   @arg: The comparison argument.
+ *   &returns: The index, or the count if all keys are smaller.
+ */
+
+_export
+size_t snapshot_search(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg)
+{
+	size_t lo = 0, hi, mid;
+
+	if(!snap->keyed)
+		return snap->count;
+
+	hi = snap->count;
+	while(lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if(compare_at(snap, mid, key, compare, arg) > 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+
+/**
+ * Begin iterating over a snapshot in tree order.
+ *   @snap: The snapshot.
+ *   &returns: The iterator.
+ */
+
+_export
+struct snapshot_iter_t snapshot_iter_begin(const struct snapshot_t *snap)
+{
+	return (struct snapshot_iter_t){ snap, 0 };
+}
+
+/**
+ * Retrieve the next entry from a snapshot iterator.
+ *   @iter: The iterator.
+ *   @key: Optional. Out. The key bytes, a null slice for index trees.
+ *   @ref: Optional. Out. The reference bytes.
+ *   &returns: True if an entry was retrieved, false at the end.
+ */
+
+_export
+bool snapshot_iter_next(struct snapshot_iter_t *iter, struct str_slice_t *key, struct str_slice_t *ref)
+{
+	if(iter->idx >= iter->snap->count)
+		return false;
+
+	if(key != NULL)
+		*key = snapshot_key(iter->snap, iter->idx);
+
+	if(ref != NULL)
+		*ref = snapshot_get(iter->snap, iter->idx);
+
+	iter->idx++;
+
+	return true;
+}
+
+
+/**
+ * Parse and validate a snapshot header. Only the header and table bounds are
+ * checked, entries are validated as they are accessed.
+ *   @base: The image base.
+ *   @size: The image size.
+ *   @count: Out. The number of entries.
+ *   @keyed: Out. Keyed flag.
+ *   &returns: True if valid, false otherwise.
+ */
+
+static bool parse(const uint8_t *base, size_t size, size_t *count, bool *keyed)
+{
+	uint64_t n, flags;
+
+	if((size < SNAP_HEADER) || (memcmp(base, SNAPSHOT_MAGIC, 8) != 0))
+		return false;
+	else if(load(base + 8) != SNAPSHOT_VERSION)
+		return false;
+
+	n = load(base + 16);
+	flags = load(base + 24);
+	if(flags & ~(uint64_t)SNAP_KEYED)
+		return false;
+
+	*keyed = flags & SNAP_KEYED;
+	if(n > ((size - SNAP_HEADER) / (*keyed ? 32 : 16)))
+		return false;
+
+	*count = n;
+
+	return true;
+}
+
+/**
+ * Create a snapshot over an image.
+ *   @base: The image base.
+ *   @size: The image size.
+ *   @mapped: Mapped flag.
+ *   &returns: The snapshot, or null if the image is invalid.
+ */
+
+static struct snapshot_t *make(const uint8_t *base, size_t size, bool mapped)
+{
+	size_t count;
+	bool keyed;
+	struct snapshot_t *snap;
+
+	if(!parse(base, size, &count, &keyed))
+		return NULL;
+
+	snap = mem_alloc(sizeof(struct snapshot_t));
+	snap->base = base;
+	snap->size = size;
+	snap->count = count;
+	snap->stride = keyed ? 32 : 16;
+	snap->keyed = keyed;
+	snap->mapped = mapped;
+
+	return snap;
+}
+
+/**
+ * Retrieve the bytes of an entry field, checking the image bounds.
+ *   @snap: The snapshot.
+ *   @idx: The entry index.
+ *   @field: The field, zero for the key or the reference of index trees.
+ *   &returns: The bytes.
+ */
+
+static struct str_slice_t blob(const struct snapshot_t *snap, size_t idx, unsigned int field)
+{
+	uint64_t off, len;
+	const uint8_t *ent;
+
+	ent = snap->base + SNAP_HEADER + idx * snap->stride + 16 * field;
+	off = load(ent);
+	len = load(ent + 8);
+	if((off > snap->size) || (len > (snap->size - off)))
+		throw("Corrupt snapshot.");
+
+	return (struct str_slice_t){ (const char *)snap->base + off, len };
+}
+
+/**
+ * Compare a search key against the key at an index.
+ *   @snap: The snapshot.
+ *   @idx: The index.
+ *   @key: The search key.
+ *   @compare: Optional. The comparison callback.
+ *   @arg: The comparison argument.
+ *   &returns: Their order.
+ */
+
+static int compare_at(const struct snapshot_t *snap, size_t idx, const void *key, snapshot_compare_f compare, void *arg)
+{
+	if(compare == NULL)
+		return str_slice_cmp(*(const struct str_slice_t *)key, blob(snap, idx, 0));
+	else
+		return compare(key, blob(snap, idx, 0), arg);
+}
+
+/**
+ * Load a little-endian 64-bit integer.
+ *   @ptr: The pointer.
+ *   &returns: The integer.
+ */
+
+static inline uint64_t load(const uint8_t *ptr)
+{
+	uint64_t v;
+
+	mem_copy(&v, ptr, sizeof(v));
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+
+	return v;
+}
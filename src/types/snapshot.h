@@ -0,0 +1,87 @@
+#ifndef TYPES_SNAPSHOT_H
+#define TYPES_SNAPSHOT_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct io_output_t;
+struct snapshot_t;
+
+
+/*
+ * snapshot definitions
+ */
+
+#define SNAPSHOT_MAGIC	"shimsnap"
+#define SNAPSHOT_VERSION	1
+
+/**
+ * Snapshot encoding callback. The returned bytes must remain valid until the
+ * snapshot has been written.
+ *   @ptr: The key or reference.
+ *   @arg: The argument.
+ *   &returns: The encoded bytes.
+ */
+
+typedef struct str_slice_t (*snapshot_encode_f)(const void *ptr, void *arg);
+
+/**
+ * Snapshot comparison callback. The ordering must match the ordering of the
+ * tree the snapshot was created from.
+ *   @key: The search key.
+ *   @stored: The stored key bytes.
+ *   @arg: The argument.
+ *   &returns: The comparison of the search key against the stored key.
+ */
+
+typedef int (*snapshot_compare_f)(const void *key, struct str_slice_t stored, void *arg);
+
+/**
+ * Snapshot iterator structure.
+ *   @snap: The snapshot.
+ *   @idx: The next index.
+ */
+
+struct snapshot_iter_t {
+	const struct snapshot_t *snap;
+	size_t idx;
+};
+
+
+/*
+ * snapshot function declarations
+ */
+
+void snapshot_save_avltree(struct io_output_t output, const struct avltree_t *tree, snapshot_encode_f key, snapshot_encode_f ref, void *arg);
+void snapshot_save_avlitree(struct io_output_t output, const struct avlitree_t *tree, snapshot_encode_f ref, void *arg);
+
+struct snapshot_t *snapshot_open(const char *path);
+struct snapshot_t *snapshot_load(const void *buf, size_t nbytes);
+void snapshot_close(struct snapshot_t *snap);
+
+size_t snapshot_count(const struct snapshot_t *snap);
+struct str_slice_t snapshot_key(const struct snapshot_t *snap, size_t idx);
+struct str_slice_t snapshot_get(const struct snapshot_t *snap, size_t idx);
+
+struct str_slice_t snapshot_lookup(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+struct str_slice_t snapshot_atleast(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+struct str_slice_t snapshot_atmost(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+size_t snapshot_search(const struct snapshot_t *snap, const void *key, snapshot_compare_f compare, void *arg);
+
+struct snapshot_iter_t snapshot_iter_begin(const struct snapshot_t *snap);
+bool snapshot_iter_next(struct snapshot_iter_t *iter, struct str_slice_t *key, struct str_slice_t *ref);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -0,0 +1,286 @@
+#include "../common.h"
+#include "sort.h"
+#include <string.h>
+#include "../mem/manage.h"
+#include "../thread/base.h"
+#include "../thread/pool.h"
+
+
+/*
+ * local definitions
+ */
+
+#define RUN_LEN		16
+#define SORT_GRAIN	8192
+#define MERGE_GRAIN	8192
+
+/**
+ * Parallel sort structure.
+ *   @pool: The pool.
+ *   @arr, tmp: The array and scratch buffer.
+ *   @n: The number of elements.
+ *   @intmp: Flag to leave the result in the scratch buffer.
+ *   @compare: The comparison callback.
+ */
+
+struct psort_t {
+	struct thread_pool_t *pool;
+	void **arr, **tmp;
+	size_t n;
+	bool intmp;
+	compare_f compare;
+};
+
+/**
+ * Parallel merge structure.
+ *   @pool: The pool.
+ *   @dest: The destination.
+ *   @left, right: The sorted inputs.
+ *   @nleft, nright: The input lengths.
+ *   @compare: The comparison callback.
+ */
+
+struct pmerge_t {
+	struct thread_pool_t *pool;
+	void **dest;
+	void **left, **right;
+	size_t nleft, nright;
+	compare_f compare;
+};
+
+
+/*
+ * local function declarations
+ */
+
+static void insertion(void **arr, size_t n, compare_f compare);
+static void msort(void **arr, void **tmp, size_t n, compare_f compare);
+
+static void psort_task(void *arg);
+static void pmerge_task(void *arg);
+
+
+/**
+ * Stable sort an array of references.
+ *   @arr: The array.
+ *   @n: The number of elements.
+ *   @compare: The comparison callback.
+ */
+
+_export
+void sort_stable(void **arr, size_t n, compare_f compare)
+{
+	void **tmp;
+
+	if(n <= RUN_LEN) {
+		insertion(arr, n, compare);
+		return;
+	}
+
+	tmp = mem_alloc(n * sizeof(void *));
+	msort(arr, tmp, n, compare);
+	mem_free(tmp);
+}
+
+/**
+ * Merge two sorted arrays, taking from the left array on ties.
+ *   @dest: The destination, not overlapping either input.
+ *   @left: The left array.
+ *   @nleft: The left length.
+ *   @right: The right array.
+ *   @nright: The right length.
+ *   @compare: The comparison callback.
+ */
+
+_export
+void sort_merge(void **dest, void **left, size_t nleft, void **right, size_t nright, compare_f compare)
+{
+	size_t i = 0, j = 0;
+
+	if((nleft > 0) && (nright > 0) && (compare(left[nleft - 1], right[0]) <= 0)) {
+		memcpy(dest, left, nleft * sizeof(void *));
+		memcpy(dest + nleft, right, nright * sizeof(void *));
+		return;
+	}
+
+	while((i < nleft) && (j < nright)) {
+		if(compare(right[j], left[i]) < 0)
+			*dest++ = right[j++];
+		else
+			*dest++ = left[i++];
+	}
+
+	memcpy(dest, left + i, (nleft - i) * sizeof(void *));
+	memcpy(dest + (nleft - i), right + j, (nright - j) * sizeof(void *));
+}
+
+/**
+ * Stable sort an array of references in parallel on a pool. The comparison
+ * callback is invoked concurrently and must not throw.
+ *   @pool: The pool. Null sorts on the calling thread.
+ *   @arr: The array.
+ *   @n: The number of elements.
+ *   @compare: The comparison callback.
+ */
+
+_export
+void sort_par(struct thread_pool_t *pool, void **arr, size_t n, compare_f compare)
+{
+	struct psort_t sort;
+
+	if((pool == NULL) || (n <= SORT_GRAIN)) {
+		sort_stable(arr, n, compare);
+		return;
+	}
+
+	sort = (struct psort_t){ pool, arr, mem_alloc(n * sizeof(void *)), n, false, compare };
+	psort_task(&sort);
+	mem_free(sort.tmp);
+}
+
+
+/**
+ * Insertion sort a short array.
+ *   @arr: The array.
+ *   @n: The number of elements.
+ *   @compare: The comparison callback.
+ */
+
+static void insertion(void **arr, size_t n, compare_f compare)
+{
+	size_t i, j;
+	void *ref;
+
+	for(i = 1; i < n; i++) {
+		ref = arr[i];
+		for(j = i; (j > 0) && (compare(ref, arr[j - 1]) < 0); j--)
+			arr[j] = arr[j - 1];
+
+		arr[j] = ref;
+	}
+}
+
+/**
+ * Bottom-up merge sort, sorting short runs by insertion.
+ *   @arr: The array.
+ *   @tmp: The scratch buffer.
+ *   @n: The number of elements.
+ *   @compare: The comparison callback.
+ */
+
+static void msort(void **arr, void **tmp, size_t n, compare_f compare)
+{
+	size_t i, w;
+	void **src = arr, **dst = tmp, **swap;
+
+	for(i = 0; i < n; i += RUN_LEN)
+		insertion(arr + i, ((n - i) < RUN_LEN) ? (n - i) : RUN_LEN, compare);
+
+	for(w = RUN_LEN; w < n; w *= 2) {
+		for(i = 0; i < n; i += 2 * w) {
+			if((n - i) <= w)
+				memcpy(dst + i, src + i, (n - i) * sizeof(void *));
+			else
+				sort_merge(dst + i, src + i, w, src + i + w, ((n - i - w) < w) ? (n - i - w) : w, compare);
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if(src != arr)
+		memcpy(arr, src, n * sizeof(void *));
+}
+
+
+/**
+ * Parallel sort task. The halves are sorted into the opposite buffer and
+ * then merged into the requested one, so no level copies back.
+ *   @arg: The sort structure.
+ */
+
+static void psort_task(void *arg)
+{
+	size_t h;
+	struct psort_t *sort = arg, lo, hi;
+	struct pmerge_t merge;
+	struct thread_group_t group = THREAD_GROUP_INIT;
+
+	if(sort->n <= SORT_GRAIN) {
+		msort(sort->arr, sort->tmp, sort->n, sort->compare);
+		if(sort->intmp)
+			memcpy(sort->tmp, sort->arr, sort->n * sizeof(void *));
+
+		return;
+	}
+
+	h = sort->n / 2;
+	lo = (struct psort_t){ sort->pool, sort->arr, sort->tmp, h, !sort->intmp, sort->compare };
+	hi = (struct psort_t){ sort->pool, sort->arr + h, sort->tmp + h, sort->n - h, !sort->intmp, sort->compare };
+
+	thread_pool_submit(sort->pool, &group, psort_task, &hi);
+	psort_task(&lo);
+	thread_pool_wait(sort->pool, &group);
+
+	if(sort->intmp)
+		merge = (struct pmerge_t){ sort->pool, sort->tmp, sort->arr, sort->arr + h, h, sort->n - h, sort->compare };
+	else
+		merge = (struct pmerge_t){ sort->pool, sort->arr, sort->tmp, sort->tmp + h, h, sort->n - h, sort->compare };
+
+	pmerge_task(&merge);
+}
+
+/**
+ * Parallel merge task. The larger input is split at its midpoint and the
+ * other is split by binary search, keeping ties in left-first order.
+ *   @arg: The merge structure.
+ */
+
+static void pmerge_task(void *arg)
+{
+	size_t i, j, lo, hi;
+	struct pmerge_t *merge = arg, first, second;
+	struct thread_group_t group = THREAD_GROUP_INIT;
+
+	if((merge->nleft + merge->nright) <= MERGE_GRAIN) {
+		sort_merge(merge->dest, merge->left, merge->nleft, merge->right, merge->nright, merge->compare);
+		return;
+	}
+
+	if(merge->nleft >= merge->nright) {
+		i = merge->nleft / 2;
+
+		lo = 0;
+		hi = merge->nright;
+		while(lo < hi) {
+			if(merge->compare(merge->right[(lo + hi) / 2], merge->left[i]) < 0)
+				lo = (lo + hi) / 2 + 1;
+			else
+				hi = (lo + hi) / 2;
+		}
+
+		j = lo;
+	}
+	else {
+		j = merge->nright / 2;
+
+		lo = 0;
+		hi = merge->nleft;
+		while(lo < hi) {
+			if(merge->compare(merge->right[j], merge->left[(lo + hi) / 2]) < 0)
+				hi = (lo + hi) / 2;
+			else
+				lo = (lo + hi) / 2 + 1;
+		}
+
+		i = lo;
+	}
+
+	first = (struct pmerge_t){ merge->pool, merge->dest, merge->left, merge->right, i, j, merge->compare };
+	second = (struct pmerge_t){ merge->pool, merge->dest + i + j, merge->left + i, merge->right + j, merge->nleft - i, merge->nright - j, merge->compare };
+
+	thread_pool_submit(merge->pool, &group, pmerge_task, &second);
+	pmerge_task(&first);
+	thread_pool_wait(merge->pool, &group);
+}
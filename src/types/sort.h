@@ -0,0 +1,31 @@
+#ifndef TYPES_SORT_H
+#define TYPES_SORT_H
+
+/*
+ * start header: shim.h
+ */
+
+/* %shim.h% */
+
+/*
+ * structure prototypes
+ */
+
+struct thread_pool_t;
+
+
+/*
+ * sort function declarations
+ */
+
+void sort_stable(void **arr, size_t n, compare_f compare);
+void sort_merge(void **dest, void **left, size_t nleft, void **right, size_t nright, compare_f compare);
+void sort_par(struct thread_pool_t *pool, void **arr, size_t n, compare_f compare);
+
+/* %~shim.h% */
+
+/*
+ * end header: shim.h
+ */
+
+#endif
@@ -1,6 +1,8 @@
 #include "../common.h"
 #include "strbuf.h"
+#include "../debug/exception.h"
 #include "../io/output.h"
+#include "../io/print.h"
 #include "../mem/base.h"
 #include "../mem/manage.h"
 #include "../string/base.h"
@@ -10,6 +12,7 @@
  * local function declarations
  */
 
+static char *grow(struct strbuf_t *buf, size_t nbytes);
 static size_t output_write(void *ref, const void *restrict buf, size_t nbytes);
 
 /*
@@ -26,7 +29,20 @@ static struct io_output_i output_iface = {
 
 
 /**
- * Initialize the string buffer.
+ * Retrieve the character storage of a string buffer.
+ *   @buf: The string buffer.
+ *   &returns: The storage.
+ */
+
+static inline char *storage(struct strbuf_t *buf)
+{
+	return buf->store ? buf->store : buf->small;
+}
+
+
+/**
+ * Initialize the string buffer. Lengths up to 'STRBUF_SMALL' use the inline
+ * storage, so no memory is allocated until it overflows.
  *   @buf: The memory where the string buffer is stored.
  *   @initlen: The initial buffer length.
  */
@@ -34,9 +50,7 @@ static struct io_output_i output_iface = {
 _export
 void strbuf_init(struct strbuf_t *buf, size_t initlen)
 {
-	buf->i = 0;
-	buf->n = initlen;
-	buf->store = mem_alloc(initlen);
+	*buf = strbuf_empty(initlen);
 }
 
 /**
@@ -48,7 +62,10 @@ void strbuf_init(struct strbuf_t *buf, size_t initlen)
 _export
 struct strbuf_t strbuf_empty(size_t initlen)
 {
-	return (struct strbuf_t){ mem_alloc(initlen), 0, initlen };
+	if(initlen <= STRBUF_SMALL)
+		return (struct strbuf_t){ .store = NULL, .i = 0, .n = STRBUF_SMALL };
+	else
+		return (struct strbuf_t){ .store = mem_alloc(initlen), .i = 0, .n = initlen };
 }
 
 /**
@@ -76,7 +93,8 @@ struct strbuf_t *strbuf_new(size_t initlen)
 _export
 void strbuf_destroy(struct strbuf_t *buf)
 {
-	mem_free(buf->store);
+	if(buf->store != NULL)
+		mem_free(buf->store);
 }
 
 /**
@@ -103,6 +121,46 @@ void strbuf_reset(struct strbuf_t *buf)
 	buf->i = 0;
 }
 
+/**
+ * Reserve space so that the given number of bytes may be added without
+ * reallocating.
+ *   @buf: The string buffer.
+ *   @nbytes: The number of bytes.
+ */
+
+_export
+void strbuf_reserve(struct strbuf_t *buf, size_t nbytes)
+{
+	if((buf->n - buf->i) < nbytes)
+		grow(buf, nbytes);
+}
+
+/**
+ * Shrink the storage to fit the buffered characters, returning to the inline
+ * storage when they fit.
+ *   @buf: The string buffer.
+ */
+
+_export
+void strbuf_shrink(struct strbuf_t *buf)
+{
+	if(buf->store == NULL)
+		return;
+
+	if(buf->i <= STRBUF_SMALL) {
+		char *store = buf->store;
+
+		mem_copy(buf->small, store, buf->i);
+		mem_free(store);
+		buf->store = NULL;
+		buf->n = STRBUF_SMALL;
+	}
+	else if(buf->i < buf->n) {
+		buf->store = mem_realloc(buf->store, buf->i);
+		buf->n = buf->i;
+	}
+}
+
 /**
  * Store a character in the string buffer.
  *   @buf: The string buffer.
@@ -112,12 +170,10 @@ void strbuf_reset(struct strbuf_t *buf)
 _export
 void strbuf_store(struct strbuf_t *buf, char ch)
 {
-	if(buf->i >= buf->n) {
-		buf->store = mem_realloc(buf->store, 2 * buf->n);
-		buf->n *= 2;
-	}
+	char *ptr;
 
-	buf->store[buf->i++] = ch;
+	ptr = (buf->i < buf->n) ? storage(buf) : grow(buf, 1);
+	ptr[buf->i++] = ch;
 }
 
 /**
@@ -132,6 +188,18 @@ void strbuf_append(struct strbuf_t *buf, const char *restrict str)
 	strbuf_write(buf, str, str_len(str));
 }
 
+/**
+ * Append a string slice onto the string buffer.
+ *   @buf: The string buffer.
+ *   @slice: The slice.
+ */
+
+_export
+void strbuf_append_slice(struct strbuf_t *buf, struct str_slice_t slice)
+{
+	strbuf_write(buf, slice.ptr, slice.len);
+}
+
 /**
  * Write data onto the string buffer.
  *   @buf: The string buffer.
@@ -142,22 +210,43 @@ void strbuf_append(struct strbuf_t *buf, const char *restrict str)
 _export
 void strbuf_write(struct strbuf_t *buf, const void *restrict data, size_t nbytes)
 {
-	unsigned int i, n;
+	char *ptr;
+
+	ptr = ((buf->n - buf->i) >= nbytes) ? storage(buf) : grow(buf, nbytes);
+	mem_copy(ptr + buf->i, data, nbytes);
+	buf->i += nbytes;
+}
 
-	i = buf->i + nbytes;
-	if(i >= buf->n) {
-		n = buf->n;
+/**
+ * Print formatted text onto the string buffer. The text is written straight
+ * into the spare capacity without an intermediate string.
+ *   @buf: The string buffer.
+ *   @format: The printf-style format.
+ *   @...: The printf-style arguments.
+ */
 
-		do
-			n *= 2;
-		while(i >= n);
+_export
+void strbuf_printf(struct strbuf_t *buf, const char *restrict format, ...)
+{
+	va_list args;
 
-		buf->store = mem_realloc(buf->store, n);
-		buf->n = n;
-	}
+	va_start(args, format);
+	strbuf_vprintf(buf, format, args);
+	va_end(args);
+}
 
-	mem_copy(buf->store + buf->i, data, nbytes);
-	buf->i = i;
+/**
+ * Print formatted text onto the string buffer using a variable argument
+ * list.
+ *   @buf: The string buffer.
+ *   @format: The printf-style format.
+ *   @args: The printf-style arguments.
+ */
+
+_export
+void strbuf_vprintf(struct strbuf_t *buf, const char *restrict format, va_list args)
+{
+	io_vprintf((struct io_output_t){ buf, &output_iface }, format, args);
 }
 
 
@@ -171,7 +260,13 @@ void strbuf_write(struct strbuf_t *buf, const void *restrict data, size_t nbytes
 _export
 char *strbuf_done(struct strbuf_t *buf)
 {
-	buf->store = mem_realloc(buf->store, buf->i + 1);
+	if(buf->store == NULL) {
+		buf->store = mem_alloc(buf->i + 1);
+		mem_copy(buf->store, buf->small, buf->i);
+	}
+	else if((buf->i + 1) != buf->n)
+		buf->store = mem_realloc(buf->store, buf->i + 1);
+
 	buf->store[buf->i] = '\0';
 
 	return buf->store;
@@ -209,7 +304,20 @@ const char *strbuf_finish(struct strbuf_t *buf)
 	strbuf_store(buf, '\0');
 	buf->i = 0;
 
-	return buf->store;
+	return storage(buf);
+}
+
+/**
+ * Retrieve a slice over the buffered characters. The slice is valid until
+ * the buffer is next modified.
+ *   @buf: The string buffer.
+ *   &returns: The slice.
+ */
+
+_export
+struct str_slice_t strbuf_slice(const struct strbuf_t *buf)
+{
+	return (struct str_slice_t){ buf->store ? buf->store : buf->small, buf->i };
 }
 
 
@@ -224,6 +332,37 @@ struct io_output_t strbuf_output(struct strbuf_t *buf)
 	return (struct io_output_t){ buf, &output_iface };
 }
 
+
+/**
+ * Grow the storage to fit additional bytes, at least doubling the capacity
+ * and moving off the inline storage if needed.
+ *   @buf: The string buffer.
+ *   @nbytes: The number of additional bytes.
+ *   &returns: The new storage.
+ */
+
+static char *grow(struct strbuf_t *buf, size_t nbytes)
+{
+	size_t n = buf->n;
+
+	if(nbytes > (SIZE_MAX - buf->i))
+		throw("String buffer too large.");
+
+	while((n - buf->i) < nbytes)
+		n = (n > (SIZE_MAX / 2)) ? SIZE_MAX : (2 * n);
+
+	if(buf->store == NULL) {
+		buf->store = mem_alloc(n);
+		mem_copy(buf->store, buf->small, buf->i);
+	}
+	else
+		buf->store = mem_realloc(buf->store, n);
+
+	buf->n = n;
+
+	return buf->store;
+}
+
 /**
  * Write callback for the string buffer output device.
  *   @ref: The reference.
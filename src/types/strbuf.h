@@ -14,15 +14,23 @@
 struct io_output_t;
 
 
+/*
+ * string buffer definitions
+ */
+
+#define STRBUF_SMALL	40
+
 /**
  * String buffer storage.
- *   @store: The internal buffer storage.
+ *   @store: The heap storage, or null while using the inline storage.
  *   @i, n: The current index and buffer length.
+ *   @small: The inline storage.
  */
 
 struct strbuf_t {
 	char *store;
 	size_t i, n;
+	char small[STRBUF_SMALL];
 };
 
 
@@ -37,13 +45,19 @@ void strbuf_destroy(struct strbuf_t *buf);
 void strbuf_delete(struct strbuf_t *buf);
 
 void strbuf_reset(struct strbuf_t *buf);
+void strbuf_reserve(struct strbuf_t *buf, size_t nbytes);
+void strbuf_shrink(struct strbuf_t *buf);
 void strbuf_store(struct strbuf_t *buf, char ch);
 void strbuf_append(struct strbuf_t *buf, const char *restrict str);
+void strbuf_append_slice(struct strbuf_t *buf, struct str_slice_t slice);
 void strbuf_write(struct strbuf_t *buf, const void *restrict data, size_t nbytes);
+void strbuf_printf(struct strbuf_t *buf, const char *restrict format, ...);
+void strbuf_vprintf(struct strbuf_t *buf, const char *restrict format, va_list args);
 
 char *strbuf_done(struct strbuf_t *buf);
 char *strbuf_detach(struct strbuf_t *buf);
 const char *strbuf_finish(struct strbuf_t *buf);
+struct str_slice_t strbuf_slice(const struct strbuf_t *buf);
 
 struct io_output_t strbuf_output(struct strbuf_t *buf);
 
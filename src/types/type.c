@@ -3,6 +3,8 @@
 #include "../debug/exception.h"
 #include "../io/print.h"
 #include "../mem/manage.h"
+#include "../string/intern.h"
+#include "../thread/base.h"
 
 
 /*
@@ -15,6 +17,15 @@ static void proc_void(struct io_output_t output, void *arg);
 static void proc_native(struct io_output_t output, void *arg);
 static void proc_func(struct io_output_t output, void *arg);
 
+static void name_init();
+
+/*
+ * local variables
+ */
+
+static const char *name_list[type_func_e + 1];
+static struct thread_once_t name_once = THREAD_ONCE_INIT;
+
 
 /**
  * Copy a type.
@@ -546,21 +557,31 @@ bool type_issigned(enum type_e id)
 /**
  * Retrieve the name for the type identifier.
  *   @id: The identifier.
- *   &returns: The string name.
+ *   &returns: The string name, interned in the global pool.
  */
 
 _export
 const char *type_name(enum type_e id)
 {
-	switch(id) {
-	case type_void_e: return "void"; break;
-	case type_int_e: return "int"; break;
-	case type_uint_e: return "uint"; break;
-	case type_int32_e: return "int32"; break;
-	case type_uint32_e: return "uint32"; break;
-	case type_ptr_e: return "ptr"; break;
-	case type_func_e: return "func"; break;
-	}
+	if((unsigned int)id >= (sizeof(name_list) / sizeof(name_list[0])))
+		throw("Invalid type identifier.");
 
-	throw("Invalid type identifier.");
+	thread_once(&name_once, name_init);
+
+	return name_list[id];
+}
+
+/**
+ * Initialize the interned type names.
+ */
+
+static void name_init()
+{
+	name_list[type_void_e] = str_intern("void");
+	name_list[type_int_e] = str_intern("int");
+	name_list[type_uint_e] = str_intern("uint");
+	name_list[type_int32_e] = str_intern("int32");
+	name_list[type_uint32_e] = str_intern("uint32");
+	name_list[type_ptr_e] = str_intern("ptr");
+	name_list[type_func_e] = str_intern("func");
 }
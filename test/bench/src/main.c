@@ -0,0 +1,287 @@
+#include "common.h"
+
+
+/*
+ * local definitions
+ */
+
+#define DIGITS	10000
+#define NODES	1000000
+
+/**
+ * Node structure.
+ *   @val: The integer value.
+ *   @real: The real value.
+ *   @name: The name.
+ *   @next: The next node.
+ */
+
+struct node_t {
+	int64_t val;
+	double real;
+	char *name;
+
+	struct node_t *next;
+};
+
+
+/**
+ * Retrieve the time elapsed since a start time.
+ *   @start: The start time from 'sys_monotonic_ns'.
+ *   &returns: The elapsed time in microseconds.
+ */
+
+static unsigned int elapsed(uint64_t start)
+{
+	return (sys_monotonic_ns() - start) / 1000;
+}
+
+
+/**
+ * Benchmark arbitrary-precision integer parsing, printing, multiplication,
+ * and division on decimal operands.
+ */
+
+void bench_integer()
+{
+	unsigned int i;
+	char *str;
+	size_t len;
+	uint64_t start;
+	struct m_rand_t rand;
+	struct io_output_t output;
+	struct integer_t *a, *b, *prod, *quot;
+	unsigned int parse, print, mul, div;
+
+	rand = m_rand_new(1);
+	str = mem_alloc(DIGITS + 1);
+
+	for(i = 0; i < DIGITS; i++)
+		str[i] = '0' + (m_rand_next(&rand) % 10);
+
+	str[0] = '1' + (str[0] % 9);
+	str[DIGITS] = '\0';
+
+	start = sys_monotonic_ns();
+	a = integer_parse(str, NULL);
+	parse = elapsed(start);
+
+	output = str_output_len(&len);
+	start = sys_monotonic_ns();
+	integer_print(a, output);
+	print = elapsed(start);
+	io_output_close(output);
+
+	str[DIGITS / 2] = '\0';
+	b = integer_parse(str, NULL);
+	prod = integer_copy(a);
+
+	start = sys_monotonic_ns();
+	integer_mul(&prod, a);
+	mul = elapsed(start);
+
+	quot = integer_copy(a);
+
+	start = sys_monotonic_ns();
+	integer_div(&quot, b);
+	div = elapsed(start);
+
+	printf("integer, %u digits: parse %u us, print %u us, mul %u us, div %u us\n", DIGITS, parse, print, mul, div);
+
+	integer_delete(a);
+	integer_delete(b);
+	integer_delete(prod);
+	integer_delete(quot);
+	mem_free(str);
+}
+
+
+/**
+ * Save a benchmark node.
+ *   @ref: The node reference.
+ *   @writer: The writer.
+ *   @arg: Unused.
+ */
+
+static void node_save(void *ref, struct io_writer_t *writer, void *arg)
+{
+	struct node_t *node = ref;
+
+	io_writer_int64(writer, node->val);
+	io_writer_double(writer, node->real);
+	io_writer_str(writer, node->name);
+	io_writer_bool(writer, node->next != NULL);
+
+	if(node->next != NULL)
+		io_writer_save(writer, node->next, node_save, NULL);
+}
+
+/**
+ * Load a benchmark node.
+ *   @reader: The reader.
+ *   @arg: Unused.
+ *   &returns: The node.
+ */
+
+static void *node_load(struct io_reader_t *reader, void *arg)
+{
+	struct node_t *node;
+
+	node = mem_alloc(sizeof(struct node_t));
+	node->val = io_reader_int64(reader);
+	node->real = io_reader_double(reader);
+	node->name = io_reader_str(reader);
+	node->next = io_reader_bool(reader) ? io_reader_load(reader, node_load, NULL) : NULL;
+
+	return node;
+}
+
+/**
+ * Benchmark serialization of a node graph, half of which shares a single
+ * back-reference, over buffered file I/O.
+ *   @serial: The encoding.
+ *   @label: The encoding label.
+ */
+
+void bench_serial(enum io_serial_e serial, const char *label)
+{
+	unsigned int i;
+	uint64_t start, size;
+	unsigned int write, read;
+	struct node_t *node, *load, *first = NULL, shared = { 42, 0.5, "shared", NULL };
+	struct io_file_t file;
+	struct io_output_t output;
+	struct io_input_t input;
+	struct io_writer_t *writer;
+	struct io_reader_t *reader;
+
+	node = mem_alloc(NODES * sizeof(struct node_t));
+
+	for(i = 0; i < NODES; i++)
+		node[i] = (struct node_t){ i, i * 0.25, "node", (i % 2) ? &shared : NULL };
+
+	start = sys_monotonic_ns();
+	output = io_output_open("./tmp-bench");
+	writer = io_writer_new(output, serial);
+
+	for(i = 0; i < NODES; i++)
+		io_writer_save(writer, &node[i], node_save, NULL);
+
+	io_writer_delete(writer);
+	io_output_close(output);
+	write = elapsed(start);
+
+	start = sys_monotonic_ns();
+	input = io_input_open("./tmp-bench");
+	reader = io_reader_new(input, serial);
+
+	for(i = 0; i < NODES; i++) {
+		load = io_reader_load(reader, node_load, NULL);
+		if(load->next != NULL) {
+			if(first == NULL)
+				first = load->next;
+			else if(load->next != first)
+				printf("shared reference mismatch\n");
+		}
+
+		mem_free(load->name);
+		mem_free(load);
+	}
+
+	io_reader_delete(reader);
+	io_input_close(input);
+	read = elapsed(start);
+
+	file = io_file_open("./tmp-bench", io_read_e);
+	size = io_file_seek(file, 0, io_seek_end_e);
+	io_file_close(file);
+	fs_rmfile("./tmp-bench");
+
+	printf("serial %s, %u nodes: %u KB, write %u ms, read %u ms\n", label, NODES, (unsigned int)(size / 1000), write / 1000, read / 1000);
+
+	mem_free(first->name);
+	mem_free(first);
+	mem_free(node);
+}
+
+/**
+ * Benchmark back-reference lookups, with every node referring to a random
+ * earlier node, using the compact encoding.
+ */
+
+void bench_refs()
+{
+	unsigned int i;
+	uint64_t start;
+	unsigned int write, read;
+	struct m_rand_t rand;
+	struct node_t *node, **load;
+	struct io_output_t output;
+	struct io_input_t input;
+	struct io_writer_t *writer;
+	struct io_reader_t *reader;
+
+	rand = m_rand_new(2);
+	node = mem_alloc(NODES * sizeof(struct node_t));
+	load = mem_alloc(NODES * sizeof(struct node_t *));
+
+	for(i = 0; i < NODES; i++)
+		node[i] = (struct node_t){ i, 0.0, "", (i > 0) ? &node[m_rand_next(&rand) % i] : NULL };
+
+	start = sys_monotonic_ns();
+	output = io_output_open("./tmp-bench");
+	writer = io_writer_new(output, io_serial_compact_e);
+
+	for(i = 0; i < NODES; i++)
+		io_writer_save(writer, &node[i], node_save, NULL);
+
+	io_writer_delete(writer);
+	io_output_close(output);
+	write = elapsed(start);
+
+	start = sys_monotonic_ns();
+	input = io_input_open("./tmp-bench");
+	reader = io_reader_new(input, io_serial_compact_e);
+
+	for(i = 0; i < NODES; i++)
+		load[i] = io_reader_load(reader, node_load, NULL);
+
+	io_reader_delete(reader);
+	io_input_close(input);
+	read = elapsed(start);
+
+	fs_rmfile("./tmp-bench");
+
+	printf("serial refs, %u nodes: write %u ms, read %u ms\n", NODES, write / 1000, read / 1000);
+
+	for(i = 0; i < NODES; i++) {
+		if((i > 0) && (load[i]->next != load[node[i].next - node]))
+			printf("back-reference mismatch\n");
+	}
+
+	for(i = 0; i < NODES; i++) {
+		mem_free(load[i]->name);
+		mem_free(load[i]);
+	}
+
+	mem_free(load);
+	mem_free(node);
+}
+
+
+/**
+ * Main entry point.
+ *   @argc: The number of arguments.
+ *   @argv: The argument array.
+ *   &returns: The return status code.
+ */
+
+int main(int argc, char *argv[])
+{
+	bench_integer();
+	bench_serial(io_serial_native_e, "native");
+	bench_serial(io_serial_compact_e, "compact");
+	bench_refs();
+
+	return 0;
+}
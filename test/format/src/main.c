@@ -59,6 +59,60 @@ bool test_io_accum()
 	return true;
 }
 
+/**
+ * I/O buffer test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_buffer()
+{
+	size_t len;
+	struct io_output_t output, buffer;
+
+	printf("testing io buffer... ");
+
+	output = str_output_len(&len);
+	buffer = io_output_buffer(output, 16, io_buf_full_e);
+	io_printf(buffer, "%u %s", 123, "abc");
+	if(len != 0)
+		return printf("failed\n"), false;
+
+	io_printf(buffer, "0123456789");
+	if(len != 7)
+		return printf("failed\n"), false;
+
+	io_output_flush(buffer);
+	if(len != 17)
+		return printf("failed\n"), false;
+
+	io_printf(buffer, "%s", "a string longer than the buffer");
+	if(len != 48)
+		return printf("failed\n"), false;
+
+	io_output_close(buffer);
+	io_output_close(output);
+
+	output = str_output_len(&len);
+	buffer = io_output_buffer(output, 64, io_buf_line_e);
+	io_printf(buffer, "line %u", 1);
+	if(len != 0)
+		return printf("failed\n"), false;
+
+	io_printf(buffer, "\nnext");
+	if(len != 11)
+		return printf("failed\n"), false;
+
+	io_output_close(buffer);
+	if(len != 11)
+		return printf("failed\n"), false;
+
+	io_output_close(output);
+
+	printf("okay\n");
+
+	return true;
+}
+
 /**
  * String formatting test.
  *   &returns: True of success, false on failure.
@@ -107,6 +161,354 @@ bool test_str_printf()
 	return true;
 }
 
+/**
+ * Compiled format test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_fmt()
+{
+	char buf[1024];
+	struct io_fmt_t *fmt;
+	struct io_output_t output;
+
+	printf("testing compiled format... ");
+
+	fmt = io_fmt_new("a %s b %05u %% %-4x|%:char:");
+
+	output = str_output_buf(buf, sizeof(buf), NULL);
+	io_fmt_printf(output, fmt, "str", 12, 0xab, 'z');
+	io_output_close(output);
+	if(!str_isequal(buf, "a str b 00012 % ab  |z"))
+		return printf("failed (%s)\n", buf), false;
+
+	output = str_output_buf(buf, sizeof(buf), NULL);
+	io_fmt_printf(output, fmt, "", 7, 1, '!');
+	io_output_close(output);
+	if(!str_isequal(buf, "a  b 00007 % 1   |!"))
+		return printf("failed (%s)\n", buf), false;
+
+	io_fmt_delete(fmt);
+
+	fmt = io_fmt_new("%%");
+	output = str_output_buf(buf, sizeof(buf), NULL);
+	io_fmt_printf(output, fmt);
+	io_output_close(output);
+	if(!str_isequal(buf, "%"))
+		return printf("failed (%s)\n", buf), false;
+
+	io_fmt_delete(fmt);
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Base string function test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_str_base()
+{
+	unsigned int i;
+	char buf[256], sub[256];
+
+	printf("testing string base... ");
+
+	for(i = 0; i < sizeof(buf) - 1; i++)
+		buf[i] = 'a' + (i % 26);
+
+	buf[sizeof(buf) - 1] = '\0';
+
+	for(i = 0; i < 64; i++) {
+		if(str_len(buf + i) != (sizeof(buf) - 1 - i))
+			return printf("failed\n"), false;
+	}
+
+	if((str_chr(buf + 1, 'a') != (buf + 26)) || (str_chr(buf, '!') != NULL) || (str_chr(buf, '\0') != (buf + sizeof(buf) - 1)))
+		return printf("failed\n"), false;
+
+	if((str_pbrk(buf, "!?z") != (buf + 25)) || (str_pbrk(buf, "\xe9") != NULL) || (str_pbrk("a\xe9", "\xe9") == NULL))
+		return printf("failed\n"), false;
+
+	str_copy(sub, buf);
+	for(i = 0; sub[i] != '\0'; i += 3)
+		sub[i] -= 'a' - 'A';
+
+	if(!str_isequali(buf, sub) || str_isequal(buf, sub) || str_isequali(buf, sub + 1) || !str_isequali("", ""))
+		return printf("failed\n"), false;
+
+	if(!str_isprefix(buf, "abcdefghijklmnopqrstuvwxyzabcdefgh") || str_isprefix(buf, "abcdefghijklmnopqrstuvwxyzabcdefgx") || str_isprefix("ab", "abc"))
+		return printf("failed\n"), false;
+
+	str_copy(sub, buf);
+	sub[100] = '!';
+	str_longest(sub, buf);
+	if(str_len(sub) != 100)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * String slice test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_str_slice()
+{
+	char buf[64];
+	unsigned int n = 0;
+	bool more = true;
+	struct strbuf_t strbuf;
+	struct str_slice_t slice, field;
+	static const char *fields[] = { "alpha", "", "gamma" };
+
+	printf("testing string slice... ");
+
+	slice = str_slice_trim(str_slice_from("  alpha,,gamma \n"));
+	if(!str_slice_isequal(slice, str_slice("alpha,,gamma", 12)) || str_slice_isequal(slice, str_slice("alpha", 5)))
+		return printf("failed\n"), false;
+
+	while(more) {
+		more = str_slice_split(slice, ',', &field, &slice);
+		if((n >= 3) || !str_slice_isequal(field, str_slice_from(fields[n++])))
+			return printf("failed\n"), false;
+	}
+
+	if(n != 3)
+		return printf("failed\n"), false;
+
+	slice = str_slice_from("key=Value;more");
+	if((str_slice_chr(slice, '=') != (slice.ptr + 3)) || (str_slice_rchr(slice, 'e') != (slice.ptr + 13)) || (str_slice_chr(str_slice_sub(slice, 0, 3), '=') != NULL))
+		return printf("failed\n"), false;
+
+	if((str_slice_find(slice, str_slice_from("ue;m")) != (slice.ptr + 7)) || (str_slice_find(slice, str_slice_from("mores")) != NULL) || (str_slice_pbrk(slice, ";=") != (slice.ptr + 3)))
+		return printf("failed\n"), false;
+
+	if(!str_slice_isprefix(slice, str_slice_from("key")) || !str_slice_issuffix(slice, str_slice_from("more")) || !str_slice_isequali(str_slice_sub(slice, 4, 5), str_slice_from("vALUE")))
+		return printf("failed\n"), false;
+
+	if((str_slice_cmp(str_slice_from("ab"), str_slice_from("abc")) >= 0) || (str_slice_cmp(str_slice_from("b"), str_slice_from("abc")) <= 0))
+		return printf("failed\n"), false;
+
+	str_printf(buf, "[%:slice:|%6:slice:]", str_slice_sub(slice, 4, 5), str_slice(slice.ptr, 3));
+	if(!str_isequal(buf, "[Value|   key]"))
+		return printf("failed (%s)\n", buf), false;
+
+	strbuf_init(&strbuf, 4);
+	strbuf_append_slice(&strbuf, str_slice_sub(slice, 0, 3));
+	strbuf_append_slice(&strbuf, str_slice_sub(slice, 9, 100));
+	if(!str_slice_isequal(strbuf_slice(&strbuf), str_slice_from("key;more")))
+		return printf("failed\n"), false;
+
+	strbuf_destroy(&strbuf);
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * String interning test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_str_intern()
+{
+	unsigned int i;
+	char buf[32];
+	const char *str[64];
+	struct io_input_t input;
+	struct io_conf_t *conf;
+	struct str_intern_t *pool;
+
+	printf("testing string intern... ");
+
+	pool = str_intern_new();
+
+	for(i = 0; i < 64; i++) {
+		str_printf(buf, "key%u", i);
+		str[i] = str_intern_add(pool, str_slice_from(buf));
+	}
+
+	for(i = 0; i < 64; i++) {
+		str_printf(buf, "key%u", i);
+		if((str_intern_add(pool, str_slice_from(buf)) != str[i]) || !str_isequal(str[i], buf))
+			return printf("failed\n"), false;
+	}
+
+	if((str_intern_count(pool) != 64) || (str_intern_find(pool, str_slice("key1x", 4)) != str[1]) || (str_intern_find(pool, str_slice_from("key64")) != NULL))
+		return printf("failed\n"), false;
+
+	str_intern_delete(pool);
+
+	if((str_intern("global") != str_intern_slice(str_slice("globally", 6))) || (type_name(type_int_e) != str_intern("int")))
+		return printf("failed\n"), false;
+
+	input = str_input_buf("Name first\nList 'a b' c\nName second # comment\nBegin Sub\nInner value\nEnd\n");
+	conf = io_conf_read(input);
+	io_input_close(input);
+
+	if((io_conf_accum(conf) != 2) || !str_isequal(io_conf_lookup_values(conf, "Name")[1], "second") || (io_conf_lookup(conf, "Missing-Key") != NULL))
+		return printf("failed\n"), false;
+
+	if(!str_isequal(io_conf_lookup_values(conf, "List")[0], "a b") || (io_conf_lookup(conf, "List")->id != str_intern("List")))
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	io_conf_delete(conf);
+
+	return true;
+}
+
+/**
+ * Buffer number scanning test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_str_scan()
+{
+	unsigned int i;
+	bool ovf, suc = true;
+	static const char *bad[] = { "", "abc", "-", "." };
+	uint64_t u64;
+	double dbl;
+	char *end;
+
+	printf("testing buffer scanning... ");
+
+	if((str_scan_uint64("1234567890123456789x", 20, &u64, &ovf) != 19) || (u64 != UINT64_C(1234567890123456789)) || ovf)
+		return printf("failed\n"), false;
+
+	if((str_scan_uint64("99999999999999999999", 20, &u64, &ovf) != 20) || (u64 != UINT64_MAX) || !ovf)
+		return printf("failed\n"), false;
+
+	if((str_scan_uint64("12345678", 4, &u64, NULL) != 4) || (u64 != 1234))
+		return printf("failed\n"), false;
+
+	if((str_scan_double("0.1", 3, &dbl, NULL) != 3) || (dbl != 0.1))
+		return printf("failed\n"), false;
+
+	if((str_scan_double("-1.7976931348623157e308", 23, &dbl, &ovf) != 23) || (dbl != -1.7976931348623157e308) || ovf)
+		return printf("failed\n"), false;
+
+	if((str_scan_double("1e400", 5, &dbl, &ovf) != 5) || !ovf)
+		return printf("failed\n"), false;
+
+	if((str_scan_double("4.9406564584124654e-324", 23, &dbl, NULL) != 23) || (dbl != 4.9406564584124654e-324))
+		return printf("failed\n"), false;
+
+	if((str_scan_double("3.14159265358979323846264338327950288", 37, &dbl, NULL) != 37) || (dbl != 3.14159265358979323846264338327950288))
+		return printf("failed\n"), false;
+
+	if((str_scan_double("1e", 2, &dbl, NULL) != 1) || (dbl != 1.0) || (str_scan_double(".", 1, &dbl, NULL) != 0))
+		return printf("failed\n"), false;
+
+	if((str_todouble("-inf,", &end) != -1.0 / 0.0) || (*end != ','))
+		return printf("failed\n"), false;
+
+	if((str_toulong("077 ", &end) != 077) || (*end != ' '))
+		return printf("failed\n"), false;
+
+	if((str_toulong("", &end) != 0) || (*end != '\0') || (str_toulong("abc", &end) != 0) || (*end != 'a'))
+		return printf("failed\n"), false;
+
+	if((str_todouble("", &end), *end != '\0') || (str_todouble("-x", &end), *end != '-'))
+		return printf("failed\n"), false;
+
+	for(i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+		try {
+			str_parse_uint(bad[i]);
+			suc = false;
+		}
+		catch(e)
+			suc &= str_isequal(e, "Invalid number.");
+
+		try {
+			str_parse_double(bad[i]);
+			suc = false;
+		}
+		catch(e)
+			suc &= str_isequal(e, "Invalid number.");
+	}
+
+	try {
+		str_toulong("99999999999999999999", NULL);
+		suc = false;
+	}
+	catch(e)
+		suc &= str_isequal(e, "Value too large.");
+
+	if(!suc || (str_parse_uint("12 ") != 12) || (str_parse_double("2.5") != 2.5))
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Number conversion test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_conv()
+{
+	unsigned int i;
+	char buf[1024];
+	struct io_output_t output;
+	static const struct { double value; const char *str; } dbl[] = {
+		{ 0.0, "0" }, { -0.0, "-0" }, { 1.0, "1" }, { 0.1, "0.1" }, { -2.5, "-2.5" },
+		{ 1.23456789, "1.23456789" }, { 1e30, "1e+30" }, { 1e-7, "1e-07" }, { 0.000123, "0.000123" },
+		{ 123456789012.0, "123456789012" }, { 5e-324, "5e-324" }, { 1.7976931348623157e308, "1.7976931348623157e+308" },
+		{ 1.0 / 3.0, "0.3333333333333333" }, { 1.0 / 0.0, "inf" }, { -1.0 / 0.0, "-inf" }
+	};
+
+	printf("testing number conversion... ");
+
+	str_printf(buf, "%d %d %u", INT32_MIN, INT32_MAX, UINT32_MAX);
+	if(!str_isequal(buf, "-2147483648 2147483647 4294967295"))
+		return printf("failed (%s)\n", buf), false;
+
+	str_printf(buf, "%:int64: %:uint64: %:hex64:", INT64_MIN, UINT64_MAX, UINT64_C(0x1234abcd5678));
+	if(!str_isequal(buf, "-9223372036854775808 18446744073709551615 1234abcd5678"))
+		return printf("failed (%s)\n", buf), false;
+
+	str_printf(buf, "%05d|%5d|%-5d|%2u|%x", -42, -42, -42, 123456, 0);
+	if(!str_isequal(buf, "-0042|  -42|-42  |123456|0"))
+		return printf("failed (%s)\n", buf), false;
+
+	output = str_output_buf(buf, sizeof(buf), NULL);
+	io_format_int(output, -5, 16, 0, false);
+	io_format_int(output, INT_MIN, 16, 0, false);
+	io_format_int(output, -5, 2, 5, true);
+	io_format_int(output, 255, 16, 0, false);
+	io_format_int(output, -35, 36, 0, false);
+	io_format_uint64(output, 46655, 36, 0, false, false);
+	io_output_close(output);
+	if(!str_isequal(buf, "-5-80000000-0101ff-zzzz"))
+		return printf("failed (%s)\n", buf), false;
+
+	for(i = 0; i < sizeof(dbl) / sizeof(dbl[0]); i++) {
+		str_printf(buf, "%f", dbl[i].value);
+		if(!str_isequal(buf, dbl[i].str))
+			return printf("failed (%s)\n", buf), false;
+	}
+
+	str_printf(buf, "%8f|%-6f|%06f", 2.5, 0.5, -1.5);
+	if(!str_isequal(buf, "     2.5|0.5   |-001.5"))
+		return printf("failed (%s)\n", buf), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
 /**
  * I/O scanning test.
  *   &returns: True of success, false on failure.
@@ -172,12 +574,364 @@ bool test_io_scan()
 
 	io_input_close(input);
 
+	ch = '\0';
+	ptr = str = "2.5e-3,";
+	input = str_input_ref(&ptr);
+
+	dbl = io_scan_double(input, &ch);
+	if((dbl != 2.5e-3) || (ch != ','))
+		return printf("failed\n"), false;
+
+	io_input_close(input);
+
 	printf("okay\n");
 
 	return true;
 }
 
 
+/**
+ * Serialization test node.
+ *   @val: The value.
+ *   @real: The real value.
+ *   @name: The name.
+ *   @next: The shared next node.
+ */
+
+struct node_t {
+	int64_t val;
+	double real;
+	char *name;
+
+	struct node_t *next;
+};
+
+/**
+ * Save a test node.
+ *   @ref: The node reference.
+ *   @writer: The writer.
+ *   @arg: Unused.
+ */
+
+static void node_save(void *ref, struct io_writer_t *writer, void *arg)
+{
+	struct node_t *node = ref;
+
+	io_writer_int64(writer, node->val);
+	io_writer_double(writer, node->real);
+	io_writer_str(writer, node->name);
+	io_writer_bool(writer, node->next != NULL);
+
+	if(node->next != NULL)
+		io_writer_save(writer, node->next, node_save, NULL);
+}
+
+/**
+ * Load a test node.
+ *   @reader: The reader.
+ *   @arg: Unused.
+ *   &returns: The node.
+ */
+
+static void *node_load(struct io_reader_t *reader, void *arg)
+{
+	struct node_t *node;
+
+	node = mem_alloc(sizeof(struct node_t));
+	node->val = io_reader_int64(reader);
+	node->real = io_reader_double(reader);
+	node->name = io_reader_str(reader);
+	node->next = io_reader_bool(reader) ? io_reader_load(reader, node_load, NULL) : NULL;
+
+	return node;
+}
+
+/**
+ * Write a test graph.
+ *   @output: The output.
+ *   @serial: The encoding.
+ */
+
+static void node_graph(struct io_output_t output, enum io_serial_e serial)
+{
+	struct io_writer_t *writer;
+	struct node_t c = { 300, 0.25, "shared", NULL };
+	struct node_t a = { -1, 1.5, "first", &c }, b = { 1234567890123, -2.0, "second", &c };
+
+	writer = io_writer_new(output, serial);
+	io_writer_save(writer, &a, node_save, NULL);
+	io_writer_save(writer, &b, node_save, NULL);
+	io_writer_save(writer, &c, node_save, NULL);
+	io_writer_delete(writer);
+}
+
+/**
+ * Serialization testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_serial()
+{
+	bool suc = true;
+	unsigned int i;
+	size_t len[2];
+	enum io_serial_e serial[2] = { io_serial_native_e, io_serial_compact_e };
+	struct io_input_t input;
+	struct io_output_t output;
+	struct io_reader_t *reader;
+
+	printf("testing io serial... ");
+
+	for(i = 0; i < 2; i++) {
+		char tail[4];
+		struct node_t *a, *b, *c;
+
+		output = str_output_len(&len[i]);
+		node_graph(output, serial[i]);
+		io_output_close(output);
+
+		output = io_output_open("./tmp-serial");
+		node_graph(output, serial[i]);
+		io_output_write(output, "tail", 4);
+		io_output_close(output);
+
+		input = io_input_open("./tmp-serial");
+		reader = io_reader_new(input, serial[i]);
+		a = io_reader_load(reader, node_load, NULL);
+		b = io_reader_load(reader, node_load, NULL);
+		c = io_reader_load(reader, node_load, NULL);
+		io_input_readfull(io_reader_input(reader), tail, sizeof(tail));
+		io_reader_delete(reader);
+		io_input_close(input);
+		fs_rmfile("./tmp-serial");
+
+		if((a->next != c) || (b->next != c) || (c->next != NULL))
+			suc = false;
+		else if(!mem_isequal(tail, "tail", sizeof(tail)))
+			suc = false;
+		else if((a->val != -1) || (b->val != 1234567890123) || (c->val != 300))
+			suc = false;
+		else if((a->real != 1.5) || (b->real != -2.0) || (c->real != 0.25))
+			suc = false;
+		else if(!str_isequal(a->name, "first") || !str_isequal(b->name, "second") || !str_isequal(c->name, "shared"))
+			suc = false;
+
+		mem_free(a->name);
+		mem_free(b->name);
+		mem_free(c->name);
+		mem_free(a);
+		mem_free(b);
+		mem_free(c);
+
+		if(!suc)
+			return printf("failed\n"), false;
+	}
+
+	if(len[1] >= len[0])
+		return printf("failed\n"), false;
+
+	output = io_output_open("./tmp-serial");
+	io_writer_delete(io_writer_new(output, io_serial_compact_e));
+	io_output_varint(output, (uint64_t)1 << 40);
+	io_output_write(output, "trunc", 5);
+	io_output_close(output);
+
+	input = io_input_open("./tmp-serial");
+	reader = io_reader_new(input, io_serial_compact_e);
+
+	try {
+		mem_free(io_reader_str(reader));
+		suc = false;
+	}
+	catch(e) { }
+
+	io_reader_delete(reader);
+	io_input_close(input);
+	fs_rmfile("./tmp-serial");
+
+	if(!suc)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+
+/**
+ * Scoped serialization testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_stream()
+{
+	bool suc = true;
+	unsigned int i;
+	struct io_input_t input;
+	struct io_output_t output;
+	struct io_writer_t *writer;
+	struct io_reader_t *reader;
+	struct node_t root = { 7, 0.5, "root", NULL }, rec = { 0, 0.0, "record", &root };
+	struct node_t *load, *first, *second;
+
+	printf("testing io stream... ");
+
+	output = io_output_open("./tmp-stream");
+	writer = io_writer_new(output, io_serial_compact_e);
+	io_writer_save(writer, &root, node_save, NULL);
+
+	for(i = 0; i < 100; i++) {
+		rec.val = i;
+
+		io_writer_scope_begin(writer);
+		io_writer_save(writer, &rec, node_save, NULL);
+		io_writer_save(writer, &rec, node_save, NULL);
+		io_writer_scope_end(writer);
+	}
+
+	io_writer_delete(writer);
+	io_output_close(output);
+
+	input = io_input_open("./tmp-stream");
+	reader = io_reader_new(input, io_serial_compact_e);
+	load = io_reader_load(reader, node_load, NULL);
+
+	for(i = 0; i < 100; i++) {
+		io_reader_scope_begin(reader);
+		first = io_reader_load(reader, node_load, NULL);
+		second = io_reader_load(reader, node_load, NULL);
+		io_reader_scope_end(reader);
+
+		if((first != second) || (first->next != load) || (first->val != i))
+			suc = false;
+
+		mem_free(first->name);
+		mem_free(first);
+	}
+
+	io_reader_delete(reader);
+	io_input_close(input);
+	fs_rmfile("./tmp-stream");
+
+	mem_free(load->name);
+	mem_free(load);
+
+	if(!suc)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+
+/**
+ * Record a configuration change.
+ *   @change: The change.
+ *   @arg: The string buffer.
+ */
+
+void conf_change(const struct io_conf_change_t *change, void *arg)
+{
+	static const char sym[] = { '+', '-', '~' };
+
+	if(change->section)
+		strbuf_printf(arg, "%c[%s] ", sym[change->type], change->id);
+	else
+		strbuf_printf(arg, "%c%s%s%s ", sym[change->type], (change->next && io_conf_id(change->next)) ? io_conf_id(change->next) : "", (change->next && io_conf_id(change->next)) ? "." : "", change->id);
+}
+
+/**
+ * Configuration test.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_io_conf()
+{
+	bool suc = true;
+	char *str;
+	struct strbuf_t buf;
+	struct io_input_t input;
+	struct io_conf_t *conf, *next, *sub;
+	struct io_conf_subiter_t iter;
+	struct io_conf_pair_t *pair;
+
+	printf("testing configuration... ");
+
+	input = str_input_buf("Multi a\nMulti b c\nKeep 1\nDrop x\nMulti d\nSingle one\nBegin Sec\nInner 1\nEnd\nBegin Old\nEnd\n");
+	conf = io_conf_read(input);
+	io_input_close(input);
+
+	suc &= (io_conf_accum(conf) == 4);
+	suc &= (io_conf_lookup(conf, "Multi")->nvalues == 4) && str_isequal(io_conf_lookup_values(conf, "Multi")[3], "d");
+	suc &= (io_conf_lookup_values(conf, "Multi")[4] == NULL);
+
+	str = io_conf_remove_single(conf, "Single");
+	suc &= str_isequal(str, "one") && (io_conf_lookup(conf, "Single") == NULL) && (io_conf_accum(conf) == 3);
+	mem_free(str);
+
+	suc &= (io_conf_lookup(conf, "Keep") != NULL) && (io_conf_lookup(conf, "Drop") != NULL);
+
+	input = str_input_buf("Gone a b\nGone c\nStay d\n");
+	next = io_conf_read(input);
+	io_input_close(input);
+
+	pair = io_conf_remove(next, "Gone");
+	suc &= (pair != NULL) && (pair->nvalues == 3) && str_isequal(pair->value[2], "c") && (pair->value[3] == NULL);
+	suc &= (io_conf_lookup(next, "Gone") == NULL) && (io_conf_remove(next, "Gone") == NULL);
+	io_conf_pair_delete(pair);
+	io_conf_delete(next);
+
+	iter = io_conf_subiter_begin(conf);
+	sub = io_conf_subiter_next(&iter);
+	suc &= str_isequal(io_conf_id(sub), "Sec") && (io_conf_parent(sub) == conf);
+	suc &= str_isequal(io_conf_lookup_single(sub, "Inner"), "1");
+
+	input = str_input_buf("Keep 1\nMulti a b c e\nAdded y\nBegin Sec\nInner 2\nEnd\nBegin New\nEnd\n");
+	next = io_conf_read(input);
+	io_input_close(input);
+
+	strbuf_init(&buf, 0);
+	io_conf_diff(conf, next, conf_change, &buf);
+	str = strbuf_done(&buf);
+	suc &= str_isequal(str, "~Multi -Drop +Added ~Sec.Inner -[Old] +[New] ");
+	mem_free(str);
+
+	strbuf_init(&buf, 0);
+	io_conf_diff(next, next, conf_change, &buf);
+	str = strbuf_done(&buf);
+	suc &= str_isequal(str, "");
+	mem_free(str);
+
+	fs_writestr("./tmp-conf", "Keep 2\n");
+	strbuf_init(&buf, 0);
+	next = io_conf_reload(next, "./tmp-conf", conf_change, &buf);
+	str = strbuf_done(&buf);
+	suc &= str_isequal(str, "~Keep -Multi -Added -[Sec] -[New] ");
+	suc &= str_isequal(io_conf_lookup_single(next, "Keep"), "2");
+	mem_free(str);
+
+	fs_writestr("./tmp-conf", "Keep 'open\n");
+	try {
+		next = io_conf_reload(next, "./tmp-conf", conf_change, NULL);
+		suc = false;
+	}
+	catch(e) { }
+
+	suc &= str_isequal(io_conf_lookup_single(next, "Keep"), "2");
+
+	fs_rmfile("./tmp-conf");
+	io_conf_delete(conf);
+	io_conf_delete(next);
+
+	if(!suc)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
 /**
  * Main entry point.
  *   @argc: The number of arguments.
@@ -191,8 +945,18 @@ int main(int argc, char *argv[])
 
 	suc &= test_io_len();
 	suc &= test_io_accum();
+	suc &= test_io_buffer();
+	suc &= test_io_fmt();
+	suc &= test_io_conv();
 	suc &= test_io_scan();
+	suc &= test_io_serial();
+	suc &= test_io_stream();
+	suc &= test_str_scan();
 	suc &= test_str_printf();
+	suc &= test_str_base();
+	suc &= test_str_slice();
+	suc &= test_str_intern();
+	suc &= test_io_conf();
 
 	return suc ? 0 : 1;
 }
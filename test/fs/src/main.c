@@ -84,6 +84,28 @@ bool test_fs_manip()
 
 	printf("okay\n");
 
+	printf("testing file segment... ");
+
+	{
+		struct io_file_t file;
+		struct io_output_t output;
+
+		file = io_file_open("testfile", io_read_e);
+		output = io_output_open("copyfile");
+		io_output_str(output, "x");
+		io_output_segment(output, file, 4, 4);
+		io_output_close(output);
+		io_file_close(file);
+
+		str = fs_readstr("copyfile");
+		if(!mem_isequal(str + 4, "xTEST", 6))
+			return printf("failed\n"), false;
+
+		mem_free(str);
+	}
+
+	printf("okay\n");
+
 	printf("testing file deletion... ");
 
 	fs_rmfile("testfile");
@@ -0,0 +1,25 @@
+src/main.o: src/main.c
+	$(bmake_PRECC)
+	$(CC) -I../../ $(CFLAGS) -c $< -o $@
+
+sanity: src/main.o
+	$(LD) $^ -Wl,-rpath=../../ -L../../ -lshim $(LDFLAGS) -o $@
+
+bmake_all:
+
+bmake_test: sanity
+
+bmake_install:
+
+bmake_clean:
+	rm -rf config.status config.log src/main.o src/.deps/*
+
+bmake_dist:
+	if [ -e shim-test-sanity-0.1.0 ] ; then rm -rf shim-test-sanity-0.1.0 ; fi ; mkdir shim-test-sanity-0.1.0
+	cp --parents configure Makefile.in $(wildcard mktests/* sources user.mk) src/common.h src/main.c shim-test-sanity-0.1.0
+	tar -zcf shim-test-sanity-0.1.0.tar.gz shim-test-sanity-0.1.0/
+	rm -rf shim-test-sanity-0.1.0
+
+sinclude src/.deps/*
+
+.PNOHY: bmake_install bmake_clean
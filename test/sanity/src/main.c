@@ -5,6 +5,7 @@
  * local function declarations
  */
 
+static bool clock_check();
 static void *thread_func(void *arg);
 
 
@@ -23,12 +24,50 @@ int main(int argc, char *argv[])
 	mem_free(mem_realloc(mem_alloc(10), 20));
 	printf("okay\n");
 
+	printf("clocks... ");
+	if(!clock_check())
+		printf("failed\n"), sys_exit(1);
+	else
+		printf("okay\n");
+
 	printf("spawn thread... ");
 	thread_join(thread_new(thread_func, NULL, NULL));
 
 	return 0;
 }
 
+/**
+ * Check the clocks against a short sleep.
+ *   &returns: True if the clocks agree.
+ */
+
+static bool clock_check()
+{
+	uint64_t ns, coarse, tsc;
+
+	sys_tsc_calibrate();
+	if(sys_tsc_hz() == 0)
+		return false;
+
+	ns = sys_monotonic_ns();
+	coarse = sys_coarsetime();
+	tsc = sys_tsc();
+	sys_usleep(20000);
+	tsc = sys_tsc() - tsc;
+	coarse = sys_coarsetime() - coarse;
+	ns = sys_monotonic_ns() - ns;
+	tsc = sys_tsc_ns(tsc);
+
+	if((ns < 20000000) || (ns > 2000000000))
+		return false;
+	else if((coarse + 20000000 < ns) || (coarse > ns + 20000000))
+		return false;
+	else if((tsc + 2000000 < ns) || (tsc > ns + 2000000))
+		return false;
+
+	return true;
+}
+
 /**
  * Thread test function.
  *   @arg: The argument.
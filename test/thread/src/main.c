@@ -5,7 +5,144 @@
  * local function declarations
  */
 
+static bool test_sync();
+static bool test_pool();
+static bool test_future();
+static bool test_graph();
+static bool test_attr();
+static bool test_lock();
+static bool test_read();
+static bool test_epoch();
+static bool test_prim();
+static bool test_cond();
+
 static void *sync_func(void *arg);
+static void count_task(void *arg);
+static void fib_task(void *arg);
+static void *square_func(void *arg);
+static void *throw_func(void *arg);
+static void then_func(struct thread_future_t *future, void *arg);
+static void step_task(void *arg);
+static void *lock_func(void *arg);
+static void *read_func(void *arg);
+static void *epoch_func(void *arg);
+static void node_delete(void *ref);
+static void *phase_func(void *arg);
+static void *post_func(void *arg);
+static void *signal_func(void *arg);
+
+/**
+ * Fibonacci task structure.
+ *   @pool: The pool.
+ *   @n: The input.
+ *   @res: The result.
+ */
+
+struct fib_t {
+	struct thread_pool_t *pool;
+	unsigned int n;
+	uint64_t res;
+};
+
+/**
+ * Lock contention structure.
+ *   @kind: The lock kind, zero for spinlock, one for adaptive mutex and two
+ *     for ticket lock.
+ *   @spin: The spinlock.
+ *   @fmutex: The adaptive mutex.
+ *   @ticket: The ticket lock.
+ *   @count: The protected counter.
+ */
+
+struct lock_t {
+	unsigned int kind;
+	struct thread_spin_t spin;
+	struct thread_fmutex_t fmutex;
+	struct thread_ticket_t ticket;
+	unsigned int count;
+};
+
+/**
+ * Read-mostly locking structure.
+ *   @seq: The sequence lock.
+ *   @drw: The distributed read-write lock.
+ *   @pair: The protected pair, always equal.
+ *   @bad: The number of inconsistent reads.
+ */
+
+struct read_t {
+	struct thread_seq_t seq;
+	struct thread_drwlock_t drw;
+	uintptr_t pair[2];
+	unsigned int bad;
+};
+
+/**
+ * Epoch reclamation structure.
+ *   @epoch: The epoch domain.
+ *   @node: The shared node.
+ *   @alloc: The number of nodes allocated.
+ *   @freed: The number of nodes deleted.
+ *   @bad: The number of reads of deleted nodes.
+ */
+
+struct epoch_t {
+	struct thread_epoch_t *epoch;
+	struct node_t *node;
+	unsigned int alloc, freed, bad;
+};
+
+/**
+ * Epoch protected node structure.
+ *   @magic: The magic value, cleared when deleted.
+ *   @freed: The counter of deleted nodes.
+ */
+
+struct node_t {
+	unsigned int magic;
+	unsigned int *freed;
+};
+
+/**
+ * Phased synchronization structure.
+ *   @go: The manual-reset start event.
+ *   @barrier: The phase barrier.
+ *   @sem: The completion semaphore.
+ *   @latch: The exit latch.
+ *   @count: The shared counter.
+ *   @serial: The number of serial barrier returns.
+ *   @bad: The number of phase violations.
+ */
+
+struct phase_t {
+	struct thread_event_t go;
+	struct thread_barrier_t barrier;
+	struct thread_sem_t sem;
+	struct thread_latch_t latch;
+	unsigned int count, serial, bad;
+};
+
+/**
+ * Condition signaling structure.
+ *   @cond: The condition variable.
+ *   @mutex: The mutex.
+ */
+
+struct signal_t {
+	struct thread_cond_t *cond;
+	struct thread_mutex_t *mutex;
+};
+
+/**
+ * Graph step structure.
+ *   @seq: The shared sequence counter.
+ *   @step: The step at which the node ran.
+ */
+
+struct step_t {
+	unsigned int *seq;
+	unsigned int step;
+};
 
 
 /**
@@ -16,20 +153,500 @@ static void *sync_func(void *arg);
  */
 
 int main(int argc, char *argv[])
+{
+	bool suc = true;
+
+	suc &= test_sync();
+	suc &= test_pool();
+	suc &= test_future();
+	suc &= test_graph();
+	suc &= test_attr();
+	suc &= test_lock();
+	suc &= test_read();
+	suc &= test_epoch();
+	suc &= test_prim();
+	suc &= test_cond();
+
+	return suc ? 0 : 1;
+}
+
+
+/**
+ * Thread synchronization testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_sync()
 {
 	unsigned int val = 0;
 	struct thread_t *thread;
 
 	printf("thread sync... ");
+
 	thread = thread_new(sync_func, &val, NULL);
 	if(thread_join(thread) != (void *)2)
-		printf("failed\n"), sys_exit(1);
+		return printf("failed\n"), false;
 	else if(val != 5)
-		printf("failed\n"), sys_exit(1);
-	else
-		printf("okay\n");
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread pool testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_pool()
+{
+	unsigned int i, val = 0;
+	struct fib_t fib;
+	struct thread_pool_t *pool;
+	struct thread_group_t group = THREAD_GROUP_INIT;
+
+	printf("thread pool... ");
+
+	pool = thread_pool_new(4);
+
+	for(i = 0; i < 100000; i++)
+		thread_pool_submit(pool, &group, count_task, &val);
+
+	thread_pool_wait(pool, &group);
+	if((val != 100000) || (group.pending != 0))
+		return printf("failed\n"), false;
+
+	fib = (struct fib_t){ pool, 24, 0 };
+	thread_pool_submit(pool, NULL, fib_task, &fib);
+	thread_pool_wait(pool, NULL);
+	if(fib.res != 46368)
+		return printf("failed\n"), false;
+
+	thread_pool_delete(pool);
+
+	pool = thread_pool_new(0);
+	if(thread_pool_nworkers(pool) == 0)
+		return printf("failed\n"), false;
+
+	fib = (struct fib_t){ pool, 20, 0 };
+	thread_pool_submit(pool, &group, fib_task, &fib);
+	thread_pool_wait(pool, &group);
+	thread_pool_delete(pool);
+
+	if(fib.res != 6765)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread future testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_future()
+{
+	unsigned int val = 0;
+	bool thrown = false;
+	struct thread_pool_t *pool;
+	struct thread_future_t *future;
+
+	printf("thread future... ");
+
+	pool = thread_pool_new(4);
+
+	future = thread_future_new();
+	if(thread_future_timedwait(future, sys_utime() + 1000))
+		return printf("failed\n"), false;
+
+	thread_future_then(future, then_func, &val);
+	thread_future_set(future, (void *)7);
+	if((thread_future_get(future) != (void *)7) || (val != 7))
+		return printf("failed\n"), false;
+
+	thread_future_then(future, then_func, &val);
+	thread_future_delete(future);
+	if(val != 14)
+		return printf("failed\n"), false;
+
+	future = thread_future_async(pool, square_func, (void *)9);
+	if(thread_future_get(future) != (void *)81)
+		return printf("failed\n"), false;
+
+	thread_future_delete(future);
+
+	future = thread_future_async(pool, throw_func, NULL);
+	try {
+		thread_future_get(future);
+	}
+	catch(e) {
+		thrown = true;
+	}
+
+	thread_future_delete(future);
+	thread_pool_delete(pool);
+
+	if(!thrown)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread graph testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_graph()
+{
+	unsigned int i, val = 0;
+	bool thrown = false;
+	struct step_t step[4];
+	struct thread_pool_t *pool;
+	struct thread_graph_t *graph;
+	struct thread_graph_node_t *node[4];
+
+	printf("thread graph... ");
+
+	pool = thread_pool_new(4);
+	graph = thread_graph_new(pool);
+
+	for(i = 0; i < 4; i++) {
+		step[i] = (struct step_t){ &val, 0 };
+		node[i] = thread_graph_add(graph, step_task, &step[i]);
+	}
+
+	thread_graph_depend(graph, node[1], node[0]);
+	thread_graph_depend(graph, node[2], node[0]);
+	thread_graph_depend(graph, node[3], node[1]);
+	thread_graph_depend(graph, node[3], node[2]);
+	thread_graph_run(graph);
+
+	if((val != 4) || (step[0].step != 0) || (step[3].step != 3))
+		return printf("failed\n"), false;
+
+	thread_graph_depend(graph, node[0], node[3]);
+	try {
+		thread_graph_run(graph);
+	}
+	catch(e) {
+		thrown = true;
+	}
+
+	thread_graph_delete(graph);
+	thread_pool_delete(pool);
+
+	if(!thrown)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread attribute testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_attr()
+{
+	unsigned int val = 0, cpu = 0;
+	bool thrown = false;
+	struct thread_t *thread;
+	struct thread_attr_t attr = THREAD_ATTR_INIT;
+
+	printf("thread attributes... ");
+
+	attr.stack = 64 * 1024;
+	attr.name = "attribute-test-thread";
+	attr.cpu = &cpu;
+	attr.ncpu = 1;
+	attr.sched = thread_sched_other_e;
+	attr.priority = 5;
+
+	thread = thread_new(sync_func, &val, &attr);
+	if((thread_join(thread) != (void *)2) || (val != 5))
+		return printf("failed\n"), false;
+
+	cpu = 1u << 30;
+	try {
+		thread_join(thread_new(sync_func, &val, &attr));
+	}
+	catch(e) {
+		thrown = true;
+	}
+
+	if(!thrown)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread lock testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_lock()
+{
+	unsigned int i;
+	struct lock_t lock;
+	struct thread_t *threads[4];
+
+	printf("thread locks... ");
+
+	for(lock.kind = 0; lock.kind < 3; lock.kind++) {
+		lock = (struct lock_t){ lock.kind, THREAD_SPIN_INIT, THREAD_FMUTEX_INIT, THREAD_TICKET_INIT, 0 };
+
+		for(i = 0; i < 4; i++)
+			threads[i] = thread_new(lock_func, &lock, NULL);
+
+		for(i = 0; i < 4; i++)
+			thread_join(threads[i]);
+
+		if(lock.count != 40000)
+			return printf("failed\n"), false;
+	}
+
+	lock.count = 0;
+	if(!thread_spin_trylock(&lock.spin) || thread_spin_trylock(&lock.spin))
+		lock.count++;
+
+	if(!thread_fmutex_trylock(&lock.fmutex) || thread_fmutex_trylock(&lock.fmutex))
+		lock.count++;
+
+	if(!thread_ticket_trylock(&lock.ticket) || thread_ticket_trylock(&lock.ticket))
+		lock.count++;
+
+	thread_spin_unlock(&lock.spin);
+	thread_fmutex_unlock(&lock.fmutex);
+	thread_ticket_unlock(&lock.ticket);
+
+	if(lock.count != 0)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread read-mostly lock testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_read()
+{
+	unsigned int i;
+	struct read_t read;
+	struct thread_t *threads[4];
+
+	printf("thread read locks... ");
+
+	read = (struct read_t){ THREAD_SEQ_INIT, thread_drwlock_new(), { 0, 0 }, 0 };
+
+	for(i = 0; i < 4; i++)
+		threads[i] = thread_new(read_func, &read, NULL);
+
+	for(i = 0; i < 4; i++)
+		thread_join(threads[i]);
+
+	if(!thread_drwlock_trywrlock(&read.drw))
+		return printf("failed\n"), false;
+
+	if(thread_drwlock_tryrdlock(&read.drw))
+		return printf("failed\n"), false;
+
+	thread_drwlock_wrunlock(&read.drw);
+	thread_drwlock_delete(&read.drw);
+
+	if((read.bad != 0) || (read.pair[0] != 8000) || (read.pair[1] != 8000))
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread epoch reclamation testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_epoch()
+{
+	unsigned int i, val = 0;
+	struct epoch_t epoch;
+	struct thread_t *threads[4];
+
+	printf("thread epoch... ");
+
+	epoch.epoch = thread_epoch_new();
+	epoch.node = mem_alloc(sizeof(struct node_t));
+	*epoch.node = (struct node_t){ 0xC0FFEE, &epoch.freed };
+	epoch.alloc = 1;
+	epoch.freed = 0;
+	epoch.bad = 0;
+
+	for(i = 0; i < 4; i++)
+		threads[i] = thread_new(epoch_func, &epoch, NULL);
+
+	for(i = 0; i < 4; i++)
+		thread_join(threads[i]);
 
-	return 0;
+	thread_epoch_defer(epoch.epoch, epoch.node, node_delete);
+	thread_epoch_synchronize(epoch.epoch);
+
+	if((epoch.bad != 0) || (epoch.freed != epoch.alloc))
+		return printf("failed\n"), false;
+
+	thread_epoch_enter(epoch.epoch);
+	thread_epoch_defer(epoch.epoch, &val, count_task);
+	thread_epoch_exit(epoch.epoch);
+	thread_epoch_synchronize(epoch.epoch);
+	thread_epoch_delete(epoch.epoch);
+
+	if(val != 1)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread synchronization primitive testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_prim()
+{
+	unsigned int i;
+	struct phase_t phase;
+	struct thread_event_t event;
+	struct thread_t *threads[4];
+
+	printf("thread sync primitives... ");
+
+	phase = (struct phase_t){ thread_event_new(true), thread_barrier_new(4), thread_sem_new(0), thread_latch_new(4), 0, 0, 0 };
+
+	for(i = 0; i < 4; i++)
+		threads[i] = thread_new(phase_func, &phase, NULL);
+
+	if(thread_latch_waitfor(&phase.latch, 1000) || thread_sem_trywait(&phase.sem))
+		return printf("failed\n"), false;
+
+	thread_event_set(&phase.go);
+
+	for(i = 0; i < 400; i++)
+		thread_sem_wait(&phase.sem);
+
+	if(!thread_latch_waituntil(&phase.latch, sys_monotonic_ns() + 10000000000))
+		return printf("failed\n"), false;
+
+	for(i = 0; i < 4; i++)
+		thread_join(threads[i]);
+
+	if(thread_sem_waituntil(&phase.sem, sys_monotonic_ns() + 1000000) || (phase.bad != 0) || (phase.serial != 200) || (phase.count != 400))
+		return printf("failed\n"), false;
+
+	event = thread_event_new(false);
+	if(thread_event_waituntil(&event, sys_monotonic_ns() + 1000000))
+		return printf("failed\n"), false;
+
+	thread_event_set(&event);
+	if(!thread_event_trywait(&event) || thread_event_trywait(&event))
+		return printf("failed\n"), false;
+
+	thread_event_set(&event);
+	if(!thread_event_waitfor(&event, 1000))
+		return printf("failed\n"), false;
+
+	phase.sem = thread_sem_new(0);
+	threads[0] = thread_new(post_func, &phase.sem, NULL);
+	if(!thread_sem_waitfor(&phase.sem, UINT64_MAX))
+		return printf("failed\n"), false;
+
+	thread_join(threads[0]);
+
+	threads[0] = thread_new(post_func, &phase.sem, NULL);
+	if(!thread_sem_waituntil(&phase.sem, UINT64_MAX))
+		return printf("failed\n"), false;
+
+	thread_join(threads[0]);
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Thread condition variable timeout testing.
+ *   &returns: True on success, false on failure.
+ */
+
+static bool test_cond()
+{
+	unsigned int i;
+	uint64_t start;
+	struct thread_t *thread;
+	struct thread_cond_t cond;
+	struct thread_mutex_t mutex;
+	struct thread_cond_attr_t attr = THREAD_COND_ATTR_INIT;
+
+	printf("thread cond timeouts... ");
+
+	mutex = thread_mutex_new(NULL);
+
+	for(i = 0; i < 2; i++) {
+		attr.realtime = (i == 1);
+		cond = thread_cond_new(&attr);
+		thread_mutex_lock(&mutex);
+
+		start = sys_monotonic_ns();
+		if(thread_cond_waitfor(&cond, &mutex, 2000) || ((sys_monotonic_ns() - start) < 2000000))
+			return printf("failed\n"), false;
+
+		start = sys_monotonic_ns();
+		if(thread_cond_waituntil(&cond, &mutex, start + 2000000) || ((sys_monotonic_ns() - start) < 2000000))
+			return printf("failed\n"), false;
+
+		if(thread_cond_timedwait(&cond, &mutex, sys_utime() + 1000))
+			return printf("failed\n"), false;
+
+		thread = thread_new(signal_func, &(struct signal_t){ &cond, &mutex }, NULL);
+		if(!thread_cond_waitfor(&cond, &mutex, UINT64_MAX))
+			return printf("failed\n"), false;
+
+		thread_mutex_unlock(&mutex);
+		thread_join(thread);
+		thread_mutex_lock(&mutex);
+
+		thread = thread_new(signal_func, &(struct signal_t){ &cond, &mutex }, NULL);
+		if(!thread_cond_timedwait(&cond, &mutex, UINT64_MAX))
+			return printf("failed\n"), false;
+
+		thread_mutex_unlock(&mutex);
+		thread_join(thread);
+		thread_mutex_lock(&mutex);
+
+		thread_mutex_unlock(&mutex);
+		thread_cond_delete(&cond);
+	}
+
+	thread_mutex_delete(&mutex);
+
+	printf("okay\n");
+
+	return true;
 }
 
 
@@ -46,3 +663,271 @@ static void *sync_func(void *arg)
 
 	return (void *)2;
 }
+
+/**
+ * Counting task.
+ *   @arg: The counter.
+ */
+
+static void count_task(void *arg)
+{
+	__atomic_add_fetch((unsigned int *)arg, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Recursive fork/join Fibonacci task.
+ *   @arg: The Fibonacci structure.
+ */
+
+static void fib_task(void *arg)
+{
+	struct fib_t *fib = arg, left, right;
+	struct thread_group_t group = THREAD_GROUP_INIT;
+
+	if(fib->n < 2) {
+		fib->res = fib->n;
+		return;
+	}
+
+	left = (struct fib_t){ fib->pool, fib->n - 1, 0 };
+	right = (struct fib_t){ fib->pool, fib->n - 2, 0 };
+	thread_pool_submit(fib->pool, &group, fib_task, &left);
+	thread_pool_submit(fib->pool, &group, fib_task, &right);
+	thread_pool_wait(fib->pool, &group);
+
+	fib->res = left.res + right.res;
+}
+
+/**
+ * Squaring function.
+ *   @arg: The input.
+ *   &returns: The square of the input.
+ */
+
+static void *square_func(void *arg)
+{
+	return (void *)((uintptr_t)arg * (uintptr_t)arg);
+}
+
+/**
+ * Throwing function.
+ *   @arg: Unused.
+ *   &returns: Never.
+ */
+
+static void *throw_func(void *arg)
+{
+	throw("Test failure.");
+}
+
+/**
+ * Continuation adding the future value to a counter.
+ *   @future: The future.
+ *   @arg: The counter.
+ */
+
+static void then_func(struct thread_future_t *future, void *arg)
+{
+	*(unsigned int *)arg += (uintptr_t)thread_future_get(future);
+}
+
+/**
+ * Graph step task, recording the order in which it ran.
+ *   @arg: The step structure.
+ */
+
+static void step_task(void *arg)
+{
+	struct step_t *step = arg;
+
+	step->step = __atomic_fetch_add(step->seq, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Lock contention thread, incrementing the counter under the lock.
+ *   @arg: The lock structure.
+ *   &returns: Always null.
+ */
+
+static void *lock_func(void *arg)
+{
+	unsigned int i;
+	struct lock_t *lock = arg;
+
+	for(i = 0; i < 10000; i++) {
+		switch(lock->kind) {
+		case 0:
+			thread_spin_lock(&lock->spin);
+			lock->count++;
+			thread_spin_unlock(&lock->spin);
+			break;
+
+		case 1:
+			thread_fmutex_lock(&lock->fmutex);
+			lock->count++;
+			thread_fmutex_unlock(&lock->fmutex);
+			break;
+
+		case 2:
+			thread_ticket_lock(&lock->ticket);
+			lock->count++;
+			thread_ticket_unlock(&lock->ticket);
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Read-mostly thread, checking the pair under both locks and occasionally
+ * updating it.
+ *   @arg: The read structure.
+ *   &returns: Always null.
+ */
+
+static void *read_func(void *arg)
+{
+	unsigned int i;
+	uintptr_t pair[2];
+	struct read_t *read = arg;
+
+	for(i = 0; i < 16000; i++) {
+		if((i % 8) == 0) {
+			thread_drwlock_wrlock(&read->drw);
+			pair[0] = read->pair[0] + 1;
+			pair[1] = read->pair[1] + 1;
+			thread_seq_write(&read->seq, read->pair, pair, sizeof(pair));
+			thread_drwlock_wrunlock(&read->drw);
+		}
+		else if((i % 2) == 0) {
+			thread_drwlock_rdlock(&read->drw);
+			if(read->pair[0] != read->pair[1])
+				__atomic_add_fetch(&read->bad, 1, __ATOMIC_RELAXED);
+
+			thread_drwlock_rdunlock(&read->drw);
+		}
+		else {
+			thread_seq_read(&read->seq, pair, read->pair, sizeof(pair));
+			if(pair[0] != pair[1])
+				__atomic_add_fetch(&read->bad, 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Epoch reader thread, checking the shared node inside critical sections and
+ * occasionally replacing it.
+ *   @arg: The epoch structure.
+ *   &returns: Always null.
+ */
+
+static void *epoch_func(void *arg)
+{
+	unsigned int i;
+	struct node_t *node, *prev;
+	struct epoch_t *epoch = arg;
+
+	for(i = 0; i < 16000; i++) {
+		thread_epoch_enter(epoch->epoch);
+
+		if((i % 4) == 0) {
+			node = mem_alloc(sizeof(struct node_t));
+			*node = (struct node_t){ 0xC0FFEE, &epoch->freed };
+			__atomic_add_fetch(&epoch->alloc, 1, __ATOMIC_RELAXED);
+
+			prev = __atomic_exchange_n(&epoch->node, node, __ATOMIC_ACQ_REL);
+			thread_epoch_defer(epoch->epoch, prev, node_delete);
+		}
+		else {
+			node = __atomic_load_n(&epoch->node, __ATOMIC_ACQUIRE);
+			if(__atomic_load_n(&node->magic, __ATOMIC_RELAXED) != 0xC0FFEE)
+				__atomic_add_fetch(&epoch->bad, 1, __ATOMIC_RELAXED);
+		}
+
+		thread_epoch_exit(epoch->epoch);
+	}
+
+	return NULL;
+}
+
+/**
+ * Delete an epoch protected node, poisoning it first.
+ *   @ref: The node.
+ */
+
+static void node_delete(void *ref)
+{
+	struct node_t *node = ref;
+
+	__atomic_store_n(&node->magic, 0, __ATOMIC_RELAXED);
+	__atomic_add_fetch(node->freed, 1, __ATOMIC_RELAXED);
+	mem_free(node);
+}
+
+/**
+ * Phased thread, stepping a shared counter in lock-step with the others.
+ *   @arg: The phase structure.
+ *   &returns: Always null.
+ */
+
+static void *phase_func(void *arg)
+{
+	unsigned int i;
+	struct phase_t *phase = arg;
+
+	thread_event_wait(&phase->go);
+
+	for(i = 0; i < 100; i++) {
+		__atomic_add_fetch(&phase->count, 1, __ATOMIC_RELAXED);
+		if(thread_barrier_wait(&phase->barrier))
+			__atomic_add_fetch(&phase->serial, 1, __ATOMIC_RELAXED);
+
+		if(__atomic_load_n(&phase->count, __ATOMIC_RELAXED) != 4 * (i + 1))
+			__atomic_add_fetch(&phase->bad, 1, __ATOMIC_RELAXED);
+
+		if(thread_barrier_wait(&phase->barrier))
+			__atomic_add_fetch(&phase->serial, 1, __ATOMIC_RELAXED);
+
+		thread_sem_post(&phase->sem);
+	}
+
+	thread_latch_arrive(&phase->latch);
+
+	return NULL;
+}
+
+/**
+ * Delayed posting thread.
+ *   @arg: The semaphore.
+ *   &returns: Always null.
+ */
+
+static void *post_func(void *arg)
+{
+	sys_usleep(5000);
+	thread_sem_post(arg);
+
+	return NULL;
+}
+
+/**
+ * Delayed signaling thread. The mutex is held by the waiter until it waits,
+ * so the signal cannot be missed.
+ *   @arg: The signal structure.
+ *   &returns: Always null.
+ */
+
+static void *signal_func(void *arg)
+{
+	struct signal_t *signal = arg;
+
+	sys_usleep(5000);
+	thread_mutex_lock(signal->mutex);
+	thread_cond_signal(signal->cond);
+	thread_mutex_unlock(signal->mutex);
+
+	return NULL;
+}
@@ -94,7 +94,7 @@ bool test_avltree()
 bool test_integer()
 {
 	char *endptr, buf[64];
-	struct integer_t *val, *tmp;
+	struct integer_t *val, *tmp, *rem2;
 	unsigned int rem;
 
 	printf("testing integer... ");
@@ -109,7 +109,14 @@ bool test_integer()
 		return printf("failed\n"), false;
 
 	integer_add_uint(&val, UINT_MAX);
-	if((val->len != 2) || (val->arr[0] != 57) || (val->arr[1] != 1))
+	if((val->len != 1) || (val->arr[0] != (uint64_t)UINT_MAX + 58))
+		return printf("failed\n"), false;
+
+	integer_delete(val);
+
+	val = integer_parse("18446744073709551615", NULL);
+	integer_add_uint(&val, 1);
+	if((val->len != 2) || (val->arr[0] != 0) || (val->arr[1] != 1))
 		return printf("failed\n"), false;
 
 	integer_delete(val);
@@ -236,6 +243,536 @@ bool test_integer()
 		return printf("failed %u\n", integer_uint8(val)), false;
 	integer_delete(val);
 
+	val = integer_parse("-7", NULL);
+	tmp = integer_new(2);
+	integer_divmod(&val, tmp, &rem2);
+	str_printf(buf, "%C %C", integer_chunk(val), integer_chunk(rem2));
+	integer_delete(rem2);
+	integer_delete(tmp);
+	integer_delete(val);
+	if(!str_isequal(buf, "-3 -1"))
+		return printf("failed\n"), false;
+
+	val = integer_new(1);
+	integer_shl(&val, 200);
+	if((val->len != 4) || (val->arr[3] != 256))
+		return printf("failed\n"), false;
+
+	integer_shr(&val, 190);
+	str_printf(buf, "%C", integer_chunk(val));
+	integer_delete(val);
+	if(!str_isequal(buf, "1024"))
+		return printf("failed\n"), false;
+
+	val = integer_new(-5);
+	integer_shr(&val, 1);
+	str_printf(buf, "%C", integer_chunk(val));
+	integer_delete(val);
+	if(!str_isequal(buf, "-3"))
+		return printf("failed\n"), false;
+
+	val = integer_new(-12);
+	tmp = integer_new(255);
+	integer_and(&val, tmp);
+	str_printf(buf, "%C", integer_chunk(val));
+	integer_or(&val, tmp);
+	integer_xor(&val, tmp);
+	str_printf(buf + str_len(buf), " %C", integer_chunk(val));
+	integer_delete(tmp);
+	integer_delete(val);
+	if(!str_isequal(buf, "244 0"))
+		return printf("failed\n"), false;
+
+	val = integer_new(-12);
+	tmp = integer_new(10);
+	integer_or(&val, tmp);
+	str_printf(buf, "%C", integer_chunk(val));
+	integer_delete(tmp);
+	integer_delete(val);
+	if(!str_isequal(buf, "-2"))
+		return printf("failed\n"), false;
+
+	{
+		unsigned int i;
+		char nines[2001], *str;
+
+		for(i = 0; i < 2000; i++)
+			nines[i] = '9';
+
+		nines[2000] = '\0';
+
+		val = integer_parse(nines, NULL);
+		tmp = integer_copy(val);
+		integer_mul(&val, tmp);
+
+		str = str_aprintf("%C", integer_chunk(val));
+		for(i = 0; i < 1999; i++) {
+			if((str[i] != '9') || (str[i + 2000] != '0'))
+				return printf("failed\n"), false;
+		}
+
+		if((str[1999] != '8') || !str_isequal(str + 3999, "1"))
+			return printf("failed\n"), false;
+
+		mem_free(str);
+
+		integer_add_uint(&val, 5);
+		integer_divmod(&val, tmp, &rem2);
+		if((integer_cmp(val, tmp) != 0) || (integer_uint64(rem2) != 5) || (rem2->len != 1))
+			return printf("failed\n"), false;
+
+		integer_delete(rem2);
+		integer_delete(tmp);
+		integer_delete(val);
+	}
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * String buffer testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_strbuf()
+{
+	unsigned int i;
+	char *str;
+	const char *fin;
+	struct strbuf_t buf;
+	struct str_slice_t slice;
+
+	printf("testing string buffer... ");
+
+	strbuf_init(&buf, 0);
+	strbuf_append(&buf, "short");
+	if(!str_slice_isequal(strbuf_slice(&buf), str_slice_from("short")))
+		return printf("failed\n"), false;
+
+	for(i = 0; i < 100; i++)
+		strbuf_store(&buf, 'a' + (i % 26));
+
+	slice = strbuf_slice(&buf);
+	if((slice.len != 105) || (slice.ptr[4] != 't') || (slice.ptr[104] != 'v'))
+		return printf("failed\n"), false;
+
+	strbuf_reset(&buf);
+	strbuf_append(&buf, "shor");
+	strbuf_shrink(&buf);
+	strbuf_printf(&buf, "-%u-%s", 42, "x");
+	if(!str_isequal(strbuf_finish(&buf), "shor-42-x") || (strbuf_slice(&buf).len != 0))
+		return printf("failed\n"), false;
+
+	strbuf_reserve(&buf, 1000);
+	fin = strbuf_slice(&buf).ptr;
+	for(i = 0; i < 1000; i++)
+		strbuf_store(&buf, 'z');
+
+	if((strbuf_slice(&buf).ptr != fin) || (strbuf_slice(&buf).len != 1000))
+		return printf("failed\n"), false;
+
+	strbuf_reset(&buf);
+	strbuf_printf(&buf, "%s=%d", "value", -7);
+	str = strbuf_done(&buf);
+	if(!str_isequal(str, "value=-7"))
+		return printf("failed\n"), false;
+
+	mem_free(str);
+
+	buf = strbuf_empty(16);
+	strbuf_append(&buf, "inline");
+	str = strbuf_done(&buf);
+	if(!str_isequal(str, "inline"))
+		return printf("failed\n"), false;
+
+	mem_free(str);
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Encode a string for a snapshot.
+ *   @str: The string.
+ *   @arg: Unused.
+ *   &returns: The string bytes.
+ */
+
+struct str_slice_t snap_encode(const void *str, void *arg)
+{
+	return str_slice_from(str);
+}
+
+/**
+ * Encode a string for a snapshot, rejecting "v77".
+ *   @str: The string.
+ *   @arg: Unused.
+ *   &returns: The string bytes.
+ */
+
+struct str_slice_t snap_reject(const void *str, void *arg)
+{
+	if(str_isequal(str, "v77"))
+		throw("Rejected.");
+
+	return str_slice_from(str);
+}
+
+/**
+ * Compare a string against snapshot key bytes.
+ *   @key: The string key.
+ *   @stored: The stored key.
+ *   @arg: Unused.
+ *   &returns: Their order.
+ */
+
+int snap_compare(const void *key, struct str_slice_t stored, void *arg)
+{
+	return str_slice_cmp(str_slice_from(key), stored);
+}
+
+/**
+ * Snapshot testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_snapshot()
+{
+	bool suc = true;
+	unsigned int i, n;
+	char key[150][8], val[150][8];
+	struct avltree_t tree;
+	struct avlitree_t list;
+	struct io_output_t output;
+	struct snapshot_t *snap;
+	struct snapshot_iter_t iter;
+	struct str_slice_t k, v;
+	static const char bad[64] = "shimsnap";
+
+	printf("testing snapshot... ");
+
+	tree = avltree_empty(compare_str, delete_noop);
+	list = avlitree_empty(delete_noop);
+
+	for(i = 0; i < 150; i++) {
+		n = (i * 97) % 150;
+		str_printf(key[n], "k%03u", 2 * n);
+		str_printf(val[n], "v%u", n);
+		avltree_insert(&tree, key[n], val[n]);
+		avlitree_append(&list, val[n]);
+	}
+
+	output = io_output_open("./tmp-snap");
+	snapshot_save_avltree(output, &tree, snap_encode, snap_encode, NULL);
+	io_output_close(output);
+
+	snap = snapshot_open("./tmp-snap");
+
+	suc &= (snapshot_count(snap) == 150);
+	suc &= str_slice_isequal(snapshot_lookup(snap, "k042", snap_compare, NULL), str_slice_from("v21"));
+	suc &= (snapshot_lookup(snap, "k043", snap_compare, NULL).ptr == NULL);
+	suc &= str_slice_isequal(snapshot_atleast(snap, "k043", snap_compare, NULL), str_slice_from("v22"));
+	suc &= str_slice_isequal(snapshot_atmost(snap, "k043", snap_compare, NULL), str_slice_from("v21"));
+	suc &= str_slice_isequal(snapshot_atmost(snap, "k044", snap_compare, NULL), str_slice_from("v22"));
+	suc &= (snapshot_atleast(snap, "k299", snap_compare, NULL).ptr == NULL);
+	suc &= (snapshot_atmost(snap, "a", snap_compare, NULL).ptr == NULL);
+	k = str_slice_from("k298");
+	suc &= str_slice_isequal(snapshot_lookup(snap, &k, NULL, NULL), str_slice_from("v149"));
+
+	i = 0;
+	iter = snapshot_iter_begin(snap);
+	while(snapshot_iter_next(&iter, &k, &v)) {
+		suc &= str_slice_isequal(k, str_slice_from(key[i]));
+		suc &= str_slice_isequal(v, str_slice_from(val[i]));
+		suc &= (((uintptr_t)k.ptr % 8) == 0);
+		i++;
+	}
+
+	suc &= (i == 150);
+	snapshot_close(snap);
+
+	output = io_output_open("./tmp-snap");
+	snapshot_save_avlitree(output, &list, snap_encode, NULL);
+	io_output_close(output);
+
+	snap = snapshot_open("./tmp-snap");
+
+	for(i = 0; i < 150; i++)
+		suc &= str_slice_isequal(snapshot_get(snap, i), str_slice_from(avlitree_get(&list, i)));
+
+	suc &= (snapshot_get(snap, 150).ptr == NULL);
+	suc &= (snapshot_key(snap, 0).ptr == NULL);
+	suc &= (snapshot_lookup(snap, "v1", snap_compare, NULL).ptr == NULL);
+	snapshot_close(snap);
+
+	try {
+		snap = snapshot_load(bad, sizeof(bad));
+		snapshot_close(snap);
+		suc = false;
+	}
+	catch(e) { }
+
+	output = io_output_open("./tmp-snap");
+
+	try {
+		snapshot_save_avltree(output, &tree, snap_encode, snap_reject, NULL);
+		suc = false;
+	}
+	catch(e)
+		suc &= str_isequal(e, "Rejected.");
+
+	try {
+		snapshot_save_avlitree(output, &list, snap_reject, NULL);
+		suc = false;
+	}
+	catch(e)
+		suc &= str_isequal(e, "Rejected.");
+
+	io_output_close(output);
+
+	fs_rmfile("./tmp-snap");
+	avltree_destroy(&tree);
+	avlitree_destroy(&list);
+
+	if(!suc)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Sort test element.
+ *   @key: The sort key.
+ *   @idx: The original position.
+ */
+
+struct elem_t {
+	unsigned int key, idx;
+};
+
+/**
+ * Compare sort test elements by key.
+ *   @p1: The first element.
+ *   @p2: The second element.
+ *   &returns: Their order.
+ */
+
+int elem_compare(const void *p1, const void *p2)
+{
+	const struct elem_t *a = p1, *b = p2;
+
+	return (a->key > b->key) - (a->key < b->key);
+}
+
+/**
+ * Check that elements are sorted by key, with ties in original order.
+ *   @arr: The array.
+ *   @n: The number of elements.
+ *   &returns: True if sorted and stable.
+ */
+
+bool elem_check(void **arr, size_t n)
+{
+	size_t i;
+	struct elem_t *a, *b;
+
+	for(i = 1; i < n; i++) {
+		a = arr[i - 1];
+		b = arr[i];
+		if((a->key > b->key) || ((a->key == b->key) && (a->idx > b->idx)))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Sort testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_sort()
+{
+	bool suc = true;
+	unsigned int i, n;
+	void *ref, **arr;
+	struct elem_t *elem;
+	struct iter_t iter;
+	struct enum_t sort;
+	struct thread_pool_t *pool;
+
+	printf("testing sort... ");
+
+	n = 100000;
+	elem = mem_alloc(n * sizeof(struct elem_t));
+	arr = mem_alloc((n + 1) * sizeof(void *));
+
+	for(i = 0; i < n; i++) {
+		elem[i] = (struct elem_t){ (i * 7919) % 1000, i };
+		arr[i] = &elem[i];
+	}
+
+	sort_stable(arr, n, elem_compare);
+	suc &= elem_check(arr, n);
+
+	for(i = 0; i < n; i++)
+		arr[i] = &elem[n - i - 1], elem[n - i - 1].idx = i;
+
+	pool = thread_pool_new(4);
+	sort_par(pool, arr, n, elem_compare);
+	thread_pool_delete(pool);
+	suc &= elem_check(arr, n);
+
+	for(i = 0; i < 100; i++)
+		elem[i] = (struct elem_t){ i % 10, i }, arr[i] = &elem[i];
+
+	arr[100] = NULL;
+	sort = enum_sort(enum_arr(arr), elem_compare);
+	iter = enum_iter(sort);
+
+	for(i = 0; (ref = iter_next(iter)) != NULL; i++)
+		arr[i] = ref;
+
+	iter_delete(iter);
+	enum_delete(sort);
+	suc &= (i == 100) && elem_check(arr, 100);
+
+	mem_free(elem);
+	mem_free(arr);
+
+	if(!suc)
+		return printf("failed\n"), false;
+
+	printf("okay\n");
+
+	return true;
+}
+
+/**
+ * Double an integer reference.
+ *   @ref: The reference.
+ *   @arg: Unused.
+ *   &returns: The doubled reference.
+ */
+
+void *par_double(void *ref, void *arg)
+{
+	return (void *)(2 * (uintptr_t)ref);
+}
+
+/**
+ * Keep integer references divisible by three.
+ *   @in: The reference.
+ *   @arg: Unused.
+ *   &returns: The reference or null.
+ */
+
+void *par_three(void *in, void *arg)
+{
+	return ((uintptr_t)in % 3 == 0) ? in : NULL;
+}
+
+/**
+ * Sum integer references.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   @arg: Unused.
+ *   &returns: The sum.
+ */
+
+void *par_sum(void *left, void *right, void *arg)
+{
+	return (void *)((uintptr_t)left + (uintptr_t)right);
+}
+
+/**
+ * Bitwise and integer references.
+ *   @left: The left value.
+ *   @right: The right value.
+ *   @arg: Unused.
+ *   &returns: The conjunction.
+ */
+
+void *par_and(void *left, void *right, void *arg)
+{
+	return (void *)((uintptr_t)left & (uintptr_t)right);
+}
+
+/**
+ * Parallel pipeline testing.
+ *   &returns: True of success, false on failure.
+ */
+
+bool test_par()
+{
+	bool suc = true;
+	unsigned int i, n;
+	uintptr_t sum, prev;
+	void *ref, **arr;
+	struct iter_t iter;
+	struct enum_t penum;
+	struct thread_pool_t *pool;
+
+	printf("testing parallel pipelines... ");
+
+	n = 20000;
+	arr = mem_alloc((n + 1) * sizeof(void *));
+	for(i = 0; i < n; i++)
+		arr[i] = (void *)(uintptr_t)(i + 1);
+
+	arr[n] = NULL;
+	pool = thread_pool_new(4);
+
+	sum = prev = 0;
+	iter = par_map(pool, iter_arr(arr), par_double, NULL);
+	while((ref = iter_next(iter)) != NULL) {
+		suc &= ((uintptr_t)ref == prev + 2);
+		prev = (uintptr_t)ref;
+		sum += prev;
+	}
+
+	iter_delete(iter);
+	suc &= (sum == (uintptr_t)n * (n + 1));
+
+	suc &= ((uintptr_t)par_reduce(pool, iter_arr(arr), par_sum, NULL) == (uintptr_t)n * (n + 1) / 2);
+	suc &= (par_reduce(NULL, iter_blank, par_sum, NULL) == NULL);
+
+	penum = par_enum_filter(pool, enum_arr(arr), filter_new(par_three, NULL));
+	for(i = 0; i < 2; i++) {
+		sum = prev = 0;
+		iter = enum_iter(penum);
+		while((ref = iter_next(iter)) != NULL) {
+			suc &= ((uintptr_t)ref == prev + 3);
+			prev = (uintptr_t)ref;
+			sum++;
+		}
+
+		iter_delete(iter);
+		suc &= (sum == n / 3);
+	}
+
+	enum_delete(penum);
+
+	iter = par_filter(NULL, iter_arr(arr), filter_new(par_three, NULL));
+	suc &= ((uintptr_t)par_reduce(pool, iter, par_sum, NULL) == 3 * (uintptr_t)(n / 3) * (n / 3 + 1) / 2);
+
+	for(i = 0; i < n; i++)
+		arr[i] = (void *)(uintptr_t)((i < 2) ? (i + 1) : 3);
+
+	suc &= (par_reduce(pool, iter_arr(arr), par_and, NULL) == NULL);
+	suc &= (par_reduce(NULL, iter_arr(arr), par_and, NULL) == NULL);
+
+	thread_pool_delete(pool);
+	mem_free(arr);
+
+	if(!suc)
+		return printf("failed\n"), false;
+
 	printf("okay\n");
 
 	return true;
@@ -254,6 +791,10 @@ int main(int argc, char *argv[])
 
 	suc &= test_avltree();
 	suc &= test_integer();
+	suc &= test_par();
+	suc &= test_snapshot();
+	suc &= test_sort();
+	suc &= test_strbuf();
 
 	return suc ? 0 : 1;
 }
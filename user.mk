@@ -37,9 +37,11 @@ HEADERS = \
 	src/os/path.h \
 	\
 	src/string/base.h \
+	src/string/intern.h \
 	src/string/io.h \
 	src/string/locale.h \
 	src/string/scan.h \
+	src/string/slice.h \
 	\
 	src/sys/lib.h \
 	src/sys/proc.h \
@@ -48,8 +50,16 @@ HEADERS = \
 	\
 	src/thread/base.h \
 	src/thread/cond.h \
+	src/thread/drwlock.h \
+	src/thread/epoch.h \
+	src/thread/future.h \
+	src/thread/graph.h \
 	src/thread/local.h \
 	src/thread/lock.h \
+	src/thread/pool.h \
+	src/thread/seq.h \
+	src/thread/spin.h \
+	src/thread/sync.h \
 	\
 	src/types/avltree.h \
 	src/types/avlitree.h \
@@ -61,7 +71,10 @@ HEADERS = \
 	src/types/integer.h \
 	src/types/iter.h \
 	src/types/llist.h \
+	src/types/par.h \
 	src/types/queue.h \
+	src/types/snapshot.h \
+	src/types/sort.h \
 	src/types/strbuf.h \
 	src/types/type.h \
 	src/types/value.h \